@@ -0,0 +1,39 @@
+/*==============================================================================
+
+   Axis aligned bounding box [aabb.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef AABB_H
+#define AABB_H
+
+#include <DirectXMath.h>
+
+// DirectXMath only (no D3D / Windows header), headless tools use it as well
+struct AABB
+{
+	DirectX::XMFLOAT3 min;
+	DirectX::XMFLOAT3 max;
+
+	DirectX::XMFLOAT3 GetHalf() const {
+		DirectX::XMFLOAT3 half;
+		half.x = (max.x - min.x) * 0.5f;
+		half.y = (max.y - min.y) * 0.5f;
+		half.z = (max.z - min.z) * 0.5f;
+		return half;
+	}
+
+	DirectX::XMFLOAT3 GetCenter() const {
+		DirectX::XMFLOAT3 center;
+		DirectX::XMFLOAT3 half = GetHalf();
+		center.x = min.x + half.x;
+		center.y = min.y + half.y;
+		center.z = min.z + half.z;
+		return center;
+	}
+};
+
+#endif // AABB_H
@@ -0,0 +1,63 @@
+/*==============================================================================
+
+   Aligned allocator for SIMD buffers [aligned_alloc_util.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ALIGNED_ALLOC_UTIL_H
+#define ALIGNED_ALLOC_UTIL_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+// std::allocator only guarantees 8 byte alignment on Win32,
+// XMMATRIX / XMVECTOR arrays need 16
+template<typename T, size_t Alignment = 16>
+struct AlignedAllocator
+{
+	typedef T value_type;
+
+	template<typename U>
+	struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+	AlignedAllocator() = default;
+
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+	T* allocate(size_t n)
+	{
+#ifdef _MSC_VER
+		void* p = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+		void* p = nullptr;
+		if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0) p = nullptr;
+#endif
+		if (!p) throw std::bad_alloc();
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, size_t)
+	{
+#ifdef _MSC_VER
+		_aligned_free(p);
+#else
+		free(p);
+#endif
+	}
+};
+
+template<typename T, typename U, size_t A>
+bool operator==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return true; }
+
+template<typename T, typename U, size_t A>
+bool operator!=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return false; }
+
+#endif // ALIGNED_ALLOC_UTIL_H
@@ -8,196 +8,133 @@
 
 ==============================================================================*/
 
-#include "assimp/scene.h"
-#include "assimp//Importer.hpp"
-#include "assimp/postprocess.h"
-
+// Import : animation_import.cpp (assimp), skinning constant buffers : animation_skinning_cb.cpp (D3D)
+// Nothing here needs either, the headless tools link this file as it is
 #include "animation.h"
 //#include "model.h"
 #include "model_asset.h"
-#include "skeleton_util.h"
 #include "axis_util.h"
-#include "direct3d.h"
+#include "animation_root_motion.h"
+#include "debug_ostream.h"
 
 #include <cassert>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <DirectXMath.h>
 
 using namespace DirectX;
 
-static const int MAX_BONES = 256;
-
-ID3D11Device* g_pDevice = nullptr;
-ID3D11DeviceContext* g_pContext = nullptr;
-
-ID3D11Buffer* g_pSkinningCB = nullptr; // skin weightpobt@|Cg
-
-struct BoneRef
-{
-	const aiBone* bone = nullptr; // aiMesh::mBones[b]
-	const aiNode* node = nullptr; // SkeletonUtil::FindNodeByNameŌm[h
-};
-
-struct SkinningCBData
-{
-	XMFLOAT4X4 boneMatrices[MAX_BONES];
-};
-
-// ---- Assimp^ -> DirectXMath^ϊ ----
-static XMFLOAT3 ToXMFLOAT3(const aiVector3D& v);
-static XMFLOAT4 ToXMFLOAT4(const aiQuaternion& q);
-
-static XMMATRIX AiMatToXM(const aiMatrix4x4& m);
 // ---- `Ԗ@wp[ ----
 static void LerpFloat3(const XMFLOAT3& a, const XMFLOAT3& b, float t, XMFLOAT3& out);
 static void SlerpQuat(const XMFLOAT4& qa, const XMFLOAT4& qb, float t, XMFLOAT4& out);
-
-static BoneAnimTrack CreateBoneAnimationFromChannel(
-	const aiNodeAnim* channel,
-	const ModelAsset* asset,
-	const aiScene* scene,
-	double& outMaxTime
-);
 static XMMATRIX GetAxisFixMatrix(bool yUp); // Z-up to Y-up
-static const BoneAnimTrack* FindTrackForNode(const AnimationClip* clip, const aiNode* node);
+static const BoneAnimTrack* FindTrackForNode(const AnimationClip* clip, const char* nodeNameFull, const aiNode* node);
 static void SampleTrack(
 	const BoneAnimTrack& track,
 	double timeTicks,
+	TrackCursor& cursor,
 	XMFLOAT3& outT,
 	XMFLOAT4& outR,
 	XMFLOAT3& outS
 );
-static const char* GetShortName(const char* fullName);
+static void PushEventRange(AnimationEventQueue& queue, const AnimationClip* clip, const AnimationEventTrack& track, double fromTicks, double toTicks, bool includeEnd);
 
 
-// ---- ǂݍ ----
-AnimationClip* Animation_LoadFromFile(const char* filename, const ModelAsset* asset, bool animYup)
+void Animation_DestroyClip(AnimationClip* clip)
 {
-	assert(filename);
-	assert(asset);
-	assert(asset->aiScene);
-
-	//Assimp::Importer importer;
-
-	const aiScene* scene = aiImportFile(
-		filename,
-		aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_ConvertToLeftHanded
-	);
-	if (!scene || !scene->HasAnimations()) return nullptr;
-
-	const aiAnimation* anim = scene->mAnimations[0];
-	if (!anim) return nullptr;
-
-	AnimationClip* clip = new AnimationClip();
-	clip->SourceYup = animYup; // IMPORTANT: import up axis
-
-	if (anim->mName.length > 0)
-		clip->animName = anim->mName.C_Str();
-	else
-		clip->animName = filename;
-
-	clip->ticksPerSecond = (anim->mTicksPerSecond != 0.0) ? anim->mTicksPerSecond : 30.0;
-
-	double durationFromAnim = anim->mDuration;
-	double durationFromKey = 0.0;
+	delete clip;
+}
 
-	clip->tracks.reserve(anim->mNumChannels);
+void Animation_AddEvent(AnimationClip* clip, const char* trackName, double timeSec, const char* eventName, float value)
+{
+	if (!clip || !trackName) return;
 
-	for (unsigned int i = 0; i < anim->mNumChannels; ++i)
+	AnimationEventTrack* track = nullptr;
+	for (AnimationEventTrack& t : clip->eventTracks)
 	{
-		const aiNodeAnim* channel = anim->mChannels[i];
-		if (!channel) continue;
-
-		BoneAnimTrack track = CreateBoneAnimationFromChannel(channel, asset, asset->aiScene, durationFromKey);
-
-		clip->tracks.push_back(std::move(track));
+		if (t.name == trackName)
+		{
+			track = &t;
+			break;
+		}
+	}
+	if (!track)
+	{
+		clip->eventTracks.emplace_back();
+		track = &clip->eventTracks.back();
+		track->name = trackName;
 	}
 
-	clip->duration = std::max(durationFromAnim, durationFromKey);
-	clip->loop = true;
-
-	return clip;
-}
+	AnimationEvent ev;
+	ev.timeTicks = timeSec * clip->ticksPerSecond;
+	ev.name = eventName ? eventName : "";
+	ev.value = value;
 
-void Animation_DestroyClip(AnimationClip* clip)
-{
-	delete clip;
+	// After the events with the same time, so equal times keep the order they were added in
+	auto it = std::upper_bound(track->events.begin(), track->events.end(), ev.timeTicks,
+		[](double t, const AnimationEvent& e) { return t < e.timeTicks; });
+	track->events.insert(it, ev);
 }
 
-bool Animation_InitializeSkinningCB(ID3D11Device* pDevice, ID3D11DeviceContext* pContext)
+void AnimationEventQueue::Push(const AnimationEventRecord& record)
 {
-	if (!pDevice || !pContext) return false;
-	g_pDevice = pDevice;
-	g_pContext = pContext;
-
-	D3D11_BUFFER_DESC buffer_desc{};
-	buffer_desc.ByteWidth = sizeof(SkinningCBData);
-	buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-	buffer_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	buffer_desc.CPUAccessFlags = 0;
-	buffer_desc.MiscFlags = 0;
-
-	SkinningCBData initData{};
-	for (int i = 0; i < MAX_BONES; i++)
+	if (m_Count == CAPACITY)
 	{
-		XMStoreFloat4x4(&initData.boneMatrices[i], XMMatrixIdentity());
+		m_Head = (m_Head + 1) % CAPACITY;
+		--m_Count;
+		++m_Dropped;
 	}
 
-	D3D11_SUBRESOURCE_DATA sd{};
-	sd.pSysMem = &initData;
+	m_Records[(m_Head + m_Count) % CAPACITY] = record;
+	++m_Count;
+}
 
-	HRESULT hr = g_pDevice->CreateBuffer(&buffer_desc, &sd, &g_pSkinningCB);
-	if (FAILED(hr))
-	{
-		g_pSkinningCB = nullptr;
-		return false;
-	}
+bool AnimationEventQueue::Pop(AnimationEventRecord& outRecord)
+{
+	if (m_Count == 0) return false;
 
+	outRecord = m_Records[m_Head];
+	m_Head = (m_Head + 1) % CAPACITY;
+	--m_Count;
 	return true;
 }
 
-void Animation_ReleaseSkinningCB()
+void AnimationEventQueue::Clear()
 {
-	SAFE_RELEASE(g_pSkinningCB);
+	m_Head = 0;
+	m_Count = 0;
+	m_Dropped = 0;
 }
 
-void Animation_UpdateSkinningCB(const AnimationPlayer& player)
+void Animation_ResolveBinding(const AnimationClip* clip, const ModelAsset* asset, AnimationBinding& outBinding)
 {
-	if (!g_pSkinningCB) return;
-	
-	std::vector<XMFLOAT4X4> skinMatrices;
-	player.ComputeSkinMatrices(skinMatrices);
+	outBinding.clip = clip;
+	outBinding.asset = asset;
+	outBinding.nodeToTrack.clear();
+	outBinding.retarget = nullptr;
+	outBinding.keyTable = PoseKeyTable();
 
-	SkinningCBData cbData{};
-	for (int i = 0; i < MAX_BONES; ++i)
-	{
-		XMStoreFloat4x4(&cbData.boneMatrices[i], XMMatrixIdentity());
-	}
-	
-	int count = static_cast<int>(skinMatrices.size());
-	if (count > MAX_BONES) count = MAX_BONES;
+	if (!clip || !asset) return;
 
-	for (int i = 0; i < count; ++i)
-	{
-		cbData.boneMatrices[i] = skinMatrices[i];
-	}
+	const SkeletonRuntime& skel = asset->skeleton;
+	outBinding.nodeToTrack.assign(skel.NodeCount(), -1);
 
-	g_pContext->UpdateSubresource(g_pSkinningCB, 0, nullptr, &cbData, 0, 0);
-	g_pContext->VSSetConstantBuffers(3, 1, &g_pSkinningCB);
-}
+	for (int i = 0; i < skel.NodeCount(); ++i)
+	{
+		const BoneAnimTrack* track = FindTrackForNode(clip, skel.names[i].c_str(), skel.nodes[i]);
+		if (!track) continue;
 
-// no-op: shader variant decides skinning path
-/*
-void Animation_DisableSkinning()
-{
-	if (!g_pSkinningCB || !g_pContext) return;
+		const int trackIndex = static_cast<int>(track - clip->tracks.data());
 
-	SkinningCBData cbData{};
+		// Empty track -> bind pose, same as before
+		const bool empty = clip->IsCompressed() ? clip->compressedTracks[trackIndex].Empty() : track->Empty();
+		if (empty) continue;
 
-	g_pContext->UpdateSubresource(g_pSkinningCB, 0, nullptr, &cbData, 0, 0);
-	g_pContext->VSSetConstantBuffers(3, 1, &g_pSkinningCB);
+		outBinding.nodeToTrack[i] = trackIndex;
+	}
 }
-*/
 
 
 // ------------------------------------------
@@ -210,16 +147,54 @@ AnimationManager& AnimationManager::Instance()
 	return s_instance;
 }
 
-int AnimationManager::RegisterClip(AnimationClip* clip)
+AnimationManager::~AnimationManager()
+{
+	DestroyAll();
+}
+
+int AnimationManager::RegisterClip(AnimationClip* clip, const ModelAsset* asset)
 {
 	if (!clip) return -1;
 
 	m_Clips.push_back(clip);
+
+	// Resolve track binding up front when the target skeleton is known
+	if (asset)
+	{
+		GetBinding(clip, asset);
+	}
+
 	return static_cast<int>(m_Clips.size() - 1);
 }
 
 void AnimationManager::DestroyAll()
 {
+	// Running loads finish first, queued ones never start
+	m_Loader.Stop();
+
+	for (ClipLoadRequest* r : m_LoadRequests)
+	{
+		if (r->state != ClipLoadState::Ready) delete r->clip; // finished but never registered
+		delete r;
+	}
+
+	m_LoadRequests.clear();
+	m_PendingLoads = 0;
+
+	for (AnimationBinding* b : m_Bindings)
+	{
+		delete b;
+	}
+
+	m_Bindings.clear();
+
+	for (RetargetMap* m : m_RetargetMaps)
+	{
+		delete m;
+	}
+
+	m_RetargetMaps.clear();
+
 	for (AnimationClip* c : m_Clips)
 	{
 		delete c;
@@ -244,6 +219,128 @@ AnimationClip* AnimationManager::FindClipByName(const std::string& name) const
 	return nullptr;
 }
 
+AnimationClip* AnimationManager::FindClipBySource(const std::string& sourcePath) const
+{
+	for (AnimationClip* c : m_Clips)
+	{
+		if (c && c->sourcePath == sourcePath) return c;
+	}
+
+	return nullptr;
+}
+
+const AnimationBinding* AnimationManager::GetBinding(const AnimationClip* clip, const ModelAsset* asset)
+{
+	if (!clip || !asset) return nullptr;
+
+	std::lock_guard<std::mutex> lock(m_BindingMutex);
+
+	for (const AnimationBinding* b : m_Bindings)
+	{
+		if (b->clip == clip && b->asset == asset) return b;
+	}
+
+	AnimationBinding* binding = new AnimationBinding();
+	Animation_ResolveBinding(clip, asset, *binding);
+
+	// Clip authored on another rig: per bone correction, shared by every clip of that rig
+	if (!clip->skeleton.Empty())
+	{
+		const RetargetMap* map = GetRetargetMap(clip->skeleton, asset);
+		if (map && !map->IsIdentity()) binding->retarget = map;
+	}
+
+	// Keys gathered into SoA once here instead of on every sample (retarget baked in, compressed keys decoded)
+	AnimationSampler_BuildKeyTable(clip, *binding, asset->skeleton, binding->keyTable);
+
+	m_Bindings.push_back(binding);
+	return binding;
+}
+
+const RetargetMap* AnimationManager::GetRetargetMap(const ClipSkeleton& source, const ModelAsset* asset)
+{
+	if (!asset) return nullptr;
+
+	for (const RetargetMap* m : m_RetargetMaps)
+	{
+		if (m->sourceHash == source.hash && m->target == asset) return m;
+	}
+
+	RetargetMap* map = new RetargetMap();
+	AnimationRetarget_BuildMap(source, asset, *map);
+
+	if (!map->IsIdentity())
+	{
+		char buf[256];
+		snprintf(buf, sizeof(buf), "[Retarget] %d / %d nodes corrected\n", map->correctedCount, asset->skeleton.NodeCount());
+		hal::debug_print(buf);
+	}
+
+	m_RetargetMaps.push_back(map);
+	return map;
+}
+
+void AnimationManager::ReleaseBindings(const ModelAsset* asset)
+{
+	std::lock_guard<std::mutex> lock(m_BindingMutex);
+
+	auto it = std::remove_if(m_Bindings.begin(), m_Bindings.end(),
+		[asset](AnimationBinding* b)
+		{
+			if (b->asset != asset) return false;
+			delete b;
+			return true;
+		});
+
+	m_Bindings.erase(it, m_Bindings.end());
+
+	auto mapIt = std::remove_if(m_RetargetMaps.begin(), m_RetargetMaps.end(),
+		[asset](RetargetMap* m)
+		{
+			if (m->target != asset) return false;
+			delete m;
+			return true;
+		});
+
+	m_RetargetMaps.erase(mapIt, m_RetargetMaps.end());
+}
+
+void AnimationManager::ReleaseBindings(const AnimationClip* clip)
+{
+	std::lock_guard<std::mutex> lock(m_BindingMutex);
+
+	auto it = std::remove_if(m_Bindings.begin(), m_Bindings.end(),
+		[clip](AnimationBinding* b)
+		{
+			if (b->clip != clip) return false;
+			delete b;
+			return true;
+		});
+
+	m_Bindings.erase(it, m_Bindings.end());
+}
+
+ClipLoadState AnimationManager::GetLoadState(AnimationClipHandle handle) const
+{
+	if (handle.id < 0 || handle.id >= static_cast<int>(m_LoadRequests.size())) return ClipLoadState::Invalid;
+
+	return m_LoadRequests[handle.id]->state;
+}
+
+bool AnimationManager::GetRequestedYup(AnimationClipHandle handle) const
+{
+	if (GetLoadState(handle) == ClipLoadState::Invalid) return true;
+
+	return m_LoadRequests[handle.id]->animYup;
+}
+
+AnimationClip* AnimationManager::ResolveClip(AnimationClipHandle handle) const
+{
+	if (GetLoadState(handle) != ClipLoadState::Ready) return nullptr;
+
+	return m_LoadRequests[handle.id]->clip;
+}
+
 // ------------------------------------------
 // Animation Player
 // ------------------------------------------
@@ -255,21 +352,30 @@ AnimationPlayer::AnimationPlayer()
 	m_CurrentTimeTicks = 0.0;
 	m_Asset = nullptr;
 	m_Clip = nullptr;
+	m_Binding = nullptr;
 }
 
 void AnimationPlayer::Play(const AnimationClip* clip, const ModelAsset* asset, bool loop, double startTimeSec)
 {
+	m_PendingClip = AnimationClipHandle();
+
 	m_Clip = clip;
 	m_Asset = asset;
 	m_Loop = loop;
+	m_RootMotion = RootMotionDelta();
 
 	if (!m_Clip || !m_Asset)
 	{
+		m_Binding = nullptr;
 		m_Playing = false;
 		m_CurrentTimeTicks = 0.0;
 		return;
 	}
 
+	// String matching happens only here, never per frame
+	m_Binding = AnimationManager::Instance().GetBinding(m_Clip, m_Asset);
+	m_Cursors.assign(m_Clip->tracks.size(), TrackCursor());
+
 	m_Playing = true;
 
 	double startTicks = startTimeSec * m_Clip->ticksPerSecond;
@@ -285,16 +391,53 @@ void AnimationPlayer::Play(const AnimationClip* clip, const ModelAsset* asset, b
 	m_CurrentTimeTicks = startTicks;
 }
 
+void AnimationPlayer::Play(AnimationClipHandle handle, const ModelAsset* asset, bool loop, double startTimeSec)
+{
+	const AnimationManager& manager = AnimationManager::Instance();
+
+	// Already there (or never coming): same as a plain Play
+	if (manager.GetLoadState(handle) != ClipLoadState::Pending)
+	{
+		Play(manager.ResolveClip(handle), asset, loop, startTimeSec);
+		return;
+	}
+
+	Play(nullptr, asset, loop);
+
+	m_PendingClip = handle;
+	m_PendingStartSec = startTimeSec;
+	m_PendingAnimYup = manager.GetRequestedYup(handle);
+}
+
 void AnimationPlayer::Stop()
 {
+	m_PendingClip = AnimationClipHandle();
 	m_Playing = false;
 	m_CurrentTimeTicks = 0.0;
+	m_RootMotion = RootMotionDelta();
 }
 
 void AnimationPlayer::Update(double elapsed_time)
 {
+	m_RootMotion = RootMotionDelta();
+
+	// Registered clips only change in PollLoads (main thread), never during the parallel update
+	if (m_PendingClip.IsValid())
+	{
+		const AnimationManager& manager = AnimationManager::Instance();
+		if (manager.GetLoadState(m_PendingClip) == ClipLoadState::Pending) return;
+
+		// Starts at startTimeSec from this frame on; a failed load leaves the player stopped
+		Play(manager.ResolveClip(m_PendingClip), m_Asset, m_Loop, m_PendingStartSec);
+		return;
+	}
+
 	if (!m_Playing || !m_Clip) return;
 
+	const double prevTicks = m_CurrentTimeTicks;
+	bool wrapped = false;
+	bool reachedEnd = false;
+
 	double deltaTicks = elapsed_time * m_Clip->ticksPerSecond;
 	m_CurrentTimeTicks += deltaTicks;
 
@@ -303,6 +446,8 @@ void AnimationPlayer::Update(double elapsed_time)
 		// Keep in safe range
 		if (m_Loop)
 		{
+			wrapped = (m_CurrentTimeTicks >= m_Clip->duration);
+
 			m_CurrentTimeTicks = fmod(m_CurrentTimeTicks, m_Clip->duration);
 			if (m_CurrentTimeTicks < 0.0)
 			{
@@ -315,9 +460,48 @@ void AnimationPlayer::Update(double elapsed_time)
 			{
 				m_CurrentTimeTicks = m_Clip->duration;
 				m_Playing = false;
+				reachedEnd = true;
 			}
 		}
 	}
+
+	if (m_EventQueue && !m_Clip->eventTracks.empty() && deltaTicks > 0.0)
+	{
+		EmitEvents(prevTicks, m_CurrentTimeTicks, wrapped, reachedEnd, deltaTicks);
+	}
+
+	// One curve sample per end point, the extraction was done at load
+	if (!m_Clip->rootMotion.Empty() && deltaTicks > 0.0)
+	{
+		AnimationRootMotion_ComputeDelta(m_Clip->rootMotion, prevTicks, m_CurrentTimeTicks, wrapped, m_Clip->duration, m_RootMotion);
+	}
+}
+
+// Range [from, to): an event exactly on the new time fires next frame, never twice
+// Loop wrap: [from, duration) + [0, to). One-shot end: [from, duration], the last event is not lost
+void AnimationPlayer::EmitEvents(double fromTicks, double toTicks, bool wrapped, bool reachedEnd, double deltaTicks) const
+{
+	const double duration = m_Clip->duration;
+
+	for (const AnimationEventTrack& track : m_Clip->eventTracks)
+	{
+		if (track.events.empty()) continue;
+
+		if (wrapped && deltaTicks >= duration)
+		{
+			// More than one whole loop in one frame (hitch): every event once
+			PushEventRange(*m_EventQueue, m_Clip, track, 0.0, duration, false);
+		}
+		else if (wrapped)
+		{
+			PushEventRange(*m_EventQueue, m_Clip, track, fromTicks, duration, false);
+			PushEventRange(*m_EventQueue, m_Clip, track, 0.0, toTicks, false);
+		}
+		else
+		{
+			PushEventRange(*m_EventQueue, m_Clip, track, fromTicks, toTicks, reachedEnd);
+		}
+	}
 }
 
 const ModelAsset* AnimationPlayer::GetAsset()
@@ -334,28 +518,44 @@ double AnimationPlayer::GetCurrentTimeSec() const
 	return m_CurrentTimeTicks / m_Clip->ticksPerSecond;
 }
 
-void AnimationPlayer::GetCurrentPose(std::unordered_map<const aiNode*, DirectX::XMMATRIX>& outPose) const
+PoseView AnimationPlayer::GetCurrentPose() const
 {
-	outPose = m_CurrentPose;
+	PoseView view;
+	view.data = m_ModelPose.data();
+	view.count = static_cast<int>(m_ModelPose.size());
+	return view;
 }
 
 // Get local transform matrix
-XMMATRIX AnimationPlayer::SampleLocalTransform(const aiNode* node, double tickTimes) const
+XMMATRIX AnimationPlayer::SampleLocalTransform(int nodeIndex, double tickTimes) const
 {
-	const BoneAnimTrack* track = FindTrackForNode(m_Clip, node);
+	const int trackIndex = m_Binding ? m_Binding->nodeToTrack[nodeIndex] : -1;
 
 	XMFLOAT3 T(0, 0, 0);
 	XMFLOAT4 R(0, 0, 0, 1);
 	XMFLOAT3 S(1, 1, 1);
 
 	// If has track -> use track animation
-	if (track && !track->keyframes.empty())
+	if (trackIndex >= 0)
 	{
-		SampleTrack(*track, tickTimes, T, R, S);
+		if (m_Clip->IsCompressed())
+		{
+			AnimationCompression_SampleTrack(m_Clip->compressedTracks[trackIndex], tickTimes, m_Cursors[trackIndex], T, R, S);
+		}
+		else
+		{
+			SampleTrack(m_Clip->tracks[trackIndex], tickTimes, m_Cursors[trackIndex], T, R, S);
+		}
+
+		if (m_Binding->retarget)
+		{
+			AnimationRetarget_ApplyTRS(m_Binding->retarget->bones[nodeIndex], T, R, S);
+		}
 
 		// debug
 		/*
 		static double s_lastPrintTime = -1.0;
+		const aiNode* node = m_Asset->skeleton.nodes[nodeIndex];
 		if (node && strcmp(node->mName.C_Str(), "clavicle_l") == 0)
 		{
 			if (fabs(tickTimes - s_lastPrintTime) > 1.0)
@@ -373,10 +573,7 @@ XMMATRIX AnimationPlayer::SampleLocalTransform(const aiNode* node, double tickTi
 	}
 	else // If has no track -> use bind pose
 	{
-		const aiMatrix4x4& m = node->mTransformation;
-		XMMATRIX xm = AiMatToXM(m);
-
-		return xm;
+		return XMLoadFloat4x4(&m_Asset->skeleton.bindLocal[nodeIndex]);
 	}
 
 	XMVECTOR vT = XMLoadFloat3(&T);
@@ -391,164 +588,135 @@ XMMATRIX AnimationPlayer::SampleLocalTransform(const aiNode* node, double tickTi
 	return mtx;
 }
 
-// Matrix in model space for each bone
-void AnimationPlayer::BuildModelSpacePoseResursive(
-	const aiNode* node,
-	const XMMATRIX& parentMtx,
-	double timeTicks,
-	std::unordered_map<const aiNode*, XMMATRIX>& outNodeModelMtx
-) const
+// All skin matrix data in model space
+// Convert from bind pose to the playing pose
+void AnimationPlayer::ComputeSkinMatrices(std::vector<XMFLOAT4X4>& outBoneMatrix) const
 {
-	if (!node) return;
+	outBoneMatrix.clear();
+
+	if (!m_Asset) return;
+	if (m_Asset->skeleton.NodeCount() == 0) return;
+
+	// Clip still loading: bind pose (no binding -> every node takes its bind TRS)
+	if (!m_Clip && m_PendingClip.IsValid())
+	{
+		AnimationSampler_SampleLocalPose(nullptr, nullptr, m_Asset->skeleton, 0.0, nullptr, m_SampleScratch, m_LocalPose);
+		Animation_BuildSkinMatrices(m_Asset, m_PendingAnimYup, m_LocalPose, m_ModelPose, outBoneMatrix);
+		return;
+	}
 
-	XMMATRIX local = SampleLocalTransform(node, timeTicks); // local matrix
+	if (!m_Clip || !m_Binding) return;
 
-	XMMATRIX modelSpace = local * parentMtx; // DO NOT DO ANY MORE AXIS FIXING
+	// Local matrices of all nodes in one batch
+	AnimationSampler_SampleLocalPose(m_Clip, m_Binding, m_Asset->skeleton, m_CurrentTimeTicks, m_Cursors.data(), m_SampleScratch, m_LocalPose);
 
-	outNodeModelMtx[node] = modelSpace;
+	// Kept in m_ModelPose for GetCurrentPose (no copy, no per-frame allocation)
+	Animation_BuildSkinMatrices(m_Asset, m_Clip->SourceYup, m_LocalPose, m_ModelPose, outBoneMatrix);
+}
+
+void AnimationPlayer::SamplePose(LocalPoseSoA& outPose, int maxDepth) const
+{
+	if (!m_Asset) return;
 
-	for (unsigned int i = 0; i < node->mNumChildren; ++i)
+	if (!m_Clip && m_PendingClip.IsValid())
 	{
-		BuildModelSpacePoseResursive(node->mChildren[i], modelSpace, timeTicks, outNodeModelMtx);
+		AnimationSampler_SamplePose(nullptr, nullptr, m_Asset->skeleton, 0.0, nullptr, m_SampleScratch, outPose, maxDepth);
+		return;
 	}
+
+	if (!m_Clip || !m_Binding) return;
+
+	AnimationSampler_SamplePose(m_Clip, m_Binding, m_Asset->skeleton, m_CurrentTimeTicks, m_Cursors.data(), m_SampleScratch, outPose, maxDepth);
 }
 
-// All skin matrix data in model space
-// Convert from bind pose to the playing pose
+// Local pose -> model space -> skin matrices
+// Nodes are parent-ordered, so one forward pass is enough
 // MIND THE SCALING!!!
-void AnimationPlayer::ComputeSkinMatrices(std::vector<XMFLOAT4X4>& outBoneMatrix) const
+void Animation_BuildSkinMatrices(
+	const ModelAsset* asset,
+	bool animYup,
+	const PoseMatrixBuffer& localPose,
+	PoseMatrixBuffer& outModelPose,
+	std::vector<XMFLOAT4X4>& outBoneMatrix
+)
 {
 	outBoneMatrix.clear();
 
-	if (!m_Asset || !m_Clip || !m_Asset->aiScene) return;
+	const SkeletonRuntime& skel = asset->skeleton;
+	const int nodeCount = skel.NodeCount();
+	if (nodeCount == 0 || static_cast<int>(localPose.size()) != nodeCount) return;
 
-	const aiScene* scene = m_Asset->aiScene;
-
-	// 1. Build aiNode and its model matrix
-	std::unordered_map<const aiNode*, XMMATRIX> nodeModelMtx;
+	// 1. Build model matrix of every node
 	XMMATRIX rootParent = XMMatrixIdentity(); // parent node for root node
 
 	// Z-up tp Y-up
-	if (m_Asset && m_Clip)
-	{
-		UpAxis modelUp = UpFromBool(m_Asset->sourceYup);
-		UpAxis animUp = UpFromBool(m_Clip->SourceYup);
+	UpAxis modelUp = UpFromBool(asset->sourceYup);
+	UpAxis animUp = UpFromBool(animYup);
 
-		if (animUp != modelUp)
-		{
-			XMMATRIX axisFix = GetAxisConversion(animUp, modelUp);
-			rootParent = axisFix;
-		}
+	if (animUp != modelUp)
+	{
+		rootParent = GetAxisConversion(animUp, modelUp);
 	}
 
-	BuildModelSpacePoseResursive(scene->mRootNode, rootParent, m_CurrentTimeTicks, nodeModelMtx);
-
-	m_CurrentPose = nodeModelMtx; // save the pose
-
-	// 2. Collect all bones and make a table for name and index
-	const auto& boneMap = m_Asset->boneNameToIndex;
-	if (boneMap.empty()) 
-		return;
-
-	// 3. Bone name -> aiBone* e[u̍\z
-	std::unordered_map<std::string, const aiBone*> nameToBone;
+	outModelPose.resize(nodeCount);
 
-	for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+	for (int i = 0; i < nodeCount; ++i)
 	{
-		const aiMesh* mesh = scene->mMeshes[m];
-		if (!mesh || mesh->mNumBones == 0) continue;
+		const XMMATRIX& local = localPose[i]; // local matrix
 
-		for (unsigned int b = 0; b < mesh->mNumBones; ++b)
-		{
-			const aiBone* bone = mesh->mBones[b];
-			if (!bone) continue;
+		const int parent = skel.parentIndex[i];
+		const XMMATRIX& parentMtx = (parent >= 0) ? outModelPose[parent] : rootParent;
 
-			std::string boneName = bone->mName.C_Str();
-
-			if (nameToBone.find(boneName) == nameToBone.end())
-			{
-				nameToBone[boneName] = bone;
-			}
-		}
+		outModelPose[i] = local * parentMtx; // DO NOT DO ANY MORE AXIS FIXING
 	}
 
-	if (nameToBone.empty())
-		return;
-
-	outBoneMatrix.resize(boneMap.size());
-
-	// debug flag: only log once
-	static bool s_debugPrinted = false;
+	const PoseMatrixBuffer& nodeModelMtx = outModelPose;
 
-	// 4. Skin matrix computation for each bone
+	// 2. Skin matrix computation for each bone
 	// M_skin = M_offset * M_modelSpace
-	for (const auto& kv : boneMap)
-	{
-		const std::string& boneName = kv.first;
-		int index = kv.second;
-		
-		const aiNode* node = SkeletonUtil::FindNodeByName(scene, boneName);
-		if (!node) continue;
-
-		auto itM = nodeModelMtx.find(node);
-		if (itM == nodeModelMtx.end()) continue;
-
-		// debug: check if there is a track for this node
-		/*
-		if (!s_debugPrinted)
-		{
-			const BoneAnimTrack* tr = FindTrackForNode(m_Clip, node);
-
-			if (tr)
-				OutputDebugStringA((" [Anim] bone '" + boneName + "' use TRACK.\n").c_str());
-			else
-				OutputDebugStringA((" [Anim] bone '" + boneName + "' use BIND POSE.\n").c_str());
-		}
-		*/
+	const int boneCount = skel.BoneCount();
+	if (boneCount == 0)
+		return;
 
-		XMMATRIX G_current = itM->second; // model-space(animated)
+	outBoneMatrix.resize(boneCount);
 
-		auto itB = nameToBone.find(boneName);
-		if (itB == nameToBone.end() || !itB->second)
-			continue;
+	for (int b = 0; b < boneCount; ++b)
+	{
+		const int nodeIndex = skel.boneToNode[b];
+		if (nodeIndex < 0) continue;
 
-		const aiBone* bone = itB->second;
+		XMMATRIX G_current = nodeModelMtx[nodeIndex]; // model-space(animated)
 
 		// DO NOT TOUCH!!!
 		// Skin Matrix : local(vertex) -> bone space -> animated model space
-		XMMATRIX offset = AiMatToXM(bone->mOffsetMatrix);
+		XMMATRIX offset = XMLoadFloat4x4(&skel.boneOffset[b]);
 		XMMATRIX skinMtx = offset * G_current;
 
 		// HLSL̂ւ̓]u
 		XMMATRIX skinMtxT = XMMatrixTranspose(skinMtx);
 
-		if (index >= 0 && index < static_cast<int>(outBoneMatrix.size()))
-		{
-			XMStoreFloat4x4(&outBoneMatrix[index], skinMtxT);
-		}
+		XMStoreFloat4x4(&outBoneMatrix[b], skinMtxT);
 	}
 }
 
-
-static XMFLOAT3 ToXMFLOAT3(const aiVector3D& v)
+void AnimationPlayer::SampleLocalPose(PoseMatrixBuffer& outLocal, bool batched) const
 {
-	return XMFLOAT3(v.x, v.y, v.z);
-}
+	outLocal.clear();
 
-static XMFLOAT4 ToXMFLOAT4(const aiQuaternion& q)
-{
-	return XMFLOAT4(q.x, q.y, q.z, q.w);
-}
+	if (!m_Asset || !m_Clip || !m_Binding) return;
 
-static XMMATRIX AiMatToXM(const aiMatrix4x4& m)
-{
-	return XMMATRIX(
-		m.a1, m.b1, m.c1, m.d1,
-		m.a2, m.b2, m.c2, m.d2,
-		m.a3, m.b3, m.c3, m.d3,
-		m.a4, m.b4, m.c4, m.d4
-	);
-};
+	if (batched)
+	{
+		AnimationSampler_SampleLocalPose(m_Clip, m_Binding, m_Asset->skeleton, m_CurrentTimeTicks, m_Cursors.data(), m_SampleScratch, outLocal);
+		return;
+	}
+
+	outLocal.resize(m_Asset->skeleton.NodeCount());
+	for (int i = 0; i < m_Asset->skeleton.NodeCount(); ++i)
+	{
+		outLocal[i] = SampleLocalTransform(i, m_CurrentTimeTicks);
+	}
+}
 
 //template<typename T>
 static void LerpFloat3(const XMFLOAT3& a, const XMFLOAT3& b, float t, XMFLOAT3& out)
@@ -580,70 +748,12 @@ static XMMATRIX GetAxisFixMatrix(bool yUp)
 	}
 }
 
-static BoneAnimTrack CreateBoneAnimationFromChannel(
-	const aiNodeAnim* channel,
-	const ModelAsset* asset,
-	const aiScene* scene,
-	double& outMaxTime
-)
+// node : nullptr when the skeleton was read without a scene (no pointer match then)
+static const BoneAnimTrack* FindTrackForNode(const AnimationClip* clip, const char* nodeNameFull, const aiNode* node)
 {
-	BoneAnimTrack track;
-
-	// Find aiNode by name
-	std::string nodeName = channel->mNodeName.C_Str();
-	track.nodeName = nodeName;
-	track.node = SkeletonUtil::FindNodeByName(scene, nodeName);
-
-	// debug
-	if (nodeName == "clavicle_l")
-	{
-		char buf[256];
-		sprintf_s(buf, "[Channel] %s: pos = %u rot = %u \n",
-			nodeName.c_str(),
-			channel->mNumPositionKeys,
-			channel->mNumRotationKeys);
-		OutputDebugStringA(buf);
-	}
-
-	unsigned int numPos = channel->mNumPositionKeys;
-	unsigned int numRot = channel->mNumRotationKeys;
-	unsigned int numScl = channel->mNumScalingKeys;
-
-	unsigned int numKeys = std::max({ numPos, numRot, numScl });
-	track.keyframes.reserve(numKeys);
-
-	for (unsigned int i = 0; i < numKeys; ++i)
-	{
-		Keyframe kf{};
+	if (!clip || !nodeNameFull) return nullptr;
 
-		const aiVectorKey& posKey = channel->mPositionKeys[(numPos > 0) ? std::min(i, numPos - 1) : 0];
-		const aiQuatKey&   rotKey = channel->mRotationKeys[(numRot > 0) ? std::min(i, numRot - 1) : 0];
-		const aiVectorKey& sclKey = channel->mScalingKeys [(numScl > 0) ? std::min(i, numScl - 1) : 0];
-
-		double timePos = (numPos > 0) ? posKey.mTime : 0.0;
-		double timeRot = (numRot > 0) ? rotKey.mTime : 0.0;
-		double timeScl = (numScl > 0) ? sclKey.mTime : 0.0;
-
-		//kf.time = posKey.mTime;
-		kf.time = std::max({ timePos, timeRot, timeScl });
-		kf.translation = ToXMFLOAT3(posKey.mValue);
-		kf.rotation = ToXMFLOAT4(rotKey.mValue);
-		kf.scale = ToXMFLOAT3(sclKey.mValue);
-
-		outMaxTime = std::max(outMaxTime, kf.time);
-		
-		track.keyframes.push_back(kf);
-	}
-
-	return track;
-}
-
-static const BoneAnimTrack* FindTrackForNode(const AnimationClip* clip, const aiNode* node)
-{
-	if (!clip || !node) return nullptr;
-
-	const char* nodeNameFull = node->mName.C_Str();
-	const char* nodeNameShort = GetShortName(nodeNameFull);
+	const char* nodeNameShort = SkeletonUtil::GetShortName(nodeNameFull);
 
 	const BoneAnimTrack* candidateShort = nullptr;
 	const BoneAnimTrack* candidatePtr = nullptr;
@@ -655,7 +765,7 @@ static const BoneAnimTrack* FindTrackForNode(const AnimationClip* clip, const ai
 			continue;
 
 		const char* trackNameFull = t.nodeName.c_str();
-		const char* trackNameShort = GetShortName(trackNameFull);
+		const char* trackNameShort = SkeletonUtil::GetShortName(trackNameFull);
 
 		// strict full-name match
 		if (strcmp(trackNameFull, nodeNameFull) == 0)
@@ -673,7 +783,7 @@ static const BoneAnimTrack* FindTrackForNode(const AnimationClip* clip, const ai
 		}
 
 		// remember pointer match
-		if (t.node && t.node == node)
+		if (node && t.node == node)
 		{
 			candidatePtr = &t;
 		}
@@ -687,81 +797,178 @@ static const BoneAnimTrack* FindTrackForNode(const AnimationClip* clip, const ai
 	return nullptr;
 }
 
+template<typename Key>
+static uint32_t FindKeyIndex(const std::vector<Key>& keys, double timeTicks, uint32_t& cursor)
+{
+	return Animation_FindKeyIndex(static_cast<uint32_t>(keys.size()),
+		[&keys](uint32_t i) { return keys[i].time; }, timeTicks, cursor);
+}
+
+static float KeyLerpFactor(double timeA, double timeB, double timeTicks)
+{
+	const double span = timeB - timeA;
+	if (span <= 0.0) return 0.0f;
+
+	return static_cast<float>((timeTicks - timeA) / span);
+}
+
+static void SampleVectorKeys(
+	const std::vector<VectorKey>& keys,
+	double timeTicks,
+	uint32_t& cursor,
+	XMFLOAT3& out
+)
+{
+	if (keys.empty()) return; // keep default value
+
+	const uint32_t k = FindKeyIndex(keys, timeTicks, cursor);
+	if (k + 1 >= keys.size() || timeTicks <= keys[k].time)
+	{
+		out = keys[k].value;
+		return;
+	}
+
+	const VectorKey& keyA = keys[k];
+	const VectorKey& keyB = keys[k + 1];
+
+	LerpFloat3(keyA.value, keyB.value, KeyLerpFactor(keyA.time, keyB.time, timeTicks), out);
+}
+
+static void SampleQuatKeys(
+	const std::vector<QuatKey>& keys,
+	double timeTicks,
+	uint32_t& cursor,
+	XMFLOAT4& out
+)
+{
+	if (keys.empty()) return; // keep default value
+
+	const uint32_t k = FindKeyIndex(keys, timeTicks, cursor);
+	if (k + 1 >= keys.size() || timeTicks <= keys[k].time)
+	{
+		out = keys[k].value;
+		return;
+	}
+
+	const QuatKey& keyA = keys[k];
+	const QuatKey& keyB = keys[k + 1];
+
+	SlerpQuat(keyA.value, keyB.value, KeyLerpFactor(keyA.time, keyB.time, timeTicks), out);
+}
+
 static void SampleTrack(
 	const BoneAnimTrack& track,
 	double timeTicks,
+	TrackCursor& cursor,
 	XMFLOAT3& outT,
 	XMFLOAT4& outR,
 	XMFLOAT3& outS
 )
 {
-	const auto& keys = track.keyframes;
-	if (keys.empty())
-	{
-		outT = XMFLOAT3(0, 0, 0);
-		outR = XMFLOAT4(0, 0, 0, 1);
-		outS = XMFLOAT3(1, 1, 1);
-		return;
-	}
+	outT = XMFLOAT3(0, 0, 0);
+	outR = XMFLOAT4(0, 0, 0, 1);
+	outS = XMFLOAT3(1, 1, 1);
+
+	if (track.Empty()) return;
 
-	double duration = keys.back().time;
+	double duration = track.endTime;
 	if (duration > 0.0)
 	{
 		timeTicks = fmod(timeTicks, duration);
 		if (timeTicks < 0.0) timeTicks += duration;
 	}
 
-	size_t k1 = 0;
-	size_t k2 = 0;
+	SampleVectorKeys(track.positionKeys, timeTicks, cursor.pos, outT);
+	SampleQuatKeys(track.rotationKeys, timeTicks, cursor.rot, outR);
+	SampleVectorKeys(track.scaleKeys, timeTicks, cursor.scl, outS);
+}
+
+static void GetVectorKeyPair(
+	const std::vector<VectorKey>& keys,
+	double timeTicks,
+	uint32_t& cursor,
+	XMFLOAT3& out0,
+	XMFLOAT3& out1,
+	float& outFactor
+)
+{
+	if (keys.empty()) return; // keep default value
+
+	const uint32_t k = FindKeyIndex(keys, timeTicks, cursor);
+	out0 = keys[k].value;
 
-	for (size_t i = 0; i < keys.size(); ++i)
+	if (k + 1 >= keys.size() || timeTicks <= keys[k].time)
 	{
-		if (keys[i].time >= timeTicks)
-		{
-			k2 = i;
-			k1 = (i > 0) ? i - 1 : 0;
-			break;
-		}
+		out1 = out0;
+		outFactor = 0.0f;
+		return;
 	}
 
-	if (k1 == k2)
+	out1 = keys[k + 1].value;
+	outFactor = KeyLerpFactor(keys[k].time, keys[k + 1].time, timeTicks);
+}
+
+static void GetQuatKeyPair(
+	const std::vector<QuatKey>& keys,
+	double timeTicks,
+	uint32_t& cursor,
+	XMFLOAT4& out0,
+	XMFLOAT4& out1,
+	float& outFactor
+)
+{
+	if (keys.empty()) return; // keep default value
+
+	const uint32_t k = FindKeyIndex(keys, timeTicks, cursor);
+	out0 = keys[k].value;
+
+	if (k + 1 >= keys.size() || timeTicks <= keys[k].time)
 	{
-		outT = keys[k1].translation;
-		outR = keys[k1].rotation;
-		outS = keys[k1].scale;
+		out1 = out0;
+		outFactor = 0.0f;
 		return;
 	}
 
-	const Keyframe& keyA = keys[k1];
-	const Keyframe& keyB = keys[k2];
+	out1 = keys[k + 1].value;
+	outFactor = KeyLerpFactor(keys[k].time, keys[k + 1].time, timeTicks);
+}
+
+void Animation_GetTrackKeyPair(const BoneAnimTrack& track, double timeTicks, TrackCursor& cursor, TrackKeyPair& out)
+{
+	out = TrackKeyPair();
+
+	if (track.Empty()) return;
 
-	double span = keyB.time - keyA.time;
-	float t = 0.0f;
-	if (span > 0.0)
+	double duration = track.endTime;
+	if (duration > 0.0)
 	{
-		t = static_cast<float>((timeTicks - keyA.time) / span);
+		timeTicks = fmod(timeTicks, duration);
+		if (timeTicks < 0.0) timeTicks += duration;
 	}
 
-	LerpFloat3(keyA.translation, keyB.translation, t, outT);
-	SlerpQuat(keyA.rotation, keyB.rotation, t, outR);
-	LerpFloat3(keyA.scale, keyB.scale, t, outS);
+	GetVectorKeyPair(track.positionKeys, timeTicks, cursor.pos, out.t0, out.t1, out.ft);
+	GetQuatKeyPair(track.rotationKeys, timeTicks, cursor.rot, out.r0, out.r1, out.fr);
+	GetVectorKeyPair(track.scaleKeys, timeTicks, cursor.scl, out.s0, out.s1, out.fs);
 }
 
-static const char* GetShortName(const char* fullName)
+// Two binary searches, only the crossed events are touched
+static void PushEventRange(AnimationEventQueue& queue, const AnimationClip* clip, const AnimationEventTrack& track, double fromTicks, double toTicks, bool includeEnd)
 {
-	if (!fullName) return "";
+	const std::vector<AnimationEvent>& events = track.events;
+
+	auto first = std::lower_bound(events.begin(), events.end(), fromTicks,
+		[](const AnimationEvent& e, double t) { return e.timeTicks < t; });
 
-	const char* last = fullName;
-	const char* p = fullName;
+	auto last = includeEnd
+		? std::upper_bound(first, events.end(), toTicks, [](double t, const AnimationEvent& e) { return t < e.timeTicks; })
+		: std::lower_bound(first, events.end(), toTicks, [](const AnimationEvent& e, double t) { return e.timeTicks < t; });
 
-	while (*p)
+	for (auto it = first; it != last; ++it)
 	{
-		if (*p == '|' || *p == ':' || *p == '/' || *p == '\\')
-		{
-			last = p + 1;
-		}
-		++p;
+		AnimationEventRecord record;
+		record.clip = clip;
+		record.track = &track;
+		record.event = &*it;
+		queue.Push(record);
 	}
-
-	return last;
 }
@@ -12,52 +12,161 @@
 #define ANIMATION_H
 
 #include "model_asset.h"
+#include "animation_compression.h"
+#include "animation_sampler.h"
+#include "animation_retarget.h"
+#include "worker_pool_util.h"
 
+#include <atomic>
+#include <functional>
 #include <string>
 #include <vector>
 #include <DirectXMath.h>
 
 
-namespace SkeletonUtil
-{
-	const aiNode* FindNodeByName(const aiScene* scene, const std::string& name);
-}
+class AnimationBlender;
+struct SkinDualQuat;
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+struct ID3D11Buffer;
 
 /*
 // -------------------------------
 AnimationClip
- tracks[]: {[̃Aj[Vf[^
+ tracks[]: {[̃Aj[Vf[^ (by node name, not tied to one ModelAsset)
+ skeleton : bind pose of the rig the clip was authored on (retargeting, animation_retarget.h)
+ rootMotion : oς݂̃[gړ (AnimationRootMotion_Extract)
+ eventTracks[] : footsteps, VFX... sorted by time (Animation_AddEvent)
 
 AnimationPlayer
  Play()Fw肳ꂽAnimationClipModelAssetĐJn
+    Play(handle) : bind pose until the async load is registered, then starts from startTimeSec
  Update()FAj[VXV
- SampleLocalTransform() : 1{[ɑ΂āu[Jϊsv𐶐
- BuildModelSpacePoseRecursive() : S{[́ufԂł̎psv\z
+    events crossed in [previous time, new time) -> AnimationEventQueue (two binary searches per track)
+ SampleLocalTransform() : 1{[ɑ΂āu[Jϊsv𐶐 (scalar reference)
+ SampleLocalPose() : S{[̃[Jϊs (AnimationSampler, 4 bones at a time)
+ SamplePose() : S{[̃[JTRS (AnimationBlender̓)
  ComputeSkinMatrices() : GPUɑuXLsibone matricesjv𐶐
+     Animation_BuildSkinMatrices() : S{[́ufԂł̎psv XLs
 
 AnimationManager
- SĂ AnimationClip* ̊Ǘ
+ SĂ AnimationClip* ̊Ǘ
+ LoadAsync() -> handle now, import on a TaskQueue thread -> PollLoads() registers (main thread)
 // -------------------------------
 */
 
 
-// L[t[
-struct Keyframe
+// ʒuEXP[̃L[
+struct VectorKey
 {
 	double time;
+	DirectX::XMFLOAT3 value;
+};
 
-	DirectX::XMFLOAT3 translation;
-	DirectX::XMFLOAT4 rotation;
-	DirectX::XMFLOAT3 scale;
+// ]̃L[
+struct QuatKey
+{
+	double time;
+	DirectX::XMFLOAT4 value;
 };
 
 // {[̃Aj[V
+// T/R/S channels keep their own key count and key times
 struct BoneAnimTrack
 {
 	const aiNode* node = nullptr; // bone node
 	std::string nodeName;
 
-	std::vector<Keyframe> keyframes; // L[t[
+	std::vector<VectorKey> positionKeys;
+	std::vector<QuatKey>   rotationKeys;
+	std::vector<VectorKey> scaleKeys;
+
+	double endTime = 0.0; // last key time over all channels
+
+	bool Empty() const { return positionKeys.empty() && rotationKeys.empty() && scaleKeys.empty(); }
+};
+
+// Last key used per channel, so forward playback does not search from key 0
+struct TrackCursor
+{
+	uint32_t pos = 0;
+	uint32_t rot = 0;
+	uint32_t scl = 0;
+};
+
+// Keys on both sides of the sample time, per channel
+// Sampled value = interpolate(x0, x1, f), the batch sampler does the interpolation
+struct TrackKeyPair
+{
+	DirectX::XMFLOAT3 t0 = { 0.0f, 0.0f, 0.0f }, t1 = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT4 r0 = { 0.0f, 0.0f, 0.0f, 1.0f }, r1 = { 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT3 s0 = { 1.0f, 1.0f, 1.0f }, s1 = { 1.0f, 1.0f, 1.0f };
+	float ft = 0.0f;
+	float fr = 0.0f;
+	float fs = 0.0f;
+};
+
+// Root displacement baked at load, relative to time 0, in import-fixed model space (Y up, world units)
+// Uniform samples, so a runtime lookup is one index + one lerp
+struct RootMotionCurve
+{
+	double ticksPerSample = 0.0;
+	std::vector<DirectX::XMFLOAT3> samples; // x, z, yaw (radians, around +Y)
+
+	bool Empty() const { return samples.empty(); }
+};
+
+// Root motion of one update, in the character's frame at the start of the update
+struct RootMotionDelta
+{
+	DirectX::XMFLOAT3 translation = { 0.0f, 0.0f, 0.0f }; // y is always 0
+	float yaw = 0.0f;
+};
+
+// Named point in clip time
+struct AnimationEvent
+{
+	double timeTicks = 0.0;
+	std::string name;
+	float value = 0.0f; // free parameter (foot index, volume...)
+};
+
+// One kind of event ("footstep", "vfx"), sorted by timeTicks
+struct AnimationEventTrack
+{
+	std::string name;
+	std::vector<AnimationEvent> events;
+};
+
+// One crossed event, points into the clip (valid while the clip is alive)
+struct AnimationEventRecord
+{
+	const AnimationClip* clip = nullptr;
+	const AnimationEventTrack* track = nullptr;
+	const AnimationEvent* event = nullptr;
+};
+
+// Fixed ring, filled by AnimationPlayer::Update and drained by gameplay / audio
+// Full: the oldest record is overwritten and counted in GetDropped()
+class AnimationEventQueue
+{
+public:
+
+	static const int CAPACITY = 64;
+
+	void Push(const AnimationEventRecord& record);
+	bool Pop(AnimationEventRecord& outRecord);
+	void Clear();
+
+	int GetCount() const { return m_Count; }
+	int GetDropped() const { return m_Dropped; }
+
+private:
+
+	AnimationEventRecord m_Records[CAPACITY];
+	int m_Head = 0; // oldest
+	int m_Count = 0;
+	int m_Dropped = 0;
 };
 
 // Aj[VNbv
@@ -69,14 +178,131 @@ struct AnimationClip
 
 	std::vector<BoneAnimTrack> tracks;
 
+	// Quantized copy of tracks, compressedTracks[i] <-> tracks[i]
+	// Raw keys may already be released once this is filled
+	std::vector<CompressedTrack> compressedTracks;
+
+	RootMotionCurve rootMotion; // empty: the clip moves in place (or extraction was not requested)
+	int rootMotionTrack = -1;   // track the motion was taken from
+
+	std::vector<AnimationEventTrack> eventTracks;
+
+	ClipSkeleton skeleton; // empty: tracks are applied as they are on every asset
+
+	std::string sourcePath; // imported file
 	bool SourceYup = true;
 	bool loop = true;
+
+	bool IsCompressed() const { return !compressedTracks.empty(); }
+};
+
+// NbvƃXPg̑Ή\ (AnimationClip, ModelAsset)
+struct AnimationBinding
+{
+	const AnimationClip* clip = nullptr;
+	const ModelAsset* asset = nullptr;
+
+	std::vector<int> nodeToTrack; // SkeletonRuntime node index -> track index (-1: bind pose)
+	const RetargetMap* retarget = nullptr; // per node correction, nullptr: same rig (AnimationManager owns it)
+	PoseKeyTable keyTable; // AnimationManager::GetBinding, empty: sampled through the key search
 };
 
+// Key index k with time(k) <= t < time(k + 1) (clamped to both ends)
+// Forward playback walks on from the cursor, seeks and loop wraparound use binary search
+template<typename TimeAt>
+inline uint32_t Animation_FindKeyIndex(uint32_t count, const TimeAt& timeAt, double timeTicks, uint32_t& cursor)
+{
+	if (count < 2 || timeTicks <= timeAt(0))
+	{
+		cursor = 0;
+		return 0;
+	}
+	if (timeTicks >= timeAt(count - 1))
+	{
+		cursor = count - 1;
+		return count - 1;
+	}
+
+	uint32_t k = (cursor < count - 1) ? cursor : 0;
+
+	if (timeAt(k) <= timeTicks)
+	{
+		for (int step = 0; step < 4; ++step)
+		{
+			if (timeTicks < timeAt(k + 1))
+			{
+				cursor = k;
+				return k;
+			}
+			++k;
+		}
+	}
+
+	// timeAt(lo) <= t < timeAt(hi)
+	uint32_t lo = 0;
+	uint32_t hi = count - 1;
+	while (hi - lo > 1)
+	{
+		const uint32_t mid = (lo + hi) / 2;
+		if (timeAt(mid) <= timeTicks) lo = mid;
+		else hi = mid;
+	}
+
+	cursor = lo;
+	return lo;
+}
+
+// Same time wrap and key search as the scalar sampling path
+void Animation_GetTrackKeyPair(const BoneAnimTrack& track, double timeTicks, TrackCursor& cursor, TrackKeyPair& out);
+
+// Load time: inserted in time order, the track is created on first use
+void Animation_AddEvent(AnimationClip* clip, const char* trackName, double timeSec, const char* eventName, float value = 0.0f);
+
 // Aj[V̓ǂݍ
+// asset may be nullptr: the clip is bound by name when it is played (one copy for every character type)
 AnimationClip* Animation_LoadFromFile(const char* filename, const ModelAsset* asset, bool animYup);
 void Animation_DestroyClip(AnimationClip* clip);
 
+// Track matching: full name > short name > aiNode pointer
+void Animation_ResolveBinding(const AnimationClip* clip, const ModelAsset* asset, AnimationBinding& outBinding);
+
+
+// Asynchronous clip load (AnimationManager::LoadAsync)
+// The clip exists once PollLoads has registered it, until then players keep the bind pose
+struct AnimationClipHandle
+{
+	int id = -1;
+
+	bool IsValid() const { return id >= 0; }
+};
+
+enum class ClipLoadState
+{
+	Invalid,
+	Pending,
+	Ready,
+	Failed,
+};
+
+// Runs on the loader thread right after the load, before the clip is registered
+// (root motion extraction, compression, events: anything that edits the clip)
+typedef std::function<void(AnimationClip*)> ClipPrepareFunc;
+
+// One LoadAsync call. Inputs and 'done' are the only thing the loader thread and the
+// main thread share; everything else is read after 'done' (acquire) on the main thread
+struct ClipLoadRequest
+{
+	std::string filename;
+	const ModelAsset* asset = nullptr;
+	bool animYup = true;
+	ClipPrepareFunc prepare;
+
+	AnimationClip* clip = nullptr; // loader result, owned by the manager once registered
+	double loadSec = 0.0;
+	std::atomic<bool> done{ false };
+
+	ClipLoadState state = ClipLoadState::Pending; // main thread
+};
 
 // Aj[VǗNX
 class AnimationManager
@@ -84,10 +310,21 @@ class AnimationManager
 private:
 
 	std::vector<AnimationClip*> m_Clips;
+	std::vector<AnimationBinding*> m_Bindings; // resolved once per (clip, asset)
+	std::vector<RetargetMap*> m_RetargetMaps;  // one per (clip skeleton, asset), shared by the clips of a rig
+	std::mutex m_BindingMutex;                 // Play / GetBinding run concurrently on AnimationSystem workers
+
+	const RetargetMap* GetRetargetMap(const ClipSkeleton& source, const ModelAsset* asset); // m_BindingMutex held (GetBinding)
 
+	// Async loads: the vector is main thread only, a loader thread touches only its own request
+	std::vector<ClipLoadRequest*> m_LoadRequests; // index = AnimationClipHandle::id, never shrinks before DestroyAll
+	TaskQueue m_Loader;
+	int m_PendingLoads = 0;
+	double m_LoadBatchStart = 0.0; // first request of the current batch
+	double m_LoadBatchSum = 0.0;   // sum of the single load times of the batch
 
 	AnimationManager() = default;
-	~AnimationManager() = default;
+	~AnimationManager();
 
 	AnimationManager(const AnimationManager&) = delete;
 	AnimationManager& operator=(const AnimationManager&) = delete;
@@ -96,11 +333,31 @@ public:
 
 	static AnimationManager& Instance();
 
-	int RegisterClip(AnimationClip* clip);
+	int RegisterClip(AnimationClip* clip, const ModelAsset* asset = nullptr);
 	void DestroyAll();
 
 	AnimationClip* GetClipById(int id) const;
 	AnimationClip* FindClipByName(const std::string& name) const;
+	AnimationClip* FindClipBySource(const std::string& sourcePath) const; // already loaded for another character
+	int GetClipCount() const { return static_cast<int>(m_Clips.size()); }
+
+	const AnimationBinding* GetBinding(const AnimationClip* clip, const ModelAsset* asset);
+	int GetRetargetMapCount() const { return static_cast<int>(m_RetargetMaps.size()); }
+	void ReleaseBindings(const ModelAsset* asset); // call before the asset is released (retarget maps too)
+	void ReleaseBindings(const AnimationClip* clip); // for clips that are not registered
+
+	// Returns right away, the FBX import / cooked read runs on a loader thread
+	// asset is read only there (name binding, prepare), it must outlive the request
+	AnimationClipHandle LoadAsync(const char* filename, const ModelAsset* asset, bool animYup, ClipPrepareFunc prepare = nullptr);
+
+	// Main thread, once per frame: registers the clips that finished
+	void PollLoads();
+	void WaitForLoads(); // blocks, then PollLoads
+
+	ClipLoadState GetLoadState(AnimationClipHandle handle) const;
+	bool GetRequestedYup(AnimationClipHandle handle) const; // animYup of LoadAsync, known before the clip is
+	AnimationClip* ResolveClip(AnimationClipHandle handle) const; // nullptr until Ready
+	int GetPendingLoadCount() const { return m_PendingLoads; }
 };
 
 
@@ -111,28 +368,33 @@ private:
 
 	const ModelAsset* m_Asset = nullptr;
 	const AnimationClip* m_Clip = nullptr;
+	const AnimationBinding* m_Binding = nullptr;
+	AnimationClipHandle m_PendingClip; // Play(handle) before the load finished: bind pose meanwhile
+	double m_PendingStartSec = 0.0;
+	bool m_PendingAnimYup = true;      // axis the clip was requested with, so the bind pose does not flip on arrival
+	mutable std::vector<TrackCursor> m_Cursors; // per clip track
 	bool m_Playing = false;
 	bool m_Loop = true;
 	double m_CurrentTimeTicks = 0.0;
+	RootMotionDelta m_RootMotion; // last Update
+	AnimationEventQueue* m_EventQueue = nullptr; // nullptr: events are not reported
 
-	mutable std::unordered_map<const aiNode*, DirectX::XMMATRIX> m_CurrentPose; // last pose
+	// Reused every frame, sized once per skeleton
+	mutable PoseSampleScratch m_SampleScratch;
+	mutable PoseMatrixBuffer m_LocalPose; // per node, local
+	mutable PoseMatrixBuffer m_ModelPose; // per node, model space (last ComputeSkinMatrices)
 
 private:
 
-	DirectX::XMMATRIX SampleLocalTransform(const aiNode * node, double tickTimes) const;
-
-	void BuildModelSpacePoseResursive(
-		const aiNode* node,
-		const DirectX::XMMATRIX& parentMtx,
-		double timeTicks,
-		std::unordered_map<const aiNode*, DirectX::XMMATRIX>& outNodeModelMtx
-	) const;
+	DirectX::XMMATRIX SampleLocalTransform(int nodeIndex, double tickTimes) const;
+	void EmitEvents(double fromTicks, double toTicks, bool wrapped, bool reachedEnd, double deltaTicks) const;
 
 public:
 
 	AnimationPlayer();
 
 	void Play(const AnimationClip* clip, const ModelAsset* asset, bool loop = true, double startTimeSec = 0.0);
+	void Play(AnimationClipHandle handle, const ModelAsset* asset, bool loop = true, double startTimeSec = 0.0); // starts when the clip arrives
 
 	void Stop();
 
@@ -142,17 +404,71 @@ public:
 
 	const ModelAsset* GetAsset();
 	const AnimationClip* GetCurrentClip() const { return m_Clip; }
+	bool IsWaitingForClip() const { return m_PendingClip.IsValid(); }
+	bool GetAnimYup() const { return m_Clip ? m_Clip->SourceYup : m_PendingAnimYup; }
+	AnimationClipHandle GetPendingClip() const { return m_PendingClip; }
 	double GetCurrentTimeSec() const;
-	void GetCurrentPose(std::unordered_map<const aiNode*, DirectX::XMMATRIX>& outPose) const;
+	PoseView GetCurrentPose() const; // model space, valid until the next ComputeSkinMatrices
+
+	bool HasRootMotion() const { return m_Clip && !m_Clip->rootMotion.Empty(); }
+	const RootMotionDelta& GetRootMotionDelta() const { return m_RootMotion; } // covers the last Update
+
+	void SetEventQueue(AnimationEventQueue* queue) { m_EventQueue = queue; }
 
 	void ComputeSkinMatrices(std::vector<DirectX::XMFLOAT4X4>& outBoneMatrix) const;
+
+	// Local matrix of every node at the current time (batched = false: per bone scalar path)
+	void SampleLocalPose(PoseMatrixBuffer& outLocal, bool batched = true) const;
+
+	// Local TRS of every node at the current time, input of AnimationBlender
+	void SamplePose(LocalPoseSoA& outPose, int maxDepth = -1) const;
 };
 
+// Local pose -> model-space pose (outModelPose) -> transposed skin matrices
+// Shared by AnimationPlayer and AnimationBlender
+void Animation_BuildSkinMatrices(
+	const ModelAsset* asset,
+	bool animYup,
+	const PoseMatrixBuffer& localPose,
+	PoseMatrixBuffer& outModelPose,
+	std::vector<DirectX::XMFLOAT4X4>& outBoneMatrix
+);
+
 
 // XLjOp萔obt@̊Ǘ
 bool Animation_InitializeSkinningCB(ID3D11Device* pDevice, ID3D11DeviceContext* pContext);
 void Animation_ReleaseSkinningCB();
 void Animation_UpdateSkinningCB(const AnimationPlayer& player);
+void Animation_UpdateSkinningCB(const AnimationBlender& blender);
+
+// Skinning constant buffer of one instance, owned by the caller (Player)
+// Its upload is skipped while that instance's palette stays the same, whatever was drawn in between
+struct SkinningPaletteBuffer
+{
+	ID3D11Buffer* buffer = nullptr;  // created by the first upload
+	std::vector<uint8_t> uploaded;   // bytes the buffer holds
+};
+
+// Precomputed palette (AnimationSystem), instance : nullptr uploads to the shared buffer
+void Animation_UpdateSkinningCB(const std::vector<DirectX::XMFLOAT4X4>& skinMatrices, SkinningPaletteBuffer* instance = nullptr);
+void Animation_UpdateSkinningCB(const DirectX::XMFLOAT4X4* skinMatrices, int boneCount, SkinningPaletteBuffer* instance = nullptr);
+// Dual quaternion palette (SkinningMethod::DualQuaternion assets), 32 bytes per bone
+// The buffer holds 512, the packed skin stream only indexes 256 (VERTEX_PACK_MAX_BONES) like linear blend
+void Animation_UpdateSkinningCB(const std::vector<SkinDualQuat>& dualQuats, SkinningPaletteBuffer* instance = nullptr);
+void Animation_UpdateSkinningCB(const SkinDualQuat* dualQuats, int boneCount, SkinningPaletteBuffer* instance = nullptr);
+void Animation_ReleaseSkinningPalette(SkinningPaletteBuffer& palette);
+
+// Upload counters, one frame worth
+struct SkinningUploadStats
+{
+	int uploads = 0;
+	int skipped = 0;           // palette identical to the one already in the buffer
+	size_t bytesUploaded = 0;
+	size_t bytesSkipped = 0;
+};
+
+void Animation_BeginSkinningFrame(); // once per frame before drawing: closes the previous frame's counters
+const SkinningUploadStats& Animation_GetSkinningUploadStats(); // previous frame
 //void Animation_DisableSkinning();
 
 #endif // ANIMATION_H
@@ -0,0 +1,442 @@
+/*==============================================================================
+
+   Baked crowd animation [animation_bake.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_bake.h"
+#include "animation.h"
+#include "animation_skinning.h"
+#include "model_asset.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace DirectX;
+
+// Standard file I/O and the CPU animation path only (no D3D / assimp): tools/anim_bake.cpp bakes headless
+static const uint32_t BAKE_FILE_MAGIC = 0x42544156; // "VATB"
+static const uint32_t BAKE_FILE_VERSION = 1;
+
+static const uint32_t BAKE_FLAG_LOOP = 1u << 0;
+
+static const int PALETTE_TEXELS_PER_BONE = 3; // 3x4, the 4th row of a skin matrix is always (0, 0, 0, 1)
+static const int MAX_FRAMES = 1 << 16;
+
+struct BakeFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t layout;
+	uint32_t flags;
+
+	uint32_t frameCount;
+	uint32_t texelsPerFrame; // texture width, frameCount is the height
+	uint32_t boneCount;
+	uint32_t meshCount;
+
+	double sampleRate;
+	double durationSec;
+
+	uint32_t nameOffset;
+	uint32_t nameLength;
+	uint64_t texelOffset;
+
+	uint64_t fileSize;
+	uint64_t reserved;
+};
+
+struct BakeFileMesh
+{
+	uint32_t meshIndex;
+	uint32_t vertexCount;
+	uint32_t firstTexel;
+	uint32_t pad;
+};
+
+static_assert(sizeof(BakeFileHeader) == 80, "BakeFileHeader layout");
+static_assert(sizeof(BakeFileMesh) == 16, "BakeFileMesh layout");
+
+static uint64_t AlignUp16(uint64_t v);
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t fileSize);
+static int ComputeFrameCount(double durationSec, double sampleRate, bool loop);
+
+
+std::string AnimationBake_GetBakedPath(const char* sourcePath)
+{
+	std::string path = sourcePath ? sourcePath : "";
+
+	const size_t dot = path.find_last_of('.');
+	const size_t slash = path.find_last_of("/\\");
+
+	if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+	{
+		path.erase(dot);
+	}
+
+	return path + ".vat";
+}
+
+bool AnimationBake_Write(
+	const ModelAsset* asset,
+	const AnimationClip* clip,
+	const AnimationBakeSettings& settings,
+	const char* bakedPath,
+	AnimationBakeReport* outReport)
+{
+	if (!asset || !clip || !bakedPath || settings.sampleRate <= 0.0) return false;
+
+	const double tps = (clip->ticksPerSecond > 0.0) ? clip->ticksPerSecond : 30.0;
+	const double durationSec = clip->duration / tps;
+	const int frameCount = ComputeFrameCount(durationSec, settings.sampleRate, clip->loop);
+	if (frameCount <= 0) return false;
+
+	// 1. Frame layout
+	AnimationPlayer player;
+	player.Play(clip, asset, clip->loop, 0.0);
+
+	std::vector<XMFLOAT4X4> palette;
+	player.ComputeSkinMatrices(palette);
+
+	const int boneCount = static_cast<int>(palette.size());
+	if (boneCount == 0) return false;
+
+	std::vector<BakeFileMesh> meshes;
+	int texelsPerFrame = 0;
+
+	if (settings.layout == BakedAnimationLayout::BonePalette)
+	{
+		texelsPerFrame = boneCount * PALETTE_TEXELS_PER_BONE;
+	}
+	else
+	{
+		for (int m = 0; m < static_cast<int>(asset->meshes.size()); ++m)
+		{
+			const MeshAsset& mesh = asset->meshes[m];
+			if (!mesh.skinned || mesh.cpuVertices.empty()) continue;
+
+			BakeFileMesh fm;
+			memset(&fm, 0, sizeof(fm));
+			fm.meshIndex = static_cast<uint32_t>(m);
+			fm.vertexCount = static_cast<uint32_t>(mesh.cpuVertices.size());
+			fm.firstTexel = static_cast<uint32_t>(texelsPerFrame);
+			meshes.push_back(fm);
+
+			texelsPerFrame += static_cast<int>(fm.vertexCount);
+		}
+	}
+
+	if (texelsPerFrame == 0) return false;
+
+	const uint64_t frameBytes = static_cast<uint64_t>(texelsPerFrame) * sizeof(XMFLOAT4);
+	const uint64_t texelOffset = AlignUp16(sizeof(BakeFileHeader) + meshes.size() * sizeof(BakeFileMesh));
+
+	// The name offset is 32 bit: big position bakes need a lower sample rate
+	if (texelOffset + frameBytes * frameCount + clip->animName.size() > UINT32_MAX) return false;
+
+	BakeFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = BAKE_FILE_MAGIC;
+	header.version = BAKE_FILE_VERSION;
+	header.layout = static_cast<uint32_t>(settings.layout);
+	header.flags = clip->loop ? BAKE_FLAG_LOOP : 0;
+	header.frameCount = static_cast<uint32_t>(frameCount);
+	header.texelsPerFrame = static_cast<uint32_t>(texelsPerFrame);
+	header.boneCount = static_cast<uint32_t>(boneCount);
+	header.meshCount = static_cast<uint32_t>(meshes.size());
+	header.sampleRate = settings.sampleRate;
+	header.durationSec = durationSec;
+	header.texelOffset = texelOffset;
+	header.nameOffset = static_cast<uint32_t>(texelOffset + frameBytes * frameCount);
+	header.nameLength = static_cast<uint32_t>(clip->animName.size());
+	header.fileSize = header.nameOffset + clip->animName.size();
+
+	// 2. Frames streamed to a temporary file, one frame in memory at a time
+	// Any failure from here on removes it, the previous .vat (if any) stays as it was
+	const std::string tempPath = std::string(bakedPath) + ".tmp";
+	bool written = false;
+	{
+		std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+		if (!ofs) return false;
+
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		ofs.write(reinterpret_cast<const char*>(meshes.data()), meshes.size() * sizeof(BakeFileMesh));
+
+		const char zeros[16] = {};
+		ofs.write(zeros, static_cast<std::streamsize>(texelOffset - sizeof(header) - meshes.size() * sizeof(BakeFileMesh)));
+
+		std::vector<XMFLOAT4> texels(texelsPerFrame);
+		std::vector<XMFLOAT3> positions, normals;
+
+		int f = 0;
+		for (; f < frameCount; ++f)
+		{
+			// The last frame of a one-shot clip sits just before the end (Play wraps the end to 0)
+			double timeSec = f / settings.sampleRate;
+			if (timeSec >= durationSec) timeSec = durationSec * (1.0 - 1.0e-9);
+
+			player.Play(clip, asset, clip->loop, timeSec);
+			player.ComputeSkinMatrices(palette);
+
+			if (!ofs || static_cast<int>(palette.size()) != boneCount) break;
+
+			if (settings.layout == BakedAnimationLayout::BonePalette)
+			{
+				for (int b = 0; b < boneCount; ++b)
+				{
+					const XMFLOAT4X4& m = palette[b];
+					texels[b * 3 + 0] = XMFLOAT4(m._11, m._12, m._13, m._14);
+					texels[b * 3 + 1] = XMFLOAT4(m._21, m._22, m._23, m._24);
+					texels[b * 3 + 2] = XMFLOAT4(m._31, m._32, m._33, m._34);
+				}
+			}
+			else
+			{
+				for (const BakeFileMesh& fm : meshes)
+				{
+					AnimationSkinning_SkinMesh(asset->meshes[fm.meshIndex], palette, positions, normals);
+
+					for (uint32_t v = 0; v < fm.vertexCount; ++v)
+					{
+						const XMFLOAT3& p = positions[v];
+						texels[fm.firstTexel + v] = XMFLOAT4(p.x, p.y, p.z, 1.0f);
+					}
+				}
+			}
+
+			ofs.write(reinterpret_cast<const char*>(texels.data()), static_cast<std::streamsize>(frameBytes));
+		}
+
+		if (f == frameCount)
+		{
+			ofs.write(clip->animName.data(), clip->animName.size());
+			ofs.close();
+			written = !ofs.fail();
+		}
+	}
+
+	if (written)
+	{
+		std::remove(bakedPath);
+		written = (std::rename(tempPath.c_str(), bakedPath) == 0);
+	}
+
+	if (!written)
+	{
+		std::remove(tempPath.c_str());
+		return false;
+	}
+
+	if (outReport)
+	{
+		outReport->frameCount = frameCount;
+		outReport->texelsPerFrame = texelsPerFrame;
+		outReport->fileBytes = header.fileSize;
+	}
+
+	return true;
+}
+
+BakedAnimation* AnimationBake_Load(const char* bakedPath)
+{
+	if (!bakedPath) return nullptr;
+
+	std::ifstream ifs(bakedPath, std::ios::binary | std::ios::ate);
+	if (!ifs) return nullptr;
+
+	const uint64_t size = static_cast<uint64_t>(ifs.tellg());
+	if (size < sizeof(BakeFileHeader)) return nullptr;
+
+	std::vector<char> data(static_cast<size_t>(size));
+	ifs.seekg(0);
+	if (!ifs.read(data.data(), data.size())) return nullptr;
+
+	const uint8_t* base = reinterpret_cast<const uint8_t*>(data.data());
+
+	BakeFileHeader header;
+	memcpy(&header, base, sizeof(header));
+
+	if (header.magic != BAKE_FILE_MAGIC || header.version != BAKE_FILE_VERSION) return nullptr;
+	if (header.fileSize != size) return nullptr;
+	if (header.layout > static_cast<uint32_t>(BakedAnimationLayout::VertexPositions)) return nullptr;
+	if (header.frameCount == 0 || header.frameCount > MAX_FRAMES || header.texelsPerFrame == 0) return nullptr;
+	if (!(header.sampleRate > 0.0) || !(header.durationSec >= 0.0)) return nullptr;
+
+	const BakedAnimationLayout layout = static_cast<BakedAnimationLayout>(header.layout);
+	const uint64_t texelCount = static_cast<uint64_t>(header.frameCount) * header.texelsPerFrame;
+
+	if (!InFile(sizeof(BakeFileHeader), static_cast<uint64_t>(header.meshCount) * sizeof(BakeFileMesh), size)) return nullptr;
+	if (!InFile(header.texelOffset, texelCount * sizeof(XMFLOAT4), size)) return nullptr;
+	if (!InFile(header.nameOffset, header.nameLength, size)) return nullptr;
+	if (layout == BakedAnimationLayout::BonePalette && header.texelsPerFrame != header.boneCount * PALETTE_TEXELS_PER_BONE) return nullptr;
+
+	BakedAnimation* baked = new BakedAnimation();
+	baked->name.assign(reinterpret_cast<const char*>(base + header.nameOffset), header.nameLength);
+	baked->layout = layout;
+	baked->frameCount = static_cast<int>(header.frameCount);
+	baked->texelsPerFrame = static_cast<int>(header.texelsPerFrame);
+	baked->sampleRate = header.sampleRate;
+	baked->durationSec = header.durationSec;
+	baked->loop = (header.flags & BAKE_FLAG_LOOP) != 0;
+	baked->boneCount = static_cast<int>(header.boneCount);
+
+	const XMFLOAT4* texels = reinterpret_cast<const XMFLOAT4*>(base + header.texelOffset);
+
+	if (layout == BakedAnimationLayout::BonePalette)
+	{
+		// Expanded once here, so a lookup hands out a pointer the CB upload can take as is
+		baked->palettes.resize(static_cast<size_t>(header.frameCount) * header.boneCount);
+
+		for (size_t i = 0; i < baked->palettes.size(); ++i)
+		{
+			const XMFLOAT4* src = texels + i * PALETTE_TEXELS_PER_BONE;
+			baked->palettes[i] = XMFLOAT4X4(
+				src[0].x, src[0].y, src[0].z, src[0].w,
+				src[1].x, src[1].y, src[1].z, src[1].w,
+				src[2].x, src[2].y, src[2].z, src[2].w,
+				0.0f, 0.0f, 0.0f, 1.0f);
+		}
+	}
+	else
+	{
+		const BakeFileMesh* fileMeshes = reinterpret_cast<const BakeFileMesh*>(base + sizeof(BakeFileHeader));
+
+		for (uint32_t i = 0; i < header.meshCount; ++i)
+		{
+			BakeFileMesh fm;
+			memcpy(&fm, &fileMeshes[i], sizeof(fm));
+
+			if (static_cast<uint64_t>(fm.firstTexel) + fm.vertexCount > header.texelsPerFrame)
+			{
+				delete baked;
+				return nullptr;
+			}
+
+			BakedMeshRange range;
+			range.meshIndex = static_cast<int>(fm.meshIndex);
+			range.vertexCount = static_cast<int>(fm.vertexCount);
+			range.firstTexel = static_cast<int>(fm.firstTexel);
+			baked->meshes.push_back(range);
+		}
+
+		baked->positions.assign(texels, texels + texelCount);
+	}
+
+	return baked;
+}
+
+void AnimationBake_Destroy(BakedAnimation* baked)
+{
+	delete baked;
+}
+
+int AnimationBake_FrameAt(const BakedAnimation& baked, double timeSec)
+{
+	if (baked.frameCount <= 1) return 0;
+
+	if (baked.loop && baked.durationSec > 0.0)
+	{
+		timeSec = fmod(timeSec, baked.durationSec);
+		if (timeSec < 0.0) timeSec += baked.durationSec;
+
+		// Rounding up past the last frame lands on the first one again
+		return static_cast<int>(timeSec * baked.sampleRate + 0.5) % baked.frameCount;
+	}
+
+	if (timeSec <= 0.0) return 0;
+
+	const int frame = static_cast<int>(timeSec * baked.sampleRate + 0.5);
+	return (frame < baked.frameCount) ? frame : baked.frameCount - 1;
+}
+
+const XMFLOAT4X4* AnimationBake_GetPaletteFrame(const BakedAnimation& baked, int frame)
+{
+	if (baked.palettes.empty() || frame < 0 || frame >= baked.frameCount) return nullptr;
+
+	return baked.palettes.data() + static_cast<size_t>(frame) * baked.boneCount;
+}
+
+const XMFLOAT4* AnimationBake_GetPositionFrame(const BakedAnimation& baked, int frame)
+{
+	if (baked.positions.empty() || frame < 0 || frame >= baked.frameCount) return nullptr;
+
+	return baked.positions.data() + static_cast<size_t>(frame) * baked.texelsPerFrame;
+}
+
+BakedAnimationLibrary& BakedAnimationLibrary::Instance()
+{
+	static BakedAnimationLibrary instance;
+	return instance;
+}
+
+int BakedAnimationLibrary::Register(BakedAnimation* baked)
+{
+	if (!baked) return -1;
+
+	m_Clips.push_back(baked);
+	return static_cast<int>(m_Clips.size()) - 1;
+}
+
+void BakedAnimationLibrary::DestroyAll()
+{
+	for (BakedAnimation* baked : m_Clips)
+	{
+		AnimationBake_Destroy(baked);
+	}
+	m_Clips.clear();
+	m_TimeSec = 0.0;
+}
+
+const BakedAnimation* BakedAnimationLibrary::Get(int id) const
+{
+	if (id < 0 || id >= static_cast<int>(m_Clips.size())) return nullptr;
+	return m_Clips[id];
+}
+
+int BakedAnimationLibrary::FindByName(const std::string& name, BakedAnimationLayout layout) const
+{
+	for (int id = 0; id < static_cast<int>(m_Clips.size()); ++id)
+	{
+		if (m_Clips[id]->name == name && m_Clips[id]->layout == layout) return id;
+	}
+	return -1;
+}
+
+const XMFLOAT4X4* BakedAnimationLibrary::GetPalette(const BakedAnimationInstance& instance, int& outBoneCount) const
+{
+	outBoneCount = 0;
+
+	const BakedAnimation* baked = Get(instance.clipId);
+	if (!baked || baked->layout != BakedAnimationLayout::BonePalette) return nullptr;
+
+	outBoneCount = baked->boneCount;
+	return AnimationBake_GetPaletteFrame(*baked, AnimationBake_FrameAt(*baked, m_TimeSec + instance.timeOffset));
+}
+
+static uint64_t AlignUp16(uint64_t v)
+{
+	return (v + 15) & ~static_cast<uint64_t>(15);
+}
+
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t fileSize)
+{
+	return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+// Looping : [0, duration), the wrap returns to frame 0
+// One-shot: [0, duration], the end pose is the last frame
+static int ComputeFrameCount(double durationSec, double sampleRate, bool loop)
+{
+	if (!(durationSec > 0.0)) return 1;
+
+	const int spans = static_cast<int>(std::ceil(durationSec * sampleRate - 1.0e-6));
+	const int count = loop ? spans : spans + 1;
+
+	if (count < 1) return 1;
+	return (count > MAX_FRAMES) ? MAX_FRAMES : count;
+}
@@ -0,0 +1,149 @@
+/*==============================================================================
+
+   Baked crowd animation [animation_bake.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_BAKE_H
+#define ANIMATION_BAKE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+struct AnimationClip;
+struct ModelAsset;
+
+/*
+// -------------------------------
+AnimationBake_Write (offline: CPU sampling + CPU skinning only, no device, no window)
+├─ frames at sampleRate over the clip (looping clips: the frame after the last is frame 0)
+├─ BonePalette     : per frame boneCount * 3 texels (rows of the 3x4 skin matrix, as the CB gets them)
+└─ VertexPositions : per frame every skinned vertex of the asset, (x, y, z, 1) per texel
+
+.vat (little endian, texel data 16 byte aligned)
+├─ BakeFileHeader : magic, version, layout, frame count, texels per frame, sample rate, duration
+├─ BakeFileMesh[meshCount] : VertexPositions only, which texels belong to which mesh
+├─ texels : RGBA32F, frameCount rows of texelsPerFrame (= a texelsPerFrame x frameCount texture)
+└─ clip name
+
+Runtime (BakedAnimationLibrary)
+├─ instance = clip id + time offset, nothing to update per instance
+├─ Advance() : one shared clock per frame
+└─ GetPalette() : frame lookup, palette already expanded at load -> Animation_UpdateSkinningCB
+// -------------------------------
+*/
+
+enum class BakedAnimationLayout : uint32_t
+{
+	BonePalette = 0,
+	VertexPositions = 1,
+};
+
+struct AnimationBakeSettings
+{
+	BakedAnimationLayout layout = BakedAnimationLayout::BonePalette;
+	double sampleRate = 30.0; // frames per second
+};
+
+// What a bake produced
+struct AnimationBakeReport
+{
+	int frameCount = 0;
+	int texelsPerFrame = 0;
+	uint64_t fileBytes = 0;
+};
+
+// Texels of one mesh inside a VertexPositions frame
+struct BakedMeshRange
+{
+	int meshIndex = 0;
+	int vertexCount = 0;
+	int firstTexel = 0;
+};
+
+// Loaded .vat
+struct BakedAnimation
+{
+	std::string name;
+	BakedAnimationLayout layout = BakedAnimationLayout::BonePalette;
+
+	int frameCount = 0;
+	int texelsPerFrame = 0;
+	double sampleRate = 30.0;
+	double durationSec = 0.0;
+	bool loop = true;
+
+	int boneCount = 0;                           // BonePalette
+	std::vector<DirectX::XMFLOAT4X4> palettes;   // BonePalette, frame-major, ready for the skinning CB
+
+	std::vector<BakedMeshRange> meshes;          // VertexPositions
+	std::vector<DirectX::XMFLOAT4> positions;    // VertexPositions, frame-major
+};
+
+// Instance of a background character: no player, no blender, no palette of its own
+struct BakedAnimationInstance
+{
+	int clipId = -1;         // BakedAnimationLibrary id
+	float timeOffset = 0.0f; // seconds, desynchronizes a crowd
+};
+
+// "resources/Animation/Walk.fbx" -> "resources/Animation/Walk.vat"
+std::string AnimationBake_GetBakedPath(const char* sourcePath);
+
+bool AnimationBake_Write(
+	const ModelAsset* asset,
+	const AnimationClip* clip,
+	const AnimationBakeSettings& settings,
+	const char* bakedPath,
+	AnimationBakeReport* outReport = nullptr
+);
+
+// nullptr when the file is missing, broken or from another version
+BakedAnimation* AnimationBake_Load(const char* bakedPath);
+void AnimationBake_Destroy(BakedAnimation* baked);
+
+// Nearest frame at timeSec (looping clips wrap, others hold the last frame)
+int AnimationBake_FrameAt(const BakedAnimation& baked, double timeSec);
+
+const DirectX::XMFLOAT4X4* AnimationBake_GetPaletteFrame(const BakedAnimation& baked, int frame);  // boneCount matrices
+const DirectX::XMFLOAT4* AnimationBake_GetPositionFrame(const BakedAnimation& baked, int frame);   // texelsPerFrame positions
+
+
+// Baked clips and the clock every baked instance shares
+class BakedAnimationLibrary
+{
+private:
+
+	std::vector<BakedAnimation*> m_Clips;
+	double m_TimeSec = 0.0;
+
+	BakedAnimationLibrary() = default;
+	~BakedAnimationLibrary() = default;
+
+	BakedAnimationLibrary(const BakedAnimationLibrary&) = delete;
+	BakedAnimationLibrary& operator=(const BakedAnimationLibrary&) = delete;
+
+public:
+
+	static BakedAnimationLibrary& Instance();
+
+	int Register(BakedAnimation* baked); // takes ownership
+	void DestroyAll();
+
+	const BakedAnimation* Get(int id) const;
+	int FindByName(const std::string& name, BakedAnimationLayout layout) const; // -1 when not registered
+	int GetClipCount() const { return static_cast<int>(m_Clips.size()); }
+
+	void Advance(double elapsed_time) { m_TimeSec += elapsed_time; }
+	double GetTime() const { return m_TimeSec; }
+
+	// nullptr when the id is unknown or the clip is not a BonePalette bake
+	const DirectX::XMFLOAT4X4* GetPalette(const BakedAnimationInstance& instance, int& outBoneCount) const;
+};
+
+#endif // ANIMATION_BAKE_H
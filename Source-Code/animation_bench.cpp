@@ -0,0 +1,449 @@
+/*==============================================================================
+
+   Animation micro benchmarks [animation_bench.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_bench.h"
+#include "animation.h"
+#include "animation_compression.h"
+#include "animation_system.h"
+#include "animation_bake.h"
+#include "animation_skinning.h"
+#include "worker_pool_util.h"
+#include "model_asset.h"
+#include "system_timer.h"
+
+#include "imgui/imgui.h"
+
+#include <Windows.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+static const double BENCH_FRAME_TIME = 1.0 / 60.0;
+static const double CROWD_PHASE_STEP = 0.037; // start time offset between crowd members
+
+static std::vector<AnimationBench::SamplingResult> g_SamplingResults;
+static int g_SamplingIterations = 1000;
+
+static std::vector<AnimationCompressionReport> g_CompressionReports;
+static float g_CompressionThreshold = AnimationCompressionSettings().errorThreshold;
+
+static std::vector<AnimationBench::SkinningResult> g_SkinningResults;
+static int g_SkinningIterations = 100;
+
+static std::vector<AnimationBench::BakeResult> g_BakeResults;
+static bool g_BakeVertexPositions = false;
+static int g_BakeInstances = 500;
+
+static float MaxFloat3Diff(const std::vector<XMFLOAT3>& a, const std::vector<XMFLOAT3>& b);
+
+
+namespace AnimationBench
+{
+	void RunSampling(const ModelAsset* asset, int iterations, std::vector<SamplingResult>& outResults)
+	{
+		outResults.clear();
+
+		if (!asset || iterations <= 0) return;
+
+		AnimationManager& manager = AnimationManager::Instance();
+
+		std::vector<XMFLOAT4X4> skinMatrices;
+		AnimationBinding scratch;
+
+		for (int c = 0; c < manager.GetClipCount(); ++c)
+		{
+			const AnimationClip* clip = manager.GetClipById(c);
+			if (!clip) continue;
+
+			SamplingResult r;
+			r.clipName = clip->animName;
+			r.nodeCount = asset->skeleton.NodeCount();
+			r.trackCount = static_cast<int>(clip->tracks.size());
+			r.iterations = iterations;
+
+			AnimationPlayer player;
+
+			// Before: every sample matches tracks by name (what FindTrackForNode cost per frame)
+			player.Play(clip, asset, true, 0.0);
+			double start = SystemTimer_GetAbsoluteTime();
+			for (int i = 0; i < iterations; ++i)
+			{
+				Animation_ResolveBinding(clip, asset, scratch);
+				player.Update(BENCH_FRAME_TIME);
+				player.ComputeSkinMatrices(skinMatrices);
+			}
+			r.stringMatchUs = (SystemTimer_GetAbsoluteTime() - start) * 1.0e6 / iterations;
+
+			// After: binding resolved once in Play()
+			player.Play(clip, asset, true, 0.0);
+			start = SystemTimer_GetAbsoluteTime();
+			for (int i = 0; i < iterations; ++i)
+			{
+				player.Update(BENCH_FRAME_TIME);
+				player.ComputeSkinMatrices(skinMatrices);
+			}
+			r.bindingUs = (SystemTimer_GetAbsoluteTime() - start) * 1.0e6 / iterations;
+
+			char buf[256];
+			sprintf_s(buf, "[AnimBench] %s nodes=%d tracks=%d : name match %.2f us, binding %.2f us\n",
+				r.clipName.c_str(), r.nodeCount, r.trackCount, r.stringMatchUs, r.bindingUs);
+			OutputDebugStringA(buf);
+
+			outResults.push_back(r);
+		}
+	}
+
+	void RunSkinning(const ModelAsset* asset, int iterations, std::vector<SkinningResult>& outResults)
+	{
+		outResults.clear();
+
+		if (!asset || iterations <= 0) return;
+
+		AnimationManager& manager = AnimationManager::Instance();
+		const AnimationClip* clip = (manager.GetClipCount() > 0) ? manager.GetClipById(0) : nullptr;
+		if (!clip) return;
+
+		AnimationPlayer player;
+		const double tps = (clip->ticksPerSecond > 0.0) ? clip->ticksPerSecond : 30.0;
+		player.Play(clip, asset, true, clip->duration * 0.5 / tps);
+
+		std::vector<XMFLOAT4X4> palette;
+		player.ComputeSkinMatrices(palette);
+
+		WorkerPool pool;
+		pool.Start(WorkerPool::DefaultWorkerCount());
+
+		std::vector<XMFLOAT3> refPos, refNrm, simdPos, simdNrm, dqPos, dqNrm;
+		std::vector<SkinDualQuat> dualQuats;
+
+		for (int m = 0; m < static_cast<int>(asset->meshes.size()); ++m)
+		{
+			const MeshAsset& mesh = asset->meshes[m];
+			if (!mesh.skinned || mesh.cpuVertices.empty()) continue;
+
+			SkinningResult r;
+			r.meshIndex = m;
+			r.vertexCount = static_cast<int>(mesh.cpuVertices.size());
+			r.threadCount = pool.GetThreadCount();
+
+			refPos.resize(r.vertexCount);
+			refNrm.resize(r.vertexCount);
+
+			double start = SystemTimer_GetAbsoluteTime();
+			for (int i = 0; i < iterations; ++i)
+			{
+				AnimationSkinning_SkinReference(mesh.cpuVertices.data(), r.vertexCount,
+					palette.data(), static_cast<int>(palette.size()), refPos.data(), refNrm.data());
+			}
+			r.referenceUs = (SystemTimer_GetAbsoluteTime() - start) * 1.0e6 / iterations;
+
+			start = SystemTimer_GetAbsoluteTime();
+			for (int i = 0; i < iterations; ++i)
+			{
+				AnimationSkinning_SkinMesh(mesh, palette, simdPos, simdNrm);
+			}
+			r.simdUs = (SystemTimer_GetAbsoluteTime() - start) * 1.0e6 / iterations;
+
+			r.maxPositionDiff = MaxFloat3Diff(refPos, simdPos);
+			r.maxNormalDiff = MaxFloat3Diff(refNrm, simdNrm);
+
+			start = SystemTimer_GetAbsoluteTime();
+			for (int i = 0; i < iterations; ++i)
+			{
+				AnimationSkinning_SkinMesh(mesh, palette, simdPos, simdNrm, &pool);
+			}
+			r.parallelUs = (SystemTimer_GetAbsoluteTime() - start) * 1.0e6 / iterations;
+
+			start = SystemTimer_GetAbsoluteTime();
+			for (int i = 0; i < iterations; ++i)
+			{
+				AnimationSkinning_BuildDualQuatPalette(palette, dualQuats);
+			}
+			r.dualQuatPaletteUs = (SystemTimer_GetAbsoluteTime() - start) * 1.0e6 / iterations;
+
+			dqPos.resize(r.vertexCount);
+			dqNrm.resize(r.vertexCount);
+
+			start = SystemTimer_GetAbsoluteTime();
+			for (int i = 0; i < iterations; ++i)
+			{
+				AnimationSkinning_SkinDualQuat(mesh.cpuVertices.data(), r.vertexCount,
+					dualQuats.data(), static_cast<int>(dualQuats.size()), dqPos.data(), dqNrm.data());
+			}
+			r.dualQuatUs = (SystemTimer_GetAbsoluteTime() - start) * 1.0e6 / iterations;
+
+			r.maxDualQuatDiff = MaxFloat3Diff(refPos, dqPos);
+
+			char buf[256];
+			sprintf_s(buf, "[AnimBench] skinning mesh %d (%d verts) : ref %.1f us / simd %.1f us / %d threads %.1f us, diff pos %.6f nrm %.6f\n",
+				r.meshIndex, r.vertexCount, r.referenceUs, r.simdUs, r.threadCount, r.parallelUs, r.maxPositionDiff, r.maxNormalDiff);
+			OutputDebugStringA(buf);
+
+			sprintf_s(buf, "[AnimBench] dual quat mesh %d : palette %.1f us / skin %.1f us, vs linear blend %.6f\n",
+				r.meshIndex, r.dualQuatPaletteUs, r.dualQuatUs, r.maxDualQuatDiff);
+			OutputDebugStringA(buf);
+
+			outResults.push_back(r);
+		}
+
+		pool.Stop();
+	}
+
+	void RunBake(const ModelAsset* asset, bool vertexPositions, int instanceCount, std::vector<BakeResult>& outResults)
+	{
+		outResults.clear();
+
+		if (!asset || instanceCount <= 0) return;
+
+		AnimationManager& manager = AnimationManager::Instance();
+
+		AnimationBakeSettings settings;
+		settings.layout = vertexPositions ? BakedAnimationLayout::VertexPositions : BakedAnimationLayout::BonePalette;
+
+		std::vector<XMFLOAT4X4> palette;
+		std::vector<XMFLOAT3> positions, normals;
+
+		for (int c = 0; c < manager.GetClipCount(); ++c)
+		{
+			const AnimationClip* clip = manager.GetClipById(c);
+			if (!clip || clip->sourcePath.empty()) continue;
+
+			BakeResult r;
+			r.clipName = clip->animName;
+
+			const std::string path = AnimationBake_GetBakedPath(clip->sourcePath.c_str());
+
+			AnimationBakeReport report;
+			const double start = SystemTimer_GetAbsoluteTime();
+			const bool written = AnimationBake_Write(asset, clip, settings, path.c_str(), &report);
+			r.bakeMs = (SystemTimer_GetAbsoluteTime() - start) * 1000.0;
+
+			BakedAnimation* baked = written ? AnimationBake_Load(path.c_str()) : nullptr;
+			r.loaded = (baked != nullptr);
+
+			if (!baked)
+			{
+				outResults.push_back(r);
+				continue;
+			}
+
+			r.frameCount = report.frameCount;
+			r.texelsPerFrame = report.texelsPerFrame;
+			r.fileBytes = report.fileBytes;
+
+			// Frame f against the player at the time it was baked from
+			AnimationPlayer player;
+			for (int f = 0; f < baked->frameCount; ++f)
+			{
+				double timeSec = f / baked->sampleRate;
+				if (timeSec >= baked->durationSec) timeSec = baked->durationSec * (1.0 - 1.0e-9);
+
+				player.Play(clip, asset, clip->loop, timeSec);
+				player.ComputeSkinMatrices(palette);
+
+				if (baked->layout == BakedAnimationLayout::BonePalette)
+				{
+					const XMFLOAT4X4* frame = AnimationBake_GetPaletteFrame(*baked, f);
+					for (int b = 0; b < baked->boneCount && b < static_cast<int>(palette.size()); ++b)
+					{
+						for (int e = 0; e < 16; ++e)
+						{
+							r.maxDiff = std::max(r.maxDiff, std::fabs(frame[b].m[e / 4][e % 4] - palette[b].m[e / 4][e % 4]));
+						}
+					}
+					continue;
+				}
+
+				const XMFLOAT4* frame = AnimationBake_GetPositionFrame(*baked, f);
+				for (const BakedMeshRange& range : baked->meshes)
+				{
+					AnimationSkinning_SkinMesh(asset->meshes[range.meshIndex], palette, positions, normals);
+					for (int v = 0; v < range.vertexCount; ++v)
+					{
+						const XMFLOAT4& t = frame[range.firstTexel + v];
+						r.maxDiff = std::max(r.maxDiff, std::max(std::fabs(t.x - positions[v].x), std::max(std::fabs(t.y - positions[v].y), std::fabs(t.z - positions[v].z))));
+					}
+				}
+			}
+
+			// What a baked crowd costs per frame: one lookup per instance, nothing else
+			if (baked->layout == BakedAnimationLayout::BonePalette)
+			{
+				const int frames = 120;
+				uintptr_t sink = 0;
+
+				const double lookupStart = SystemTimer_GetAbsoluteTime();
+				for (int f = 0; f < frames; ++f)
+				{
+					const double now = f * BENCH_FRAME_TIME;
+					for (int i = 0; i < instanceCount; ++i)
+					{
+						sink += reinterpret_cast<uintptr_t>(AnimationBake_GetPaletteFrame(*baked, AnimationBake_FrameAt(*baked, now + i * CROWD_PHASE_STEP)));
+					}
+				}
+				r.lookupUsPerFrame = (SystemTimer_GetAbsoluteTime() - lookupStart) * 1.0e6 / frames;
+
+				if (sink == 0) r.lookupUsPerFrame = -1.0; // keeps the loop from being optimized away
+			}
+
+			char buf[256];
+			sprintf_s(buf, "[AnimBench] baked %s -> %s : %d frames x %d texels, %llu bytes, %.1f ms, diff %.6f, %d lookups %.2f us\n",
+				r.clipName.c_str(), path.c_str(), r.frameCount, r.texelsPerFrame, r.fileBytes, r.bakeMs, r.maxDiff, instanceCount, r.lookupUsPerFrame);
+			OutputDebugStringA(buf);
+
+			// Palette bakes become available to baked instances by clip name
+			BakedAnimationLibrary& library = BakedAnimationLibrary::Instance();
+			if (library.FindByName(baked->name, baked->layout) < 0)
+			{
+				library.Register(baked);
+			}
+			else
+			{
+				AnimationBake_Destroy(baked);
+			}
+
+			outResults.push_back(r);
+		}
+	}
+
+	void DrawDebugUI(const ModelAsset* asset)
+	{
+		if (!asset)
+		{
+			ImGui::TextDisabled("No animated asset");
+			return;
+		}
+
+		ImGui::InputInt("Iterations", &g_SamplingIterations);
+		if (g_SamplingIterations < 1) g_SamplingIterations = 1;
+
+		if (ImGui::Button("Run Sampling Bench"))
+		{
+			RunSampling(asset, g_SamplingIterations, g_SamplingResults);
+		}
+
+		for (const SamplingResult& r : g_SamplingResults)
+		{
+			const double speedup = (r.bindingUs > 0.0) ? r.stringMatchUs / r.bindingUs : 0.0;
+
+			ImGui::Text("%s (%d nodes, %d tracks)", r.clipName.c_str(), r.nodeCount, r.trackCount);
+			ImGui::Text("  name match %.2f us / binding %.2f us (x%.1f)", r.stringMatchUs, r.bindingUs, speedup);
+		}
+
+		ImGui::Separator();
+
+		ImGui::InputFloat("Error Threshold", &g_CompressionThreshold, 0.001f, 0.01f, "%.4f");
+		if (g_CompressionThreshold < 0.0f) g_CompressionThreshold = 0.0f;
+
+		if (ImGui::Button("Run Compression Report"))
+		{
+			AnimationCompressionSettings settings;
+			settings.errorThreshold = g_CompressionThreshold;
+			AnimationCompression_Report(asset, settings, g_CompressionReports);
+		}
+
+		for (const AnimationCompressionReport& r : g_CompressionReports)
+		{
+			ImGui::Text("%s : %zu -> %zu bytes (x%.2f)", r.clipName.c_str(), r.rawBytes, r.compressedBytes, r.Ratio());
+			ImGui::Text("  keys %d -> %d, error max %.5f / mean %.5f", r.rawKeys, r.keptKeys, r.maxError, r.meanError);
+		}
+
+		ImGui::Separator();
+
+		AnimationSystem& system = AnimationSystem::Instance();
+		ImGui::Text("AnimationSystem : %d instances, %d threads, %.3f ms", system.GetInstanceCount(), system.GetThreadCount(), system.GetLastUpdateMs());
+
+		// LOD of this asset
+		bool lodEnabled = system.IsLodEnabled();
+		if (ImGui::Checkbox("Animation LOD", &lodEnabled))
+		{
+			system.SetLodEnabled(lodEnabled);
+		}
+
+		AnimationLodSettings lod = system.GetLodSettings(asset);
+		bool lodChanged = false;
+		lodChanged |= ImGui::DragFloat("1/2 Rate Distance", &lod.halfRateDistance, 0.5f, 0.0f, 1000.0f);
+		lodChanged |= ImGui::DragFloat("1/4 Rate Distance", &lod.quarterRateDistance, 0.5f, 0.0f, 1000.0f);
+		lodChanged |= ImGui::DragFloat("Reduced Bones Distance", &lod.reducedBonesDistance, 0.5f, 0.0f, 1000.0f);
+		lodChanged |= ImGui::SliderInt("Reduced Bone Depth", &lod.reducedBoneDepth, 0, 32);
+		lodChanged |= ImGui::Checkbox("Skip Invisible", &lod.skipInvisible);
+		if (lodChanged)
+		{
+			system.SetLodSettings(asset, lod);
+		}
+
+		const AnimationLodStats& stats = system.GetLodStats();
+		ImGui::Text("  evaluated %d / interpolated %d / skipped %d", stats.evaluated, stats.interpolated, stats.skipped);
+		ImGui::Text("  bone evaluations %lld, saved by LOD %lld", stats.boneEvaluations, stats.savedBoneEvaluations);
+
+		const SkinningUploadStats& upload = Animation_GetSkinningUploadStats();
+		ImGui::Text("Skinning CB : %d uploads, %zu bytes / %d skipped, %zu bytes saved",
+			upload.uploads, upload.bytesUploaded, upload.skipped, upload.bytesSkipped);
+
+		ImGui::Separator();
+
+		ImGui::InputInt("Skinning Iterations", &g_SkinningIterations);
+		if (g_SkinningIterations < 1) g_SkinningIterations = 1;
+
+		if (ImGui::Button("Run CPU Skinning Bench"))
+		{
+			RunSkinning(asset, g_SkinningIterations, g_SkinningResults);
+		}
+
+		for (const SkinningResult& r : g_SkinningResults)
+		{
+			ImGui::Text("mesh %d (%d verts)", r.meshIndex, r.vertexCount);
+			ImGui::Text("  ref %.1f us / simd %.1f us / %d threads %.1f us", r.referenceUs, r.simdUs, r.threadCount, r.parallelUs);
+			ImGui::Text("  diff pos %.6f / normal %.6f", r.maxPositionDiff, r.maxNormalDiff);
+			ImGui::Text("  dual quat : palette %.1f us / skin %.1f us, vs linear blend %.6f", r.dualQuatPaletteUs, r.dualQuatUs, r.maxDualQuatDiff);
+		}
+
+		ImGui::Separator();
+
+		ImGui::Checkbox("Bake Vertex Positions", &g_BakeVertexPositions);
+		ImGui::InputInt("Baked Instances", &g_BakeInstances);
+		if (g_BakeInstances < 1) g_BakeInstances = 1;
+
+		if (ImGui::Button("Bake Clips (.vat)"))
+		{
+			RunBake(asset, g_BakeVertexPositions, g_BakeInstances, g_BakeResults);
+		}
+
+		for (const BakeResult& r : g_BakeResults)
+		{
+			if (!r.loaded)
+			{
+				ImGui::Text("%s : bake failed", r.clipName.c_str());
+				continue;
+			}
+
+			ImGui::Text("%s : %d frames x %d texels, %.1f KB, baked in %.1f ms", r.clipName.c_str(), r.frameCount, r.texelsPerFrame, r.fileBytes / 1024.0, r.bakeMs);
+			ImGui::Text("  diff %.6f, %d instance lookups %.2f us/frame", r.maxDiff, g_BakeInstances, r.lookupUsPerFrame);
+		}
+		ImGui::Text("Baked library : %d clips", BakedAnimationLibrary::Instance().GetClipCount());
+	}
+}
+
+static float MaxFloat3Diff(const std::vector<XMFLOAT3>& a, const std::vector<XMFLOAT3>& b)
+{
+	float maxDiff = 0.0f;
+
+	const size_t n = std::min(a.size(), b.size());
+	for (size_t i = 0; i < n; ++i)
+	{
+		maxDiff = std::max(maxDiff, std::fabs(a[i].x - b[i].x));
+		maxDiff = std::max(maxDiff, std::fabs(a[i].y - b[i].y));
+		maxDiff = std::max(maxDiff, std::fabs(a[i].z - b[i].z));
+	}
+
+	return maxDiff;
+}
@@ -0,0 +1,78 @@
+/*==============================================================================
+
+   Animation micro benchmarks [animation_bench.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_BENCH_H
+#define ANIMATION_BENCH_H
+
+#include <string>
+#include <vector>
+
+struct ModelAsset;
+
+namespace AnimationBench
+{
+	// Pose sampling: name matching every sample vs cached binding
+	struct SamplingResult
+	{
+		std::string clipName;
+		int nodeCount = 0;
+		int trackCount = 0;
+		int iterations = 0;
+
+		double stringMatchUs = 0.0; // per pose, old path (resolve by name every frame)
+		double bindingUs = 0.0;     // per pose, binding resolved once at Play()
+	};
+
+	// Runs every clip registered in AnimationManager against the asset
+	void RunSampling(const ModelAsset* asset, int iterations, std::vector<SamplingResult>& outResults);
+
+	// CPU skinning of every skinned mesh: scalar reference vs SIMD vs SIMD on the worker pool
+	struct SkinningResult
+	{
+		int meshIndex = 0;
+		int vertexCount = 0;
+		int threadCount = 0;
+
+		double referenceUs = 0.0;
+		double simdUs = 0.0;
+		double parallelUs = 0.0;
+		float maxPositionDiff = 0.0f; // SIMD vs reference
+		float maxNormalDiff = 0.0f;
+
+		// SkinningMethod::DualQuaternion on the same pose
+		double dualQuatPaletteUs = 0.0; // matrices -> dual quaternions, whole palette
+		double dualQuatUs = 0.0;
+		float maxDualQuatDiff = 0.0f;   // vs linear blend: where the two methods disagree, not an error
+	};
+
+	// Pose: middle of the first registered clip
+	void RunSkinning(const ModelAsset* asset, int iterations, std::vector<SkinningResult>& outResults);
+
+	// Baked crowd: every registered clip baked to .vat, loaded back and compared with the player
+	// at the frame times, then instanceCount lookups (clip id + time offset) timed (AnimationSystem crowd: tools/crowd_bench.cpp)
+	struct BakeResult
+	{
+		std::string clipName;
+		int frameCount = 0;
+		int texelsPerFrame = 0;
+		unsigned long long fileBytes = 0;
+
+		double bakeMs = 0.0;
+		double lookupUsPerFrame = 0.0; // instanceCount palette lookups
+		float maxDiff = 0.0f;          // largest matrix element / position component difference
+		bool loaded = false;
+	};
+
+	void RunBake(const ModelAsset* asset, bool vertexPositions, int instanceCount, std::vector<BakeResult>& outResults);
+
+	// Inspector panel
+	void DrawDebugUI(const ModelAsset* asset);
+}
+
+#endif // ANIMATION_BENCH_H
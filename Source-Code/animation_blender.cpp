@@ -0,0 +1,619 @@
+/*==============================================================================
+
+   Animation crossfade / blend layers [animation_blender.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_blender.h"
+#include "skeleton_runtime.h"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace DirectX;
+
+static void AddPoses(const LocalPoseSoA& base, const LocalPoseSoA& add, const LocalPoseSoA& reference, float weight, const float* mask, LocalPoseSoA& out);
+static void QuatMultiplySoA(const XMVECTOR* p, const XMVECTOR* q, XMVECTOR* out);
+static void NormalizeQuatSoA(XMVECTOR* q);
+static void SampleReferencePose(const AnimationClip* clip, const ModelAsset* asset, LocalPoseSoA& outPose);
+
+
+bool AnimationBlender_BuildBoneMask(const SkeletonRuntime& skel, const char* rootNodeName, BoneMask& outMask, float weight)
+{
+	const int nodeCount = skel.NodeCount();
+	outMask.weights.assign(nodeCount, 0.0f);
+
+	if (!rootNodeName) return false;
+
+	int root = -1;
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		const char* name = skel.names[i].c_str();
+		if (strcmp(name, rootNodeName) == 0 || strcmp(SkeletonUtil::GetShortName(name), rootNodeName) == 0)
+		{
+			root = i;
+			break;
+		}
+	}
+
+	if (root < 0) return false;
+
+	// Parent-ordered: descendants of root always come after it
+	std::vector<uint8_t> inMask(nodeCount, 0);
+	inMask[root] = 1;
+	outMask.weights[root] = weight;
+
+	for (int i = root + 1; i < nodeCount; ++i)
+	{
+		const int parent = skel.parentIndex[i];
+		if (parent >= 0 && inMask[parent])
+		{
+			inMask[i] = 1;
+			outMask.weights[i] = weight;
+		}
+	}
+
+	return true;
+}
+
+
+// ------------------------------------------
+// Animation Blender
+// ------------------------------------------
+
+void AnimationBlender::Initialize(const ModelAsset* asset, int layerCount)
+{
+	m_Asset = asset;
+
+	m_Layers.clear();
+	m_Layers.resize(layerCount > 0 ? layerCount : 1);
+
+	m_PoseUsed = 0;
+	m_Events.Clear();
+}
+
+void AnimationBlender::Finalize()
+{
+	m_Layers.clear();
+	m_PosePool.clear();
+	m_PoseUsed = 0;
+	m_Asset = nullptr;
+	m_RootMotion = RootMotionDelta();
+	m_Events.Clear();
+}
+
+void AnimationBlender::CrossFade(int layer, const AnimationClip* clip, bool loop, double fadeSec)
+{
+	if (layer < 0 || layer >= GetLayerCount()) return;
+
+	Layer& l = m_Layers[layer];
+
+	// Same clip still running: keep it, no restart
+	if (clip && l.current.GetCurrentClip() == clip && l.current.IsPLaying()) return;
+
+	BeginFade(l, fadeSec);
+
+	l.current.Play(clip, m_Asset, loop, 0.0);
+
+	if (l.mode == BlendLayerMode::Additive)
+	{
+		SampleReferencePose(clip, m_Asset, l.referencePose);
+	}
+}
+
+void AnimationBlender::CrossFade(int layer, AnimationClipHandle clip, bool loop, double fadeSec)
+{
+	if (layer < 0 || layer >= GetLayerCount()) return;
+
+	const AnimationManager& manager = AnimationManager::Instance();
+	if (manager.GetLoadState(clip) != ClipLoadState::Pending)
+	{
+		CrossFade(layer, manager.ResolveClip(clip), loop, fadeSec);
+		return;
+	}
+
+	Layer& l = m_Layers[layer];
+
+	// Already waiting for it
+	if (l.current.IsWaitingForClip() && l.current.GetPendingClip().id == clip.id) return;
+
+	BeginFade(l, fadeSec);
+
+	// The reference pose is taken when the clip arrives (Update)
+	l.current.Play(clip, m_Asset, loop, 0.0);
+	l.referencePose = LocalPoseSoA();
+}
+
+void AnimationBlender::StopLayer(int layer)
+{
+	if (layer < 0 || layer >= GetLayerCount()) return;
+
+	Layer& l = m_Layers[layer];
+	l.current.Play(nullptr, nullptr);
+	l.previous.Play(nullptr, nullptr);
+	l.frozen = false;
+	l.fadeTime = 0.0;
+	l.fadeDuration = 0.0;
+}
+
+void AnimationBlender::SetLayerWeight(int layer, float weight)
+{
+	if (layer < 0 || layer >= GetLayerCount()) return;
+
+	m_Layers[layer].weight = std::min(std::max(weight, 0.0f), 1.0f);
+}
+
+void AnimationBlender::SetLayerMode(int layer, BlendLayerMode mode)
+{
+	if (layer < 0 || layer >= GetLayerCount()) return;
+
+	Layer& l = m_Layers[layer];
+	if (l.mode == mode) return;
+
+	l.mode = mode;
+
+	if (mode == BlendLayerMode::Additive)
+	{
+		l.previous.Play(nullptr, nullptr);
+		l.frozen = false;
+		SampleReferencePose(l.current.GetCurrentClip(), m_Asset, l.referencePose);
+	}
+}
+
+void AnimationBlender::SetLayerMask(int layer, const BoneMask* mask)
+{
+	if (layer < 0 || layer >= GetLayerCount()) return;
+
+	Layer& l = m_Layers[layer];
+	l.mask.clear();
+
+	if (!mask || !m_Asset) return;
+
+	// Padded to the pose stride so the blend loop can load 4 weights at a time
+	const int nodeCount = m_Asset->skeleton.NodeCount();
+	const int stride = (nodeCount + 3) & ~3;
+	const int copyCount = std::min(nodeCount, static_cast<int>(mask->weights.size()));
+
+	l.mask.assign(stride, 0.0f);
+	std::copy(mask->weights.begin(), mask->weights.begin() + copyCount, l.mask.begin());
+}
+
+void AnimationBlender::Update(double elapsed_time)
+{
+	for (Layer& l : m_Layers)
+	{
+		// Only the clip fading in reports events (CrossFade swaps the players)
+		l.current.SetEventQueue(&m_Events);
+		l.previous.SetEventQueue(nullptr);
+
+		const bool waiting = l.current.IsWaitingForClip();
+		l.current.Update(elapsed_time);
+
+		// Loaded this frame
+		if (waiting && l.current.GetCurrentClip() && l.mode == BlendLayerMode::Additive)
+		{
+			SampleReferencePose(l.current.GetCurrentClip(), m_Asset, l.referencePose);
+		}
+
+		if (l.fadeTime < l.fadeDuration)
+		{
+			l.previous.Update(elapsed_time);
+			l.fadeTime += elapsed_time;
+		}
+
+		if (l.fadeTime >= l.fadeDuration && (l.previous.GetCurrentClip() || l.previous.IsWaitingForClip()))
+		{
+			l.previous.Play(nullptr, nullptr);
+		}
+		if (l.fadeTime >= l.fadeDuration)
+		{
+			l.frozen = false;
+		}
+	}
+
+	// Upper layers (masked / additive) never move the character
+	m_RootMotion = RootMotionDelta();
+
+	if (!m_Layers.empty())
+	{
+		const Layer& base = m_Layers[0];
+		const float alpha = GetFadeAlpha(base);
+
+		const RootMotionDelta& cur = base.current.GetRootMotionDelta();
+		const RootMotionDelta& prev = base.previous.GetRootMotionDelta();
+		const float prevWeight = base.previous.GetCurrentClip() ? 1.0f - alpha : 0.0f;
+
+		m_RootMotion.translation.x = cur.translation.x * alpha + prev.translation.x * prevWeight;
+		m_RootMotion.translation.z = cur.translation.z * alpha + prev.translation.z * prevWeight;
+		m_RootMotion.yaw = cur.yaw * alpha + prev.yaw * prevWeight;
+	}
+}
+
+bool AnimationBlender::HasRootMotion() const
+{
+	if (m_Layers.empty()) return false;
+
+	return m_Layers[0].current.HasRootMotion() || m_Layers[0].previous.HasRootMotion();
+}
+
+const AnimationClip* AnimationBlender::GetCurrentClip(int layer) const
+{
+	if (layer < 0 || layer >= GetLayerCount()) return nullptr;
+
+	return m_Layers[layer].current.GetCurrentClip();
+}
+
+bool AnimationBlender::IsFading(int layer) const
+{
+	if (layer < 0 || layer >= GetLayerCount()) return false;
+
+	return m_Layers[layer].fadeTime < m_Layers[layer].fadeDuration;
+}
+
+bool AnimationBlender::IsLayerPlaying(int layer) const
+{
+	if (layer < 0 || layer >= GetLayerCount()) return false;
+
+	return m_Layers[layer].current.IsPLaying();
+}
+
+PoseView AnimationBlender::GetCurrentPose() const
+{
+	PoseView view;
+	view.data = m_ModelPose.data();
+	view.count = static_cast<int>(m_ModelPose.size());
+	return view;
+}
+
+void AnimationBlender::ComputeSkinMatrices(std::vector<XMFLOAT4X4>& outBoneMatrix) const
+{
+	outBoneMatrix.clear();
+
+	if (!m_Asset) return;
+	if (m_Asset->skeleton.NodeCount() == 0) return;
+
+	m_PoseUsed = 0;
+
+	bool animYup = m_Asset->sourceYup;
+	const LocalPoseSoA* pose = EvaluatePose(animYup, -1);
+	if (!pose) return;
+
+	ComputeSkinMatrices(*pose, animYup, outBoneMatrix);
+}
+
+bool AnimationBlender::EvaluateLocalPose(LocalPoseSoA& outPose, bool& outAnimYup, int maxDepth) const
+{
+	if (!m_Asset || m_Asset->skeleton.NodeCount() == 0) return false;
+
+	m_PoseUsed = 0;
+
+	outAnimYup = m_Asset->sourceYup;
+	const LocalPoseSoA* pose = EvaluatePose(outAnimYup, maxDepth);
+	if (!pose) return false;
+
+	outPose = *pose; // same size every frame, no reallocation
+	return true;
+}
+
+void AnimationBlender::ComputeSkinMatrices(const LocalPoseSoA& pose, bool animYup, std::vector<XMFLOAT4X4>& outBoneMatrix) const
+{
+	outBoneMatrix.clear();
+
+	if (!m_Asset) return;
+	if (pose.count != m_Asset->skeleton.NodeCount()) return;
+
+	AnimationSampler_ComposeLocalMatrices(pose, m_Asset->skeleton, m_LocalPose);
+	Animation_BuildSkinMatrices(m_Asset, animYup, m_LocalPose, m_ModelPose, outBoneMatrix);
+}
+
+void AnimationBlender::BeginFade(Layer& l, double fadeSec)
+{
+	if (fadeSec > 0.0 && l.mode == BlendLayerMode::Override && (l.current.GetCurrentClip() || l.current.IsWaitingForClip()))
+	{
+		// Fade in progress: the pose on screen is a blend of two clips, dropping either one snaps.
+		// That blend is frozen as it is and fades out (main thread, between AnimationSystem updates)
+		const bool fading = GetFadeAlpha(l) < 1.0f && (l.frozen || l.previous.GetCurrentClip() || l.previous.IsWaitingForClip());
+
+		const LocalPoseSoA* pose = nullptr;
+		if (fading)
+		{
+			m_PoseUsed = 0;
+			pose = EvaluateLayer(l, -1); // reads the frozen pose of an earlier interruption
+		}
+
+		l.frozen = (pose != nullptr);
+		if (pose) l.frozenPose = *pose;
+
+		// Fade out from the current clip (or the bind pose of a clip that never arrived)
+		std::swap(l.previous, l.current);
+	}
+	else
+	{
+		l.previous.Play(nullptr, nullptr);
+		l.frozen = false;
+	}
+
+	// Additive layers have no fade-out pose, the new clip fades in by weight instead
+	l.fadeTime = 0.0;
+	l.fadeDuration = (fadeSec > 0.0) ? fadeSec : 0.0;
+}
+
+LocalPoseSoA* AnimationBlender::AcquirePose() const
+{
+	if (m_PoseUsed == static_cast<int>(m_PosePool.size()))
+	{
+		m_PosePool.emplace_back(new LocalPoseSoA());
+	}
+
+	return m_PosePool[m_PoseUsed++].get();
+}
+
+float AnimationBlender::GetFadeAlpha(const Layer& layer) const
+{
+	if (layer.fadeDuration <= 0.0 || layer.fadeTime >= layer.fadeDuration) return 1.0f;
+
+	return static_cast<float>(layer.fadeTime / layer.fadeDuration);
+}
+
+LocalPoseSoA* AnimationBlender::EvaluateLayer(const Layer& layer, int maxDepth) const
+{
+	// Loading: an override layer holds the bind pose, an additive one adds nothing yet
+	const bool waiting = layer.current.IsWaitingForClip() && layer.mode == BlendLayerMode::Override;
+	if (!layer.current.GetCurrentClip() && !waiting) return nullptr;
+
+	LocalPoseSoA* pose = AcquirePose();
+	layer.current.SamplePose(*pose, maxDepth);
+
+	const float alpha = GetFadeAlpha(layer);
+	if (alpha < 1.0f && layer.frozen && layer.frozenPose.count == pose->count)
+	{
+		AnimationBlender_BlendPoses(layer.frozenPose, *pose, alpha, nullptr, *pose);
+	}
+	else if (alpha < 1.0f && (layer.previous.GetCurrentClip() || layer.previous.IsWaitingForClip()))
+	{
+		LocalPoseSoA* prev = AcquirePose();
+		layer.previous.SamplePose(*prev, maxDepth);
+
+		AnimationBlender_BlendPoses(*prev, *pose, alpha, nullptr, *pose);
+	}
+
+	return pose;
+}
+
+// Layers in order on top of the first active one (its weight and mode are ignored, nothing is below it)
+const LocalPoseSoA* AnimationBlender::EvaluatePose(bool& outAnimYup, int maxDepth) const
+{
+	LocalPoseSoA* result = nullptr;
+
+	for (const Layer& l : m_Layers)
+	{
+		if (!result)
+		{
+			result = EvaluateLayer(l, maxDepth);
+			if (result)
+			{
+				outAnimYup = l.current.GetAnimYup();
+			}
+			continue;
+		}
+
+		if (l.weight <= 0.0f) continue;
+
+		LocalPoseSoA* pose = EvaluateLayer(l, maxDepth);
+		if (!pose) continue;
+
+		const float* mask = l.mask.empty() ? nullptr : l.mask.data();
+
+		if (l.mode == BlendLayerMode::Additive)
+		{
+			if (l.referencePose.count != pose->count) continue;
+
+			AddPoses(*result, *pose, l.referencePose, l.weight * GetFadeAlpha(l), mask, *pose);
+		}
+		else
+		{
+			AnimationBlender_BlendPoses(*result, *pose, l.weight, mask, *pose);
+		}
+
+		result = pose;
+	}
+
+	return result;
+}
+
+
+void AnimationBlender_BlendPoses(const LocalPoseSoA& a, const LocalPoseSoA& b, float weight, const float* mask, LocalPoseSoA& out)
+{
+	out.Resize(a.count);
+
+	const XMVECTOR zero = XMVectorZero();
+	const XMVECTOR splatWeight = XMVectorReplicate(weight);
+
+	for (int g = 0; g < a.stride; g += 4)
+	{
+		const XMVECTOR w = mask ? XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mask[g])), splatWeight) : splatWeight;
+
+		auto load = [g](const LocalPoseSoA& p, int lane) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&p.Lane(lane)[g])); };
+		auto store = [g, &out](int lane, FXMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&out.Lane(lane)[g]), v); };
+
+		const XMVECTOR ra[4] = { load(a, POSE_RX), load(a, POSE_RY), load(a, POSE_RZ), load(a, POSE_RW) };
+		XMVECTOR rb[4] = { load(b, POSE_RX), load(b, POSE_RY), load(b, POSE_RZ), load(b, POSE_RW) };
+
+		XMVECTOR dot = XMVectorMultiply(ra[0], rb[0]);
+		dot = XMVectorMultiplyAdd(ra[1], rb[1], dot);
+		dot = XMVectorMultiplyAdd(ra[2], rb[2], dot);
+		dot = XMVectorMultiplyAdd(ra[3], rb[3], dot);
+
+		const XMVECTOR flip = XMVectorLess(dot, zero);
+
+		XMVECTOR rot[4];
+		for (int c = 0; c < 4; ++c)
+		{
+			rb[c] = XMVectorSelect(rb[c], XMVectorNegate(rb[c]), flip);
+			rot[c] = XMVectorLerpV(ra[c], rb[c], w);
+		}
+		NormalizeQuatSoA(rot);
+
+		for (int lane = POSE_TX; lane <= POSE_TZ; ++lane)
+		{
+			store(lane, XMVectorLerpV(load(a, lane), load(b, lane), w));
+		}
+		for (int lane = POSE_SX; lane <= POSE_SZ; ++lane)
+		{
+			store(lane, XMVectorLerpV(load(a, lane), load(b, lane), w));
+		}
+
+		store(POSE_RX, rot[0]);
+		store(POSE_RY, rot[1]);
+		store(POSE_RZ, rot[2]);
+		store(POSE_RW, rot[3]);
+	}
+
+	// Exact bindLocal only where every contributing pose is bind
+	for (int i = 0; i < a.count; ++i)
+	{
+		const float wi = mask ? mask[i] * weight : weight;
+		out.bind[i] = (wi <= 0.0f) ? a.bind[i] : (wi >= 1.0f) ? b.bind[i] : static_cast<uint8_t>(a.bind[i] && b.bind[i]);
+	}
+}
+
+// Difference of 'add' against its frame 0 ('reference'), scaled by weight * mask, applied on top of base
+//   T = base + w * (add - ref)
+//   R = base * nlerp(identity, inverse(ref) * add, w)  (Hamilton order)
+//   S = base * lerp(1, add / ref, w)
+// out may alias base or add
+static void AddPoses(const LocalPoseSoA& base, const LocalPoseSoA& add, const LocalPoseSoA& reference, float weight, const float* mask, LocalPoseSoA& out)
+{
+	out.Resize(base.count);
+
+	const XMVECTOR zero = XMVectorZero();
+	const XMVECTOR one = XMVectorSplatOne();
+	const XMVECTOR splatWeight = XMVectorReplicate(weight);
+
+	for (int g = 0; g < base.stride; g += 4)
+	{
+		const XMVECTOR w = mask ? XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mask[g])), splatWeight) : splatWeight;
+
+		auto load = [g](const LocalPoseSoA& p, int lane) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&p.Lane(lane)[g])); };
+		auto store = [g, &out](int lane, FXMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&out.Lane(lane)[g]), v); };
+
+		XMVECTOR t[3], s[3];
+		for (int c = 0; c < 3; ++c)
+		{
+			const XMVECTOR delta = XMVectorSubtract(load(add, POSE_TX + c), load(reference, POSE_TX + c));
+			t[c] = XMVectorMultiplyAdd(delta, w, load(base, POSE_TX + c));
+
+			const XMVECTOR ratio = XMVectorDivide(load(add, POSE_SX + c), XMVectorMax(load(reference, POSE_SX + c), g_XMEpsilon));
+			s[c] = XMVectorMultiply(load(base, POSE_SX + c), XMVectorLerpV(one, ratio, w));
+		}
+
+		// delta = conjugate(ref) * add
+		const XMVECTOR refConj[4] =
+		{
+			XMVectorNegate(load(reference, POSE_RX)),
+			XMVectorNegate(load(reference, POSE_RY)),
+			XMVectorNegate(load(reference, POSE_RZ)),
+			load(reference, POSE_RW),
+		};
+		const XMVECTOR addRot[4] = { load(add, POSE_RX), load(add, POSE_RY), load(add, POSE_RZ), load(add, POSE_RW) };
+
+		XMVECTOR delta[4];
+		QuatMultiplySoA(refConj, addRot, delta);
+
+		// Shortest arc, then scale the angle by w
+		const XMVECTOR flip = XMVectorLess(delta[3], zero);
+		for (int c = 0; c < 4; ++c)
+		{
+			delta[c] = XMVectorSelect(delta[c], XMVectorNegate(delta[c]), flip);
+			delta[c] = XMVectorMultiply(delta[c], w);
+		}
+		delta[3] = XMVectorAdd(delta[3], XMVectorSubtract(one, w));
+		NormalizeQuatSoA(delta);
+
+		const XMVECTOR baseRot[4] = { load(base, POSE_RX), load(base, POSE_RY), load(base, POSE_RZ), load(base, POSE_RW) };
+
+		XMVECTOR rot[4];
+		QuatMultiplySoA(baseRot, delta, rot);
+
+		for (int c = 0; c < 3; ++c)
+		{
+			store(POSE_TX + c, t[c]);
+			store(POSE_SX + c, s[c]);
+		}
+		store(POSE_RX, rot[0]);
+		store(POSE_RY, rot[1]);
+		store(POSE_RZ, rot[2]);
+		store(POSE_RW, rot[3]);
+	}
+
+	// A node without a track in 'add' has no delta (bind against bind)
+	for (int i = 0; i < base.count; ++i)
+	{
+		const float wi = mask ? mask[i] * weight : weight;
+		out.bind[i] = static_cast<uint8_t>(base.bind[i] && (wi <= 0.0f || add.bind[i]));
+	}
+}
+
+// Hamilton product p * q, 4 quaternions per call (x, y, z, w rows)
+// Same as XMQuaternionMultiply(q, p)
+static void QuatMultiplySoA(const XMVECTOR* p, const XMVECTOR* q, XMVECTOR* out)
+{
+	const XMVECTOR px = p[0], py = p[1], pz = p[2], pw = p[3];
+	const XMVECTOR qx = q[0], qy = q[1], qz = q[2], qw = q[3];
+
+	XMVECTOR x = XMVectorMultiply(pw, qx);
+	x = XMVectorMultiplyAdd(px, qw, x);
+	x = XMVectorMultiplyAdd(py, qz, x);
+	x = XMVectorNegativeMultiplySubtract(pz, qy, x);
+
+	XMVECTOR y = XMVectorMultiply(pw, qy);
+	y = XMVectorNegativeMultiplySubtract(px, qz, y);
+	y = XMVectorMultiplyAdd(py, qw, y);
+	y = XMVectorMultiplyAdd(pz, qx, y);
+
+	XMVECTOR z = XMVectorMultiply(pw, qz);
+	z = XMVectorMultiplyAdd(px, qy, z);
+	z = XMVectorNegativeMultiplySubtract(py, qx, z);
+	z = XMVectorMultiplyAdd(pz, qw, z);
+
+	XMVECTOR w = XMVectorMultiply(pw, qw);
+	w = XMVectorNegativeMultiplySubtract(px, qx, w);
+	w = XMVectorNegativeMultiplySubtract(py, qy, w);
+	w = XMVectorNegativeMultiplySubtract(pz, qz, w);
+
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+	out[3] = w;
+}
+
+static void NormalizeQuatSoA(XMVECTOR* q)
+{
+	XMVECTOR lenSq = XMVectorMultiply(q[0], q[0]);
+	lenSq = XMVectorMultiplyAdd(q[1], q[1], lenSq);
+	lenSq = XMVectorMultiplyAdd(q[2], q[2], lenSq);
+	lenSq = XMVectorMultiplyAdd(q[3], q[3], lenSq);
+
+	const XMVECTOR invLen = XMVectorReciprocalSqrt(XMVectorMax(lenSq, g_XMEpsilon));
+	for (int c = 0; c < 4; ++c)
+	{
+		q[c] = XMVectorMultiply(q[c], invLen);
+	}
+}
+
+// Frame 0 of an additive clip, sampled once when the clip is set
+static void SampleReferencePose(const AnimationClip* clip, const ModelAsset* asset, LocalPoseSoA& outPose)
+{
+	if (!clip || !asset)
+	{
+		outPose = LocalPoseSoA();
+		return;
+	}
+
+	AnimationPlayer player;
+	player.Play(clip, asset, false, 0.0);
+	player.SamplePose(outPose);
+}
@@ -0,0 +1,136 @@
+/*==============================================================================
+
+   Animation crossfade / blend layers [animation_blender.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_BLENDER_H
+#define ANIMATION_BLENDER_H
+
+#include <memory>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "animation.h"
+
+/*
+// -------------------------------
+AnimationBlender
+├─ layers[0..N) : evaluated in order, layer 0 is the base pose
+│   ├─ current / previous AnimationPlayer : CrossFade() moves current to previous
+│   │   └─ CrossFade() during a fade : the blended pose of that moment is frozen and
+│   │      fades out instead (no snap, however often the state changes)
+│   ├─ Override : lerp(result, layer, weight * mask)
+│   └─ Additive : result + (layer - layer frame 0) * weight * mask
+│   └─ CrossFade(handle) : clip still loading -> the layer holds the bind pose (override layers only)
+├─ events : current clip of every layer -> one AnimationEventQueue, drained by gameplay
+├─ blending runs on LocalPoseSoA (same T/R/S lanes as AnimationSampler_SamplePose)
+│   -> a crossfade costs two samples, one compose and one hierarchy pass
+└─ intermediate poses come from a pool that is kept across frames
+// -------------------------------
+*/
+
+enum class BlendLayerMode
+{
+	Override,
+	Additive,
+};
+
+// Per SkeletonRuntime node weight 0..1
+struct BoneMask
+{
+	std::vector<float> weights;
+};
+
+// weight for rootNodeName and all of its descendants, 0 for the rest
+// (e.g. "spine_01" -> upper body). Load-time only, compares node names
+bool AnimationBlender_BuildBoneMask(const SkeletonRuntime& skel, const char* rootNodeName, BoneMask& outMask, float weight = 1.0f);
+
+// out = lerp(a, b, weight * mask[i]), R by nlerp on the shortest arc. mask may be nullptr, out may alias a or b
+void AnimationBlender_BlendPoses(const LocalPoseSoA& a, const LocalPoseSoA& b, float weight, const float* mask, LocalPoseSoA& out);
+
+class AnimationBlender
+{
+private:
+
+	struct Layer
+	{
+		AnimationPlayer current;
+		AnimationPlayer previous;   // fading out, no clip when not fading
+		LocalPoseSoA frozenPose;    // fading out instead of previous when a fade was interrupted
+		bool frozen = false;        // (previous then only drives the root motion)
+		double fadeTime = 0.0;
+		double fadeDuration = 0.0;
+
+		float weight = 1.0f;
+		BlendLayerMode mode = BlendLayerMode::Override;
+
+		std::vector<float> mask;    // padded to the pose stride, empty = all nodes
+		LocalPoseSoA referencePose; // additive: frame 0 of the current clip
+	};
+
+	const ModelAsset* m_Asset = nullptr;
+	std::vector<Layer> m_Layers;
+
+	// Pose pool, reset every evaluation and only grows on the first frames
+	mutable std::vector<std::unique_ptr<LocalPoseSoA>> m_PosePool;
+	mutable int m_PoseUsed = 0;
+
+	mutable PoseMatrixBuffer m_LocalPose;
+	mutable PoseMatrixBuffer m_ModelPose;
+
+	RootMotionDelta m_RootMotion;
+	AnimationEventQueue m_Events; // filled by Update (on an AnimationSystem worker), drained on the main thread
+
+	LocalPoseSoA* AcquirePose() const;
+	float GetFadeAlpha(const Layer& layer) const;
+	void BeginFade(Layer& layer, double fadeSec);
+
+	// Current (and fading out) clip of one layer, nullptr if the layer has nothing to play
+	LocalPoseSoA* EvaluateLayer(const Layer& layer, int maxDepth) const;
+	const LocalPoseSoA* EvaluatePose(bool& outAnimYup, int maxDepth) const;
+
+public:
+
+	void Initialize(const ModelAsset* asset, int layerCount = 1);
+	void Finalize();
+
+	// fadeSec = 0 is a hard cut
+	void CrossFade(int layer, const AnimationClip* clip, bool loop = true, double fadeSec = 0.2);
+	void CrossFade(int layer, AnimationClipHandle clip, bool loop = true, double fadeSec = 0.2); // fades to the bind pose while loading
+	void StopLayer(int layer);
+
+	void SetLayerWeight(int layer, float weight);
+	void SetLayerMode(int layer, BlendLayerMode mode);
+	void SetLayerMask(int layer, const BoneMask* mask); // nullptr: all nodes
+
+	void Update(double elapsed_time);
+
+	int GetLayerCount() const { return static_cast<int>(m_Layers.size()); }
+	const ModelAsset* GetAsset() const { return m_Asset; }
+	const AnimationClip* GetCurrentClip(int layer) const;
+	bool IsFading(int layer) const;
+	bool IsLayerPlaying(int layer) const;
+	int GetPooledPoseCount() const { return static_cast<int>(m_PosePool.size()); }
+
+	PoseView GetCurrentPose() const; // model space, valid until the next ComputeSkinMatrices
+
+	// Root motion of the last Update: base layer only, current / previous clip weighted by the fade
+	bool HasRootMotion() const;
+	const RootMotionDelta& GetRootMotionDelta() const { return m_RootMotion; }
+
+	// Events crossed since the last drain, fading-out clips do not report
+	AnimationEventQueue& GetEvents() { return m_Events; }
+
+	void ComputeSkinMatrices(std::vector<DirectX::XMFLOAT4X4>& outBoneMatrix) const;
+
+	// Split form of ComputeSkinMatrices for animation LOD (pose kept / interpolated between updates)
+	// maxDepth >= 0 : nodes deeper than that keep the bind pose
+	bool EvaluateLocalPose(LocalPoseSoA& outPose, bool& outAnimYup, int maxDepth = -1) const;
+	void ComputeSkinMatrices(const LocalPoseSoA& pose, bool animYup, std::vector<DirectX::XMFLOAT4X4>& outBoneMatrix) const;
+};
+
+#endif // ANIMATION_BLENDER_H
@@ -0,0 +1,689 @@
+/*==============================================================================
+
+   Animation clip compression [animation_compression.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_compression.h"
+#include "animation.h"
+#include "model_asset.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace DirectX;
+
+static const float QUANT_MAX = 65535.0f;
+static const float QUAT_COMPONENT_MAX = 0.70710678f; // 1 / sqrt(2), range of the three smallest
+static const float QUAT_QUANT_MAX = 32767.0f;        // 15 bit
+static const uint32_t MAX_SEGMENT_KEYS = 256;        // bounds the O(n^2) reduction cost
+static const float REDUCTION_BUDGET = 0.75f;         // rest of the threshold is left to quantization (checked per channel)
+
+// Bind pose measures used to turn the model-space threshold into channel tolerances
+struct BoneErrorMetric
+{
+	float threshold = 0.0f;
+	float leverArm = 1.0f;    // farthest descendant joint (model space)
+	float parentScale = 1.0f; // bind pose scale of the parent node
+};
+
+static void BuildErrorMetrics(
+	const AnimationClip* clip,
+	const ModelAsset* asset,
+	const AnimationCompressionSettings& settings,
+	std::vector<BoneErrorMetric>& outMetrics
+);
+
+static void CompressVectorChannel(
+	const std::vector<VectorKey>& keys,
+	float tolerance,
+	float quantTolerance,
+	CompressedVectorChannel& out
+);
+static void CompressQuatChannel(
+	const std::vector<QuatKey>& keys,
+	float toleranceRad,
+	float quantToleranceRad,
+	CompressedQuatChannel& out
+);
+
+template<typename ErrorAt>
+static void ReduceKeys(uint32_t count, float tolerance, const ErrorAt& interpError, std::vector<uint32_t>& outKept);
+
+static void EncodeQuat(const XMFLOAT4& q, uint16_t* out);
+static XMFLOAT4 DecodeQuat(const uint16_t* in);
+static XMFLOAT4 DecodeQuatKey(const CompressedQuatChannel& channel, uint32_t key);
+static XMFLOAT3 DecodeVector(const CompressedVectorChannel& channel, uint32_t key);
+
+static float Distance3(const XMFLOAT3& a, const XMFLOAT3& b);
+static float QuatAngle(const XMFLOAT4& a, const XMFLOAT4& b);
+static XMFLOAT3 Lerp3(const XMFLOAT3& a, const XMFLOAT3& b, float t);
+static XMFLOAT4 SlerpShortest(const XMFLOAT4& a, const XMFLOAT4& b, float t);
+
+
+bool AnimationCompression_CompressClip(
+	AnimationClip* clip,
+	const ModelAsset* asset,
+	const AnimationCompressionSettings& settings
+)
+{
+	if (!clip || !asset) return false;
+	if (clip->IsCompressed()) return true;
+
+	std::vector<BoneErrorMetric> metrics;
+	BuildErrorMetrics(clip, asset, settings, metrics);
+
+	clip->compressedTracks.resize(clip->tracks.size());
+
+	for (size_t i = 0; i < clip->tracks.size(); ++i)
+	{
+		const BoneAnimTrack& track = clip->tracks[i];
+		const BoneErrorMetric& m = metrics[i];
+		CompressedTrack& out = clip->compressedTracks[i];
+
+		const float budget = m.threshold * REDUCTION_BUDGET;
+		const float quantBudget = m.threshold - budget;
+
+		CompressVectorChannel(track.positionKeys, budget / m.parentScale, quantBudget / m.parentScale, out.position);
+		CompressQuatChannel(track.rotationKeys, budget / m.leverArm, quantBudget / m.leverArm, out.rotation);
+		CompressVectorChannel(track.scaleKeys, budget / m.leverArm, quantBudget / m.leverArm, out.scale);
+
+		out.endTime = track.endTime;
+	}
+
+	if (settings.releaseRawKeys)
+	{
+		for (BoneAnimTrack& track : clip->tracks)
+		{
+			std::vector<VectorKey>().swap(track.positionKeys);
+			std::vector<QuatKey>().swap(track.rotationKeys);
+			std::vector<VectorKey>().swap(track.scaleKeys);
+		}
+	}
+
+	return true;
+}
+
+size_t AnimationCompression_RawBytes(const AnimationClip* clip)
+{
+	if (!clip) return 0;
+
+	size_t bytes = 0;
+	for (const BoneAnimTrack& t : clip->tracks)
+	{
+		bytes += t.positionKeys.size() * sizeof(VectorKey);
+		bytes += t.rotationKeys.size() * sizeof(QuatKey);
+		bytes += t.scaleKeys.size() * sizeof(VectorKey);
+	}
+
+	return bytes;
+}
+
+size_t AnimationCompression_CompressedBytes(const AnimationClip* clip)
+{
+	if (!clip) return 0;
+
+	size_t bytes = 0;
+	for (const CompressedTrack& t : clip->compressedTracks)
+	{
+		bytes += t.position.times.size() * sizeof(float) + t.position.values.size() * sizeof(uint16_t);
+		bytes += t.rotation.times.size() * sizeof(float) + t.rotation.values.size() * sizeof(uint16_t);
+		bytes += t.scale.times.size() * sizeof(float) + t.scale.values.size() * sizeof(uint16_t);
+
+		bytes += t.position.rawValues.size() * sizeof(XMFLOAT3) + t.scale.rawValues.size() * sizeof(XMFLOAT3);
+		bytes += t.rotation.rawValues.size() * sizeof(XMFLOAT4);
+
+		if (!t.position.times.empty()) bytes += sizeof(XMFLOAT3) * 2;
+		if (!t.scale.times.empty())    bytes += sizeof(XMFLOAT3) * 2;
+	}
+
+	return bytes;
+}
+
+// ------------------------------------------
+// Sampling
+// ------------------------------------------
+
+static float KeyFactor(float timeA, float timeB, double timeTicks)
+{
+	const double span = static_cast<double>(timeB) - timeA;
+	if (span <= 0.0) return 0.0f;
+
+	return static_cast<float>((timeTicks - timeA) / span);
+}
+
+static void SampleVectorChannel(const CompressedVectorChannel& channel, double timeTicks, uint32_t& cursor, XMFLOAT3& out)
+{
+	const uint32_t count = channel.KeyCount();
+	if (count == 0) return; // keep default value
+
+	const std::vector<float>& times = channel.times;
+	const uint32_t k = Animation_FindKeyIndex(count, [&times](uint32_t i) { return static_cast<double>(times[i]); }, timeTicks, cursor);
+
+	const XMFLOAT3 a = DecodeVector(channel, k);
+	if (k + 1 >= count || timeTicks <= times[k])
+	{
+		out = a;
+		return;
+	}
+
+	const XMFLOAT3 b = DecodeVector(channel, k + 1);
+	out = Lerp3(a, b, KeyFactor(times[k], times[k + 1], timeTicks));
+}
+
+static void SampleQuatChannel(const CompressedQuatChannel& channel, double timeTicks, uint32_t& cursor, XMFLOAT4& out)
+{
+	const uint32_t count = channel.KeyCount();
+	if (count == 0) return; // keep default value
+
+	const std::vector<float>& times = channel.times;
+	const uint32_t k = Animation_FindKeyIndex(count, [&times](uint32_t i) { return static_cast<double>(times[i]); }, timeTicks, cursor);
+
+	const XMFLOAT4 a = DecodeQuatKey(channel, k);
+	if (k + 1 >= count || timeTicks <= times[k])
+	{
+		out = a;
+		return;
+	}
+
+	const XMFLOAT4 b = DecodeQuatKey(channel, k + 1);
+	const float t = KeyFactor(times[k], times[k + 1], timeTicks);
+
+	XMStoreFloat4(&out, XMQuaternionSlerp(XMLoadFloat4(&a), XMLoadFloat4(&b), t));
+}
+
+void AnimationCompression_SampleTrack(
+	const CompressedTrack& track,
+	double timeTicks,
+	TrackCursor& cursor,
+	XMFLOAT3& outT,
+	XMFLOAT4& outR,
+	XMFLOAT3& outS
+)
+{
+	outT = XMFLOAT3(0, 0, 0);
+	outR = XMFLOAT4(0, 0, 0, 1);
+	outS = XMFLOAT3(1, 1, 1);
+
+	if (track.Empty()) return;
+
+	double duration = track.endTime;
+	if (duration > 0.0)
+	{
+		timeTicks = fmod(timeTicks, duration);
+		if (timeTicks < 0.0) timeTicks += duration;
+	}
+
+	SampleVectorChannel(track.position, timeTicks, cursor.pos, outT);
+	SampleQuatChannel(track.rotation, timeTicks, cursor.rot, outR);
+	SampleVectorChannel(track.scale, timeTicks, cursor.scl, outS);
+}
+
+static void VectorChannelKeyPair(const CompressedVectorChannel& channel, double timeTicks, uint32_t& cursor, XMFLOAT3& out0, XMFLOAT3& out1, float& outFactor)
+{
+	const uint32_t count = channel.KeyCount();
+	if (count == 0) return; // keep default value
+
+	const std::vector<float>& times = channel.times;
+	const uint32_t k = Animation_FindKeyIndex(count, [&times](uint32_t i) { return static_cast<double>(times[i]); }, timeTicks, cursor);
+
+	out0 = DecodeVector(channel, k);
+	if (k + 1 >= count || timeTicks <= times[k])
+	{
+		out1 = out0;
+		outFactor = 0.0f;
+		return;
+	}
+
+	out1 = DecodeVector(channel, k + 1);
+	outFactor = KeyFactor(times[k], times[k + 1], timeTicks);
+}
+
+static void QuatChannelKeyPair(const CompressedQuatChannel& channel, double timeTicks, uint32_t& cursor, XMFLOAT4& out0, XMFLOAT4& out1, float& outFactor)
+{
+	const uint32_t count = channel.KeyCount();
+	if (count == 0) return; // keep default value
+
+	const std::vector<float>& times = channel.times;
+	const uint32_t k = Animation_FindKeyIndex(count, [&times](uint32_t i) { return static_cast<double>(times[i]); }, timeTicks, cursor);
+
+	out0 = DecodeQuatKey(channel, k);
+	if (k + 1 >= count || timeTicks <= times[k])
+	{
+		out1 = out0;
+		outFactor = 0.0f;
+		return;
+	}
+
+	out1 = DecodeQuatKey(channel, k + 1);
+	outFactor = KeyFactor(times[k], times[k + 1], timeTicks);
+}
+
+void AnimationCompression_GetTrackKeyPair(
+	const CompressedTrack& track,
+	double timeTicks,
+	TrackCursor& cursor,
+	TrackKeyPair& out
+)
+{
+	out = TrackKeyPair();
+
+	if (track.Empty()) return;
+
+	double duration = track.endTime;
+	if (duration > 0.0)
+	{
+		timeTicks = fmod(timeTicks, duration);
+		if (timeTicks < 0.0) timeTicks += duration;
+	}
+
+	VectorChannelKeyPair(track.position, timeTicks, cursor.pos, out.t0, out.t1, out.ft);
+	QuatChannelKeyPair(track.rotation, timeTicks, cursor.rot, out.r0, out.r1, out.fr);
+	VectorChannelKeyPair(track.scale, timeTicks, cursor.scl, out.s0, out.s1, out.fs);
+}
+
+void AnimationCompression_GetLastKeys(
+	const CompressedTrack& track,
+	XMFLOAT3& outT,
+	XMFLOAT4& outR,
+	XMFLOAT3& outS
+)
+{
+	if (track.position.KeyCount() > 0) outT = DecodeVector(track.position, track.position.KeyCount() - 1);
+	if (track.rotation.KeyCount() > 0) outR = DecodeQuatKey(track.rotation, track.rotation.KeyCount() - 1);
+	if (track.scale.KeyCount() > 0)    outS = DecodeVector(track.scale, track.scale.KeyCount() - 1);
+}
+
+// ------------------------------------------
+// Compression helpers
+// ------------------------------------------
+
+static void BuildErrorMetrics(
+	const AnimationClip* clip,
+	const ModelAsset* asset,
+	const AnimationCompressionSettings& settings,
+	std::vector<BoneErrorMetric>& outMetrics
+)
+{
+	const SkeletonRuntime& skel = asset->skeleton;
+	const int nodeCount = skel.NodeCount();
+
+	// Bind pose in model space
+	std::vector<XMFLOAT4X4> bindModel(nodeCount);
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		XMMATRIX local = XMLoadFloat4x4(&skel.bindLocal[i]);
+		const int parent = skel.parentIndex[i];
+		XMMATRIX model = (parent >= 0) ? local * XMLoadFloat4x4(&bindModel[parent]) : local;
+		XMStoreFloat4x4(&bindModel[i], model);
+	}
+
+	// Farthest descendant joint, children come after parents so walk backwards
+	std::vector<float> leverArm(nodeCount, 0.0f);
+	for (int i = nodeCount - 1; i > 0; --i)
+	{
+		const int parent = skel.parentIndex[i];
+		if (parent < 0) continue;
+
+		const XMFLOAT3 p(bindModel[parent]._41, bindModel[parent]._42, bindModel[parent]._43);
+		const XMFLOAT3 c(bindModel[i]._41, bindModel[i]._42, bindModel[i]._43);
+
+		leverArm[parent] = std::max(leverArm[parent], Distance3(p, c) + leverArm[i]);
+	}
+
+	// Track -> node through the usual name matching
+	AnimationBinding binding;
+	Animation_ResolveBinding(clip, asset, binding);
+
+	std::vector<int> trackToNode(clip->tracks.size(), -1);
+	for (int i = 0; i < static_cast<int>(binding.nodeToTrack.size()); ++i)
+	{
+		if (binding.nodeToTrack[i] >= 0) trackToNode[binding.nodeToTrack[i]] = i;
+	}
+
+	outMetrics.assign(clip->tracks.size(), BoneErrorMetric());
+
+	for (size_t t = 0; t < clip->tracks.size(); ++t)
+	{
+		BoneErrorMetric& m = outMetrics[t];
+
+		auto it = settings.boneErrorThreshold.find(clip->tracks[t].nodeName);
+		m.threshold = (it != settings.boneErrorThreshold.end()) ? it->second : settings.errorThreshold;
+		m.leverArm = settings.minLeverArm;
+
+		const int node = trackToNode[t];
+		if (node < 0) continue;
+
+		m.leverArm = std::max(leverArm[node], settings.minLeverArm);
+
+		const int parent = skel.parentIndex[node];
+		if (parent >= 0)
+		{
+			const XMFLOAT4X4& pm = bindModel[parent];
+			const float sx = Distance3(XMFLOAT3(0, 0, 0), XMFLOAT3(pm._11, pm._12, pm._13));
+			const float sy = Distance3(XMFLOAT3(0, 0, 0), XMFLOAT3(pm._21, pm._22, pm._23));
+			const float sz = Distance3(XMFLOAT3(0, 0, 0), XMFLOAT3(pm._31, pm._32, pm._33));
+			m.parentScale = std::max(std::max(sx, sy), std::max(sz, 1.0e-6f));
+		}
+	}
+}
+
+// Greedy linear reduction: from each kept key, extend the segment while every
+// key inside it is reproduced by interpolating the two ends within tolerance
+template<typename ErrorAt>
+static void ReduceKeys(uint32_t count, float tolerance, const ErrorAt& interpError, std::vector<uint32_t>& outKept)
+{
+	outKept.clear();
+	if (count == 0) return;
+
+	outKept.push_back(0);
+
+	uint32_t a = 0;
+	while (a + 1 < count)
+	{
+		uint32_t b = a + 1;
+
+		while (b + 1 < count && b + 1 - a <= MAX_SEGMENT_KEYS)
+		{
+			bool fits = true;
+			for (uint32_t k = a + 1; k <= b; ++k)
+			{
+				if (interpError(a, b + 1, k) > tolerance)
+				{
+					fits = false;
+					break;
+				}
+			}
+
+			if (!fits) break;
+			++b;
+		}
+
+		outKept.push_back(b);
+		a = b;
+	}
+}
+
+static void CompressVectorChannel(
+	const std::vector<VectorKey>& keys,
+	float tolerance,
+	float quantTolerance,
+	CompressedVectorChannel& out
+)
+{
+	out = CompressedVectorChannel();
+	if (keys.empty()) return;
+
+	const uint32_t count = static_cast<uint32_t>(keys.size());
+
+	// Constant channel -> one key
+	bool constant = true;
+	for (uint32_t k = 1; k < count && constant; ++k)
+	{
+		constant = Distance3(keys[k].value, keys[0].value) <= tolerance;
+	}
+
+	std::vector<uint32_t> kept;
+	if (constant)
+	{
+		kept.push_back(0);
+	}
+	else
+	{
+		ReduceKeys(count, tolerance,
+			[&keys](uint32_t a, uint32_t b, uint32_t k)
+			{
+				const double span = keys[b].time - keys[a].time;
+				const float t = (span > 0.0) ? static_cast<float>((keys[k].time - keys[a].time) / span) : 0.0f;
+				return Distance3(Lerp3(keys[a].value, keys[b].value, t), keys[k].value);
+			},
+			kept);
+	}
+
+	// Range of the kept keys
+	XMFLOAT3 vmin = keys[kept[0]].value;
+	XMFLOAT3 vmax = vmin;
+	for (uint32_t k : kept)
+	{
+		const XMFLOAT3& v = keys[k].value;
+		vmin = XMFLOAT3(std::min(vmin.x, v.x), std::min(vmin.y, v.y), std::min(vmin.z, v.z));
+		vmax = XMFLOAT3(std::max(vmax.x, v.x), std::max(vmax.y, v.y), std::max(vmax.z, v.z));
+	}
+
+	out.rangeMin = vmin;
+	out.rangeExtent = XMFLOAT3(vmax.x - vmin.x, vmax.y - vmin.y, vmax.z - vmin.z);
+
+	const float* minC = &out.rangeMin.x;
+	const float* extC = &out.rangeExtent.x;
+
+	out.times.reserve(kept.size());
+	out.values.reserve(kept.size() * 3);
+
+	for (uint32_t k : kept)
+	{
+		out.times.push_back(static_cast<float>(keys[k].time));
+
+		const float* v = &keys[k].value.x;
+		for (int c = 0; c < 3; ++c)
+		{
+			const float n = (extC[c] > 0.0f) ? (v[c] - minC[c]) / extC[c] : 0.0f;
+			const float q = std::min(std::max(n, 0.0f), 1.0f) * QUANT_MAX + 0.5f;
+			out.values.push_back(static_cast<uint16_t>(q));
+		}
+	}
+
+	// Wide ranges lose more than the quantization budget to 16 bit: keep the keys as they are
+	float quantError = 0.0f;
+	for (size_t i = 0; i < kept.size(); ++i)
+	{
+		quantError = std::max(quantError, Distance3(DecodeVector(out, static_cast<uint32_t>(i)), keys[kept[i]].value));
+	}
+
+	if (quantError > quantTolerance)
+	{
+		std::vector<uint16_t>().swap(out.values);
+		out.rawValues.reserve(kept.size());
+		for (uint32_t k : kept) out.rawValues.push_back(keys[k].value);
+	}
+}
+
+static void CompressQuatChannel(
+	const std::vector<QuatKey>& keys,
+	float toleranceRad,
+	float quantToleranceRad,
+	CompressedQuatChannel& out
+)
+{
+	out = CompressedQuatChannel();
+	if (keys.empty()) return;
+
+	const uint32_t count = static_cast<uint32_t>(keys.size());
+
+	bool constant = true;
+	for (uint32_t k = 1; k < count && constant; ++k)
+	{
+		constant = QuatAngle(keys[k].value, keys[0].value) <= toleranceRad;
+	}
+
+	std::vector<uint32_t> kept;
+	if (constant)
+	{
+		kept.push_back(0);
+	}
+	else
+	{
+		ReduceKeys(count, toleranceRad,
+			[&keys](uint32_t a, uint32_t b, uint32_t k)
+			{
+				const double span = keys[b].time - keys[a].time;
+				const float t = (span > 0.0) ? static_cast<float>((keys[k].time - keys[a].time) / span) : 0.0f;
+				return QuatAngle(SlerpShortest(keys[a].value, keys[b].value, t), keys[k].value);
+			},
+			kept);
+	}
+
+	out.times.reserve(kept.size());
+	out.values.resize(kept.size() * 3);
+
+	for (size_t i = 0; i < kept.size(); ++i)
+	{
+		out.times.push_back(static_cast<float>(keys[kept[i]].time));
+		EncodeQuat(keys[kept[i]].value, &out.values[i * 3]);
+	}
+
+	// Long lever arms leave less angle than 15 bit resolves: keep the keys as they are
+	float quantError = 0.0f;
+	for (size_t i = 0; i < kept.size(); ++i)
+	{
+		quantError = std::max(quantError, QuatAngle(DecodeQuat(&out.values[i * 3]), keys[kept[i]].value));
+	}
+
+	if (quantError > quantToleranceRad)
+	{
+		std::vector<uint16_t>().swap(out.values);
+		out.rawValues.reserve(kept.size());
+		for (uint32_t k : kept) out.rawValues.push_back(keys[k].value);
+	}
+}
+
+// Smallest three: drop the largest component (rebuilt from unit length),
+// store the other three in 15 bit each, the dropped index in the top bits of words 0 and 1
+static void EncodeQuat(const XMFLOAT4& q, uint16_t* out)
+{
+	float c[4] = { q.x, q.y, q.z, q.w };
+
+	const float len = sqrtf(c[0] * c[0] + c[1] * c[1] + c[2] * c[2] + c[3] * c[3]);
+	const float inv = (len > 0.0f) ? 1.0f / len : 0.0f;
+
+	int largest = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		c[i] *= inv;
+		if (fabsf(c[i]) > fabsf(c[largest])) largest = i;
+	}
+
+	// q and -q are the same rotation, keep the dropped component positive
+	const float sign = (c[largest] < 0.0f) ? -1.0f : 1.0f;
+
+	int w = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (i == largest) continue;
+
+		float n = (c[i] * sign / QUAT_COMPONENT_MAX) * 0.5f + 0.5f;
+		n = std::min(std::max(n, 0.0f), 1.0f);
+
+		out[w++] = static_cast<uint16_t>(n * QUAT_QUANT_MAX + 0.5f);
+	}
+
+	out[0] |= static_cast<uint16_t>((largest & 1) << 15);
+	out[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+}
+
+static XMFLOAT4 DecodeQuat(const uint16_t* in)
+{
+	const int largest = (in[0] >> 15) | ((in[1] >> 15) << 1);
+
+	float c[4];
+	float sum = 0.0f;
+
+	int r = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (i == largest) continue;
+
+		const float n = static_cast<float>(in[r++] & 0x7FFF) / QUAT_QUANT_MAX;
+		c[i] = (n * 2.0f - 1.0f) * QUAT_COMPONENT_MAX;
+		sum += c[i] * c[i];
+	}
+
+	c[largest] = sqrtf(std::max(0.0f, 1.0f - sum));
+
+	return XMFLOAT4(c[0], c[1], c[2], c[3]);
+}
+
+static XMFLOAT4 DecodeQuatKey(const CompressedQuatChannel& channel, uint32_t key)
+{
+	if (!channel.rawValues.empty()) return channel.rawValues[key];
+
+	return DecodeQuat(&channel.values[key * 3]);
+}
+
+static XMFLOAT3 DecodeVector(const CompressedVectorChannel& channel, uint32_t key)
+{
+	if (!channel.rawValues.empty()) return channel.rawValues[key];
+
+	const uint16_t* q = &channel.values[key * 3];
+	const float scale = 1.0f / QUANT_MAX;
+
+	return XMFLOAT3(
+		channel.rangeMin.x + q[0] * scale * channel.rangeExtent.x,
+		channel.rangeMin.y + q[1] * scale * channel.rangeExtent.y,
+		channel.rangeMin.z + q[2] * scale * channel.rangeExtent.z
+	);
+}
+
+static float Distance3(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	const float dx = a.x - b.x;
+	const float dy = a.y - b.y;
+	const float dz = a.z - b.z;
+	return sqrtf(dx * dx + dy * dy + dz * dz);
+}
+
+static float QuatAngle(const XMFLOAT4& a, const XMFLOAT4& b)
+{
+	const float la = sqrtf(a.x * a.x + a.y * a.y + a.z * a.z + a.w * a.w);
+	const float lb = sqrtf(b.x * b.x + b.y * b.y + b.z * b.z + b.w * b.w);
+	if (la <= 0.0f || lb <= 0.0f) return 0.0f;
+
+	// Chord length instead of acos(dot), acos has no precision left near 1
+	const float sign = (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w < 0.0f) ? -1.0f : 1.0f;
+	const float dx = a.x / la - sign * b.x / lb;
+	const float dy = a.y / la - sign * b.y / lb;
+	const float dz = a.z / la - sign * b.z / lb;
+	const float dw = a.w / la - sign * b.w / lb;
+
+	const float chord = sqrtf(dx * dx + dy * dy + dz * dz + dw * dw);
+	return 4.0f * asinf(std::min(chord * 0.5f, 1.0f));
+}
+
+static XMFLOAT3 Lerp3(const XMFLOAT3& a, const XMFLOAT3& b, float t)
+{
+	return XMFLOAT3(
+		a.x + (b.x - a.x) * t,
+		a.y + (b.y - a.y) * t,
+		a.z + (b.z - a.z) * t
+	);
+}
+
+// Scalar slerp for load-time error checks (same result as XMQuaternionSlerp)
+static XMFLOAT4 SlerpShortest(const XMFLOAT4& a, const XMFLOAT4& b, float t)
+{
+	float cosOmega = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	const float sign = (cosOmega < 0.0f) ? -1.0f : 1.0f;
+	cosOmega *= sign;
+
+	float wa = 1.0f - t;
+	float wb = t;
+
+	if (cosOmega < 0.9999f)
+	{
+		const float omega = acosf(cosOmega);
+		const float invSin = 1.0f / sinf(omega);
+		wa = sinf(wa * omega) * invSin;
+		wb = sinf(wb * omega) * invSin;
+	}
+
+	wb *= sign;
+
+	return XMFLOAT4(
+		a.x * wa + b.x * wb,
+		a.y * wa + b.y * wb,
+		a.z * wa + b.z * wb,
+		a.w * wa + b.w * wb
+	);
+}
@@ -0,0 +1,142 @@
+/*==============================================================================
+
+   Animation clip compression [animation_compression.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_COMPRESSION_H
+#define ANIMATION_COMPRESSION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <DirectXMath.h>
+
+struct AnimationClip;
+struct ModelAsset;
+struct TrackCursor;
+struct TrackKeyPair;
+
+/*
+// -------------------------------
+CompressedTrack (one per BoneAnimTrack)
+├─ position / scale : keys quantized to 16 bit per component inside [rangeMin, rangeMin + rangeExtent]
+├─ rotation         : smallest three, 3 x 16 bit per key (2 bit index + 3 x 15 bit)
+├─ quantization     : decoded keys are measured against the rest of the threshold,
+│                     a channel that misses it keeps its kept keys unquantized (rawValues)
+└─ key reduction    : constant channels keep 1 key, keys that linear interpolation
+                      reproduces within the bone's error threshold are removed
+// -------------------------------
+*/
+
+// Position / scale channel
+struct CompressedVectorChannel
+{
+	std::vector<float> times;     // key time (ticks)
+	std::vector<uint16_t> values; // 3 per key
+	std::vector<DirectX::XMFLOAT3> rawValues; // instead of values when 16 bit exceeds the quantization budget
+
+	DirectX::XMFLOAT3 rangeMin = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 rangeExtent = { 0.0f, 0.0f, 0.0f };
+
+	uint32_t KeyCount() const { return static_cast<uint32_t>(times.size()); }
+};
+
+// Rotation channel
+struct CompressedQuatChannel
+{
+	std::vector<float> times;     // key time (ticks)
+	std::vector<uint16_t> values; // 3 per key
+	std::vector<DirectX::XMFLOAT4> rawValues; // instead of values when 15 bit exceeds the quantization budget
+
+	uint32_t KeyCount() const { return static_cast<uint32_t>(times.size()); }
+};
+
+struct CompressedTrack
+{
+	CompressedVectorChannel position;
+	CompressedQuatChannel   rotation;
+	CompressedVectorChannel scale;
+
+	double endTime = 0.0; // same as BoneAnimTrack::endTime
+
+	bool Empty() const { return position.times.empty() && rotation.times.empty() && scale.times.empty(); }
+};
+
+struct AnimationCompressionSettings
+{
+	float errorThreshold = 0.01f; // max joint position error in model space (model units)
+	float minLeverArm = 1.0f;     // lever arm for leaf bones (no child joint to measure)
+
+	// Per-bone override by node name (e.g. tighter for hands and head)
+	std::unordered_map<std::string, float> boneErrorThreshold;
+
+	bool releaseRawKeys = true; // drop BoneAnimTrack keys after compressing
+};
+
+struct AnimationCompressionReport
+{
+	std::string clipName;
+
+	size_t rawBytes = 0;
+	size_t compressedBytes = 0;
+	int rawKeys = 0;
+	int keptKeys = 0;
+
+	int sampledFrames = 0;
+	float maxError = 0.0f;  // joint position, model space
+	float meanError = 0.0f;
+
+	double Ratio() const { return compressedBytes > 0 ? static_cast<double>(rawBytes) / compressedBytes : 0.0; }
+};
+
+// Builds clip->compressedTracks against the asset skeleton (bind pose gives the lever arms)
+bool AnimationCompression_CompressClip(
+	AnimationClip* clip,
+	const ModelAsset* asset,
+	const AnimationCompressionSettings& settings
+);
+
+// Same output as the raw SampleTrack() in animation.cpp
+void AnimationCompression_SampleTrack(
+	const CompressedTrack& track,
+	double timeTicks,
+	TrackCursor& cursor,
+	DirectX::XMFLOAT3& outT,
+	DirectX::XMFLOAT4& outR,
+	DirectX::XMFLOAT3& outS
+);
+
+// Decoded keys around the sample time, for the batch sampler
+void AnimationCompression_GetTrackKeyPair(
+	const CompressedTrack& track,
+	double timeTicks,
+	TrackCursor& cursor,
+	TrackKeyPair& out
+);
+
+// Decoded last key of every channel (the track end, which sampling wraps to 0)
+// Channels without keys leave their output untouched
+void AnimationCompression_GetLastKeys(
+	const CompressedTrack& track,
+	DirectX::XMFLOAT3& outT,
+	DirectX::XMFLOAT4& outR,
+	DirectX::XMFLOAT3& outS
+);
+
+size_t AnimationCompression_RawBytes(const AnimationClip* clip);
+size_t AnimationCompression_CompressedBytes(const AnimationClip* clip);
+
+// Reimports every registered clip from its source file, compresses it and
+// compares the model-space joint positions against the raw clip (animation_compression_report.cpp)
+void AnimationCompression_Report(
+	const ModelAsset* asset,
+	const AnimationCompressionSettings& settings,
+	std::vector<AnimationCompressionReport>& outReports
+);
+
+#endif // ANIMATION_COMPRESSION_H
@@ -0,0 +1,118 @@
+/*==============================================================================
+
+   Compression error report [animation_compression_report.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   Reimports from the source files (Animation_LoadFromFile), so it stays out of
+   animation_compression.cpp, which the headless tools link without assimp
+
+==============================================================================*/
+
+#include "animation_compression.h"
+#include "animation.h"
+#include "model_asset.h"
+#include "debug_ostream.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace DirectX;
+
+static const double REPORT_SAMPLE_RATE = 60.0;
+
+
+void AnimationCompression_Report(
+	const ModelAsset* asset,
+	const AnimationCompressionSettings& settings,
+	std::vector<AnimationCompressionReport>& outReports
+)
+{
+	outReports.clear();
+
+	if (!asset) return;
+
+	AnimationManager& manager = AnimationManager::Instance();
+	const SkeletonRuntime& skel = asset->skeleton;
+
+	AnimationCompressionSettings packSettings = settings;
+	packSettings.releaseRawKeys = true; // make sure only the compressed path is sampled
+
+	std::vector<XMFLOAT4X4> skinScratch;
+
+	for (int c = 0; c < manager.GetClipCount(); ++c)
+	{
+		const AnimationClip* registered = manager.GetClipById(c);
+		if (!registered || registered->sourcePath.empty()) continue;
+
+		// Registered clips may already have dropped their raw keys, so start from the source file
+		AnimationClip* raw = Animation_LoadFromFile(registered->sourcePath.c_str(), asset, registered->SourceYup);
+		if (!raw) continue;
+
+		AnimationClip* packed = new AnimationClip(*raw);
+		AnimationCompression_CompressClip(packed, asset, packSettings);
+
+		AnimationCompressionReport r;
+		r.clipName = raw->animName;
+		r.rawBytes = AnimationCompression_RawBytes(raw);
+		r.compressedBytes = AnimationCompression_CompressedBytes(packed);
+
+		for (const BoneAnimTrack& t : raw->tracks)
+		{
+			r.rawKeys += static_cast<int>(t.positionKeys.size() + t.rotationKeys.size() + t.scaleKeys.size());
+		}
+		for (const CompressedTrack& t : packed->compressedTracks)
+		{
+			r.keptKeys += static_cast<int>(t.position.KeyCount() + t.rotation.KeyCount() + t.scale.KeyCount());
+		}
+
+		// Joint positions of every skinned bone, sampled at a fixed rate
+		AnimationPlayer rawPlayer;
+		AnimationPlayer packedPlayer;
+
+		const double durationSec = (raw->ticksPerSecond > 0.0) ? raw->duration / raw->ticksPerSecond : 0.0;
+		double errorSum = 0.0;
+		int errorCount = 0;
+
+		for (double t = 0.0; t < durationSec || r.sampledFrames == 0; t += 1.0 / REPORT_SAMPLE_RATE)
+		{
+			rawPlayer.Play(raw, asset, false, t);
+			packedPlayer.Play(packed, asset, false, t);
+
+			rawPlayer.ComputeSkinMatrices(skinScratch);
+			packedPlayer.ComputeSkinMatrices(skinScratch);
+
+			const PoseView rawPose = rawPlayer.GetCurrentPose();
+			const PoseView packedPose = packedPlayer.GetCurrentPose();
+
+			for (int b = 0; b < skel.BoneCount(); ++b)
+			{
+				const int nodeIndex = skel.boneToNode[b];
+				if (nodeIndex < 0 || nodeIndex >= rawPose.Size() || nodeIndex >= packedPose.Size()) continue;
+
+				const float err = XMVectorGetX(XMVector3Length(XMVectorSubtract(rawPose[nodeIndex].r[3], packedPose[nodeIndex].r[3])));
+
+				r.maxError = std::max(r.maxError, err);
+				errorSum += err;
+				++errorCount;
+			}
+
+			++r.sampledFrames;
+		}
+
+		r.meanError = (errorCount > 0) ? static_cast<float>(errorSum / errorCount) : 0.0f;
+
+		char buf[256];
+		snprintf(buf, sizeof(buf), "[AnimCompress] %s : %zu -> %zu bytes (x%.2f), keys %d -> %d, error max %.5f mean %.5f\n",
+			r.clipName.c_str(), r.rawBytes, r.compressedBytes, r.Ratio(), r.rawKeys, r.keptKeys, r.maxError, r.meanError);
+		hal::debug_print(buf);
+
+		outReports.push_back(r);
+
+		manager.ReleaseBindings(raw);
+		manager.ReleaseBindings(packed);
+		Animation_DestroyClip(raw);
+		Animation_DestroyClip(packed);
+	}
+}
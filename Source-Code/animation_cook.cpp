@@ -0,0 +1,327 @@
+/*==============================================================================
+
+   Cooked animation clip file [animation_cook.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_cook.h"
+#include "animation.h"
+#include "model_asset.h"
+#include "mapped_file_util.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+static const uint32_t ANIM_FILE_MAGIC = 0x4D494E41; // "ANIM"
+static const uint32_t ANIM_FILE_VERSION = 2;        // bump when the layout or the import flags change
+
+static const uint32_t ANIM_FLAG_LOOP = 1u << 0;
+
+struct AnimFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+
+	double duration;
+	double ticksPerSecond;
+
+	uint32_t trackCount;
+	uint32_t flags;
+	uint32_t nameOffset;
+	uint32_t nameLength;
+
+	uint64_t fileSize;
+	uint32_t skeletonOffset; // AnimFileNode[skeletonCount], the rig the clip was authored on
+	uint32_t skeletonCount;
+};
+
+struct AnimFileTrack
+{
+	uint32_t nameOffset;
+	uint32_t nameLength;
+
+	uint32_t positionCount;
+	uint32_t rotationCount;
+	uint32_t scaleCount;
+	uint32_t pad;
+
+	uint64_t positionOffset;
+	uint64_t rotationOffset;
+	uint64_t scaleOffset;
+
+	double endTime;
+};
+
+struct AnimFileNode
+{
+	uint32_t nameOffset;
+	uint32_t nameLength;
+	int32_t parent;
+	uint32_t pad;
+
+	float t[3];
+	float r[4];
+	float s[3];
+};
+
+static_assert(sizeof(AnimFileHeader) == 64, "AnimFileHeader layout");
+static_assert(sizeof(AnimFileTrack) == 56, "AnimFileTrack layout");
+static_assert(sizeof(AnimFileNode) == 56, "AnimFileNode layout");
+static_assert(sizeof(VectorKey) == 24 && sizeof(QuatKey) == 24, "key layout is written as is");
+
+static uint64_t AlignUp8(uint64_t v);
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t fileSize);
+
+
+std::string AnimationCook_GetCookedPath(const char* sourcePath)
+{
+	std::string path = sourcePath ? sourcePath : "";
+
+	const size_t dot = path.find_last_of('.');
+	const size_t slash = path.find_last_of("/\\");
+
+	if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+	{
+		path.erase(dot);
+	}
+
+	return path + ".anim";
+}
+
+AnimationClip* AnimationCook_Load(const char* cookedPath, uint64_t sourceHash, bool checkHash, const ModelAsset* asset)
+{
+	MappedFile file;
+	if (!file.Open(cookedPath)) return nullptr;
+
+	const uint8_t* base = file.Data();
+	const uint64_t size = file.Size();
+
+	if (size < sizeof(AnimFileHeader)) return nullptr;
+
+	const AnimFileHeader& header = *reinterpret_cast<const AnimFileHeader*>(base);
+
+	if (header.magic != ANIM_FILE_MAGIC || header.version != ANIM_FILE_VERSION) return nullptr;
+	if (header.fileSize != size) return nullptr;
+	if (checkHash && header.sourceHash != sourceHash) return nullptr; // stale
+
+	const uint64_t tracksOffset = sizeof(AnimFileHeader);
+	if (!InFile(tracksOffset, static_cast<uint64_t>(header.trackCount) * sizeof(AnimFileTrack), size)) return nullptr;
+	if (!InFile(header.nameOffset, header.nameLength, size)) return nullptr;
+	if (!InFile(header.skeletonOffset, static_cast<uint64_t>(header.skeletonCount) * sizeof(AnimFileNode), size)) return nullptr;
+
+	const AnimFileTrack* fileTracks = reinterpret_cast<const AnimFileTrack*>(base + tracksOffset);
+	const AnimFileNode* fileNodes = reinterpret_cast<const AnimFileNode*>(base + header.skeletonOffset);
+
+	// Range checks only, no per key work: the arrays are copied as they are
+	for (uint32_t i = 0; i < header.trackCount; ++i)
+	{
+		const AnimFileTrack& ft = fileTracks[i];
+		if (!InFile(ft.nameOffset, ft.nameLength, size) ||
+			!InFile(ft.positionOffset, static_cast<uint64_t>(ft.positionCount) * sizeof(VectorKey), size) ||
+			!InFile(ft.rotationOffset, static_cast<uint64_t>(ft.rotationCount) * sizeof(QuatKey), size) ||
+			!InFile(ft.scaleOffset, static_cast<uint64_t>(ft.scaleCount) * sizeof(VectorKey), size))
+		{
+			return nullptr;
+		}
+	}
+
+	for (uint32_t i = 0; i < header.skeletonCount; ++i)
+	{
+		const AnimFileNode& fn = fileNodes[i];
+		if (!InFile(fn.nameOffset, fn.nameLength, size) || fn.parent >= static_cast<int32_t>(i)) return nullptr;
+	}
+
+	AnimationClip* clip = new AnimationClip();
+	clip->animName.assign(reinterpret_cast<const char*>(base + header.nameOffset), header.nameLength);
+	clip->duration = header.duration;
+	clip->ticksPerSecond = header.ticksPerSecond;
+	clip->loop = (header.flags & ANIM_FLAG_LOOP) != 0;
+
+	clip->tracks.resize(header.trackCount);
+
+	for (uint32_t i = 0; i < header.trackCount; ++i)
+	{
+		const AnimFileTrack& ft = fileTracks[i];
+		BoneAnimTrack& track = clip->tracks[i];
+
+		track.nodeName.assign(reinterpret_cast<const char*>(base + ft.nameOffset), ft.nameLength);
+		const int nodeIndex = asset ? asset->skeleton.FindNodeIndexByName(track.nodeName) : -1;
+		track.node = (nodeIndex >= 0) ? asset->skeleton.nodes[nodeIndex] : nullptr;
+
+		const VectorKey* pos = reinterpret_cast<const VectorKey*>(base + ft.positionOffset);
+		const QuatKey* rot = reinterpret_cast<const QuatKey*>(base + ft.rotationOffset);
+		const VectorKey* scl = reinterpret_cast<const VectorKey*>(base + ft.scaleOffset);
+
+		track.positionKeys.assign(pos, pos + ft.positionCount);
+		track.rotationKeys.assign(rot, rot + ft.rotationCount);
+		track.scaleKeys.assign(scl, scl + ft.scaleCount);
+
+		track.endTime = ft.endTime;
+	}
+
+	ClipSkeleton& skeleton = clip->skeleton;
+	skeleton.names.resize(header.skeletonCount);
+	skeleton.parent.resize(header.skeletonCount);
+	skeleton.bindT.resize(header.skeletonCount);
+	skeleton.bindR.resize(header.skeletonCount);
+	skeleton.bindS.resize(header.skeletonCount);
+
+	for (uint32_t i = 0; i < header.skeletonCount; ++i)
+	{
+		const AnimFileNode& fn = fileNodes[i];
+
+		skeleton.names[i].assign(reinterpret_cast<const char*>(base + fn.nameOffset), fn.nameLength);
+		skeleton.parent[i] = fn.parent;
+		skeleton.bindT[i] = DirectX::XMFLOAT3(fn.t[0], fn.t[1], fn.t[2]);
+		skeleton.bindR[i] = DirectX::XMFLOAT4(fn.r[0], fn.r[1], fn.r[2], fn.r[3]);
+		skeleton.bindS[i] = DirectX::XMFLOAT3(fn.s[0], fn.s[1], fn.s[2]);
+	}
+
+	skeleton.hash = AnimationRetarget_HashSkeleton(skeleton);
+
+	return clip;
+}
+
+bool AnimationCook_Write(const AnimationClip& clip, const char* cookedPath, uint64_t sourceHash)
+{
+	const uint32_t trackCount = static_cast<uint32_t>(clip.tracks.size());
+	const ClipSkeleton& skeleton = clip.skeleton;
+	const uint32_t nodeCount = static_cast<uint32_t>(skeleton.NodeCount());
+
+	// 1. Layout : header, track table, key arrays, skeleton, strings
+	std::vector<AnimFileTrack> fileTracks(trackCount);
+
+	uint64_t offset = sizeof(AnimFileHeader) + static_cast<uint64_t>(trackCount) * sizeof(AnimFileTrack);
+
+	for (uint32_t i = 0; i < trackCount; ++i)
+	{
+		const BoneAnimTrack& track = clip.tracks[i];
+		AnimFileTrack& ft = fileTracks[i];
+		memset(&ft, 0, sizeof(ft));
+
+		ft.positionCount = static_cast<uint32_t>(track.positionKeys.size());
+		ft.rotationCount = static_cast<uint32_t>(track.rotationKeys.size());
+		ft.scaleCount = static_cast<uint32_t>(track.scaleKeys.size());
+		ft.endTime = track.endTime;
+
+		ft.positionOffset = offset;
+		offset = AlignUp8(offset + ft.positionCount * sizeof(VectorKey));
+		ft.rotationOffset = offset;
+		offset = AlignUp8(offset + ft.rotationCount * sizeof(QuatKey));
+		ft.scaleOffset = offset;
+		offset = AlignUp8(offset + ft.scaleCount * sizeof(VectorKey));
+	}
+
+	const uint64_t skeletonOffset = offset;
+	offset += static_cast<uint64_t>(nodeCount) * sizeof(AnimFileNode);
+
+	std::string strings = clip.animName;
+	for (uint32_t i = 0; i < trackCount; ++i)
+	{
+		fileTracks[i].nameOffset = static_cast<uint32_t>(offset + strings.size());
+		fileTracks[i].nameLength = static_cast<uint32_t>(clip.tracks[i].nodeName.size());
+		strings += clip.tracks[i].nodeName;
+	}
+
+	std::vector<AnimFileNode> fileNodes(nodeCount);
+	for (uint32_t i = 0; i < nodeCount; ++i)
+	{
+		AnimFileNode& fn = fileNodes[i];
+		memset(&fn, 0, sizeof(fn));
+
+		fn.nameOffset = static_cast<uint32_t>(offset + strings.size());
+		fn.nameLength = static_cast<uint32_t>(skeleton.names[i].size());
+		fn.parent = skeleton.parent[i];
+		memcpy(fn.t, &skeleton.bindT[i], sizeof(fn.t));
+		memcpy(fn.r, &skeleton.bindR[i], sizeof(fn.r));
+		memcpy(fn.s, &skeleton.bindS[i], sizeof(fn.s));
+
+		strings += skeleton.names[i];
+	}
+
+	AnimFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = ANIM_FILE_MAGIC;
+	header.version = ANIM_FILE_VERSION;
+	header.sourceHash = sourceHash;
+	header.duration = clip.duration;
+	header.ticksPerSecond = clip.ticksPerSecond;
+	header.trackCount = trackCount;
+	header.flags = clip.loop ? ANIM_FLAG_LOOP : 0;
+	header.nameOffset = static_cast<uint32_t>(offset);
+	header.nameLength = static_cast<uint32_t>(clip.animName.size());
+	header.fileSize = offset + strings.size();
+	header.skeletonOffset = static_cast<uint32_t>(skeletonOffset);
+	header.skeletonCount = nodeCount;
+
+	// 2. Write to a temporary file first, a half written .anim is never picked up
+	const std::string tempPath = std::string(cookedPath) + ".tmp";
+	bool written = false;
+	{
+		std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+		if (!ofs) return false;
+
+		const char zeros[8] = {};
+		auto padTo = [&ofs, &zeros](uint64_t target)
+		{
+			const uint64_t pos = static_cast<uint64_t>(ofs.tellp());
+			if (target > pos) ofs.write(zeros, static_cast<std::streamsize>(target - pos));
+		};
+
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		ofs.write(reinterpret_cast<const char*>(fileTracks.data()), fileTracks.size() * sizeof(AnimFileTrack));
+
+		for (uint32_t i = 0; i < trackCount; ++i)
+		{
+			const BoneAnimTrack& track = clip.tracks[i];
+			const AnimFileTrack& ft = fileTracks[i];
+
+			padTo(ft.positionOffset);
+			ofs.write(reinterpret_cast<const char*>(track.positionKeys.data()), track.positionKeys.size() * sizeof(VectorKey));
+			padTo(ft.rotationOffset);
+			ofs.write(reinterpret_cast<const char*>(track.rotationKeys.data()), track.rotationKeys.size() * sizeof(QuatKey));
+			padTo(ft.scaleOffset);
+			ofs.write(reinterpret_cast<const char*>(track.scaleKeys.data()), track.scaleKeys.size() * sizeof(VectorKey));
+		}
+
+		padTo(header.skeletonOffset);
+		ofs.write(reinterpret_cast<const char*>(fileNodes.data()), fileNodes.size() * sizeof(AnimFileNode));
+
+		padTo(header.nameOffset);
+		ofs.write(strings.data(), strings.size());
+
+		ofs.close();
+		written = !ofs.fail();
+	}
+
+	if (written)
+	{
+		std::remove(cookedPath);
+		written = (std::rename(tempPath.c_str(), cookedPath) == 0);
+	}
+
+	// Nothing is left behind on a failed write or rename
+	if (!written)
+	{
+		std::remove(tempPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+static uint64_t AlignUp8(uint64_t v)
+{
+	return (v + 7) & ~static_cast<uint64_t>(7);
+}
+
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t fileSize)
+{
+	return offset <= fileSize && bytes <= fileSize - offset;
+}
@@ -0,0 +1,43 @@
+/*==============================================================================
+
+   Cooked animation clip file [animation_cook.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_COOK_H
+#define ANIMATION_COOK_H
+
+#include <cstdint>
+#include <string>
+
+struct AnimationClip;
+struct ModelAsset;
+
+/*
+// -------------------------------
+.anim (little endian, every section 8 byte aligned)
+├─ AnimFileHeader : magic, version, FNV-1a 64 of the source file, clip metadata
+├─ AnimFileTrack[trackCount] : name + per channel key count / offset
+├─ key arrays : VectorKey / QuatKey exactly as in memory (24 bytes each)
+├─ AnimFileNode[skeletonCount] : node tree + bind TRS of the source file (retargeting)
+└─ string table : clip name, track names, skeleton node names (not null terminated)
+
+Animation_LoadFromFile
+├─ cooked file present and hash matches -> MappedFile, keys copied as whole arrays
+└─ otherwise -> assimp import (animation only) -> AnimationCook_Write
+// -------------------------------
+*/
+
+// "resources/Animation/Idle.fbx" -> "resources/Animation/Idle.anim"
+std::string AnimationCook_GetCookedPath(const char* sourcePath);
+
+// nullptr when the file is missing, broken, from another version,
+// or (checkHash) was cooked from a different source file
+AnimationClip* AnimationCook_Load(const char* cookedPath, uint64_t sourceHash, bool checkHash, const ModelAsset* asset);
+
+bool AnimationCook_Write(const AnimationClip& clip, const char* cookedPath, uint64_t sourceHash);
+
+#endif // ANIMATION_COOK_H
@@ -0,0 +1,382 @@
+/*==============================================================================
+
+   Clip import and asynchronous loads [animation_import.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+// assimp side of animation.cpp: the rest of the runtime (sampling, players, manager
+// registry) builds without assimp / D3D and runs in the headless tools
+#include "assimp/scene.h"
+#include "assimp/cimport.h"
+#include "assimp/postprocess.h"
+
+#include "animation.h"
+#include "skeleton_util.h"
+#include "animation_cook.h"
+#include "animation_retarget.h"
+#include "mapped_file_util.h"
+#include "system_timer.h"
+#include "debug_ostream.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cstdio>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+static const int CLIP_LOADER_THREADS = 4; // clips of one character load side by side
+
+struct BoneRef
+{
+	const aiBone* bone = nullptr; // aiMesh::mBones[b]
+	const aiNode* node = nullptr; // SkeletonUtil::FindNodeByNameŌm[h
+};
+
+// ---- Assimp^ -> DirectXMath^ϊ ----
+static XMFLOAT3 ToXMFLOAT3(const aiVector3D& v);
+static XMFLOAT4 ToXMFLOAT4(const aiQuaternion& q);
+
+static XMMATRIX AiMatToXM(const aiMatrix4x4& m);
+
+static BoneAnimTrack CreateBoneAnimationFromChannel(
+	const aiNodeAnim* channel,
+	const ModelAsset* asset,
+	const aiScene* scene,
+	double& outMaxTime
+);
+static AnimationClip* ImportClip(const char* filename, const ModelAsset* asset);
+static void FlattenNodeRecursive(const aiNode* node, int parent, ClipSkeleton& out);
+
+
+// ---- ǂݍ ----
+AnimationClip* Animation_LoadFromFile(const char* filename, const ModelAsset* asset, bool animYup)
+{
+	assert(filename);
+
+	const double start = SystemTimer_GetAbsoluteTime();
+
+	// Cooked file first; the source is only hashed to detect a stale cache
+	// (no source file: trust the cooked one)
+	const std::string cookedPath = AnimationCook_GetCookedPath(filename);
+	uint64_t sourceHash = 0;
+	const bool hasSource = FileUtil_HashFile(filename, sourceHash);
+
+	AnimationClip* clip = AnimationCook_Load(cookedPath.c_str(), sourceHash, hasSource, asset);
+	const bool fromCache = (clip != nullptr);
+
+	if (!clip)
+	{
+		clip = ImportClip(filename, asset);
+
+		if (clip && hasSource && !AnimationCook_Write(*clip, cookedPath.c_str(), sourceHash))
+		{
+			char buf[512];
+			snprintf(buf, sizeof(buf), "[AnimCook] failed to write %s\n", cookedPath.c_str());
+			hal::debug_print(buf);
+		}
+	}
+
+	if (!clip) return nullptr;
+
+	clip->SourceYup = animYup; // IMPORTANT: import up axis
+	clip->sourcePath = filename;
+
+	char buf[512];
+	snprintf(buf, sizeof(buf), "[AnimCook] %s : %s, %.2f ms\n", filename, fromCache ? "cooked" : "imported", (SystemTimer_GetAbsoluteTime() - start) * 1000.0);
+	hal::debug_print(buf);
+
+	return clip;
+}
+
+// assimp path, animation data only (no triangulation / normals / tangents, they would be thrown away)
+static AnimationClip* ImportClip(const char* filename, const ModelAsset* asset)
+{
+	const aiScene* scene = aiImportFile(
+		filename,
+		aiProcess_ConvertToLeftHanded | aiProcess_FindInvalidData
+	);
+	if (!scene) return nullptr;
+
+	const aiAnimation* anim = scene->HasAnimations() ? scene->mAnimations[0] : nullptr;
+	if (!anim)
+	{
+		aiReleaseImport(scene);
+		return nullptr;
+	}
+
+	AnimationClip* clip = new AnimationClip();
+
+	if (anim->mName.length > 0)
+		clip->animName = anim->mName.C_Str();
+	else
+		clip->animName = filename;
+
+	clip->ticksPerSecond = (anim->mTicksPerSecond != 0.0) ? anim->mTicksPerSecond : 30.0;
+
+	double durationFromAnim = anim->mDuration;
+	double durationFromKey = 0.0;
+
+	clip->tracks.reserve(anim->mNumChannels);
+
+	for (unsigned int i = 0; i < anim->mNumChannels; ++i)
+	{
+		const aiNodeAnim* channel = anim->mChannels[i];
+		if (!channel) continue;
+
+		BoneAnimTrack track = CreateBoneAnimationFromChannel(channel, asset, asset ? asset->aiScene : nullptr, durationFromKey);
+
+		clip->tracks.push_back(std::move(track));
+	}
+
+	clip->duration = std::max(durationFromAnim, durationFromKey);
+	clip->loop = true;
+
+	// Rig the clip was authored on, so other skeletons can be retargeted to it
+	AnimationRetarget_BuildClipSkeleton(scene->mRootNode, clip->skeleton);
+
+	aiReleaseImport(scene);
+
+	return clip;
+}
+
+
+// ------------------------------------------
+// Animation Manager : asynchronous loads
+// ------------------------------------------
+
+AnimationClipHandle AnimationManager::LoadAsync(const char* filename, const ModelAsset* asset, bool animYup, ClipPrepareFunc prepare)
+{
+	AnimationClipHandle handle;
+	if (!filename) return handle;
+
+	// Same file requested again (another character, a restart): one load, one clip.
+	// The first request's prepare is the one that ran
+	for (int i = 0; i < static_cast<int>(m_LoadRequests.size()); ++i)
+	{
+		const ClipLoadRequest* r = m_LoadRequests[i];
+		if (r->filename == filename && r->state != ClipLoadState::Failed)
+		{
+			handle.id = i;
+			return handle;
+		}
+	}
+
+	ClipLoadRequest* request = new ClipLoadRequest();
+	request->filename = filename;
+	request->asset = asset;
+	request->animYup = animYup;
+	request->prepare = std::move(prepare);
+
+	// Loaded synchronously before (RegisterClip): hand that clip out
+	if (AnimationClip* existing = FindClipBySource(filename))
+	{
+		request->clip = existing;
+		request->done.store(true);
+		request->state = ClipLoadState::Ready;
+	}
+	else
+	{
+		if (!m_Loader.IsRunning())
+		{
+			const int hw = static_cast<int>(std::thread::hardware_concurrency());
+			m_Loader.Start(std::max(1, std::min(CLIP_LOADER_THREADS, hw)));
+		}
+
+		if (m_PendingLoads == 0)
+		{
+			m_LoadBatchStart = SystemTimer_GetAbsoluteTime();
+			m_LoadBatchSum = 0.0;
+		}
+		++m_PendingLoads;
+
+		m_Loader.Push([request]()
+		{
+			const double start = SystemTimer_GetAbsoluteTime();
+
+			AnimationClip* clip = Animation_LoadFromFile(request->filename.c_str(), request->asset, request->animYup);
+			if (clip && request->prepare)
+			{
+				request->prepare(clip);
+			}
+
+			request->clip = clip;
+			request->loadSec = SystemTimer_GetAbsoluteTime() - start;
+			request->done.store(true, std::memory_order_release);
+		});
+	}
+
+	handle.id = static_cast<int>(m_LoadRequests.size());
+	m_LoadRequests.push_back(request);
+	return handle;
+}
+
+void AnimationManager::PollLoads()
+{
+	if (m_PendingLoads == 0) return;
+
+	for (ClipLoadRequest* r : m_LoadRequests)
+	{
+		if (r->state != ClipLoadState::Pending || !r->done.load(std::memory_order_acquire)) continue;
+
+		if (r->clip)
+		{
+			RegisterClip(r->clip, r->asset); // binding resolved here, not on the first Play
+			r->state = ClipLoadState::Ready;
+		}
+		else
+		{
+			r->state = ClipLoadState::Failed;
+
+			char buf[512];
+			snprintf(buf, sizeof(buf), "[AnimLoad] failed: %s\n", r->filename.c_str());
+			hal::debug_print(buf);
+		}
+
+		r->prepare = nullptr; // captures are not needed anymore
+		m_LoadBatchSum += r->loadSec;
+		--m_PendingLoads;
+	}
+
+	// Wall time close to the slowest single load means the loads really overlapped
+	if (m_PendingLoads == 0)
+	{
+		char buf[256];
+		snprintf(buf, sizeof(buf), "[AnimLoad] batch done: %.2f ms wall, %.2f ms summed over the clips\n",
+			(SystemTimer_GetAbsoluteTime() - m_LoadBatchStart) * 1000.0, m_LoadBatchSum * 1000.0);
+		hal::debug_print(buf);
+	}
+}
+
+void AnimationManager::WaitForLoads()
+{
+	m_Loader.WaitIdle();
+	PollLoads();
+}
+
+
+static XMFLOAT3 ToXMFLOAT3(const aiVector3D& v)
+{
+	return XMFLOAT3(v.x, v.y, v.z);
+}
+
+static XMFLOAT4 ToXMFLOAT4(const aiQuaternion& q)
+{
+	return XMFLOAT4(q.x, q.y, q.z, q.w);
+}
+
+static XMMATRIX AiMatToXM(const aiMatrix4x4& m)
+{
+	return XMMATRIX(
+		m.a1, m.b1, m.c1, m.d1,
+		m.a2, m.b2, m.c2, m.d2,
+		m.a3, m.b3, m.c3, m.d3,
+		m.a4, m.b4, m.c4, m.d4
+	);
+};
+
+static BoneAnimTrack CreateBoneAnimationFromChannel(
+	const aiNodeAnim* channel,
+	const ModelAsset* asset,
+	const aiScene* scene,
+	double& outMaxTime
+)
+{
+	BoneAnimTrack track;
+
+	// Find aiNode by name
+	std::string nodeName = channel->mNodeName.C_Str();
+	track.nodeName = nodeName;
+	track.node = scene ? SkeletonUtil::FindNodeByName(scene, nodeName) : nullptr;
+
+	// debug
+	if (nodeName == "clavicle_l")
+	{
+		char buf[256];
+		snprintf(buf, sizeof(buf), "[Channel] %s: pos = %u rot = %u \n",
+			nodeName.c_str(),
+			channel->mNumPositionKeys,
+			channel->mNumRotationKeys);
+		hal::debug_print(buf);
+	}
+
+	track.positionKeys.resize(channel->mNumPositionKeys);
+	for (unsigned int i = 0; i < channel->mNumPositionKeys; ++i)
+	{
+		const aiVectorKey& key = channel->mPositionKeys[i];
+		track.positionKeys[i] = { key.mTime, ToXMFLOAT3(key.mValue) };
+	}
+
+	track.rotationKeys.resize(channel->mNumRotationKeys);
+	for (unsigned int i = 0; i < channel->mNumRotationKeys; ++i)
+	{
+		const aiQuatKey& key = channel->mRotationKeys[i];
+		track.rotationKeys[i] = { key.mTime, ToXMFLOAT4(key.mValue) };
+	}
+
+	track.scaleKeys.resize(channel->mNumScalingKeys);
+	for (unsigned int i = 0; i < channel->mNumScalingKeys; ++i)
+	{
+		const aiVectorKey& key = channel->mScalingKeys[i];
+		track.scaleKeys[i] = { key.mTime, ToXMFLOAT3(key.mValue) };
+	}
+
+	if (!track.positionKeys.empty()) track.endTime = std::max(track.endTime, track.positionKeys.back().time);
+	if (!track.rotationKeys.empty()) track.endTime = std::max(track.endTime, track.rotationKeys.back().time);
+	if (!track.scaleKeys.empty())    track.endTime = std::max(track.endTime, track.scaleKeys.back().time);
+
+	outMaxTime = std::max(outMaxTime, track.endTime);
+
+	return track;
+}
+
+void AnimationRetarget_BuildClipSkeleton(const aiNode* root, ClipSkeleton& out)
+{
+	out = ClipSkeleton();
+
+	FlattenNodeRecursive(root, -1, out);
+
+	out.hash = AnimationRetarget_HashSkeleton(out);
+}
+
+static void FlattenNodeRecursive(const aiNode* node, int parent, ClipSkeleton& out)
+{
+	if (!node) return;
+
+	const int index = out.NodeCount();
+
+	const aiMatrix4x4& m = node->mTransformation;
+	const XMMATRIX local(
+		m.a1, m.b1, m.c1, m.d1,
+		m.a2, m.b2, m.c2, m.d2,
+		m.a3, m.b3, m.c3, m.d3,
+		m.a4, m.b4, m.c4, m.d4);
+
+	XMVECTOR s, r, t;
+	if (!XMMatrixDecompose(&s, &r, &t, local))
+	{
+		s = XMVectorSplatOne();
+		r = XMQuaternionIdentity();
+		t = XMVectorZero();
+	}
+
+	XMFLOAT3 fs, ft;
+	XMFLOAT4 fr;
+	XMStoreFloat3(&fs, s);
+	XMStoreFloat4(&fr, r);
+	XMStoreFloat3(&ft, t);
+
+	out.names.push_back(node->mName.C_Str());
+	out.parent.push_back(parent);
+	out.bindT.push_back(ft);
+	out.bindR.push_back(fr);
+	out.bindS.push_back(fs);
+
+	for (unsigned int i = 0; i < node->mNumChildren; ++i)
+	{
+		FlattenNodeRecursive(node->mChildren[i], index, out);
+	}
+}
@@ -0,0 +1,166 @@
+/*==============================================================================
+
+   Clip retargeting [animation_retarget.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_retarget.h"
+#include "animation.h"
+#include "model_asset.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+static const uint64_t FNV_PRIME = 1099511628211ull;
+
+// Below these the bone is treated as the same on both rigs
+static const float IDENTITY_ROTATION_DOT = 0.99999f; // |w| of the correction, ~0.5 degrees
+static const float IDENTITY_RATIO_EPS = 1.0e-4f;
+static const float IDENTITY_OFFSET_EPS = 1.0e-4f;    // relative to the bone length
+static const float MIN_BONE_LENGTH = 1.0e-5f;
+
+static int FindSourceNode(const ClipSkeleton& source, const char* targetName);
+static void HashBytes(uint64_t& hash, const void* data, size_t size);
+
+
+uint64_t AnimationRetarget_HashSkeleton(const ClipSkeleton& skeleton)
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+
+	for (int i = 0; i < skeleton.NodeCount(); ++i)
+	{
+		HashBytes(hash, skeleton.names[i].data(), skeleton.names[i].size() + 1);
+		HashBytes(hash, &skeleton.parent[i], sizeof(int));
+		HashBytes(hash, &skeleton.bindT[i], sizeof(XMFLOAT3));
+		HashBytes(hash, &skeleton.bindR[i], sizeof(XMFLOAT4));
+		HashBytes(hash, &skeleton.bindS[i], sizeof(XMFLOAT3));
+	}
+
+	return hash;
+}
+
+void AnimationRetarget_BuildMap(const ClipSkeleton& source, const ModelAsset* target, RetargetMap& outMap)
+{
+	outMap = RetargetMap();
+	outMap.sourceHash = source.hash;
+	outMap.target = target;
+
+	if (!target) return;
+
+	const SkeletonRuntime& skel = target->skeleton;
+	const int nodeCount = skel.NodeCount();
+
+	outMap.sourceNode.assign(nodeCount, -1);
+	outMap.bones.assign(nodeCount, RetargetBone());
+
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		const int s = FindSourceNode(source, skel.names[i].c_str());
+		outMap.sourceNode[i] = s;
+		if (s < 0) continue;
+
+		RetargetBone& bone = outMap.bones[i];
+
+		// Rotation: C = targetBind * inverse(sourceBind), applied on the left of the sampled rotation
+		const XMVECTOR sourceR = XMQuaternionNormalize(XMLoadFloat4(&source.bindR[s]));
+		const XMVECTOR targetR = XMQuaternionNormalize(XMLoadFloat4(&skel.bindR[i]));
+		XMVECTOR c = XMQuaternionNormalize(XMQuaternionMultiply(XMQuaternionInverse(sourceR), targetR));
+		if (XMVectorGetW(c) < 0.0f) c = XMVectorNegate(c);
+		XMStoreFloat4(&bone.rotation, c);
+
+		// Translation: offsets from the bind position scaled by the bone length ratio
+		const XMVECTOR sourceT = XMLoadFloat3(&source.bindT[s]);
+		const XMVECTOR targetT = XMLoadFloat3(&skel.bindT[i]);
+		const float sourceLen = XMVectorGetX(XMVector3Length(sourceT));
+		const float targetLen = XMVectorGetX(XMVector3Length(targetT));
+
+		bone.translationScale = (sourceLen > MIN_BONE_LENGTH && targetLen > MIN_BONE_LENGTH) ? targetLen / sourceLen : 1.0f;
+		XMStoreFloat3(&bone.translationOffset, XMVectorSubtract(targetT, XMVectorScale(sourceT, bone.translationScale)));
+
+		// Scale: ratio of the bind scales
+		const XMFLOAT3& ss = source.bindS[s];
+		const XMFLOAT3& ts = skel.bindS[i];
+		bone.scale.x = (std::fabs(ss.x) > MIN_BONE_LENGTH) ? ts.x / ss.x : 1.0f;
+		bone.scale.y = (std::fabs(ss.y) > MIN_BONE_LENGTH) ? ts.y / ss.y : 1.0f;
+		bone.scale.z = (std::fabs(ss.z) > MIN_BONE_LENGTH) ? ts.z / ss.z : 1.0f;
+
+		const float offsetEps = IDENTITY_OFFSET_EPS * std::max(targetLen, 1.0f);
+
+		bone.identity =
+			bone.rotation.w >= IDENTITY_ROTATION_DOT &&
+			std::fabs(bone.translationScale - 1.0f) <= IDENTITY_RATIO_EPS &&
+			XMVectorGetX(XMVector3Length(XMLoadFloat3(&bone.translationOffset))) <= offsetEps &&
+			std::fabs(bone.scale.x - 1.0f) <= IDENTITY_RATIO_EPS &&
+			std::fabs(bone.scale.y - 1.0f) <= IDENTITY_RATIO_EPS &&
+			std::fabs(bone.scale.z - 1.0f) <= IDENTITY_RATIO_EPS;
+
+		if (bone.identity)
+		{
+			bone = RetargetBone();
+		}
+		else
+		{
+			++outMap.correctedCount;
+		}
+	}
+}
+
+void AnimationRetarget_ApplyKeyPair(const RetargetBone& bone, TrackKeyPair& ioKeys)
+{
+	AnimationRetarget_ApplyTRS(bone, ioKeys.t0, ioKeys.r0, ioKeys.s0);
+	AnimationRetarget_ApplyTRS(bone, ioKeys.t1, ioKeys.r1, ioKeys.s1);
+}
+
+void AnimationRetarget_ApplyTRS(const RetargetBone& bone, XMFLOAT3& ioT, XMFLOAT4& ioR, XMFLOAT3& ioS)
+{
+	if (bone.identity) return;
+
+	// XMQuaternionMultiply(R, C) = C * R : the correction is applied after the clip rotation
+	XMStoreFloat4(&ioR, XMQuaternionMultiply(XMLoadFloat4(&ioR), XMLoadFloat4(&bone.rotation)));
+
+	ioT.x = ioT.x * bone.translationScale + bone.translationOffset.x;
+	ioT.y = ioT.y * bone.translationScale + bone.translationOffset.y;
+	ioT.z = ioT.z * bone.translationScale + bone.translationOffset.z;
+
+	ioS.x *= bone.scale.x;
+	ioS.y *= bone.scale.y;
+	ioS.z *= bone.scale.z;
+}
+
+// Same rule as the track binding: full name first, then the name after the last namespace separator
+static int FindSourceNode(const ClipSkeleton& source, const char* targetName)
+{
+	const char* targetShort = SkeletonUtil::GetShortName(targetName);
+	int candidateShort = -1;
+
+	for (int s = 0; s < source.NodeCount(); ++s)
+	{
+		const char* sourceName = source.names[s].c_str();
+
+		if (strcmp(sourceName, targetName) == 0) return s;
+
+		if (candidateShort < 0 && strcmp(SkeletonUtil::GetShortName(sourceName), targetShort) == 0)
+		{
+			candidateShort = s;
+		}
+	}
+
+	return candidateShort;
+}
+
+static void HashBytes(uint64_t& hash, const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+}
@@ -0,0 +1,87 @@
+/*==============================================================================
+
+   Clip retargeting [animation_retarget.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_RETARGET_H
+#define ANIMATION_RETARGET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+struct aiNode;
+struct ModelAsset;
+struct TrackKeyPair;
+
+/*
+// -------------------------------
+AnimationClip : tracks by name + ClipSkeleton (bind pose of the rig the clip was authored on)
+    -> loaded once, shared by every ModelAsset it plays on
+
+RetargetMap (one per (clip skeleton hash, target asset), cached in AnimationManager)
+├─ sourceNode[] : target node -> clip skeleton node, name match (full name > short name)
+└─ bones[]      : per target node, delta of the clip on top of the target bind pose
+    ├─ R' = C * R,  C = targetBindR * inverse(sourceBindR)
+    ├─ T' = T * translationScale + translationOffset (bone length ratio, bind maps to bind)
+    └─ S' = S * scale (targetBindS / sourceBindS)
+
+AnimationSampler : applied to both keys of a pair before interpolation, so in the same pass
+    (left quaternion product keeps the nlerp result, T / S maps are affine)
+Same rig (every correction ~identity) -> AnimationBinding::retarget stays nullptr, zero cost
+// -------------------------------
+*/
+
+// Node tree of the file a clip came from, parent before child
+struct ClipSkeleton
+{
+	std::vector<std::string> names;
+	std::vector<int> parent;
+	std::vector<DirectX::XMFLOAT3> bindT;
+	std::vector<DirectX::XMFLOAT4> bindR;
+	std::vector<DirectX::XMFLOAT3> bindS;
+
+	uint64_t hash = 0; // names + bind pose, clips of the same rig share retarget maps
+
+	int NodeCount() const { return static_cast<int>(names.size()); }
+	bool Empty() const { return names.empty(); }
+};
+
+struct RetargetBone
+{
+	DirectX::XMFLOAT4 rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+	DirectX::XMFLOAT3 translationOffset = { 0.0f, 0.0f, 0.0f };
+	float translationScale = 1.0f;
+	DirectX::XMFLOAT3 scale = { 1.0f, 1.0f, 1.0f };
+	bool identity = true;
+};
+
+struct RetargetMap
+{
+	uint64_t sourceHash = 0;
+	const ModelAsset* target = nullptr;
+
+	std::vector<int> sourceNode;     // per target node, -1: no counterpart
+	std::vector<RetargetBone> bones; // per target node
+	int correctedCount = 0;          // bones that are not identity
+
+	bool IsIdentity() const { return correctedCount == 0; }
+};
+
+// Load time, from the clip file's scene (names are copied, no aiNode is kept)
+// Defined with the import (animation_import.cpp), the only part that needs assimp
+void AnimationRetarget_BuildClipSkeleton(const aiNode* root, ClipSkeleton& out);
+uint64_t AnimationRetarget_HashSkeleton(const ClipSkeleton& skeleton);
+
+void AnimationRetarget_BuildMap(const ClipSkeleton& source, const ModelAsset* target, RetargetMap& outMap);
+
+// Frame path
+void AnimationRetarget_ApplyKeyPair(const RetargetBone& bone, TrackKeyPair& ioKeys);
+void AnimationRetarget_ApplyTRS(const RetargetBone& bone, DirectX::XMFLOAT3& ioT, DirectX::XMFLOAT4& ioR, DirectX::XMFLOAT3& ioS);
+
+#endif // ANIMATION_RETARGET_H
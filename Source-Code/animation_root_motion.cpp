@@ -0,0 +1,325 @@
+/*==============================================================================
+
+   Root motion extraction [animation_root_motion.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_root_motion.h"
+#include "animation.h"
+#include "axis_util.h"
+#include "debug_ostream.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+using namespace DirectX;
+
+static XMVECTOR SamplePosition(const std::vector<VectorKey>& keys, double ticks, const XMFLOAT3& fallback);
+static XMVECTOR SampleRotation(const std::vector<QuatKey>& keys, double ticks, const XMFLOAT4& fallback);
+static XMMATRIX BuildParentMatrix(const AnimationClip* clip, const ModelAsset* asset, int nodeIndex);
+static float ExtractYaw(FXMVECTOR rotation0, FXMVECTOR rotation);
+static float HorizontalRange(const BoneAnimTrack& track, FXMMATRIX toModel);
+static int FindRootTrack(const AnimationClip* clip, const ModelAsset* asset, const RootMotionSettings& settings, int& outNode);
+static XMVECTOR SampleCurve(const RootMotionCurve& curve, double ticks);
+
+
+bool AnimationRootMotion_Extract(AnimationClip* clip, const ModelAsset* asset, const RootMotionSettings& settings)
+{
+	if (!clip || !asset || clip->duration <= 0.0 || clip->ticksPerSecond <= 0.0) return false;
+
+	// Raw keys are edited, the quantized copy would keep the old motion
+	if (clip->IsCompressed())
+	{
+		hal::debug_print("[RootMotion] clip is already compressed, extract before AnimationCompression_CompressClip\n");
+		return false;
+	}
+
+	int nodeIndex = -1;
+	const int trackIndex = FindRootTrack(clip, asset, settings, nodeIndex);
+	if (trackIndex < 0) return false;
+
+	BoneAnimTrack& track = clip->tracks[trackIndex];
+	const SkeletonRuntime& skel = asset->skeleton;
+
+	// Track space -> import-fixed model space (rotation + uniform scale)
+	const XMMATRIX toModel = BuildParentMatrix(clip, asset, nodeIndex) * asset->importFix;
+	const XMMATRIX fromModel = XMMatrixInverse(nullptr, toModel);
+
+	XMVECTOR modelScale, modelRot, modelTrans;
+	XMMatrixDecompose(&modelScale, &modelRot, &modelTrans, toModel);
+	const XMVECTOR modelRotInv = XMQuaternionInverse(modelRot);
+
+	const XMFLOAT3& bindT = skel.bindT[nodeIndex];
+	const XMFLOAT4& bindR = skel.bindR[nodeIndex];
+
+	const XMVECTOR pos0 = XMVector3TransformCoord(SamplePosition(track.positionKeys, 0.0, bindT), toModel);
+	const XMVECTOR rot0 = XMQuaternionMultiply(SampleRotation(track.rotationKeys, 0.0, bindR), modelRot);
+
+	// 1. Bake the curve from the untouched keys
+	// Spacing rounded so the last sample lands exactly on the clip end
+	const double sampleRate = (settings.sampleRate > 0.0) ? settings.sampleRate : 30.0;
+	const int sampleCount = static_cast<int>(std::ceil(clip->duration / clip->ticksPerSecond * sampleRate)) + 1;
+
+	RootMotionCurve curve;
+	curve.ticksPerSample = clip->duration / (sampleCount - 1);
+	curve.samples.resize(sampleCount);
+
+	float prevYaw = 0.0f;
+	for (int i = 0; i < sampleCount; ++i)
+	{
+		const double ticks = std::min(i * curve.ticksPerSample, clip->duration);
+
+		const XMVECTOR pos = XMVector3TransformCoord(SamplePosition(track.positionKeys, ticks, bindT), toModel);
+		const XMVECTOR d = XMVectorSubtract(pos, pos0);
+
+		float yaw = 0.0f;
+		if (settings.extractYaw)
+		{
+			const XMVECTOR rot = XMQuaternionMultiply(SampleRotation(track.rotationKeys, ticks, bindR), modelRot);
+			yaw = ExtractYaw(rot0, rot);
+
+			// Unwrapped, so the lerp between two samples never spins the long way
+			while (yaw - prevYaw > XM_PI) yaw -= XM_2PI;
+			while (yaw - prevYaw < -XM_PI) yaw += XM_2PI;
+			prevYaw = yaw;
+		}
+
+		curve.samples[i] = XMFLOAT3(XMVectorGetX(d), XMVectorGetZ(d), yaw);
+	}
+
+	// 2. Remove it from the keys: x / z pinned to time 0, yaw taken out in model space
+	for (VectorKey& key : track.positionKeys)
+	{
+		XMVECTOR pos = XMVector3TransformCoord(XMLoadFloat3(&key.value), toModel);
+		pos = XMVectorSet(XMVectorGetX(pos0), XMVectorGetY(pos), XMVectorGetZ(pos0), 1.0f);
+		XMStoreFloat3(&key.value, XMVector3TransformCoord(pos, fromModel));
+	}
+
+	if (settings.extractYaw)
+	{
+		for (QuatKey& key : track.rotationKeys)
+		{
+			const XMVECTOR rot = XMQuaternionMultiply(XMLoadFloat4(&key.value), modelRot);
+			const XMVECTOR unyaw = XMQuaternionRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), -ExtractYaw(rot0, rot));
+
+			XMStoreFloat4(&key.value, XMQuaternionNormalize(XMQuaternionMultiply(XMQuaternionMultiply(rot, unyaw), modelRotInv)));
+		}
+	}
+
+	clip->rootMotion = std::move(curve);
+	clip->rootMotionTrack = trackIndex;
+
+	const XMFLOAT3& last = clip->rootMotion.samples.back();
+	char buf[256];
+	snprintf(buf, sizeof(buf), "[RootMotion] %s : track '%s', %.3f / %.3f over the clip, yaw %.1f deg\n",
+		clip->animName.c_str(), track.nodeName.c_str(), last.x, last.y, XMConvertToDegrees(last.z));
+	hal::debug_print(buf);
+
+	return true;
+}
+
+void AnimationRootMotion_ComputeDelta(const RootMotionCurve& curve, double fromTicks, double toTicks, bool wrapped, double duration, RootMotionDelta& outDelta)
+{
+	outDelta = RootMotionDelta();
+	if (curve.Empty()) return;
+
+	const XMVECTOR from = SampleCurve(curve, fromTicks);
+	const XMVECTOR to = SampleCurve(curve, toTicks);
+
+	XMVECTOR move; // (x, z, yaw) in the frame of time 0
+	float yaw;
+
+	if (!wrapped)
+	{
+		move = XMVectorSubtract(to, from);
+		yaw = XMVectorGetZ(move);
+	}
+	else
+	{
+		// from -> end, then start -> to turned by the yaw gained until the end
+		const XMVECTOR end = SampleCurve(curve, duration);
+		const XMVECTOR first = XMVectorSubtract(end, from);
+		const float turn = XMVectorGetZ(end);
+
+		const float c = std::cos(turn);
+		const float s = std::sin(turn);
+		const XMVECTOR second = XMVectorSet(
+			XMVectorGetX(to) * c + XMVectorGetY(to) * s,
+			-XMVectorGetX(to) * s + XMVectorGetY(to) * c,
+			0.0f, 0.0f);
+
+		move = XMVectorAdd(first, second);
+		yaw = XMVectorGetZ(first) + XMVectorGetZ(to);
+	}
+
+	// Into the character's frame at fromTicks (row vector, same as XMMatrixRotationY)
+	const float fromYaw = -XMVectorGetZ(from);
+	const float c = std::cos(fromYaw);
+	const float s = std::sin(fromYaw);
+	const float x = XMVectorGetX(move);
+	const float z = XMVectorGetY(move);
+
+	outDelta.translation = XMFLOAT3(x * c + z * s, 0.0f, -x * s + z * c);
+	outDelta.yaw = yaw;
+}
+
+// First key before / after the time, same clamping as the sampler
+static XMVECTOR SamplePosition(const std::vector<VectorKey>& keys, double ticks, const XMFLOAT3& fallback)
+{
+	if (keys.empty()) return XMLoadFloat3(&fallback);
+	if (keys.size() == 1 || ticks <= keys.front().time) return XMLoadFloat3(&keys.front().value);
+	if (ticks >= keys.back().time) return XMLoadFloat3(&keys.back().value);
+
+	auto it = std::upper_bound(keys.begin(), keys.end(), ticks, [](double t, const VectorKey& k) { return t < k.time; });
+	const VectorKey& k1 = *it;
+	const VectorKey& k0 = *(it - 1);
+
+	const double span = k1.time - k0.time;
+	const float f = (span > 0.0) ? static_cast<float>((ticks - k0.time) / span) : 0.0f;
+
+	return XMVectorLerp(XMLoadFloat3(&k0.value), XMLoadFloat3(&k1.value), f);
+}
+
+static XMVECTOR SampleRotation(const std::vector<QuatKey>& keys, double ticks, const XMFLOAT4& fallback)
+{
+	if (keys.empty()) return XMLoadFloat4(&fallback);
+	if (keys.size() == 1 || ticks <= keys.front().time) return XMLoadFloat4(&keys.front().value);
+	if (ticks >= keys.back().time) return XMLoadFloat4(&keys.back().value);
+
+	auto it = std::upper_bound(keys.begin(), keys.end(), ticks, [](double t, const QuatKey& k) { return t < k.time; });
+	const QuatKey& k1 = *it;
+	const QuatKey& k0 = *(it - 1);
+
+	const double span = k1.time - k0.time;
+	const float f = (span > 0.0) ? static_cast<float>((ticks - k0.time) / span) : 0.0f;
+
+	return XMQuaternionSlerp(XMLoadFloat4(&k0.value), XMLoadFloat4(&k1.value), f);
+}
+
+// Model matrix of the node's parent in the bind pose, with the clip axis fix of Animation_BuildSkinMatrices
+static XMMATRIX BuildParentMatrix(const AnimationClip* clip, const ModelAsset* asset, int nodeIndex)
+{
+	const SkeletonRuntime& skel = asset->skeleton;
+
+	XMMATRIX parentMtx = XMMatrixIdentity();
+	for (int p = skel.parentIndex[nodeIndex]; p >= 0; p = skel.parentIndex[p])
+	{
+		parentMtx = parentMtx * XMLoadFloat4x4(&skel.bindLocal[p]);
+	}
+
+	const UpAxis modelUp = UpFromBool(asset->sourceYup);
+	const UpAxis animUp = UpFromBool(clip->SourceYup);
+	if (animUp != modelUp)
+	{
+		parentMtx = parentMtx * GetAxisConversion(animUp, modelUp);
+	}
+
+	return parentMtx;
+}
+
+// Twist around +Y of the rotation from rotation0 to rotation (model space)
+static float ExtractYaw(FXMVECTOR rotation0, FXMVECTOR rotation)
+{
+	// rotation = rotation0 then delta
+	const XMVECTOR delta = XMQuaternionMultiply(XMQuaternionInverse(rotation0), rotation);
+
+	XMFLOAT4 d;
+	XMStoreFloat4(&d, delta);
+
+	return 2.0f * std::atan2(d.y, d.w);
+}
+
+static float HorizontalRange(const BoneAnimTrack& track, FXMMATRIX toModel)
+{
+	if (track.positionKeys.empty()) return 0.0f;
+
+	XMVECTOR vmin = XMVectorReplicate(FLT_MAX);
+	XMVECTOR vmax = XMVectorReplicate(-FLT_MAX);
+
+	for (const VectorKey& key : track.positionKeys)
+	{
+		const XMVECTOR pos = XMVector3TransformCoord(XMLoadFloat3(&key.value), toModel);
+		vmin = XMVectorMin(vmin, pos);
+		vmax = XMVectorMax(vmax, pos);
+	}
+
+	const XMVECTOR range = XMVectorSubtract(vmax, vmin);
+	return std::max(XMVectorGetX(range), XMVectorGetZ(range));
+}
+
+static int FindRootTrack(const AnimationClip* clip, const ModelAsset* asset, const RootMotionSettings& settings, int& outNode)
+{
+	const SkeletonRuntime& skel = asset->skeleton;
+	const int nodeCount = skel.NodeCount();
+
+	// Tracks are bound by name (the clip may not come from this asset's file)
+	AnimationBinding binding;
+	Animation_ResolveBinding(clip, asset, binding);
+
+	std::vector<int> trackToNode(clip->tracks.size(), -1);
+	for (int n = 0; n < nodeCount; ++n)
+	{
+		if (binding.nodeToTrack[n] >= 0) trackToNode[binding.nodeToTrack[n]] = n;
+	}
+
+	// Bone nodes and everything above them
+	std::vector<bool> skeletal(nodeCount, false);
+	for (int node : skel.boneToNode)
+	{
+		for (int n = node; n >= 0 && !skeletal[n]; n = skel.parentIndex[n])
+		{
+			skeletal[n] = true;
+		}
+	}
+
+	int best = -1;
+	int bestDepth = 0;
+
+	for (int t = 0; t < static_cast<int>(clip->tracks.size()); ++t)
+	{
+		const BoneAnimTrack& track = clip->tracks[t];
+
+		const int node = trackToNode[t];
+		if (node < 0) continue;
+
+		if (settings.rootNodeName)
+		{
+			if (track.nodeName != settings.rootNodeName) continue;
+			outNode = node;
+			return t;
+		}
+
+		if (!skeletal[node] || track.positionKeys.empty()) continue;
+		if (best >= 0 && skel.depth[node] >= bestDepth) continue;
+
+		// In-place tracks above the real root (armature nodes with constant keys) are skipped
+		const XMMATRIX toModel = BuildParentMatrix(clip, asset, node) * asset->importFix;
+		if (HorizontalRange(track, toModel) < settings.minDisplacement) continue;
+
+		best = t;
+		bestDepth = skel.depth[node];
+		outNode = node;
+	}
+
+	return best;
+}
+
+// (x, z, yaw) at 'ticks', clamped to the baked range
+static XMVECTOR SampleCurve(const RootMotionCurve& curve, double ticks)
+{
+	const int last = static_cast<int>(curve.samples.size()) - 1;
+
+	const double pos = (curve.ticksPerSample > 0.0) ? ticks / curve.ticksPerSample : 0.0;
+	if (pos <= 0.0) return XMLoadFloat3(&curve.samples.front());
+	if (pos >= last) return XMLoadFloat3(&curve.samples.back());
+
+	const int i = static_cast<int>(pos);
+	const float f = static_cast<float>(pos - i);
+
+	return XMVectorLerp(XMLoadFloat3(&curve.samples[i]), XMLoadFloat3(&curve.samples[i + 1]), f);
+}
@@ -0,0 +1,46 @@
+/*==============================================================================
+
+   Root motion extraction [animation_root_motion.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_ROOT_MOTION_H
+#define ANIMATION_ROOT_MOTION_H
+
+struct AnimationClip;
+struct ModelAsset;
+struct RootMotionCurve;
+struct RootMotionDelta;
+
+/*
+// -------------------------------
+AnimationRootMotion_Extract (load time, before compression)
+├─ 1. root track : rootNodeName, or the shallowest animated bone (ancestor) whose
+│     horizontal displacement exceeds minDisplacement
+├─ 2. root position / rotation moved into import-fixed model space (bind parents, axis fix, importFix)
+├─ 3. x, z and yaw relative to time 0 baked into clip->rootMotion at sampleRate
+└─ 4. the same x, z and yaw removed from the root track keys (character stays on the spot)
+
+AnimationPlayer::Update
+└─ AnimationRootMotion_ComputeDelta : two curve samples (one more on a loop wrap)
+// -------------------------------
+*/
+
+struct RootMotionSettings
+{
+	const char* rootNodeName = nullptr; // nullptr: pick automatically
+	bool extractYaw = true;
+	double sampleRate = 30.0;           // curve samples per second
+	float minDisplacement = 0.01f;      // world units, automatic pick ignores in-place tracks
+};
+
+// false when no track moves (idle clips): the clip is left untouched
+bool AnimationRootMotion_Extract(AnimationClip* clip, const ModelAsset* asset, const RootMotionSettings& settings = RootMotionSettings());
+
+// Motion from fromTicks to toTicks (wrapped: the clip looped once in between)
+void AnimationRootMotion_ComputeDelta(const RootMotionCurve& curve, double fromTicks, double toTicks, bool wrapped, double duration, RootMotionDelta& outDelta);
+
+#endif // ANIMATION_ROOT_MOTION_H
@@ -0,0 +1,697 @@
+/*==============================================================================
+
+   Batched pose sampling [animation_sampler.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_sampler.h"
+#include "animation.h"
+#include "skeleton_runtime.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+// Below this |dot| the keys are more than ~16 degrees apart and nlerp drifts, use slerp
+static const float NLERP_MIN_DOT = 0.99f;
+
+static const double KEY_GRID_EPSILON = 1.0e-3;            // key time off the common grid, in frames
+static const int KEY_GRID_MAX_DIVISOR = 8;                 // reduced keys: grid down to 1/8 of their smallest spacing
+static const size_t KEY_TABLE_MAX_BYTES = 4 * 1024 * 1024; // per binding, longer clips keep the key search
+
+// One row of 'stride' floats per key component
+enum PoseLane
+{
+	LANE_T0X, LANE_T0Y, LANE_T0Z,
+	LANE_T1X, LANE_T1Y, LANE_T1Z,
+	LANE_TF,
+	LANE_R0X, LANE_R0Y, LANE_R0Z, LANE_R0W,
+	LANE_R1X, LANE_R1Y, LANE_R1Z, LANE_R1W,
+	LANE_RF,
+	LANE_S0X, LANE_S0Y, LANE_S0Z,
+	LANE_S1X, LANE_S1Y, LANE_S1Z,
+	LANE_SF,
+
+	POSE_LANE_COUNT
+};
+
+// Keys of 4 nodes, one XMVECTOR per component (both sampling paths fill it)
+struct KeyGroup
+{
+	XMVECTOR t0[3], t1[3], ft;
+	XMVECTOR r0[4], r1[4], fr;
+	XMVECTOR s0[3], s1[3], fs;
+};
+
+static void GatherKeyPairs(
+	const AnimationClip* clip,
+	const AnimationBinding* binding,
+	const SkeletonRuntime& skel,
+	double timeTicks,
+	TrackCursor* cursors,
+	PoseSampleScratch& scratch,
+	LocalPoseSoA& outPose,
+	int maxDepth
+);
+static void SampleKeyTable(const PoseKeyTable& table, const SkeletonRuntime& skel, double timeTicks, LocalPoseSoA& outPose, int maxDepth);
+static void InterpolateGroup(KeyGroup& keys, LocalPoseSoA& outPose, int group);
+static void SlerpFallback(const KeyGroup& keys, const XMFLOAT4A& absDot, XMVECTOR* rot);
+template<typename Key>
+static void FindKeyStep(const std::vector<Key>& keys, double& ioStep);
+template<typename Key>
+static bool KeysOnGrid(const std::vector<Key>& keys, double step);
+static void FindTrackStep(const AnimationClip* clip, int trackIndex, double& ioStep);
+static bool TrackOnGrid(const AnimationClip* clip, int trackIndex, double step);
+static bool IsConstantTrack(const AnimationClip* clip, int trackIndex);
+static double TrackEndTime(const AnimationClip* clip, int trackIndex);
+static double KeyTime(const VectorKey& key) { return key.time; }
+static double KeyTime(const QuatKey& key) { return key.time; }
+static double KeyTime(float time) { return time; }
+
+
+void LocalPoseSoA::Resize(int nodeCount)
+{
+	if (count == nodeCount && !lanes.empty()) return;
+
+	count = nodeCount;
+	stride = (nodeCount + 3) & ~3;
+	lanes.assign(static_cast<size_t>(POSE_TRS_LANE_COUNT) * stride, 0.0f);
+	bind.assign(nodeCount, 1);
+
+	// Identity in the padding lanes
+	for (int i = nodeCount; i < stride; ++i)
+	{
+		Lane(POSE_RW)[i] = 1.0f;
+		Lane(POSE_SX)[i] = 1.0f;
+		Lane(POSE_SY)[i] = 1.0f;
+		Lane(POSE_SZ)[i] = 1.0f;
+	}
+}
+
+void AnimationSampler_SampleLocalPose(
+	const AnimationClip* clip,
+	const AnimationBinding* binding,
+	const SkeletonRuntime& skel,
+	double timeTicks,
+	TrackCursor* cursors,
+	PoseSampleScratch& scratch,
+	PoseMatrixBuffer& outLocal
+)
+{
+	AnimationSampler_SamplePose(clip, binding, skel, timeTicks, cursors, scratch, scratch.pose);
+	AnimationSampler_ComposeLocalMatrices(scratch.pose, skel, outLocal);
+}
+
+void AnimationSampler_SamplePose(
+	const AnimationClip* clip,
+	const AnimationBinding* binding,
+	const SkeletonRuntime& skel,
+	double timeTicks,
+	TrackCursor* cursors,
+	PoseSampleScratch& scratch,
+	LocalPoseSoA& outPose,
+	int maxDepth
+)
+{
+	const int nodeCount = skel.NodeCount();
+	outPose.Resize(nodeCount);
+
+	if (nodeCount == 0) return;
+
+	// 1. Frames gathered at bind time, or key search (scalar, cursor based) and SoA gather
+	if (binding && !binding->keyTable.Empty() && binding->keyTable.stride == outPose.stride)
+	{
+		SampleKeyTable(binding->keyTable, skel, timeTicks, outPose, maxDepth);
+		return;
+	}
+
+	GatherKeyPairs(clip, binding, skel, timeTicks, cursors, scratch, outPose, maxDepth);
+
+	const int stride = scratch.stride;
+	const float* lanes = scratch.lanes.data();
+
+	auto load = [lanes, stride](int lane, int group) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&lanes[lane * stride + group])); };
+
+	// 2. 4 bones per iteration
+	KeyGroup keys;
+	for (int g = 0; g < stride; g += 4)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			keys.t0[c] = load(LANE_T0X + c, g);
+			keys.t1[c] = load(LANE_T1X + c, g);
+			keys.s0[c] = load(LANE_S0X + c, g);
+			keys.s1[c] = load(LANE_S1X + c, g);
+		}
+		for (int c = 0; c < 4; ++c)
+		{
+			keys.r0[c] = load(LANE_R0X + c, g);
+			keys.r1[c] = load(LANE_R1X + c, g);
+		}
+		keys.ft = load(LANE_TF, g);
+		keys.fr = load(LANE_RF, g);
+		keys.fs = load(LANE_SF, g);
+
+		InterpolateGroup(keys, outPose, g);
+	}
+}
+
+bool AnimationSampler_BuildKeyTable(
+	const AnimationClip* clip,
+	const AnimationBinding& binding,
+	const SkeletonRuntime& skel,
+	PoseKeyTable& outTable
+)
+{
+	outTable = PoseKeyTable();
+
+	const int nodeCount = skel.NodeCount();
+	if (!clip || nodeCount == 0) return false;
+	if (static_cast<int>(binding.nodeToTrack.size()) != nodeCount) return false;
+
+	// Compressed clips are decoded here once, the table is the same for raw and quantized keys
+	const bool compressed = clip->IsCompressed();
+
+	// 1. Smallest key spacing and the wrap period of the driven tracks
+	// Constant tracks (one key per channel) sample the same at any time and are left out
+	double step = 0.0;
+	double endTime = -1.0;
+
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		const int trackIndex = binding.nodeToTrack[i];
+		if (trackIndex < 0 || IsConstantTrack(clip, trackIndex)) continue;
+
+		// Each track wraps at its own end, one table can only follow one
+		const double trackEnd = TrackEndTime(clip, trackIndex);
+		if (endTime < 0.0) endTime = trackEnd;
+		else if (trackEnd != endTime) return false;
+
+		FindTrackStep(clip, trackIndex, step);
+	}
+
+	int frameCount = 1;
+	if (step > 0.0)
+	{
+		// Key reduction may leave no two neighbouring keys anywhere: the spacing found is then
+		// a multiple of the source grid, which the kept keys are still on
+		double gridStep = 0.0;
+		for (int d = 1; d <= KEY_GRID_MAX_DIVISOR && gridStep <= 0.0; ++d)
+		{
+			bool onGrid = true;
+			for (int i = 0; i < nodeCount && onGrid; ++i)
+			{
+				const int trackIndex = binding.nodeToTrack[i];
+				if (trackIndex >= 0) onGrid = TrackOnGrid(clip, trackIndex, step / d);
+			}
+
+			if (onGrid) gridStep = step / d;
+		}
+
+		if (gridStep <= 0.0) return false;
+
+		step = gridStep;
+		frameCount = static_cast<int>(std::floor(endTime / step + 0.5)) + 1;
+	}
+	else
+	{
+		endTime = 0.0;
+	}
+
+	const int stride = (nodeCount + 3) & ~3;
+	const size_t floatsPerFrame = static_cast<size_t>(POSE_TRS_LANE_COUNT) * stride;
+	if (frameCount * floatsPerFrame * sizeof(float) > KEY_TABLE_MAX_BYTES) return false;
+
+	outTable.stride = stride;
+	outTable.frameCount = frameCount;
+	outTable.ticksPerFrame = step;
+	outTable.endTime = endTime;
+	outTable.frames.assign(frameCount * floatsPerFrame, 0.0f);
+	outTable.bind.assign(nodeCount, 1);
+
+	// 2. One pose per grid point: the key itself where the channel has one, interpolated across gaps.
+	// The last point is the end of the track, which the key search wraps to 0, so it takes the last keys
+	std::vector<TrackCursor> cursors(clip->tracks.size());
+	TrackKeyPair kp;
+
+	for (int f = 0; f < frameCount; ++f)
+	{
+		float* frame = &outTable.frames[f * floatsPerFrame];
+		const bool last = (frameCount > 1 && f == frameCount - 1);
+
+		for (int i = 0; i < stride; ++i)
+		{
+			XMFLOAT3 T(0.0f, 0.0f, 0.0f);
+			XMFLOAT4 R(0.0f, 0.0f, 0.0f, 1.0f);
+			XMFLOAT3 S(1.0f, 1.0f, 1.0f);
+
+			const int trackIndex = (i < nodeCount) ? binding.nodeToTrack[i] : -1;
+
+			if (trackIndex >= 0)
+			{
+				if (last && compressed)
+				{
+					AnimationCompression_GetLastKeys(clip->compressedTracks[trackIndex], T, R, S);
+				}
+				else if (last)
+				{
+					const BoneAnimTrack& track = clip->tracks[trackIndex];
+					if (!track.positionKeys.empty()) T = track.positionKeys.back().value;
+					if (!track.rotationKeys.empty()) R = track.rotationKeys.back().value;
+					if (!track.scaleKeys.empty())    S = track.scaleKeys.back().value;
+				}
+				else
+				{
+					if (compressed)
+					{
+						AnimationCompression_GetTrackKeyPair(clip->compressedTracks[trackIndex], f * step, cursors[trackIndex], kp);
+					}
+					else
+					{
+						Animation_GetTrackKeyPair(clip->tracks[trackIndex], f * step, cursors[trackIndex], kp);
+					}
+
+					XMStoreFloat3(&T, XMVectorLerp(XMLoadFloat3(&kp.t0), XMLoadFloat3(&kp.t1), kp.ft));
+					XMStoreFloat4(&R, XMQuaternionSlerp(XMLoadFloat4(&kp.r0), XMLoadFloat4(&kp.r1), kp.fr));
+					XMStoreFloat3(&S, XMVectorLerp(XMLoadFloat3(&kp.s0), XMLoadFloat3(&kp.s1), kp.fs));
+				}
+
+				if (binding.retarget && !binding.retarget->bones[i].identity)
+				{
+					AnimationRetarget_ApplyTRS(binding.retarget->bones[i], T, R, S);
+				}
+				outTable.bind[i] = 0;
+			}
+			else if (i < nodeCount)
+			{
+				T = skel.bindT[i];
+				R = skel.bindR[i];
+				S = skel.bindS[i];
+			}
+
+			frame[POSE_TX * stride + i] = T.x;
+			frame[POSE_TY * stride + i] = T.y;
+			frame[POSE_TZ * stride + i] = T.z;
+			frame[POSE_RX * stride + i] = R.x;
+			frame[POSE_RY * stride + i] = R.y;
+			frame[POSE_RZ * stride + i] = R.z;
+			frame[POSE_RW * stride + i] = R.w;
+			frame[POSE_SX * stride + i] = S.x;
+			frame[POSE_SY * stride + i] = S.y;
+			frame[POSE_SZ * stride + i] = S.z;
+		}
+	}
+
+	return true;
+}
+
+void AnimationSampler_ComposeLocalMatrices(
+	const LocalPoseSoA& pose,
+	const SkeletonRuntime& skel,
+	PoseMatrixBuffer& outLocal
+)
+{
+	const int nodeCount = pose.count;
+	outLocal.resize(nodeCount);
+
+	if (nodeCount == 0) return;
+
+	auto load = [&pose](int lane, int group) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pose.Lane(lane)[group])); };
+
+	const XMVECTOR zero = XMVectorZero();
+	const XMVECTOR one = XMVectorSplatOne();
+	const XMVECTOR two = XMVectorReplicate(2.0f);
+
+	for (int g = 0; g < pose.stride; g += 4)
+	{
+		const XMVECTOR tx = load(POSE_TX, g), ty = load(POSE_TY, g), tz = load(POSE_TZ, g);
+		const XMVECTOR sx = load(POSE_SX, g), sy = load(POSE_SY, g), sz = load(POSE_SZ, g);
+
+		// 3. M = S * R * T (row vectors, same layout as XMMatrixRotationQuaternion)
+		const XMVECTOR x = load(POSE_RX, g), y = load(POSE_RY, g), z = load(POSE_RZ, g), w = load(POSE_RW, g);
+
+		const XMVECTOR xx = XMVectorMultiply(x, x), yy = XMVectorMultiply(y, y), zz = XMVectorMultiply(z, z);
+		const XMVECTOR xy = XMVectorMultiply(x, y), xz = XMVectorMultiply(x, z), yz = XMVectorMultiply(y, z);
+		const XMVECTOR wx = XMVectorMultiply(w, x), wy = XMVectorMultiply(w, y), wz = XMVectorMultiply(w, z);
+
+		const XMVECTOR m00 = XMVectorMultiply(XMVectorNegativeMultiplySubtract(two, XMVectorAdd(yy, zz), one), sx);
+		const XMVECTOR m01 = XMVectorMultiply(XMVectorMultiply(two, XMVectorAdd(xy, wz)), sx);
+		const XMVECTOR m02 = XMVectorMultiply(XMVectorMultiply(two, XMVectorSubtract(xz, wy)), sx);
+
+		const XMVECTOR m10 = XMVectorMultiply(XMVectorMultiply(two, XMVectorSubtract(xy, wz)), sy);
+		const XMVECTOR m11 = XMVectorMultiply(XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, zz), one), sy);
+		const XMVECTOR m12 = XMVectorMultiply(XMVectorMultiply(two, XMVectorAdd(yz, wx)), sy);
+
+		const XMVECTOR m20 = XMVectorMultiply(XMVectorMultiply(two, XMVectorAdd(xz, wy)), sz);
+		const XMVECTOR m21 = XMVectorMultiply(XMVectorMultiply(two, XMVectorSubtract(yz, wx)), sz);
+		const XMVECTOR m22 = XMVectorMultiply(XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, yy), one), sz);
+
+		// SoA -> one matrix per lane
+		const XMMATRIX row0 = XMMatrixTranspose(XMMATRIX(m00, m01, m02, zero));
+		const XMMATRIX row1 = XMMatrixTranspose(XMMATRIX(m10, m11, m12, zero));
+		const XMMATRIX row2 = XMMatrixTranspose(XMMATRIX(m20, m21, m22, zero));
+		const XMMATRIX row3 = XMMatrixTranspose(XMMATRIX(tx, ty, tz, one));
+
+		const int laneCount = (nodeCount - g < 4) ? nodeCount - g : 4;
+		for (int j = 0; j < laneCount; ++j)
+		{
+			XMMATRIX& m = outLocal[g + j];
+			m.r[0] = row0.r[j];
+			m.r[1] = row1.r[j];
+			m.r[2] = row2.r[j];
+			m.r[3] = row3.r[j];
+		}
+	}
+
+	// Nodes no clip drives keep the exact bind matrix (may contain shear)
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		if (pose.bind[i])
+		{
+			outLocal[i] = XMLoadFloat4x4(&skel.bindLocal[i]);
+		}
+	}
+}
+
+static void GatherKeyPairs(
+	const AnimationClip* clip,
+	const AnimationBinding* binding,
+	const SkeletonRuntime& skel,
+	double timeTicks,
+	TrackCursor* cursors,
+	PoseSampleScratch& scratch,
+	LocalPoseSoA& outPose,
+	int maxDepth
+)
+{
+	const int nodeCount = skel.NodeCount();
+	const int stride = (nodeCount + 3) & ~3;
+	if (scratch.stride != stride)
+	{
+		scratch.stride = stride;
+		scratch.lanes.assign(static_cast<size_t>(POSE_LANE_COUNT) * stride, 0.0f);
+	}
+
+	float* lanes = scratch.lanes.data();
+	const bool compressed = clip && clip->IsCompressed();
+	const RetargetMap* retarget = binding ? binding->retarget : nullptr;
+
+	TrackKeyPair kp;
+
+	for (int i = 0; i < stride; ++i)
+	{
+		int trackIndex = (i < nodeCount && binding) ? binding->nodeToTrack[i] : -1;
+
+		if (trackIndex >= 0 && maxDepth >= 0 && skel.depth[i] > maxDepth)
+		{
+			trackIndex = -1; // LOD: too deep, bind pose
+		}
+
+		if (trackIndex >= 0)
+		{
+			if (compressed)
+			{
+				AnimationCompression_GetTrackKeyPair(clip->compressedTracks[trackIndex], timeTicks, cursors[trackIndex], kp);
+			}
+			else
+			{
+				Animation_GetTrackKeyPair(clip->tracks[trackIndex], timeTicks, cursors[trackIndex], kp);
+			}
+
+			// Both keys, so the correction rides along with the interpolation below
+			if (retarget && !retarget->bones[i].identity)
+			{
+				AnimationRetarget_ApplyKeyPair(retarget->bones[i], kp);
+			}
+			outPose.bind[i] = 0;
+		}
+		else if (i < nodeCount)
+		{
+			// Constant bind TRS, so blending against other clips stays continuous
+			kp = TrackKeyPair();
+			kp.t0 = kp.t1 = skel.bindT[i];
+			kp.r0 = kp.r1 = skel.bindR[i];
+			kp.s0 = kp.s1 = skel.bindS[i];
+			outPose.bind[i] = 1;
+		}
+		else
+		{
+			kp = TrackKeyPair(); // padding : identity
+		}
+
+		lanes[LANE_T0X * stride + i] = kp.t0.x;
+		lanes[LANE_T0Y * stride + i] = kp.t0.y;
+		lanes[LANE_T0Z * stride + i] = kp.t0.z;
+		lanes[LANE_T1X * stride + i] = kp.t1.x;
+		lanes[LANE_T1Y * stride + i] = kp.t1.y;
+		lanes[LANE_T1Z * stride + i] = kp.t1.z;
+		lanes[LANE_TF  * stride + i] = kp.ft;
+
+		lanes[LANE_R0X * stride + i] = kp.r0.x;
+		lanes[LANE_R0Y * stride + i] = kp.r0.y;
+		lanes[LANE_R0Z * stride + i] = kp.r0.z;
+		lanes[LANE_R0W * stride + i] = kp.r0.w;
+		lanes[LANE_R1X * stride + i] = kp.r1.x;
+		lanes[LANE_R1Y * stride + i] = kp.r1.y;
+		lanes[LANE_R1Z * stride + i] = kp.r1.z;
+		lanes[LANE_R1W * stride + i] = kp.r1.w;
+		lanes[LANE_RF  * stride + i] = kp.fr;
+
+		lanes[LANE_S0X * stride + i] = kp.s0.x;
+		lanes[LANE_S0Y * stride + i] = kp.s0.y;
+		lanes[LANE_S0Z * stride + i] = kp.s0.z;
+		lanes[LANE_S1X * stride + i] = kp.s1.x;
+		lanes[LANE_S1Y * stride + i] = kp.s1.y;
+		lanes[LANE_S1Z * stride + i] = kp.s1.z;
+		lanes[LANE_SF  * stride + i] = kp.fs;
+	}
+}
+
+// Same time wrap as the key search; frames f and f + 1 around the time, one factor for every lane
+static void SampleKeyTable(const PoseKeyTable& table, const SkeletonRuntime& skel, double timeTicks, LocalPoseSoA& outPose, int maxDepth)
+{
+	double t = timeTicks;
+	if (table.endTime > 0.0)
+	{
+		t = fmod(t, table.endTime);
+		if (t < 0.0) t += table.endTime;
+	}
+
+	int f = 0;
+	float factor = 0.0f;
+	if (table.frameCount > 1)
+	{
+		const double x = t / table.ticksPerFrame;
+		f = std::min(std::max(static_cast<int>(std::floor(x)), 0), table.frameCount - 2);
+		factor = static_cast<float>(std::min(std::max(x - f, 0.0), 1.0));
+	}
+
+	const int stride = table.stride;
+	const float* a = table.Frame(f);
+	const float* b = table.Frame(std::min(f + 1, table.frameCount - 1));
+
+	auto load = [stride](const float* frame, int lane, int group) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&frame[lane * stride + group])); };
+
+	KeyGroup keys;
+	keys.ft = keys.fr = keys.fs = XMVectorReplicate(factor);
+
+	for (int g = 0; g < stride; g += 4)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			keys.t0[c] = load(a, POSE_TX + c, g);
+			keys.t1[c] = load(b, POSE_TX + c, g);
+			keys.s0[c] = load(a, POSE_SX + c, g);
+			keys.s1[c] = load(b, POSE_SX + c, g);
+		}
+		for (int c = 0; c < 4; ++c)
+		{
+			keys.r0[c] = load(a, POSE_RX + c, g);
+			keys.r1[c] = load(b, POSE_RX + c, g);
+		}
+
+		InterpolateGroup(keys, outPose, g);
+	}
+
+	outPose.bind.assign(table.bind.begin(), table.bind.end());
+
+	// LOD: too deep, bind pose (what the key search path gathers for those nodes)
+	if (maxDepth < 0) return;
+
+	for (int i = 0; i < outPose.count; ++i)
+	{
+		if (outPose.bind[i] || skel.depth[i] <= maxDepth) continue;
+
+		outPose.Lane(POSE_TX)[i] = skel.bindT[i].x;
+		outPose.Lane(POSE_TY)[i] = skel.bindT[i].y;
+		outPose.Lane(POSE_TZ)[i] = skel.bindT[i].z;
+		outPose.Lane(POSE_RX)[i] = skel.bindR[i].x;
+		outPose.Lane(POSE_RY)[i] = skel.bindR[i].y;
+		outPose.Lane(POSE_RZ)[i] = skel.bindR[i].z;
+		outPose.Lane(POSE_RW)[i] = skel.bindR[i].w;
+		outPose.Lane(POSE_SX)[i] = skel.bindS[i].x;
+		outPose.Lane(POSE_SY)[i] = skel.bindS[i].y;
+		outPose.Lane(POSE_SZ)[i] = skel.bindS[i].z;
+		outPose.bind[i] = 1;
+	}
+}
+
+// Lerp T / S, nlerp R on the shortest arc, 4 nodes from 'group' on
+static void InterpolateGroup(KeyGroup& keys, LocalPoseSoA& outPose, int group)
+{
+	auto store = [&outPose, group](int lane, FXMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&outPose.Lane(lane)[group]), v); };
+
+	for (int c = 0; c < 3; ++c)
+	{
+		store(POSE_TX + c, XMVectorLerpV(keys.t0[c], keys.t1[c], keys.ft));
+		store(POSE_SX + c, XMVectorLerpV(keys.s0[c], keys.s1[c], keys.fs));
+	}
+
+	XMVECTOR dot = XMVectorMultiply(keys.r0[0], keys.r1[0]);
+	dot = XMVectorMultiplyAdd(keys.r0[1], keys.r1[1], dot);
+	dot = XMVectorMultiplyAdd(keys.r0[2], keys.r1[2], dot);
+	dot = XMVectorMultiplyAdd(keys.r0[3], keys.r1[3], dot);
+
+	const XMVECTOR flip = XMVectorLess(dot, XMVectorZero());
+
+	XMVECTOR rot[4];
+	for (int c = 0; c < 4; ++c)
+	{
+		keys.r1[c] = XMVectorSelect(keys.r1[c], XMVectorNegate(keys.r1[c]), flip);
+		rot[c] = XMVectorLerpV(keys.r0[c], keys.r1[c], keys.fr);
+	}
+
+	XMVECTOR lenSq = XMVectorMultiply(rot[0], rot[0]);
+	lenSq = XMVectorMultiplyAdd(rot[1], rot[1], lenSq);
+	lenSq = XMVectorMultiplyAdd(rot[2], rot[2], lenSq);
+	lenSq = XMVectorMultiplyAdd(rot[3], rot[3], lenSq);
+
+	const XMVECTOR invLen = XMVectorReciprocalSqrt(XMVectorMax(lenSq, g_XMEpsilon));
+	for (int c = 0; c < 4; ++c)
+	{
+		rot[c] = XMVectorMultiply(rot[c], invLen);
+	}
+
+	XMFLOAT4A absDot;
+	XMStoreFloat4A(&absDot, XMVectorAbs(dot));
+	if (absDot.x < NLERP_MIN_DOT || absDot.y < NLERP_MIN_DOT || absDot.z < NLERP_MIN_DOT || absDot.w < NLERP_MIN_DOT)
+	{
+		SlerpFallback(keys, absDot, rot);
+	}
+
+	for (int c = 0; c < 4; ++c)
+	{
+		store(POSE_RX + c, rot[c]);
+	}
+}
+
+// Lanes whose keys are far apart: redo them with XMQuaternionSlerp, like the scalar path
+static void SlerpFallback(const KeyGroup& keys, const XMFLOAT4A& absDot, XMVECTOR* rot)
+{
+	const float dots[4] = { absDot.x, absDot.y, absDot.z, absDot.w };
+
+	XMFLOAT4A comp[4], r0[4], r1[4], fr;
+	for (int c = 0; c < 4; ++c)
+	{
+		XMStoreFloat4A(&comp[c], rot[c]);
+		XMStoreFloat4A(&r0[c], keys.r0[c]);
+		XMStoreFloat4A(&r1[c], keys.r1[c]);
+	}
+	XMStoreFloat4A(&fr, keys.fr);
+
+	for (int j = 0; j < 4; ++j)
+	{
+		if (dots[j] >= NLERP_MIN_DOT) continue;
+
+		const XMVECTOR a = XMVectorSet((&r0[0].x)[j], (&r0[1].x)[j], (&r0[2].x)[j], (&r0[3].x)[j]);
+		const XMVECTOR b = XMVectorSet((&r1[0].x)[j], (&r1[1].x)[j], (&r1[2].x)[j], (&r1[3].x)[j]);
+
+		XMFLOAT4 q;
+		XMStoreFloat4(&q, XMQuaternionSlerp(a, b, (&fr.x)[j]));
+
+		(&comp[0].x)[j] = q.x;
+		(&comp[1].x)[j] = q.y;
+		(&comp[2].x)[j] = q.z;
+		(&comp[3].x)[j] = q.w;
+	}
+
+	for (int c = 0; c < 4; ++c)
+	{
+		rot[c] = XMLoadFloat4A(&comp[c]);
+	}
+}
+
+template<typename Key>
+static void FindKeyStep(const std::vector<Key>& keys, double& ioStep)
+{
+	for (size_t k = 1; k < keys.size(); ++k)
+	{
+		const double d = KeyTime(keys[k]) - KeyTime(keys[k - 1]);
+		if (d > 0.0 && (ioStep <= 0.0 || d < ioStep)) ioStep = d;
+	}
+}
+
+template<typename Key>
+static bool KeysOnGrid(const std::vector<Key>& keys, double step)
+{
+	if (keys.size() < 2) return true; // constant channel
+
+	for (const Key& key : keys)
+	{
+		const double x = KeyTime(key) / step;
+		if (x < -KEY_GRID_EPSILON || std::fabs(x - std::floor(x + 0.5)) > KEY_GRID_EPSILON) return false;
+	}
+
+	return true;
+}
+
+// Raw keys or the kept keys of the compressed track, whichever the clip samples
+static void FindTrackStep(const AnimationClip* clip, int trackIndex, double& ioStep)
+{
+	if (clip->IsCompressed())
+	{
+		const CompressedTrack& track = clip->compressedTracks[trackIndex];
+		FindKeyStep(track.position.times, ioStep);
+		FindKeyStep(track.rotation.times, ioStep);
+		FindKeyStep(track.scale.times, ioStep);
+		return;
+	}
+
+	const BoneAnimTrack& track = clip->tracks[trackIndex];
+	FindKeyStep(track.positionKeys, ioStep);
+	FindKeyStep(track.rotationKeys, ioStep);
+	FindKeyStep(track.scaleKeys, ioStep);
+}
+
+static bool TrackOnGrid(const AnimationClip* clip, int trackIndex, double step)
+{
+	if (clip->IsCompressed())
+	{
+		const CompressedTrack& track = clip->compressedTracks[trackIndex];
+		return KeysOnGrid(track.position.times, step) && KeysOnGrid(track.rotation.times, step) && KeysOnGrid(track.scale.times, step);
+	}
+
+	const BoneAnimTrack& track = clip->tracks[trackIndex];
+	return KeysOnGrid(track.positionKeys, step) && KeysOnGrid(track.rotationKeys, step) && KeysOnGrid(track.scaleKeys, step);
+}
+
+static bool IsConstantTrack(const AnimationClip* clip, int trackIndex)
+{
+	if (clip->IsCompressed())
+	{
+		const CompressedTrack& track = clip->compressedTracks[trackIndex];
+		return track.position.KeyCount() < 2 && track.rotation.KeyCount() < 2 && track.scale.KeyCount() < 2;
+	}
+
+	const BoneAnimTrack& track = clip->tracks[trackIndex];
+	return track.positionKeys.size() < 2 && track.rotationKeys.size() < 2 && track.scaleKeys.size() < 2;
+}
+
+static double TrackEndTime(const AnimationClip* clip, int trackIndex)
+{
+	return clip->IsCompressed() ? clip->compressedTracks[trackIndex].endTime : clip->tracks[trackIndex].endTime;
+}
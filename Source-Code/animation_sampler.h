@@ -0,0 +1,147 @@
+/*==============================================================================
+
+   Batched pose sampling [animation_sampler.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_SAMPLER_H
+#define ANIMATION_SAMPLER_H
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "aligned_alloc_util.h"
+
+struct AnimationClip;
+struct AnimationBinding;
+struct SkeletonRuntime;
+struct TrackCursor;
+
+/*
+// -------------------------------
+AnimationSampler_SampleLocalPose
+├─ AnimationSampler_SamplePose
+│   ├─ 1. binding with a PoseKeyTable : two frames picked by time, already in SoA lanes
+│   │     otherwise : key search per channel (cursor) -> key pairs gathered into SoA lanes
+│   └─ 2. 4 bones per XMVECTOR : lerp T/S, nlerp R (slerp for lanes with a large angle)
+│         -> LocalPoseSoA (blend space, see AnimationBlender)
+└─ AnimationSampler_ComposeLocalMatrices
+    └─ 3. S * R * T composed per lane group and transposed into the pose buffer
+// -------------------------------
+*/
+
+// Per-node matrices (local or model space), 16 byte aligned on every platform
+typedef std::vector<DirectX::XMMATRIX, AlignedAllocator<DirectX::XMMATRIX, 16>> PoseMatrixBuffer;
+
+// Read-only view into a pose buffer, indexed by SkeletonRuntime node index
+struct PoseView
+{
+	const DirectX::XMMATRIX* data = nullptr;
+	int count = 0;
+
+	int Size() const { return count; }
+	bool Empty() const { return count == 0; }
+
+	const DirectX::XMMATRIX& operator[](int i) const { return data[i]; }
+	const DirectX::XMMATRIX* begin() const { return data; }
+	const DirectX::XMMATRIX* end() const { return data + count; }
+};
+
+// Components of LocalPoseSoA, one row of 'stride' floats each
+enum PoseTrsLane
+{
+	POSE_TX, POSE_TY, POSE_TZ,
+	POSE_RX, POSE_RY, POSE_RZ, POSE_RW,
+	POSE_SX, POSE_SY, POSE_SZ,
+
+	POSE_TRS_LANE_COUNT
+};
+
+// Local T / R / S of every node in SoA layout
+// Padding lanes (count..stride) hold identity so 4-wide loops need no tail
+struct LocalPoseSoA
+{
+	int count = 0;
+	int stride = 0;             // count rounded up to 4
+	std::vector<float> lanes;   // POSE_TRS_LANE_COUNT * stride
+	std::vector<uint8_t> bind;  // 1: no clip drives the node, compose uses the exact bindLocal
+
+	// Reallocates only when the node count changes
+	void Resize(int nodeCount);
+
+	float* Lane(int lane) { return &lanes[static_cast<size_t>(lane) * stride]; }
+	const float* Lane(int lane) const { return &lanes[static_cast<size_t>(lane) * stride]; }
+};
+
+// Keys of one binding gathered into SoA once, when every driven channel has its keys
+// on one uniform grid (FBX bakes do): frame f holds the pose at f * ticksPerFrame,
+// POSE_TRS_LANE_COUNT rows of 'stride' floats (retarget applied, bind TRS for the
+// nodes no track drives). Sampling then reads two frames, no key search and no gather
+struct PoseKeyTable
+{
+	int stride = 0;
+	int frameCount = 0;
+	double ticksPerFrame = 0.0;
+	double endTime = 0.0;      // wrap period, BoneAnimTrack::endTime of the driven tracks
+	std::vector<float> frames; // frameCount * POSE_TRS_LANE_COUNT * stride
+	std::vector<uint8_t> bind; // per node, same meaning as LocalPoseSoA::bind
+
+	bool Empty() const { return frames.empty(); }
+	const float* Frame(int f) const { return &frames[static_cast<size_t>(f) * POSE_TRS_LANE_COUNT * stride]; }
+};
+
+// Per-player scratch, grows to the largest skeleton and is reused every frame
+struct PoseSampleScratch
+{
+	int stride = 0;             // node count rounded up to 4
+	std::vector<float> lanes;   // key pair lanes, one row per component
+	LocalPoseSoA pose;          // SampleLocalPose intermediate
+};
+
+// Compressed clips are decoded into the table (the keys key reduction kept are still on
+// the source grid, which the table is built on)
+// false (outTable left empty) : keys off a common grid, or a table over the size limit;
+// the binding then keeps sampling through the key search
+bool AnimationSampler_BuildKeyTable(
+	const AnimationClip* clip,
+	const AnimationBinding& binding,
+	const SkeletonRuntime& skel,
+	PoseKeyTable& outTable
+);
+
+// Interpolated local TRS of every node; untracked nodes get the bind TRS
+// maxDepth >= 0 : nodes deeper than SkeletonRuntime::depth maxDepth are not sampled and keep the bind pose (LOD)
+void AnimationSampler_SamplePose(
+	const AnimationClip* clip,
+	const AnimationBinding* binding,
+	const SkeletonRuntime& skel,
+	double timeTicks,
+	TrackCursor* cursors,
+	PoseSampleScratch& scratch,
+	LocalPoseSoA& outPose,
+	int maxDepth = -1
+);
+
+// outLocal[i] = S * R * T of node i (bindLocal where pose.bind[i])
+void AnimationSampler_ComposeLocalMatrices(
+	const LocalPoseSoA& pose,
+	const SkeletonRuntime& skel,
+	PoseMatrixBuffer& outLocal
+);
+
+// SamplePose + ComposeLocalMatrices, outLocal[i] : local matrix of SkeletonRuntime node i
+void AnimationSampler_SampleLocalPose(
+	const AnimationClip* clip,
+	const AnimationBinding* binding,
+	const SkeletonRuntime& skel,
+	double timeTicks,
+	TrackCursor* cursors,
+	PoseSampleScratch& scratch,
+	PoseMatrixBuffer& outLocal
+);
+
+#endif // ANIMATION_SAMPLER_H
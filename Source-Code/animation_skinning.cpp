@@ -0,0 +1,358 @@
+/*==============================================================================
+
+   CPU skinning [animation_skinning.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_skinning.h"
+#include "model_vertex.h"
+#include "worker_pool_util.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace DirectX;
+
+static const int MAX_BONES = 256;          // shader_vertex_3d_skinned.hlsl
+static const int MAX_DQ_BONES = 512;       // shader_vertex_3d_skinned_dq.hlsl, same buffer size
+static const float MIN_WEIGHT_SUM = 0.0001f; // below this the shader keeps the bind pose
+static const int VERTEX_GRAIN = 2048;      // vertices per chunk on the worker pool
+
+static int ClampBoneCount(int boneCount, int maxBones = MAX_BONES);
+static void MergeBox(const XMVECTOR& center, const XMVECTOR& extent, XMVECTOR& ioMin, XMVECTOR& ioMax);
+
+
+// palette[b] is the transposed skin matrix, so each row dotted with (x, y, z, 1)
+// gives one output component. Rows are blended first (linear, same result as
+// blending the 4 transformed positions in the shader), then transposed once into
+// columns shared by the position and the normal
+void AnimationSkinning_Skin(
+	const Vertex3d* vertices,
+	int vertexCount,
+	const XMFLOAT4X4* palette,
+	int boneCount,
+	XMFLOAT3* outPositions,
+	XMFLOAT3* outNormals)
+{
+	const int bones = ClampBoneCount(boneCount);
+
+	for (int v = 0; v < vertexCount; ++v)
+	{
+		const Vertex3d& vtx = vertices[v];
+
+		const float weightSum = vtx.boneWeight[0] + vtx.boneWeight[1] + vtx.boneWeight[2] + vtx.boneWeight[3];
+
+		if (weightSum <= MIN_WEIGHT_SUM)
+		{
+			outPositions[v] = vtx.position;
+			if (outNormals) outNormals[v] = vtx.normal;
+			continue;
+		}
+
+		XMVECTOR r0 = XMVectorZero();
+		XMVECTOR r1 = XMVectorZero();
+		XMVECTOR r2 = XMVectorZero();
+
+		for (int i = 0; i < 4; ++i)
+		{
+			const uint32_t idx = vtx.boneIndex[i];
+			const float w = vtx.boneWeight[i];
+
+			if (idx >= static_cast<uint32_t>(bones) || !(w > 0.0f)) continue;
+
+			const XMFLOAT4X4& m = palette[idx];
+			const XMVECTOR wv = XMVectorReplicate(w);
+
+			r0 = XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m._11)), wv, r0);
+			r1 = XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m._21)), wv, r1);
+			r2 = XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m._31)), wv, r2);
+		}
+
+		// Columns of the blended 3x4 (4th row unused: w of a position stays the weight sum)
+		const XMMATRIX cols = XMMatrixTranspose(XMMATRIX(r0, r1, r2, XMVectorZero()));
+
+		const XMVECTOR p = XMLoadFloat3(&vtx.position);
+		XMVECTOR pos = XMVectorMultiplyAdd(cols.r[0], XMVectorSplatX(p), cols.r[3]);
+		pos = XMVectorMultiplyAdd(cols.r[1], XMVectorSplatY(p), pos);
+		pos = XMVectorMultiplyAdd(cols.r[2], XMVectorSplatZ(p), pos);
+		XMStoreFloat3(&outPositions[v], pos);
+
+		if (outNormals)
+		{
+			const XMVECTOR n = XMLoadFloat3(&vtx.normal);
+			XMVECTOR nrm = XMVectorMultiply(cols.r[0], XMVectorSplatX(n));
+			nrm = XMVectorMultiplyAdd(cols.r[1], XMVectorSplatY(n), nrm);
+			nrm = XMVectorMultiplyAdd(cols.r[2], XMVectorSplatZ(n), nrm);
+			XMStoreFloat3(&outNormals[v], XMVector3Normalize(nrm));
+		}
+	}
+}
+
+void AnimationSkinning_SkinParallel(
+	WorkerPool* pool,
+	const Vertex3d* vertices,
+	int vertexCount,
+	const XMFLOAT4X4* palette,
+	int boneCount,
+	XMFLOAT3* outPositions,
+	XMFLOAT3* outNormals)
+{
+	if (!pool || vertexCount <= VERTEX_GRAIN)
+	{
+		AnimationSkinning_Skin(vertices, vertexCount, palette, boneCount, outPositions, outNormals);
+		return;
+	}
+
+	// Vertices are independent, chunks write disjoint ranges
+	pool->ParallelFor(vertexCount, VERTEX_GRAIN, [=](int begin, int end)
+	{
+		AnimationSkinning_Skin(
+			vertices + begin, end - begin, palette, boneCount,
+			outPositions + begin, outNormals ? outNormals + begin : nullptr);
+	});
+}
+
+bool AnimationSkinning_ComputePosedAABB(const BoneBounds* bounds, int boundsCount, const XMFLOAT4X4* palette, int boneCount, AABB& outBox)
+{
+	if (!bounds || boundsCount <= 0) return false;
+
+	const int bones = ClampBoneCount(boneCount);
+
+	XMVECTOR vmin = XMVectorReplicate(FLT_MAX);
+	XMVECTOR vmax = XMVectorReplicate(-FLT_MAX);
+
+	for (int i = 0; i < boundsCount; ++i)
+	{
+		const BoneBounds& bb = bounds[i];
+
+		const XMVECTOR bmin = XMLoadFloat3(&bb.box.min);
+		const XMVECTOR bmax = XMLoadFloat3(&bb.box.max);
+		const XMVECTOR center = XMVectorScale(XMVectorAdd(bmin, bmax), 0.5f);
+		const XMVECTOR extent = XMVectorScale(XMVectorSubtract(bmax, bmin), 0.5f);
+
+		// Unweighted vertices (bone -1) stay where they are, like in the shader
+		if (bb.bone < 0 || bb.bone >= bones)
+		{
+			MergeBox(center, extent, vmin, vmax);
+			continue;
+		}
+
+		// Center through the skin matrix, extent through its absolute rows
+		const XMMATRIX skin = XMMatrixTranspose(XMLoadFloat4x4(&palette[bb.bone]));
+
+		const XMVECTOR c = XMVector3Transform(center, skin);
+
+		XMVECTOR e = XMVectorMultiply(XMVectorAbs(skin.r[0]), XMVectorSplatX(extent));
+		e = XMVectorMultiplyAdd(XMVectorAbs(skin.r[1]), XMVectorSplatY(extent), e);
+		e = XMVectorMultiplyAdd(XMVectorAbs(skin.r[2]), XMVectorSplatZ(extent), e);
+
+		MergeBox(c, e, vmin, vmax);
+	}
+
+	XMStoreFloat3(&outBox.min, vmin);
+	XMStoreFloat3(&outBox.max, vmax);
+	return true;
+}
+
+void AnimationSkinning_BuildDualQuatPalette(const XMFLOAT4X4* palette, int boneCount, SkinDualQuat* outDualQuats)
+{
+	const int bones = ClampBoneCount(boneCount, MAX_DQ_BONES);
+
+	for (int b = 0; b < bones; ++b)
+	{
+		// Back to the row-vector skin matrix: rows 0..2 rotation (* scale), row 3 translation
+		const XMMATRIX m = XMMatrixTranspose(XMLoadFloat4x4(&palette[b]));
+
+		const XMMATRIX rot(
+			XMVector3Normalize(m.r[0]),
+			XMVector3Normalize(m.r[1]),
+			XMVector3Normalize(m.r[2]),
+			g_XMIdentityR3);
+
+		const XMVECTOR real = XMQuaternionNormalize(XMQuaternionRotationMatrix(rot));
+		const XMVECTOR t = XMVectorSetW(m.r[3], 0.0f); // (t, 0)
+
+		// XMQuaternionMultiply(real, t) = t * real
+		const XMVECTOR dual = XMVectorScale(XMQuaternionMultiply(real, t), 0.5f);
+
+		XMStoreFloat4(&outDualQuats[b].real, real);
+		XMStoreFloat4(&outDualQuats[b].dual, dual);
+	}
+}
+
+void AnimationSkinning_BuildDualQuatPalette(const std::vector<XMFLOAT4X4>& palette, std::vector<SkinDualQuat>& outDualQuats)
+{
+	outDualQuats.resize(ClampBoneCount(static_cast<int>(palette.size()), MAX_DQ_BONES));
+
+	if (outDualQuats.empty()) return;
+
+	AnimationSkinning_BuildDualQuatPalette(palette.data(), static_cast<int>(outDualQuats.size()), outDualQuats.data());
+}
+
+void AnimationSkinning_SkinDualQuat(
+	const Vertex3d* vertices,
+	int vertexCount,
+	const SkinDualQuat* dualQuats,
+	int boneCount,
+	XMFLOAT3* outPositions,
+	XMFLOAT3* outNormals)
+{
+	const int bones = ClampBoneCount(boneCount, MAX_DQ_BONES);
+
+	for (int v = 0; v < vertexCount; ++v)
+	{
+		const Vertex3d& vtx = vertices[v];
+
+		const float weightSum = vtx.boneWeight[0] + vtx.boneWeight[1] + vtx.boneWeight[2] + vtx.boneWeight[3];
+
+		if (weightSum <= MIN_WEIGHT_SUM)
+		{
+			outPositions[v] = vtx.position;
+			if (outNormals) outNormals[v] = vtx.normal;
+			continue;
+		}
+
+		XMVECTOR real = XMVectorZero();
+		XMVECTOR dual = XMVectorZero();
+		XMVECTOR pivot = XMVectorZero();
+		bool first = true;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			const uint32_t idx = vtx.boneIndex[i];
+			float w = vtx.boneWeight[i];
+
+			if (idx >= static_cast<uint32_t>(bones) || !(w > 0.0f)) continue;
+
+			const XMVECTOR r = XMLoadFloat4(&dualQuats[idx].real);
+			const XMVECTOR d = XMLoadFloat4(&dualQuats[idx].dual);
+
+			// q and -q are the same transform, blend on the first influence's side
+			if (first)
+			{
+				pivot = r;
+				first = false;
+			}
+			else if (XMVectorGetX(XMVector4Dot(r, pivot)) < 0.0f)
+			{
+				w = -w;
+			}
+
+			const XMVECTOR wv = XMVectorReplicate(w);
+			real = XMVectorMultiplyAdd(r, wv, real);
+			dual = XMVectorMultiplyAdd(d, wv, dual);
+		}
+
+		const float len = XMVectorGetX(XMVector4Length(real));
+		if (first || !(len > 0.0f))
+		{
+			outPositions[v] = vtx.position;
+			if (outNormals) outNormals[v] = vtx.normal;
+			continue;
+		}
+
+		const XMVECTOR invLen = XMVectorReplicate(1.0f / len);
+		real = XMVectorMultiply(real, invLen);
+		dual = XMVectorMultiply(dual, invLen);
+
+		// Rotation: p + 2 * r.xyz x (r.xyz x p + r.w * p)
+		// Translation: 2 * (r.w * d.xyz - d.w * r.xyz + r.xyz x d.xyz)
+		const XMVECTOR rw = XMVectorSplatW(real);
+		const XMVECTOR dw = XMVectorSplatW(dual);
+		const XMVECTOR two = XMVectorReplicate(2.0f);
+
+		XMVECTOR trans = XMVectorSubtract(XMVectorMultiply(rw, dual), XMVectorMultiply(dw, real));
+		trans = XMVectorScale(XMVectorAdd(trans, XMVector3Cross(real, dual)), 2.0f);
+
+		const XMVECTOR p = XMLoadFloat3(&vtx.position);
+		const XMVECTOR pr = XMVectorMultiplyAdd(two, XMVector3Cross(real, XMVectorMultiplyAdd(rw, p, XMVector3Cross(real, p))), p);
+		XMStoreFloat3(&outPositions[v], XMVectorAdd(pr, trans));
+
+		if (outNormals)
+		{
+			const XMVECTOR n = XMLoadFloat3(&vtx.normal);
+			const XMVECTOR nr = XMVectorMultiplyAdd(two, XMVector3Cross(real, XMVectorMultiplyAdd(rw, n, XMVector3Cross(real, n))), n);
+			XMStoreFloat3(&outNormals[v], XMVector3Normalize(nr));
+		}
+	}
+}
+
+void AnimationSkinning_SkinReference(
+	const Vertex3d* vertices,
+	int vertexCount,
+	const XMFLOAT4X4* palette,
+	int boneCount,
+	XMFLOAT3* outPositions,
+	XMFLOAT3* outNormals)
+{
+	const int bones = ClampBoneCount(boneCount);
+
+	for (int v = 0; v < vertexCount; ++v)
+	{
+		const Vertex3d& vtx = vertices[v];
+
+		const float weightSum = vtx.boneWeight[0] + vtx.boneWeight[1] + vtx.boneWeight[2] + vtx.boneWeight[3];
+
+		if (weightSum <= MIN_WEIGHT_SUM)
+		{
+			outPositions[v] = vtx.position;
+			if (outNormals) outNormals[v] = vtx.normal;
+			continue;
+		}
+
+		const float p[4] = { vtx.position.x, vtx.position.y, vtx.position.z, 1.0f };
+		const float n[4] = { vtx.normal.x, vtx.normal.y, vtx.normal.z, 0.0f };
+
+		float pos[3] = {};
+		float nrm[3] = {};
+
+		for (int i = 0; i < 4; ++i)
+		{
+			const uint32_t idx = vtx.boneIndex[i];
+			const float w = vtx.boneWeight[i];
+
+			if (idx >= static_cast<uint32_t>(bones) || !(w > 0.0f)) continue;
+
+			// mul(v, M) with M = transpose(palette[idx]) : component j = row j . v
+			const XMFLOAT4X4& m = palette[idx];
+
+			for (int j = 0; j < 3; ++j)
+			{
+				float tp = 0.0f;
+				float tn = 0.0f;
+				for (int k = 0; k < 4; ++k)
+				{
+					tp += m.m[j][k] * p[k];
+					tn += m.m[j][k] * n[k];
+				}
+				pos[j] += tp * w;
+				nrm[j] += tn * w;
+			}
+		}
+
+		outPositions[v] = XMFLOAT3(pos[0], pos[1], pos[2]);
+
+		if (outNormals)
+		{
+			const float len = std::sqrt(nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2]);
+			const float inv = (len > 0.0f) ? 1.0f / len : 0.0f;
+			outNormals[v] = XMFLOAT3(nrm[0] * inv, nrm[1] * inv, nrm[2] * inv);
+		}
+	}
+}
+
+static void MergeBox(const XMVECTOR& center, const XMVECTOR& extent, XMVECTOR& ioMin, XMVECTOR& ioMax)
+{
+	ioMin = XMVectorMin(ioMin, XMVectorSubtract(center, extent));
+	ioMax = XMVectorMax(ioMax, XMVectorAdd(center, extent));
+}
+
+static int ClampBoneCount(int boneCount, int maxBones)
+{
+	if (boneCount < 0) return 0;
+	return (boneCount > maxBones) ? maxBones : boneCount;
+}
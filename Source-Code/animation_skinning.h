@@ -0,0 +1,120 @@
+/*==============================================================================
+
+   CPU skinning [animation_skinning.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_SKINNING_H
+#define ANIMATION_SKINNING_H
+
+#include <vector>
+#include <DirectXMath.h>
+
+struct Vertex3d;
+struct BoneBounds;
+struct MeshAsset;
+struct ModelAsset;
+struct AABB;
+class WorkerPool;
+
+/*
+// -------------------------------
+Same math as shader_vertex_3d_skinned.hlsl, on the CPU
+(posed bounds, picking against posed characters, checks without a GPU)
+SkinDualQuat functions: same for shader_vertex_3d_skinned_dq.hlsl (SkinningMethod::DualQuaternion)
+
+animation_skinning.cpp      : kernels on Vertex3d / BoneBounds (model_vertex.h), no D3D / assimp -> tools/skinning_test.cpp
+animation_skinning_mesh.cpp : MeshAsset / ModelAsset front ends
+
+AnimationSkinning_Skin (per vertex)
+├─ 1. weight sum <= 0.0001 -> bind position / normal as they are
+├─ 2. the 4 influences blended into one 3x4 matrix (XMVECTOR rows, 4 multiply-adds)
+│     index >= bone count or weight <= 0 : skipped, like the shader
+└─ 3. one transpose, position = c0*x + c1*y + c2*z + c3, normal = c0*nx + c1*ny + c2*nz, normalized
+
+AnimationSkinning_SkinDualQuat (per vertex)
+├─ 1. same bind pose fallback
+├─ 2. b = sum(w * dq), influences on the other hemisphere of the first one are negated
+├─ 3. b / |b.real|
+└─ 4. position = rotate(p, real) + translation(b), normal = rotate(n, real)
+    -> blends rotations instead of matrices: no volume loss on twisting joints
+// -------------------------------
+*/
+
+// Unit dual quaternion of one skin matrix, 32 bytes (two float4 in the skinning CB)
+// real : rotation, dual : 0.5 * (t, 0) * real
+struct SkinDualQuat
+{
+	DirectX::XMFLOAT4 real;
+	DirectX::XMFLOAT4 dual;
+};
+
+// palette : what Animation_UpdateSkinningCB uploads (transposed for HLSL)
+// outNormals may be nullptr when only positions are needed
+void AnimationSkinning_Skin(
+	const Vertex3d* vertices,
+	int vertexCount,
+	const DirectX::XMFLOAT4X4* palette,
+	int boneCount,
+	DirectX::XMFLOAT3* outPositions,
+	DirectX::XMFLOAT3* outNormals
+);
+
+// Same, split into vertex chunks on 'pool' (nullptr: runs on the caller)
+void AnimationSkinning_SkinParallel(
+	WorkerPool* pool,
+	const Vertex3d* vertices,
+	int vertexCount,
+	const DirectX::XMFLOAT4X4* palette,
+	int boneCount,
+	DirectX::XMFLOAT3* outPositions,
+	DirectX::XMFLOAT3* outNormals
+);
+
+// Whole mesh from its CPU vertex copy, output resized to the vertex count
+void AnimationSkinning_SkinMesh(
+	const MeshAsset& mesh,
+	const std::vector<DirectX::XMFLOAT4X4>& palette,
+	std::vector<DirectX::XMFLOAT3>& outPositions,
+	std::vector<DirectX::XMFLOAT3>& outNormals,
+	WorkerPool* pool = nullptr
+);
+
+// Posed mesh-space box from the per-bone bind boxes (MeshAsset::boneBounds)
+// ~60 box transforms instead of skinning every vertex; false when there are no bone boxes
+bool AnimationSkinning_ComputePosedAABB(const BoneBounds* bounds, int boundsCount, const DirectX::XMFLOAT4X4* palette, int boneCount, AABB& outBox);
+bool AnimationSkinning_ComputePosedAABB(const MeshAsset& mesh, const DirectX::XMFLOAT4X4* palette, int boneCount, AABB& outBox);
+
+// Union over every mesh of the asset, unskinned meshes use their localAABB
+bool AnimationSkinning_ComputePosedAABB(const ModelAsset* asset, const std::vector<DirectX::XMFLOAT4X4>& palette, AABB& outBox);
+
+// LBS palette (transposed bone offset * model-space pose) -> dual quaternions, one bone per iteration.
+// The rows are normalized for the rotation: a scale in the skin matrix is dropped
+void AnimationSkinning_BuildDualQuatPalette(const DirectX::XMFLOAT4X4* palette, int boneCount, SkinDualQuat* outDualQuats);
+void AnimationSkinning_BuildDualQuatPalette(const std::vector<DirectX::XMFLOAT4X4>& palette, std::vector<SkinDualQuat>& outDualQuats);
+
+// CPU version of the dual quaternion vertex shader (compare with AnimationSkinning_Skin)
+void AnimationSkinning_SkinDualQuat(
+	const Vertex3d* vertices,
+	int vertexCount,
+	const SkinDualQuat* dualQuats,
+	int boneCount,
+	DirectX::XMFLOAT3* outPositions,
+	DirectX::XMFLOAT3* outNormals
+);
+
+// Reference: scalar, one influence at a time in the order of the shader
+// Only for validating AnimationSkinning_Skin
+void AnimationSkinning_SkinReference(
+	const Vertex3d* vertices,
+	int vertexCount,
+	const DirectX::XMFLOAT4X4* palette,
+	int boneCount,
+	DirectX::XMFLOAT3* outPositions,
+	DirectX::XMFLOAT3* outNormals
+);
+
+#endif // ANIMATION_SKINNING_H
@@ -0,0 +1,225 @@
+/*==============================================================================
+
+   Skinning constant buffers [animation_skinning_cb.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation.h"
+#include "animation_blender.h"
+#include "animation_skinning.h"
+#include "direct3d.h"
+
+#include <cstring>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+static const int MAX_BONES = 256;     // linear blend: one float4x4 per bone
+static const int MAX_DQ_BONES = 512;  // dual quaternion: two float4 per bone, same buffer (packed vertices index 256)
+
+ID3D11Device* g_pDevice = nullptr;
+ID3D11DeviceContext* g_pContext = nullptr;
+
+ID3D11Buffer* g_pSkinningCB = nullptr; // skin weightpobt@|Cg
+
+struct SkinningCBData
+{
+	XMFLOAT4X4 boneMatrices[MAX_BONES]; // or SkinDualQuat[MAX_DQ_BONES] (shader_vertex_3d_skinned_dq.hlsl)
+};
+
+static_assert(sizeof(SkinDualQuat) * MAX_DQ_BONES == sizeof(SkinningCBData), "both palettes fill the same buffer");
+
+// Copy of what g_pSkinningCB currently holds (callers without their own SkinningPaletteBuffer)
+static std::vector<uint8_t> g_UploadedPalette;
+
+// Reused by the AnimationPlayer / AnimationBlender overloads (render thread only)
+static std::vector<XMFLOAT4X4> g_PaletteScratch;
+
+static SkinningUploadStats g_UploadStats;     // frame in progress
+static SkinningUploadStats g_LastUploadStats; // previous frame, for the debug UI
+
+static void UploadPalette(const void* palette, size_t bytes, SkinningPaletteBuffer* instance);
+
+
+bool Animation_InitializeSkinningCB(ID3D11Device* pDevice, ID3D11DeviceContext* pContext)
+{
+	if (!pDevice || !pContext) return false;
+	g_pDevice = pDevice;
+	g_pContext = pContext;
+
+	// Dynamic: uploads go through Map(WRITE_DISCARD) and copy only the live bones
+	D3D11_BUFFER_DESC buffer_desc{};
+	buffer_desc.ByteWidth = sizeof(SkinningCBData);
+	buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+	buffer_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	buffer_desc.MiscFlags = 0;
+
+	SkinningCBData initData{};
+	for (int i = 0; i < MAX_BONES; i++)
+	{
+		XMStoreFloat4x4(&initData.boneMatrices[i], XMMatrixIdentity());
+	}
+
+	D3D11_SUBRESOURCE_DATA sd{};
+	sd.pSysMem = &initData;
+
+	HRESULT hr = g_pDevice->CreateBuffer(&buffer_desc, &sd, &g_pSkinningCB);
+	if (FAILED(hr))
+	{
+		g_pSkinningCB = nullptr;
+		return false;
+	}
+
+	g_UploadedPalette.clear();
+	g_UploadStats = SkinningUploadStats();
+	g_LastUploadStats = SkinningUploadStats();
+
+	return true;
+}
+
+void Animation_ReleaseSkinningCB()
+{
+	SAFE_RELEASE(g_pSkinningCB);
+
+	std::vector<uint8_t>().swap(g_UploadedPalette);
+	g_PaletteScratch.clear();
+	g_PaletteScratch.shrink_to_fit();
+}
+
+void Animation_UpdateSkinningCB(const AnimationPlayer& player)
+{
+	if (!g_pSkinningCB) return;
+
+	player.ComputeSkinMatrices(g_PaletteScratch);
+
+	Animation_UpdateSkinningCB(g_PaletteScratch);
+}
+
+void Animation_UpdateSkinningCB(const AnimationBlender& blender)
+{
+	if (!g_pSkinningCB) return;
+
+	blender.ComputeSkinMatrices(g_PaletteScratch);
+
+	Animation_UpdateSkinningCB(g_PaletteScratch);
+}
+
+void Animation_UpdateSkinningCB(const std::vector<XMFLOAT4X4>& skinMatrices, SkinningPaletteBuffer* instance)
+{
+	Animation_UpdateSkinningCB(skinMatrices.data(), static_cast<int>(skinMatrices.size()), instance);
+}
+
+void Animation_UpdateSkinningCB(const XMFLOAT4X4* skinMatrices, int boneCount, SkinningPaletteBuffer* instance)
+{
+	if (!g_pSkinningCB) return;
+
+	int count = boneCount;
+	if (count > MAX_BONES) count = MAX_BONES;
+	if (count < 0 || !skinMatrices) count = 0;
+
+	UploadPalette(skinMatrices, sizeof(XMFLOAT4X4) * count, instance);
+}
+
+void Animation_UpdateSkinningCB(const std::vector<SkinDualQuat>& dualQuats, SkinningPaletteBuffer* instance)
+{
+	Animation_UpdateSkinningCB(dualQuats.data(), static_cast<int>(dualQuats.size()), instance);
+}
+
+void Animation_UpdateSkinningCB(const SkinDualQuat* dualQuats, int boneCount, SkinningPaletteBuffer* instance)
+{
+	if (!g_pSkinningCB) return;
+
+	int count = boneCount;
+	if (count > MAX_DQ_BONES) count = MAX_DQ_BONES;
+	if (count < 0 || !dualQuats) count = 0;
+
+	UploadPalette(dualQuats, sizeof(SkinDualQuat) * count, instance);
+}
+
+void Animation_ReleaseSkinningPalette(SkinningPaletteBuffer& palette)
+{
+	SAFE_RELEASE(palette.buffer);
+	std::vector<uint8_t>().swap(palette.uploaded);
+}
+
+void Animation_BeginSkinningFrame()
+{
+	g_LastUploadStats = g_UploadStats;
+	g_UploadStats = SkinningUploadStats();
+}
+
+const SkinningUploadStats& Animation_GetSkinningUploadStats()
+{
+	return g_LastUploadStats;
+}
+
+// no-op: shader variant decides skinning path
+/*
+void Animation_DisableSkinning()
+{
+	if (!g_pSkinningCB || !g_pContext) return;
+
+	SkinningCBData cbData{};
+
+	g_pContext->UpdateSubresource(g_pSkinningCB, 0, nullptr, &cbData, 0, 0);
+	g_pContext->VSSetConstantBuffers(3, 1, &g_pSkinningCB);
+}
+*/
+
+// Either palette layout; the buffer holds bytes, the bound vertex shader decides what they are
+// instance : its own buffer (created on first use), nullptr : the shared g_pSkinningCB
+static void UploadPalette(const void* palette, size_t bytes, SkinningPaletteBuffer* instance)
+{
+	if (instance && !instance->buffer)
+	{
+		D3D11_BUFFER_DESC buffer_desc{};
+		buffer_desc.ByteWidth = sizeof(SkinningCBData);
+		buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+		buffer_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+		if (FAILED(g_pDevice->CreateBuffer(&buffer_desc, nullptr, &instance->buffer)))
+		{
+			instance->buffer = nullptr;
+			instance = nullptr; // draw with the shared buffer this time
+		}
+		else
+		{
+			instance->uploaded.clear();
+		}
+	}
+
+	ID3D11Buffer* buffer = instance ? instance->buffer : g_pSkinningCB;
+	std::vector<uint8_t>& uploaded = instance ? instance->uploaded : g_UploadedPalette;
+
+	// Same palette as this buffer's last upload (paused, LOD throttled, invisible): it already holds it.
+	// An instance buffer keeps its palette whatever is drawn in between, the shared one only until the next upload.
+	// The skinned shader only reads the bones the mesh references, so a shorter previous
+	// upload is not a match even when the common prefix is
+	if (bytes == uploaded.size() && (bytes == 0 || memcmp(uploaded.data(), palette, bytes) == 0))
+	{
+		++g_UploadStats.skipped;
+		g_UploadStats.bytesSkipped += bytes;
+	}
+	else
+	{
+		D3D11_MAPPED_SUBRESOURCE mapped{};
+		if (FAILED(g_pContext->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) return;
+
+		// Bones past the palette are left undefined by the discard, no mesh of this rig indexes them
+		memcpy(mapped.pData, palette, bytes);
+		g_pContext->Unmap(buffer, 0);
+
+		const uint8_t* src = static_cast<const uint8_t*>(palette);
+		uploaded.assign(src, src + bytes);
+
+		++g_UploadStats.uploads;
+		g_UploadStats.bytesUploaded += bytes;
+	}
+
+	g_pContext->VSSetConstantBuffers(3, 1, &buffer);
+}
\ No newline at end of file
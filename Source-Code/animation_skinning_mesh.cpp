@@ -0,0 +1,76 @@
+/*==============================================================================
+
+   CPU skinning of mesh / model assets [animation_skinning_mesh.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   MeshAsset / ModelAsset front ends of the kernels in animation_skinning.cpp,
+   kept apart so that file needs no model_asset.h (D3D / assimp)
+
+==============================================================================*/
+
+#include "animation_skinning.h"
+#include "model_asset.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+
+void AnimationSkinning_SkinMesh(
+	const MeshAsset& mesh,
+	const std::vector<XMFLOAT4X4>& palette,
+	std::vector<XMFLOAT3>& outPositions,
+	std::vector<XMFLOAT3>& outNormals,
+	WorkerPool* pool)
+{
+	const int vertexCount = static_cast<int>(mesh.cpuVertices.size());
+
+	outPositions.resize(vertexCount);
+	outNormals.resize(vertexCount);
+
+	if (vertexCount == 0) return;
+
+	AnimationSkinning_SkinParallel(
+		pool, mesh.cpuVertices.data(), vertexCount,
+		palette.data(), static_cast<int>(palette.size()),
+		outPositions.data(), outNormals.data());
+}
+
+bool AnimationSkinning_ComputePosedAABB(const MeshAsset& mesh, const XMFLOAT4X4* palette, int boneCount, AABB& outBox)
+{
+	return AnimationSkinning_ComputePosedAABB(mesh.boneBounds.data(), static_cast<int>(mesh.boneBounds.size()), palette, boneCount, outBox);
+}
+
+bool AnimationSkinning_ComputePosedAABB(const ModelAsset* asset, const std::vector<XMFLOAT4X4>& palette, AABB& outBox)
+{
+	if (!asset || palette.empty()) return false;
+
+	bool any = false;
+
+	for (const MeshAsset& mesh : asset->meshes)
+	{
+		AABB box;
+		if (!AnimationSkinning_ComputePosedAABB(mesh, palette.data(), static_cast<int>(palette.size()), box))
+		{
+			box = mesh.localAABB;
+		}
+
+		if (!any)
+		{
+			outBox = box;
+			any = true;
+			continue;
+		}
+
+		outBox.min.x = std::min(outBox.min.x, box.min.x);
+		outBox.min.y = std::min(outBox.min.y, box.min.y);
+		outBox.min.z = std::min(outBox.min.z, box.min.z);
+		outBox.max.x = std::max(outBox.max.x, box.max.x);
+		outBox.max.y = std::max(outBox.max.y, box.max.y);
+		outBox.max.z = std::max(outBox.max.z, box.max.z);
+	}
+
+	return any;
+}
@@ -0,0 +1,357 @@
+/*==============================================================================
+
+   Parallel animation update [animation_system.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "animation_system.h"
+#include "skeleton_runtime.h"
+#include "model_asset.h"
+
+#include <chrono>
+#include <utility>
+
+using namespace DirectX;
+
+// Instances per chunk: big enough to amortize the atomic, small enough to balance 500+ characters
+static const int INSTANCE_GRAIN = 8;
+
+enum LodResult
+{
+	LOD_EVALUATED,
+	LOD_INTERPOLATED,
+	LOD_SKIPPED,
+};
+
+static bool IsInsideFrustum(const AABB& box, const XMFLOAT4X4& viewProj);
+static int CountSampledNodes(const SkeletonRuntime& skel, int maxDepth);
+
+
+AnimationSystem::~AnimationSystem()
+{
+	Finalize();
+}
+
+AnimationSystem& AnimationSystem::Instance()
+{
+	static AnimationSystem instance;
+	return instance;
+}
+
+void AnimationSystem::Initialize(int workerCount)
+{
+	SetWorkerCount(workerCount);
+}
+
+void AnimationSystem::Finalize()
+{
+	m_Pool.Stop();
+
+	m_Instances.clear();
+	m_FreeIds.clear();
+	m_Active.clear();
+}
+
+void AnimationSystem::SetWorkerCount(int workerCount)
+{
+	m_Pool.Start(workerCount < 0 ? WorkerPool::DefaultWorkerCount() : workerCount);
+}
+
+int AnimationSystem::CreateInstance(const ModelAsset* asset, int layerCount)
+{
+	int id;
+	if (!m_FreeIds.empty())
+	{
+		id = m_FreeIds.back();
+		m_FreeIds.pop_back();
+	}
+	else
+	{
+		id = static_cast<int>(m_Instances.size());
+		m_Instances.emplace_back(new InstanceData());
+	}
+
+	InstanceData& inst = *m_Instances[id];
+	inst.blender.Initialize(asset, layerCount);
+	inst.palette.clear();
+	inst.dualQuats.clear();
+	inst.alive = true;
+	inst.id = id;
+	inst.hasBounds = false;
+	inst.poseValid = false;
+	inst.interval = 1;
+
+	RebuildActiveList();
+	return id;
+}
+
+void AnimationSystem::DestroyInstance(int id)
+{
+	if (id < 0 || id >= static_cast<int>(m_Instances.size())) return;
+
+	InstanceData& inst = *m_Instances[id];
+	if (!inst.alive) return;
+
+	inst.blender.Finalize();
+	inst.palette.clear();
+	inst.dualQuats.clear();
+	inst.alive = false;
+
+	m_FreeIds.push_back(id);
+	RebuildActiveList();
+}
+
+void AnimationSystem::DestroyInstances(const ModelAsset* asset)
+{
+	for (int id = 0; id < static_cast<int>(m_Instances.size()); ++id)
+	{
+		if (m_Instances[id]->alive && m_Instances[id]->blender.GetAsset() == asset)
+		{
+			DestroyInstance(id);
+		}
+	}
+}
+
+AnimationBlender* AnimationSystem::GetBlender(int id)
+{
+	if (id < 0 || id >= static_cast<int>(m_Instances.size())) return nullptr;
+	if (!m_Instances[id]->alive) return nullptr;
+
+	return &m_Instances[id]->blender;
+}
+
+const std::vector<XMFLOAT4X4>* AnimationSystem::GetPalette(int id) const
+{
+	if (id < 0 || id >= static_cast<int>(m_Instances.size())) return nullptr;
+	if (!m_Instances[id]->alive) return nullptr;
+
+	return &m_Instances[id]->palette;
+}
+
+const std::vector<SkinDualQuat>* AnimationSystem::GetDualQuatPalette(int id) const
+{
+	if (id < 0 || id >= static_cast<int>(m_Instances.size())) return nullptr;
+	if (!m_Instances[id]->alive) return nullptr;
+
+	return &m_Instances[id]->dualQuats;
+}
+
+void AnimationSystem::Update(double elapsed_time)
+{
+	// std::chrono, not SystemTimer: the system also runs in headless tools (tools/crowd_bench.cpp)
+	const auto start = std::chrono::steady_clock::now();
+
+	InstanceData* const* active = m_Active.data();
+
+	m_Pool.ParallelFor(static_cast<int>(m_Active.size()), INSTANCE_GRAIN, [this, active, elapsed_time](int begin, int end)
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			InstanceData& inst = *active[i];
+			UpdateInstance(inst, elapsed_time);
+
+			// Converted on the same worker, skipped instances keep last frame's quaternions
+			// (built anyway right after the asset switches to DualQuaternion, Player::DebugDraw)
+			const ModelAsset* asset = inst.blender.GetAsset();
+			if (!asset || asset->skinning != SkinningMethod::DualQuaternion)
+			{
+				inst.dualQuats.clear();
+			}
+			else if (inst.lodResult != LOD_SKIPPED || inst.dualQuats.empty())
+			{
+				AnimationSkinning_BuildDualQuatPalette(inst.palette, inst.dualQuats);
+			}
+		}
+	});
+
+	// Stats summed on this thread, in instance order
+	m_LodStats = AnimationLodStats();
+	m_LodStats.instances = static_cast<int>(m_Active.size());
+
+	for (const InstanceData* inst : m_Active)
+	{
+		m_LodStats.boneEvaluations += inst->boneEvaluations;
+		m_LodStats.savedBoneEvaluations += inst->savedBoneEvaluations;
+
+		switch (inst->lodResult)
+		{
+		case LOD_EVALUATED:    ++m_LodStats.evaluated; break;
+		case LOD_INTERPOLATED: ++m_LodStats.interpolated; break;
+		case LOD_SKIPPED:      ++m_LodStats.skipped; break;
+		}
+	}
+
+	++m_FrameIndex;
+	m_LastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void AnimationSystem::SetLodSettings(const ModelAsset* asset, const AnimationLodSettings& settings)
+{
+	m_LodSettings[asset] = settings;
+}
+
+const AnimationLodSettings& AnimationSystem::GetLodSettings(const ModelAsset* asset) const
+{
+	auto it = m_LodSettings.find(asset);
+	return (it != m_LodSettings.end()) ? it->second : m_DefaultLod;
+}
+
+void AnimationSystem::SetLodView(const XMFLOAT3& cameraPos, const XMFLOAT4X4& viewProj)
+{
+	m_LodCameraPos = cameraPos;
+	m_LodViewProj = viewProj;
+	m_HasLodView = true;
+}
+
+void AnimationSystem::SetInstanceBounds(int id, const AABB& worldAABB)
+{
+	if (id < 0 || id >= static_cast<int>(m_Instances.size())) return;
+	if (!m_Instances[id]->alive) return;
+
+	m_Instances[id]->bounds = worldAABB;
+	m_Instances[id]->hasBounds = true;
+}
+
+// Runs on a worker, writes nothing but 'inst'
+void AnimationSystem::UpdateInstance(InstanceData& inst, double elapsed_time) const
+{
+	inst.blender.Update(elapsed_time);
+
+	const ModelAsset* asset = inst.blender.GetAsset();
+	const int nodeCount = asset ? asset->skeleton.NodeCount() : 0;
+
+	inst.boneEvaluations = 0;
+	inst.savedBoneEvaluations = 0;
+	inst.lodResult = LOD_EVALUATED;
+
+	// Full rate and full skeleton, same path as without LOD
+	if (!m_LodEnabled || !m_HasLodView || !inst.hasBounds || nodeCount == 0)
+	{
+		inst.poseValid = false;
+		inst.blender.ComputeSkinMatrices(inst.palette);
+		inst.boneEvaluations = nodeCount;
+		return;
+	}
+
+	const AnimationLodSettings& lod = GetLodSettings(asset);
+
+	if (lod.skipInvisible && !IsInsideFrustum(inst.bounds, m_LodViewProj))
+	{
+		// Palette of the last visible frame is kept, the next visible frame samples again
+		inst.poseValid = false;
+		inst.savedBoneEvaluations = nodeCount;
+		inst.lodResult = LOD_SKIPPED;
+		return;
+	}
+
+	const XMVECTOR center = XMVectorScale(XMVectorAdd(XMLoadFloat3(&inst.bounds.min), XMLoadFloat3(&inst.bounds.max)), 0.5f);
+	const float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(center, XMLoadFloat3(&m_LodCameraPos))));
+
+	const int interval = (distance > lod.quarterRateDistance) ? 4 : (distance > lod.halfRateDistance) ? 2 : 1;
+	const int maxDepth = (distance > lod.reducedBonesDistance) ? lod.reducedBoneDepth : -1;
+
+	// Staggered by id so a crowd does not update all on the same frame
+	const int slot = static_cast<int>((m_FrameIndex + static_cast<unsigned int>(inst.id)) % static_cast<unsigned int>(interval));
+
+	if (!inst.poseValid || interval != inst.interval || slot == 0)
+	{
+		std::swap(inst.prevPose, inst.nextPose);
+
+		if (!inst.blender.EvaluateLocalPose(inst.nextPose, inst.animYup, maxDepth))
+		{
+			inst.poseValid = false;
+			inst.palette.clear();
+			return;
+		}
+
+		if (!inst.poseValid)
+		{
+			inst.prevPose = inst.nextPose;
+		}
+
+		inst.poseValid = true;
+		inst.interval = interval;
+
+		inst.boneEvaluations = CountSampledNodes(asset->skeleton, maxDepth);
+		inst.savedBoneEvaluations = nodeCount - inst.boneEvaluations;
+	}
+	else
+	{
+		inst.savedBoneEvaluations = nodeCount;
+		inst.lodResult = LOD_INTERPOLATED;
+	}
+
+	if (interval == 1)
+	{
+		inst.blender.ComputeSkinMatrices(inst.nextPose, inst.animYup, inst.palette);
+		return;
+	}
+
+	// Shown one interval behind: slot 0 is exactly the previous update, no pop when the next one lands
+	const float phase = static_cast<float>(slot) / static_cast<float>(interval);
+	AnimationBlender_BlendPoses(inst.prevPose, inst.nextPose, phase, nullptr, inst.lerpPose);
+
+	inst.blender.ComputeSkinMatrices(inst.lerpPose, inst.animYup, inst.palette);
+}
+
+void AnimationSystem::RebuildActiveList()
+{
+	m_Active.clear();
+
+	for (const std::unique_ptr<InstanceData>& inst : m_Instances)
+	{
+		if (inst->alive)
+		{
+			m_Active.push_back(inst.get());
+		}
+	}
+}
+
+// Conservative: false only when all 8 corners are outside the same clip plane
+static bool IsInsideFrustum(const AABB& box, const XMFLOAT4X4& viewProj)
+{
+	const XMMATRIX vp = XMLoadFloat4x4(&viewProj);
+
+	int outside[6] = {};
+
+	for (int c = 0; c < 8; ++c)
+	{
+		const XMVECTOR corner = XMVectorSet(
+			(c & 1) ? box.max.x : box.min.x,
+			(c & 2) ? box.max.y : box.min.y,
+			(c & 4) ? box.max.z : box.min.z,
+			1.0f);
+
+		XMFLOAT4 h;
+		XMStoreFloat4(&h, XMVector4Transform(corner, vp));
+
+		if (h.x < -h.w) ++outside[0];
+		if (h.x >  h.w) ++outside[1];
+		if (h.y < -h.w) ++outside[2];
+		if (h.y >  h.w) ++outside[3];
+		if (h.z <  0.0f) ++outside[4]; // D3D depth range 0..w
+		if (h.z >  h.w) ++outside[5];
+	}
+
+	for (int p = 0; p < 6; ++p)
+	{
+		if (outside[p] == 8) return false;
+	}
+
+	return true;
+}
+
+static int CountSampledNodes(const SkeletonRuntime& skel, int maxDepth)
+{
+	if (maxDepth < 0) return skel.NodeCount();
+
+	int count = 0;
+	for (int d : skel.depth)
+	{
+		if (d <= maxDepth) ++count;
+	}
+	return count;
+}
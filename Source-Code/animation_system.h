@@ -0,0 +1,159 @@
+/*==============================================================================
+
+   Parallel animation update [animation_system.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef ANIMATION_SYSTEM_H
+#define ANIMATION_SYSTEM_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "animation_blender.h"
+#include "animation_skinning.h"
+#include "aabb.h"
+#include "worker_pool_util.h"
+
+/*
+// -------------------------------
+AnimationSystem
+├─ instances[] : AnimationBlender + skin palette, addressed by id
+└─ Update()    : once per frame, after gameplay has issued its CrossFade calls
+    └─ WorkerPool::ParallelFor over active instances
+        ├─ AnimationBlender::Update (time, fades) : every frame
+        ├─ LOD (instances with bounds, SetLodView) :
+        │   ├─ outside the view frustum  -> no evaluation, palette kept
+        │   ├─ distance -> update interval 1 / 2 / 4 frames,
+        │   │             in-between frames lerp the last two poses (one interval behind)
+        │   └─ distance -> deep nodes keep the bind pose
+        └─ AnimationBlender::ComputeSkinMatrices -> instance palette
+// -------------------------------
+*/
+
+// Per asset thresholds (world units from the camera to the instance bounds center)
+struct AnimationLodSettings
+{
+	float halfRateDistance = 20.0f;     // farther: update every 2nd frame
+	float quarterRateDistance = 40.0f;  // farther: update every 4th frame
+	float reducedBonesDistance = 30.0f; // farther: nodes deeper than reducedBoneDepth keep the bind pose
+	int reducedBoneDepth = 10;          // SkeletonRuntime::depth (mannequin: hands ~10, fingers below)
+	bool skipInvisible = true;
+};
+
+// Last Update, one bone evaluation = one node sampled for one pose
+struct AnimationLodStats
+{
+	int instances = 0;
+	int evaluated = 0;    // sampled this frame
+	int interpolated = 0; // between two updates
+	int skipped = 0;      // outside the frustum
+
+	long long boneEvaluations = 0;
+	long long savedBoneEvaluations = 0; // against every instance sampling every node
+};
+
+// Every instance owns all of its scratch and output, clips and skeletons are read-only,
+// so the result does not depend on the thread count or on which thread ran an instance
+class AnimationSystem
+{
+private:
+
+	struct InstanceData
+	{
+		AnimationBlender blender;
+		std::vector<DirectX::XMFLOAT4X4> palette; // transposed, ready for the skinning CB
+		std::vector<SkinDualQuat> dualQuats;      // SkinningMethod::DualQuaternion assets only
+		bool alive = false;
+		int id = -1;
+
+		// LOD input
+		bool hasBounds = false;
+		AABB bounds{};
+
+		// LOD state : pose of the last two updates
+		LocalPoseSoA prevPose;
+		LocalPoseSoA nextPose;
+		LocalPoseSoA lerpPose;
+		bool poseValid = false;
+		bool animYup = false;
+		int interval = 1;
+
+		// Stats of the last Update
+		int boneEvaluations = 0;
+		int savedBoneEvaluations = 0;
+		int lodResult = 0;
+	};
+
+	std::vector<std::unique_ptr<InstanceData>> m_Instances; // index = instance id
+	std::vector<int> m_FreeIds;
+	std::vector<InstanceData*> m_Active;                // rebuilt on create / destroy only
+
+	WorkerPool m_Pool;
+	double m_LastUpdateMs = 0.0;
+
+	// LOD
+	std::unordered_map<const ModelAsset*, AnimationLodSettings> m_LodSettings;
+	AnimationLodSettings m_DefaultLod;
+	bool m_LodEnabled = true;
+	bool m_HasLodView = false;
+	DirectX::XMFLOAT3 m_LodCameraPos{};
+	DirectX::XMFLOAT4X4 m_LodViewProj{};
+	unsigned int m_FrameIndex = 0;
+	AnimationLodStats m_LodStats;
+
+	void RebuildActiveList();
+	void UpdateInstance(InstanceData& inst, double elapsed_time) const;
+
+public:
+
+	AnimationSystem() = default;
+	~AnimationSystem();
+
+	AnimationSystem(const AnimationSystem&) = delete;
+	AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+	static AnimationSystem& Instance();
+
+	// workerCount < 0 : hardware_concurrency - 1
+	void Initialize(int workerCount = -1);
+	void Finalize();
+
+	void SetWorkerCount(int workerCount);
+	int GetThreadCount() const { return m_Pool.GetThreadCount(); }
+
+	int CreateInstance(const ModelAsset* asset, int layerCount = 1);
+	void DestroyInstance(int id);
+	void DestroyInstances(const ModelAsset* asset); // call before the asset is released
+
+	AnimationBlender* GetBlender(int id);
+	const std::vector<DirectX::XMFLOAT4X4>* GetPalette(int id) const; // last Update result
+	const std::vector<SkinDualQuat>* GetDualQuatPalette(int id) const; // empty unless the asset uses dual quaternions
+
+	int GetInstanceCount() const { return static_cast<int>(m_Active.size()); }
+	double GetLastUpdateMs() const { return m_LastUpdateMs; }
+
+	// ---- LOD ----
+	void SetLodSettings(const ModelAsset* asset, const AnimationLodSettings& settings);
+	const AnimationLodSettings& GetLodSettings(const ModelAsset* asset) const;
+
+	void SetLodEnabled(bool enabled) { m_LodEnabled = enabled; }
+	bool IsLodEnabled() const { return m_LodEnabled; }
+
+	// Camera of this frame, call before Update
+	void SetLodView(const DirectX::XMFLOAT3& cameraPos, const DirectX::XMFLOAT4X4& viewProj);
+	// World bounds of the instance; instances without bounds always run at full LOD
+	void SetInstanceBounds(int id, const AABB& worldAABB);
+
+	const AnimationLodStats& GetLodStats() const { return m_LodStats; }
+
+	// Advance and evaluate every instance
+	void Update(double elapsed_time);
+};
+
+#endif // ANIMATION_SYSTEM_H
@@ -0,0 +1,196 @@
+/*==============================================================================
+
+   Background crowd drawn from baked clips [baked_crowd.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "baked_crowd.h"
+#include "animation.h"
+#include "animation_bake.h"
+#include "model_asset.h"
+#include "model_renderer.h"
+#include "imgui/imgui.h"
+
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+
+// Same import as the player, but an asset of its own: it stays LinearBlend whatever
+// the player's skinning method is (the bakes hold skin matrices, not dual quaternions)
+static const char* const CROWD_MODEL = "resources/mannequin.FBX";
+static const float CROWD_MODEL_SCALE = 0.04f;
+
+// In-place clips only, the walk cycles would snap back to their start on every loop
+static const char* const CROWD_CLIPS[] =
+{
+	"resources/Animation/Idle.fbx",
+	"resources/Animation/Sad_Idle.fbx",
+};
+
+static const float CROWD_PHASE_STEP = 0.37f; // seconds between neighbours, so the crowd does not move in sync
+
+static const XMFLOAT3 CROWD_ORIGIN = { 0.0f, 0.0f, 12.0f };
+
+struct CrowdClip
+{
+	std::string bakedPath;
+	int bakedId = -1; // BakedAnimationLibrary, -1 : no .vat
+};
+
+static ModelAsset* g_pAsset = nullptr;
+static std::vector<CrowdClip> g_Clips;
+static std::vector<BakedAnimationInstance> g_Instances;
+
+static bool g_Enabled = false;
+static int g_Rows = 3;
+static int g_Columns = 6;
+static float g_Spacing = 2.5f;
+static bool g_Visible = true;
+
+static void Load();
+static int LoadBaked(const std::string& bakedPath);
+static void AssignClips();
+
+
+void BakedCrowd_Finalize()
+{
+	g_Instances.clear();
+	g_Clips.clear();
+
+	if (g_pAsset)
+	{
+		ModelAsset_Release(g_pAsset);
+		g_pAsset = nullptr;
+	}
+}
+
+void BakedCrowd_Draw(const XMFLOAT3& cameraPos)
+{
+	if (!g_Enabled || !g_pAsset || !g_Visible) return;
+
+	const BakedAnimationLibrary& library = BakedAnimationLibrary::Instance();
+
+	for (int i = 0; i < static_cast<int>(g_Instances.size()); ++i)
+	{
+		int boneCount = 0;
+		const XMFLOAT4X4* palette = library.GetPalette(g_Instances[i], boneCount);
+		if (!palette) continue;
+
+		const int row = i / g_Columns;
+		const int column = i % g_Columns;
+		const XMMATRIX world = XMMatrixTranslation(
+			CROWD_ORIGIN.x + (column - (g_Columns - 1) * 0.5f) * g_Spacing,
+			CROWD_ORIGIN.y,
+			CROWD_ORIGIN.z + row * g_Spacing);
+
+		// Shared buffer: neighbours on the same clip frame skip the upload
+		Animation_UpdateSkinningCB(palette, boneCount);
+		ModelRenderer_DrawAsset(g_pAsset, world, cameraPos);
+	}
+}
+
+void BakedCrowd_DrawDebugUI()
+{
+	ImGui::Text("Baked Crowd");
+
+	// Off by default, the asset and the .vat files are only read once it is ticked
+	if (ImGui::Checkbox("Enable Crowd", &g_Enabled))
+	{
+		if (g_Enabled) Load();
+		else BakedCrowd_Finalize();
+	}
+
+	if (!g_Enabled)
+	{
+		ImGui::Separator();
+		return;
+	}
+
+	ImGui::Checkbox("Show Crowd", &g_Visible);
+
+	bool changed = false;
+	changed |= ImGui::SliderInt("Crowd Rows", &g_Rows, 1, 16);
+	changed |= ImGui::SliderInt("Crowd Columns", &g_Columns, 1, 16);
+	ImGui::DragFloat("Crowd Spacing", &g_Spacing, 0.1f, 0.5f, 20.0f);
+
+	if (changed) AssignClips();
+
+	int baked = 0;
+	for (const CrowdClip& c : g_Clips)
+	{
+		if (c.bakedId >= 0) ++baked;
+	}
+	ImGui::Text("  %d instances, %d / %d clips baked", static_cast<int>(g_Instances.size()), baked, static_cast<int>(g_Clips.size()));
+	if (baked < static_cast<int>(g_Clips.size()))
+	{
+		ImGui::TextDisabled("  missing .vat : run tools/anim_bake on the cooked clips");
+	}
+
+	ImGui::Separator();
+}
+
+// Asset and the .vat files that are already there, the ones missing are skipped
+static void Load()
+{
+	if (g_pAsset) return;
+
+	g_pAsset = ModelAsset_Load(CROWD_MODEL, false, CROWD_MODEL_SCALE);
+	if (!g_pAsset) return;
+
+	for (const char* source : CROWD_CLIPS)
+	{
+		CrowdClip c;
+		c.bakedPath = AnimationBake_GetBakedPath(source);
+		c.bakedId = LoadBaked(c.bakedPath);
+		g_Clips.push_back(c);
+	}
+
+	AssignClips();
+}
+
+// Id of the registered palette bake, the same clip may already be in the library (AnimationBench)
+static int LoadBaked(const std::string& bakedPath)
+{
+	BakedAnimation* baked = AnimationBake_Load(bakedPath.c_str());
+	if (!baked) return -1;
+
+	// AnimationBench may have left a vertex position bake at that path: not usable here
+	if (baked->layout != BakedAnimationLayout::BonePalette)
+	{
+		AnimationBake_Destroy(baked);
+		return -1;
+	}
+
+	BakedAnimationLibrary& library = BakedAnimationLibrary::Instance();
+
+	const int existing = library.FindByName(baked->name, baked->layout);
+	if (existing >= 0)
+	{
+		AnimationBake_Destroy(baked);
+		return existing;
+	}
+
+	return library.Register(baked);
+}
+
+// Instances cycle through the baked clips
+static void AssignClips()
+{
+	std::vector<int> ids;
+	for (const CrowdClip& c : g_Clips)
+	{
+		if (c.bakedId >= 0) ids.push_back(c.bakedId);
+	}
+
+	g_Instances.assign(ids.empty() ? 0 : g_Rows * g_Columns, BakedAnimationInstance());
+
+	for (int i = 0; i < static_cast<int>(g_Instances.size()); ++i)
+	{
+		g_Instances[i].clipId = ids[i % ids.size()];
+		g_Instances[i].timeOffset = i * CROWD_PHASE_STEP;
+	}
+}
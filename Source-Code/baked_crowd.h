@@ -0,0 +1,31 @@
+/*==============================================================================
+
+   Background crowd drawn from baked clips [baked_crowd.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef BAKED_CROWD_H
+#define BAKED_CROWD_H
+
+#include <DirectXMath.h>
+
+/*
+// -------------------------------
+BakedCrowd : debug only, off until "Enable Crowd" is ticked (Inspector > Animation)
+├─ enabled : own mannequin asset, .vat of every crowd clip (animation_bake.h)
+│   └─ .vat missing : the clip is left out, nothing is baked at runtime
+│                     (tools/anim_bake.cpp makes them offline)
+├─ Draw() : per instance, palette lookup (clip id + time offset) -> shared skinning CB -> draw
+│           no AnimationSystem instance, no player, no per-instance update
+└─ disabled / Finalize() : asset released, the bakes stay in BakedAnimationLibrary
+// -------------------------------
+*/
+
+void BakedCrowd_Finalize();
+void BakedCrowd_Draw(const DirectX::XMFLOAT3& cameraPos); // nothing while disabled
+void BakedCrowd_DrawDebugUI(); // Inspector > Animation, the toggle
+
+#endif // BAKED_CROWD_H
@@ -14,6 +14,7 @@
 #include <vector>
 #include <DirectXMath.h>
 
+#include "aabb.h"
 #include "aabb_provider.h"
 
 struct ModelAsset;
@@ -38,29 +39,6 @@ struct Box
 	float half_height;
 };
 
-struct AABB
-{
-	DirectX::XMFLOAT3 min;
-	DirectX::XMFLOAT3 max;
-
-	DirectX::XMFLOAT3 GetHalf() const {
-		DirectX::XMFLOAT3 half;
-		half.x = (max.x - min.x) * 0.5f;
-		half.y = (max.y - min.y) * 0.5f;
-		half.z = (max.z - min.z) * 0.5f;
-		return half;
-	}
-
-	DirectX::XMFLOAT3 GetCenter() const {
-		DirectX::XMFLOAT3 center;
-		DirectX::XMFLOAT3 half = GetHalf();
-		center.x = min.x + half.x;
-		center.y = min.y + half.y;
-		center.z = min.z + half.z;
-		return center;
-	}
-};
-
 struct Hit
 {
 	bool isHit;
@@ -12,6 +12,7 @@
 #include "direct3d.h"
 #include "default3Dshader.h"
 #include "texture.h"
+#include "vertex_pack_util.h"
 
 #include <DirectXMath.h>
 
@@ -100,15 +101,23 @@ void Cube_Initialize(ID3D11Device* pDevice, ID3D11DeviceContext* pContext, float
 		{ { -s, -s,  s }, { 0.0f, -1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1, 1, 1, 1 }, { 0.0f, 1.0f } },
 	};
 
+	// Default3DShader (static) input layout
+	VertexPacked packed[NUM_VERTEX];
+	for (int i = 0; i < NUM_VERTEX; ++i)
+	{
+		const VertexCube& v = g_CubeVertex[i];
+		VertexPack_Encode(v.position, v.normal, v.tangent, v.color, v.texcoord, packed[i]);
+	}
+
 	// 頂点バッファ生成
 	D3D11_BUFFER_DESC bd = {};
 	bd.Usage = D3D11_USAGE_DEFAULT;
-	bd.ByteWidth = sizeof(VertexCube) * NUM_VERTEX; // sizeof(g_CubeVertex)
+	bd.ByteWidth = sizeof(VertexPacked) * NUM_VERTEX;
 	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	bd.CPUAccessFlags = 0;
 
 	D3D11_SUBRESOURCE_DATA sd{};
-	sd.pSysMem = g_CubeVertex;
+	sd.pSysMem = packed;
 
 	g_pDevice->CreateBuffer(&bd, &sd, &g_pVertexBuffer);
 
@@ -139,7 +148,7 @@ void Cube_DrawMesh(const XMMATRIX& mtxWorld)
 	g_CubeTex.SetTexture();
 
 	// 頂点バッファを描画パイプラインに設定
-	UINT stride = sizeof(VertexCube);
+	UINT stride = sizeof(VertexPacked);
 	UINT offset = 0;
 	g_pContext->IASetVertexBuffers(0, 1, &g_pVertexBuffer, &stride, &offset);
 
@@ -1,11 +1,26 @@
 #ifndef DEBUG_OSTREAM_H
 #define DEBUG_OSTREAM_H
 
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <cstdio>
+#endif
 #include <sstream>
 
 namespace hal
 {
+	// Debugger output on Windows, stderr elsewhere (headless tools)
+	// One call per line: safe from several threads, unlike dout
+	inline void debug_print(const char* text)
+	{
+#ifdef _WIN32
+		OutputDebugStringA(text);
+#else
+		fputs(text, stderr);
+#endif
+	}
+
 	class debugbuf : public std::basic_stringbuf <char, std::char_traits<char>>
 	{
 	public:
@@ -18,7 +33,7 @@ namespace hal
 
 		int sync()
 		{
-			OutputDebugStringA(str().c_str());
+			debug_print(str().c_str());
 			str(std::basic_string<char>());
 			return 0;
 		}
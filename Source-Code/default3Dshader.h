@@ -38,7 +38,8 @@ public:
 	enum class Variant
 	{
 		Static,
-		Skinned
+		Skinned,
+		SkinnedDualQuat  // same vertex layout as Skinned, dual quaternion palette
 	};
 
 	Default3DShader() = default;
@@ -64,5 +65,6 @@ public:
 
 extern Default3DShader g_Default3DshaderStatic;
 extern Default3DShader g_Default3DshaderSkinned;
+extern Default3DShader g_Default3DshaderSkinnedDQ;
 
 #endif // DEFAULT_3D_SHADER_H
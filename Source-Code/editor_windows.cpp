@@ -120,6 +120,10 @@ namespace
 			{
 				Game_DrawLightDebugUI();
 			}
+			if (ImGui::CollapsingHeader("Animation"))
+			{
+				Game_DrawAnimationDebugUI();
+			}
 
 			ImGui::EndChild();
 
@@ -35,6 +35,10 @@
 #include "scene_manager.h"
 #include "collision.h"
 #include "debug_draw_gate.h"
+#include "animation_bench.h"
+#include "animation_system.h"
+#include "animation_bake.h"
+#include "baked_crowd.h"
 
 #include <DirectXMath.h>
 
@@ -74,6 +78,7 @@ void Game_Initialize()
     // Shaders
     g_Default3DshaderStatic.UpdateSpecularParams(camPos, 30.0f, { 1.0f, 1.0f, 1.0f, 1.0f });
     g_Default3DshaderSkinned.UpdateSpecularParams(camPos, 30.0f, { 1.0f, 1.0f, 1.0f, 1.0f });
+    g_Default3DshaderSkinnedDQ.UpdateSpecularParams(camPos, 30.0f, { 1.0f, 1.0f, 1.0f, 1.0f });
  
     g_LightManager.SetPointLightCount(1);
     g_LightManager.SetPointLight(0, { 0.0f, 3.0f, -2.0f }, 5.0f, { 1.0f, 0.0f, 0.0f });
@@ -113,6 +118,9 @@ void Game_Initialize()
 
     Skydome_Initialize();
 
+    // Animation workers (before anything creates an instance)
+    AnimationSystem::Instance().Initialize();
+
     // Player
     g_Player.Initialize({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f });
 
@@ -134,6 +142,10 @@ void Game_Finalize()
     }
 
     g_Player.Finalize();
+    BakedCrowd_Finalize(); // debug crowd, only loaded when it was enabled
+
+    AnimationSystem::Instance().Finalize();
+    BakedAnimationLibrary::Instance().DestroyAll();
 
     Skydome_Finalize();
 
@@ -154,15 +166,22 @@ void Game_Update(double elapsed_time)
     XMFLOAT3 camPos = cam.GetPosition();
     XMFLOAT3 camFront = cam.GetFront();
 
+    // Clips finished on the loader threads become playable from here on
+    AnimationManager::Instance().PollLoads();
+
     //g_Player.Update(elapsed_time);
     if (CameraManager::IsPlayMode())
     {
         g_Player.Update(elapsed_time, camFront);
     }
-    else
-    {
-        g_Player.UpdateAnimationOnly(elapsed_time);
-    }
+
+    // Every animated instance, in parallel (editor mode keeps animating too)
+    XMFLOAT4X4 viewProj;
+    XMStoreFloat4x4(&viewProj, XMLoadFloat4x4(&cam.GetView()) * XMLoadFloat4x4(&cam.GetProj()));
+    AnimationSystem::Instance().SetLodView(camPos, viewProj);
+    AnimationSystem::Instance().Update(elapsed_time);
+    g_Player.HandleAnimationEvents(); // crossed just now, drained in editor mode too
+    BakedAnimationLibrary::Instance().Advance(elapsed_time); // baked clips: one clock, no per-instance work
 
     // ---- COLLISIONS UPDATE ----
     SceneManager::UpdateWorldAABBs();
@@ -198,6 +217,7 @@ void Game_Draw()
     XMMATRIX proj = XMLoadFloat4x4(&cam.GetProj());
 
     Render3D_BeginFrame(cam);
+    Animation_BeginSkinningFrame();
 
     // Picking drawing setting
     if (g_PickingReady)
@@ -266,6 +286,7 @@ void Game_Draw()
     g_LightManager.DebugDrawPointLight();
 
     g_Player.Draw(camPos);
+    BakedCrowd_Draw(camPos); // debug toggle, off by default
 
     Draw3d_Draw();
 }
@@ -289,3 +310,10 @@ void Game_DrawMaterialManager()
     g_DefaultSceneMaterial.DebugDraw(g_Default3DshaderStatic, CameraManager::GetActiveCamera().GetPosition());
 }
 
+void Game_DrawAnimationDebugUI()
+{
+    g_Player.DebugDraw();
+    BakedCrowd_DrawDebugUI();
+    AnimationBench::DrawDebugUI(g_Player.GetAsset());
+}
+
@@ -19,6 +19,7 @@ void Game_Draw();
 void Game_DrawCameraDebugUI();
 void Game_DrawLightDebugUI();
 void Game_DrawMaterialManager();
+void Game_DrawAnimationDebugUI();
 
 
 #endif // GAME_H
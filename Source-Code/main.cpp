@@ -67,6 +67,7 @@ int APIENTRY WinMain(
 	g_LightManager.Initialize(Direct3D_GetDevice(), Direct3D_GetContext());
 	g_Default3DshaderStatic.Initialize(Direct3D_GetDevice(), Direct3D_GetContext(), Default3DShader::Variant::Static);
 	g_Default3DshaderSkinned.Initialize(Direct3D_GetDevice(), Direct3D_GetContext(), Default3DShader::Variant::Skinned);
+	g_Default3DshaderSkinnedDQ.Initialize(Direct3D_GetDevice(), Direct3D_GetContext(), Default3DShader::Variant::SkinnedDualQuat);
 	g_DefaultUnlitShader.Initialize(Direct3D_GetDevice(), Direct3D_GetContext());
 
 	Debug_Imgui_Initialize(hWnd, Direct3D_GetDevice(), Direct3D_GetContext());
@@ -161,6 +162,7 @@ int APIENTRY WinMain(
 
 	g_DefaultUnlitShader.Finalize();
 	g_Default3DshaderSkinned.Finalize();
+	g_Default3DshaderSkinnedDQ.Finalize();
 	g_Default3DshaderStatic.Finalize();
 	g_LightManager.Finalize();
 
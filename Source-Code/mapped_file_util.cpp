@@ -0,0 +1,154 @@
+/*==============================================================================
+
+   Read-only memory mapped file [mapped_file_util.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file_util.h"
+
+#include <fstream>
+#include <vector>
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+static const uint64_t FNV_PRIME = 1099511628211ull;
+
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char* filename)
+{
+	Close();
+
+	if (!filename) return false;
+
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_File = file;
+	m_Mapping = mapping;
+	m_Data = static_cast<const uint8_t*>(view);
+	m_Size = static_cast<size_t>(size.QuadPart);
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+	{
+		UnmapViewOfFile(m_Data);
+		m_Data = nullptr;
+	}
+	if (m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+		m_Mapping = nullptr;
+	}
+	if (m_File)
+	{
+		CloseHandle(m_File);
+		m_File = nullptr;
+	}
+	m_Size = 0;
+}
+
+#else
+
+// POSIX (headless tools): the descriptor is closed right away, the mapping keeps the file
+bool MappedFile::Open(const char* filename)
+{
+	Close();
+
+	if (!filename) return false;
+
+	const int fd = open(filename, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (view == MAP_FAILED) return false;
+
+	m_Data = static_cast<const uint8_t*>(view);
+	m_Size = static_cast<size_t>(st.st_size);
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+	{
+		munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		m_Data = nullptr;
+	}
+	m_Size = 0;
+}
+
+#endif
+
+bool FileUtil_HashFile(const char* filename, uint64_t& outHash)
+{
+	std::ifstream ifs(filename, std::ios::binary);
+	if (!ifs) return false;
+
+	uint64_t hash = FNV_OFFSET_BASIS;
+	std::vector<char> buffer(64 * 1024);
+
+	while (ifs)
+	{
+		ifs.read(buffer.data(), buffer.size());
+		const std::streamsize n = ifs.gcount();
+
+		for (std::streamsize i = 0; i < n; ++i)
+		{
+			hash ^= static_cast<uint8_t>(buffer[i]);
+			hash *= FNV_PRIME;
+		}
+	}
+
+	outHash = hash;
+	return true;
+}
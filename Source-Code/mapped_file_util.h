@@ -0,0 +1,45 @@
+/*==============================================================================
+
+   Read-only memory mapped file [mapped_file_util.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef MAPPED_FILE_UTIL_H
+#define MAPPED_FILE_UTIL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Whole file mapped read-only, pages are loaded by the OS on first touch
+class MappedFile
+{
+public:
+
+	MappedFile() = default;
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const char* filename);
+	void Close();
+
+	bool IsOpen() const { return m_Data != nullptr; }
+	const uint8_t* Data() const { return m_Data; }
+	size_t Size() const { return m_Size; }
+
+private:
+
+	void* m_File = nullptr;    // HANDLE (Windows only)
+	void* m_Mapping = nullptr; // HANDLE (Windows only)
+	const uint8_t* m_Data = nullptr;
+	size_t m_Size = 0;
+};
+
+// FNV-1a 64 of a whole file, false if it cannot be read
+bool FileUtil_HashFile(const char* filename, uint64_t& outHash);
+
+#endif // MAPPED_FILE_UTIL_H
@@ -0,0 +1,447 @@
+/*==============================================================================
+
+   Index / vertex order optimization [mesh_optimize_util.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "mesh_optimize_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const uint32_t FETCH_LINE_BYTES = 64;
+static const uint32_t FETCH_CACHE_LINES = 64;
+static const uint32_t NO_VERTEX = 0xFFFFFFFFu;
+
+// FIFO cache over time stamps: an entry is alive while fewer than cacheSize misses happened after it
+struct FifoCache
+{
+	std::vector<uint32_t> time;
+	uint32_t now = 0;
+	uint32_t size = 0;
+
+	void Reset(size_t entryCount, uint32_t cacheSize)
+	{
+		size = cacheSize;
+		now = cacheSize + 1;
+		time.assign(entryCount, 0);
+	}
+
+	void Flush() { now += size + 1; }
+
+	// true on a miss (the entry is inserted)
+	bool Touch(uint32_t entry)
+	{
+		if (now - time[entry] <= size) return false;
+		time[entry] = now++;
+		return true;
+	}
+};
+
+static uint32_t TouchTriangle(FifoCache& cache, const uint32_t* tri);
+static int64_t SkipDeadEnd(std::vector<uint32_t>& deadEnd, const std::vector<uint32_t>& live, uint32_t& cursor, uint32_t vertexCount);
+static bool IndicesInRange(const uint32_t* indices, size_t indexCount, uint32_t vertexCount);
+
+
+VertexCacheStats MeshOptimize_AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStats stats;
+	if (!indices || indexCount < 3 || !IndicesInRange(indices, indexCount, vertexCount)) return stats;
+
+	FifoCache cache;
+	cache.Reset(vertexCount, cacheSize);
+
+	std::vector<uint8_t> used(vertexCount, 0);
+
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		const uint32_t v = indices[i];
+		if (cache.Touch(v)) ++stats.transformed;
+		if (!used[v]) { used[v] = 1; ++stats.vertexCount; }
+	}
+
+	stats.triangleCount = static_cast<uint32_t>(indexCount / 3);
+	stats.acmr = static_cast<float>(stats.transformed) / static_cast<float>(stats.triangleCount);
+	stats.atvr = stats.vertexCount ? static_cast<float>(stats.transformed) / static_cast<float>(stats.vertexCount) : 0.0f;
+
+	return stats;
+}
+
+// Every post-transform miss reads the lines its vertex covers
+VertexFetchStats MeshOptimize_AnalyzeVertexFetch(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t vertexSize)
+{
+	VertexFetchStats stats;
+	if (!indices || indexCount == 0 || vertexSize == 0 || !IndicesInRange(indices, indexCount, vertexCount)) return stats;
+
+	const uint64_t lineCount = (static_cast<uint64_t>(vertexCount) * vertexSize + FETCH_LINE_BYTES - 1) / FETCH_LINE_BYTES;
+
+	FifoCache vertexCache;
+	vertexCache.Reset(vertexCount, MESH_OPTIMIZE_CACHE_SIZE);
+
+	FifoCache lineCache;
+	lineCache.Reset(static_cast<size_t>(lineCount), FETCH_CACHE_LINES);
+
+	std::vector<uint8_t> used(vertexCount, 0);
+	uint64_t referenced = 0;
+
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		const uint32_t v = indices[i];
+		if (!used[v]) { used[v] = 1; ++referenced; }
+
+		if (!vertexCache.Touch(v)) continue;
+
+		const uint64_t first = static_cast<uint64_t>(v) * vertexSize / FETCH_LINE_BYTES;
+		const uint64_t last = (static_cast<uint64_t>(v) * vertexSize + vertexSize - 1) / FETCH_LINE_BYTES;
+
+		for (uint64_t line = first; line <= last; ++line)
+		{
+			if (lineCache.Touch(static_cast<uint32_t>(line))) stats.bytesFetched += FETCH_LINE_BYTES;
+		}
+	}
+
+	stats.bytesReferenced = referenced * vertexSize;
+	stats.overfetch = stats.bytesReferenced ? static_cast<float>(static_cast<double>(stats.bytesFetched) / static_cast<double>(stats.bytesReferenced)) : 0.0f;
+
+	return stats;
+}
+
+// Tipsify: emit every live triangle around the fanning vertex, then fan around the emitted vertex
+// that is still in the cache the longest and will not fall out while its triangles are emitted
+void MeshOptimize_VertexCache(uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (!indices || triangleCount == 0 || !IndicesInRange(indices, triangleCount * 3, vertexCount)) return;
+
+	// Vertex -> triangles
+	std::vector<uint32_t> live(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; ++i) ++live[indices[i]];
+
+	std::vector<uint32_t> first(vertexCount + 1, 0);
+	for (uint32_t v = 0; v < vertexCount; ++v) first[v + 1] = first[v] + live[v];
+
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	{
+		std::vector<uint32_t> fill(first.begin(), first.end() - 1);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+		{
+			adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	FifoCache cache;
+	cache.Reset(vertexCount, cacheSize);
+
+	std::vector<uint8_t> emitted(triangleCount, 0);
+	std::vector<uint32_t> deadEnd;
+	deadEnd.reserve(triangleCount * 3);
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> out;
+	out.reserve(triangleCount * 3);
+
+	uint32_t cursor = 0;
+	int64_t fan = SkipDeadEnd(deadEnd, live, cursor, vertexCount);
+
+	while (fan >= 0)
+	{
+		candidates.clear();
+
+		for (uint32_t a = first[fan]; a < first[fan + 1]; ++a)
+		{
+			const uint32_t t = adjacency[a];
+			if (emitted[t]) continue;
+			emitted[t] = 1;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				const uint32_t v = indices[t * 3 + k];
+				out.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				--live[v];
+				cache.Touch(v);
+			}
+		}
+
+		// Vertex that stays in the cache while all its remaining triangles are emitted, oldest first
+		int64_t best = -1;
+		int64_t bestPriority = -1;
+
+		for (uint32_t v : candidates)
+		{
+			if (live[v] == 0) continue;
+
+			int64_t priority = 0;
+			const uint32_t age = cache.now - cache.time[v];
+			if (age + 2 * live[v] <= cacheSize) priority = age;
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				best = v;
+			}
+		}
+
+		fan = (best >= 0) ? best : SkipDeadEnd(deadEnd, live, cursor, vertexCount);
+	}
+
+	memcpy(indices, out.data(), out.size() * sizeof(uint32_t));
+}
+
+// Clusters of the vertex cache order, then the clusters facing away from the mesh center first
+// (they tend to occlude the rest). Sander et al. 2007, linear-speed reordering
+void MeshOptimize_Overdraw(
+	uint32_t* indices,
+	size_t indexCount,
+	const void* positions,
+	size_t positionStride,
+	uint32_t vertexCount,
+	float threshold,
+	uint32_t cacheSize)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (!indices || !positions || triangleCount < 2 || !IndicesInRange(indices, triangleCount * 3, vertexCount)) return;
+
+	FifoCache cache;
+	cache.Reset(vertexCount, cacheSize);
+
+	// Hard boundaries: all three vertices missed, the vertex cache order jumped
+	std::vector<uint32_t> hard;
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		if (TouchTriangle(cache, &indices[t * 3]) == 3 || t == 0) hard.push_back(static_cast<uint32_t>(t));
+	}
+	hard.push_back(static_cast<uint32_t>(triangleCount));
+
+	// Soft boundaries: cut as soon as the part so far is within threshold of the whole cluster's ACMR
+	std::vector<uint32_t> clusters;
+	for (size_t c = 0; c + 1 < hard.size(); ++c)
+	{
+		const uint32_t start = hard[c];
+		const uint32_t end = hard[c + 1];
+
+		cache.Flush();
+		uint32_t clusterMisses = 0;
+		for (uint32_t t = start; t < end; ++t) clusterMisses += TouchTriangle(cache, &indices[t * 3]);
+
+		const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+		cache.Flush();
+		clusters.push_back(start);
+
+		uint32_t misses = 0;
+		uint32_t triangles = 0;
+		for (uint32_t t = start; t < end; ++t)
+		{
+			misses += TouchTriangle(cache, &indices[t * 3]);
+			++triangles;
+
+			if (t + 1 < end && static_cast<float>(misses) <= clusterThreshold * static_cast<float>(triangles))
+			{
+				clusters.push_back(t + 1);
+				cache.Flush();
+				misses = 0;
+				triangles = 0;
+			}
+		}
+	}
+	clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+	const uint8_t* base = static_cast<const uint8_t*>(positions);
+	auto position = [base, positionStride](uint32_t v)
+	{
+		const float* p = reinterpret_cast<const float*>(base + static_cast<size_t>(v) * positionStride);
+		return p;
+	};
+
+	// Area weighted centroid and normal per cluster
+	const size_t clusterCount = clusters.size() - 1;
+	std::vector<float> clusterData(clusterCount * 7, 0.0f); // centroid * area (3), normal * 2 area (3), area
+	float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+
+	for (size_t c = 0; c < clusterCount; ++c)
+	{
+		float* data = &clusterData[c * 7];
+
+		for (uint32_t t = clusters[c]; t < clusters[c + 1]; ++t)
+		{
+			const float* p0 = position(indices[t * 3 + 0]);
+			const float* p1 = position(indices[t * 3 + 1]);
+			const float* p2 = position(indices[t * 3 + 2]);
+
+			const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			const float n[3] = {
+				e1[1] * e2[2] - e1[2] * e2[1],
+				e1[2] * e2[0] - e1[0] * e2[2],
+				e1[0] * e2[1] - e1[1] * e2[0] };
+
+			const float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * 0.5f;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				data[k] += (p0[k] + p1[k] + p2[k]) / 3.0f * area;
+				data[3 + k] += n[k];
+			}
+			data[6] += area;
+		}
+
+		for (int k = 0; k < 3; ++k) meshCentroid[k] += data[k];
+		meshArea += data[6];
+	}
+
+	if (meshArea > 0.0f)
+	{
+		for (int k = 0; k < 3; ++k) meshCentroid[k] /= meshArea;
+	}
+
+	std::vector<float> sortKey(clusterCount, 0.0f);
+	for (size_t c = 0; c < clusterCount; ++c)
+	{
+		const float* data = &clusterData[c * 7];
+		if (data[6] <= 0.0f) continue;
+
+		const float nLength = std::sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+		if (nLength <= 0.0f) continue;
+
+		float key = 0.0f;
+		for (int k = 0; k < 3; ++k)
+		{
+			key += (data[k] / data[6] - meshCentroid[k]) * (data[3 + k] / nLength);
+		}
+		sortKey[c] = key;
+	}
+
+	std::vector<uint32_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; ++c) order[c] = static_cast<uint32_t>(c);
+
+	std::stable_sort(order.begin(), order.end(), [&sortKey](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+	std::vector<uint32_t> out;
+	out.reserve(triangleCount * 3);
+	for (uint32_t c : order)
+	{
+		out.insert(out.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+	}
+
+	memcpy(indices, out.data(), out.size() * sizeof(uint32_t));
+}
+
+void MeshOptimize_VertexFetch(uint32_t* indices, size_t indexCount, uint32_t vertexCount, std::vector<uint32_t>& outRemap)
+{
+	outRemap.assign(vertexCount, NO_VERTEX);
+
+	uint32_t next = 0;
+
+	if (indices && IndicesInRange(indices, indexCount, vertexCount))
+	{
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			uint32_t& remapped = outRemap[indices[i]];
+			if (remapped == NO_VERTEX) remapped = next++;
+			indices[i] = remapped;
+		}
+	}
+
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		if (outRemap[v] == NO_VERTEX) outRemap[v] = next++;
+	}
+}
+
+void MeshOptimize_Run(
+	std::vector<uint32_t>& indices,
+	const void* positions,
+	size_t positionStride,
+	uint32_t vertexCount,
+	uint32_t vertexSize,
+	std::vector<uint32_t>& outRemap,
+	MeshOptimizeReport* outReport)
+{
+	auto analyze = [&](MeshOptimizeStage stage)
+	{
+		if (!outReport) return;
+		const int s = static_cast<int>(stage);
+		outReport->cache[s] = MeshOptimize_AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+		outReport->fetch[s] = MeshOptimize_AnalyzeVertexFetch(indices.data(), indices.size(), vertexCount, vertexSize);
+	};
+
+	analyze(MeshOptimizeStage::Source);
+
+	MeshOptimize_VertexCache(indices.data(), indices.size(), vertexCount);
+	analyze(MeshOptimizeStage::VertexCache);
+
+	MeshOptimize_Overdraw(indices.data(), indices.size(), positions, positionStride, vertexCount);
+	analyze(MeshOptimizeStage::Overdraw);
+
+	MeshOptimize_VertexFetch(indices.data(), indices.size(), vertexCount, outRemap);
+	analyze(MeshOptimizeStage::VertexFetch);
+}
+
+void MeshOptimize_MergeReport(MeshOptimizeReport& a, const MeshOptimizeReport& b)
+{
+	for (int s = 0; s < static_cast<int>(MeshOptimizeStage::Count); ++s)
+	{
+		VertexCacheStats& cache = a.cache[s];
+		cache.triangleCount += b.cache[s].triangleCount;
+		cache.vertexCount += b.cache[s].vertexCount;
+		cache.transformed += b.cache[s].transformed;
+		cache.acmr = cache.triangleCount ? static_cast<float>(cache.transformed) / static_cast<float>(cache.triangleCount) : 0.0f;
+		cache.atvr = cache.vertexCount ? static_cast<float>(cache.transformed) / static_cast<float>(cache.vertexCount) : 0.0f;
+
+		VertexFetchStats& fetch = a.fetch[s];
+		fetch.bytesFetched += b.fetch[s].bytesFetched;
+		fetch.bytesReferenced += b.fetch[s].bytesReferenced;
+		fetch.overfetch = fetch.bytesReferenced ? static_cast<float>(static_cast<double>(fetch.bytesFetched) / static_cast<double>(fetch.bytesReferenced)) : 0.0f;
+	}
+}
+
+const char* MeshOptimize_GetStageName(MeshOptimizeStage stage)
+{
+	switch (stage)
+	{
+	case MeshOptimizeStage::Source:      return "source";
+	case MeshOptimizeStage::VertexCache: return "vertex cache";
+	case MeshOptimizeStage::Overdraw:    return "overdraw";
+	case MeshOptimizeStage::VertexFetch: return "vertex fetch";
+	default:                             return "?";
+	}
+}
+
+static uint32_t TouchTriangle(FifoCache& cache, const uint32_t* tri)
+{
+	return (cache.Touch(tri[0]) ? 1u : 0u) + (cache.Touch(tri[1]) ? 1u : 0u) + (cache.Touch(tri[2]) ? 1u : 0u);
+}
+
+// Most recent emitted vertex with live triangles, else the next one in index order, -1 when done
+static int64_t SkipDeadEnd(std::vector<uint32_t>& deadEnd, const std::vector<uint32_t>& live, uint32_t& cursor, uint32_t vertexCount)
+{
+	while (!deadEnd.empty())
+	{
+		const uint32_t v = deadEnd.back();
+		deadEnd.pop_back();
+		if (live[v] > 0) return v;
+	}
+
+	while (cursor < vertexCount)
+	{
+		if (live[cursor] > 0) return cursor;
+		++cursor;
+	}
+
+	return -1;
+}
+
+static bool IndicesInRange(const uint32_t* indices, size_t indexCount, uint32_t vertexCount)
+{
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		if (indices[i] >= vertexCount) return false;
+	}
+	return true;
+}
@@ -0,0 +1,115 @@
+/*==============================================================================
+
+   Index / vertex order optimization [mesh_optimize_util.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef MESH_OPTIMIZE_UTIL_H
+#define MESH_OPTIMIZE_UTIL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+// -------------------------------
+Import stage, per mesh (standard C++ only, builds headless: tools/meshcache_report.cpp)
+├─ 1. vertex cache : Tipsify (Sander et al. 2007), fans around the last emitted vertex
+├─ 2. overdraw     : Tipsify output cut into clusters that keep the ACMR within a threshold,
+│                    clusters sorted front-facing-outwards first (occluders early)
+└─ 3. vertex fetch : vertices renumbered in first use order, remap applied by the caller
+
+Simulator
+├─ post-transform cache : FIFO of MESH_OPTIMIZE_CACHE_SIZE vertices -> ACMR, ATVR
+└─ pre-transform fetch  : FIFO of 64 byte lines -> overfetch
+// -------------------------------
+*/
+
+static const uint32_t MESH_OPTIMIZE_CACHE_SIZE = 16;
+static const float MESH_OPTIMIZE_OVERDRAW_THRESHOLD = 1.05f; // ACMR a cluster may lose for overdraw order
+
+enum class MeshOptimizeStage
+{
+	Source,      // as imported
+	VertexCache,
+	Overdraw,
+	VertexFetch,
+	Count,
+};
+
+struct VertexCacheStats
+{
+	uint32_t triangleCount = 0;
+	uint32_t vertexCount = 0; // vertices referenced by the indices
+	uint32_t transformed = 0; // cache misses
+	float acmr = 0.0f;        // transformed / triangle, 0.5 best, 3.0 worst
+	float atvr = 0.0f;        // transformed / vertex, 1.0 best
+};
+
+struct VertexFetchStats
+{
+	uint64_t bytesFetched = 0;
+	uint64_t bytesReferenced = 0; // vertexSize * referenced vertices
+	float overfetch = 0.0f; // bytesFetched / bytes of the referenced vertices, 1.0 best
+};
+
+struct MeshOptimizeReport
+{
+	VertexCacheStats cache[static_cast<int>(MeshOptimizeStage::Count)];
+	VertexFetchStats fetch[static_cast<int>(MeshOptimizeStage::Count)];
+};
+
+// ---- Simulator ----
+VertexCacheStats MeshOptimize_AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize = MESH_OPTIMIZE_CACHE_SIZE);
+VertexFetchStats MeshOptimize_AnalyzeVertexFetch(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t vertexSize);
+
+// ---- Stages (indices rewritten in place) ----
+void MeshOptimize_VertexCache(uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize = MESH_OPTIMIZE_CACHE_SIZE);
+
+// positions : float3 at the start of every vertex, positionStride bytes apart
+void MeshOptimize_Overdraw(
+	uint32_t* indices,
+	size_t indexCount,
+	const void* positions,
+	size_t positionStride,
+	uint32_t vertexCount,
+	float threshold = MESH_OPTIMIZE_OVERDRAW_THRESHOLD,
+	uint32_t cacheSize = MESH_OPTIMIZE_CACHE_SIZE
+);
+
+// outRemap[old] = new, unreferenced vertices keep their relative order at the end
+void MeshOptimize_VertexFetch(uint32_t* indices, size_t indexCount, uint32_t vertexCount, std::vector<uint32_t>& outRemap);
+
+// All three stages; outReport (optional) gets the simulator metrics before and after each one
+// vertexSize : bytes per vertex of the fetched stream
+void MeshOptimize_Run(
+	std::vector<uint32_t>& indices,
+	const void* positions,
+	size_t positionStride,
+	uint32_t vertexCount,
+	uint32_t vertexSize,
+	std::vector<uint32_t>& outRemap,
+	MeshOptimizeReport* outReport
+);
+
+// Accumulates b into a, the ratios are recomputed from the sums
+void MeshOptimize_MergeReport(MeshOptimizeReport& a, const MeshOptimizeReport& b);
+
+const char* MeshOptimize_GetStageName(MeshOptimizeStage stage);
+
+// vertices[remap[i]] = old vertices[i]
+template <typename T>
+void MeshOptimize_RemapVertices(std::vector<T>& vertices, const std::vector<uint32_t>& remap)
+{
+	std::vector<T> remapped(vertices.size());
+	for (size_t i = 0; i < vertices.size() && i < remap.size(); ++i)
+	{
+		remapped[remap[i]] = vertices[i];
+	}
+	vertices.swap(remapped);
+}
+
+#endif // MESH_OPTIMIZE_UTIL_H
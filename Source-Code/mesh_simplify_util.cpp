@@ -0,0 +1,679 @@
+/*==============================================================================
+
+   Quadric error mesh simplification [mesh_simplify_util.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "mesh_simplify_util.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+static const int MAX_PASSES = 64;
+static const float SKIN_MAX_DIFFERENCE = 0.5f;  // half the L1 distance of the weights, 1 : no bone in common
+static const float SKIN_ERROR_SCALE = 0.05f;    // error of a full weight difference, relative to the mesh extent
+
+// Sum of squared plane distances: p^T A p + 2 b.p + c
+struct Quadric
+{
+	double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+	double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+	double c = 0.0;
+
+	void AddPlane(double nx, double ny, double nz, double d)
+	{
+		a00 += nx * nx; a01 += nx * ny; a02 += nx * nz;
+		a11 += ny * ny; a12 += ny * nz;
+		a22 += nz * nz;
+		b0 += nx * d; b1 += ny * d; b2 += nz * d;
+		c += d * d;
+	}
+
+	void Add(const Quadric& q)
+	{
+		a00 += q.a00; a01 += q.a01; a02 += q.a02;
+		a11 += q.a11; a12 += q.a12;
+		a22 += q.a22;
+		b0 += q.b0; b1 += q.b1; b2 += q.b2;
+		c += q.c;
+	}
+
+	double Evaluate(const float* p) const
+	{
+		const double x = p[0], y = p[1], z = p[2];
+		const double e =
+			a00 * x * x + a11 * y * y + a22 * z * z +
+			2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+			2.0 * (b0 * x + b1 * y + b2 * z) + c;
+		return std::max(e, 0.0);
+	}
+};
+
+// Edge between two welded positions (group = first vertex at the position)
+enum class EdgeKind : uint8_t
+{
+	Interior,    // two triangles over the same two vertices
+	Constraint,  // border (one triangle) or seam (the two triangles use different vertices)
+	NonManifold, // more than two triangles
+};
+
+struct EdgeUse
+{
+	uint64_t groups;   // lower group << 32 | higher group
+	uint64_t vertices; // the same for the vertices of this triangle
+	uint32_t triangle;
+};
+
+struct GroupEdge
+{
+	uint32_t a, b;
+	EdgeKind kind;
+	uint32_t firstUse, useCount; // range in the sorted EdgeUse list
+};
+
+// Group collapse, every vertex of "from" moves to its partner in "to" (pairs[firstPair..])
+struct Collapse
+{
+	uint32_t from;
+	uint32_t to;
+	float cost; // squared error
+	uint32_t firstPair;
+	uint32_t pairCount;
+};
+
+static const float* Position(const MeshSimplifyVertices& v, uint32_t i);
+static void WeldVertices(const MeshSimplifyVertices& vertices, bool attributes, std::vector<uint32_t>& outWeld, std::vector<uint32_t>& outNext);
+static void BuildGroupEdges(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& weld, std::vector<EdgeUse>& uses, std::vector<GroupEdge>& outEdges);
+static void AddConstraintPlanes(const MeshSimplifyVertices& v, const std::vector<uint32_t>& indices, const std::vector<EdgeUse>& uses, const GroupEdge& edge, Quadric& qa, Quadric& qb);
+static bool FindPartners(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& first, const std::vector<uint32_t>& adjacency, const std::vector<uint32_t>& weld, const std::vector<uint32_t>& next, uint32_t from, uint32_t to, std::vector<uint32_t>& pairs);
+static float SkinDifference(const MeshSimplifyVertices& v, uint32_t a, uint32_t b);
+static bool FlipsTriangle(const MeshSimplifyVertices& v, const uint32_t* tri, uint32_t from, uint32_t to);
+static void PickFacingNormals(const MeshSimplifyVertices& v, const std::vector<uint32_t>& next, std::vector<uint32_t>& indices);
+
+
+void MeshSimplify_Run(
+	const uint32_t* indices,
+	size_t indexCount,
+	const MeshSimplifyVertices& vertices,
+	size_t targetIndexCount,
+	float maxError,
+	std::vector<uint32_t>& outIndices,
+	float& outError)
+{
+	outIndices.assign(indices, indices + (indexCount / 3) * 3);
+	outError = 0.0f;
+
+	const uint32_t vertexCount = vertices.vertexCount;
+	if (!vertices.positions || vertexCount == 0 || outIndices.size() <= targetIndexCount) return;
+
+	for (uint32_t index : outIndices)
+	{
+		if (index >= vertexCount) return;
+	}
+
+	// Vertices that differ in normal only (hard edges, flat shading) are one corner until the end
+	std::vector<uint32_t> corner;
+	std::vector<uint32_t> cornerNext;
+	if (vertices.normals)
+	{
+		WeldVertices(vertices, true, corner, cornerNext);
+		for (uint32_t& index : outIndices) index = corner[index];
+	}
+
+	// Vertices at one position collapse together, quadrics and locks are per position
+	std::vector<uint32_t> weld;
+	std::vector<uint32_t> next; // circular list of the vertices at one position
+	WeldVertices(vertices, false, weld, next);
+	if (vertices.normals)
+	{
+		// Only the corner representatives are referenced: leave the others out of the lists
+		const std::vector<uint32_t> all(next);
+		for (uint32_t v = 0; v < vertexCount; ++v)
+		{
+			uint32_t m = all[v];
+			while (corner[m] != m) m = all[m];
+			next[v] = corner[v] == v ? m : v;
+		}
+	}
+
+	// Mesh extent, scales the skin penalty into distance units
+	float minP[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float maxP[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		const float* p = Position(vertices, i);
+		for (int k = 0; k < 3; ++k)
+		{
+			minP[k] = std::min(minP[k], p[k]);
+			maxP[k] = std::max(maxP[k], p[k]);
+		}
+	}
+	const float extent = std::sqrt(
+		(maxP[0] - minP[0]) * (maxP[0] - minP[0]) +
+		(maxP[1] - minP[1]) * (maxP[1] - minP[1]) +
+		(maxP[2] - minP[2]) * (maxP[2] - minP[2]));
+	const float skinErrorScale = extent * SKIN_ERROR_SCALE;
+
+	// Plane of every triangle to its three corners
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t t = 0; t + 2 < outIndices.size(); t += 3)
+	{
+		const float* p0 = Position(vertices, outIndices[t + 0]);
+		const float* p1 = Position(vertices, outIndices[t + 1]);
+		const float* p2 = Position(vertices, outIndices[t + 2]);
+
+		const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		double n[3] = {
+			e1[1] * e2[2] - e1[2] * e2[1],
+			e1[2] * e2[0] - e1[0] * e2[2],
+			e1[0] * e2[1] - e1[1] * e2[0] };
+
+		const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length <= 0.0) continue;
+
+		n[0] /= length; n[1] /= length; n[2] /= length;
+		const double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+
+		for (int k = 0; k < 3; ++k)
+		{
+			quadrics[weld[outIndices[t + k]]].AddPlane(n[0], n[1], n[2], d);
+		}
+	}
+
+	// Seams / borders keep their line: plane through the edge, upright on its triangle
+	std::vector<EdgeUse> uses;
+	std::vector<GroupEdge> edges;
+	BuildGroupEdges(outIndices, weld, uses, edges);
+	for (const GroupEdge& edge : edges)
+	{
+		if (edge.kind == EdgeKind::Constraint)
+		{
+			AddConstraintPlanes(vertices, outIndices, uses, edge, quadrics[edge.a], quadrics[edge.b]);
+		}
+	}
+
+	const float maxCost = maxError * maxError;
+	float appliedCost = 0.0f;
+
+	std::vector<uint32_t> first(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<uint8_t> constraintCount(vertexCount); // seam / border edges at the position (saturating)
+	std::vector<uint8_t> locked(vertexCount);
+	std::vector<Collapse> candidates;
+	std::vector<uint32_t> pairs; // from / to vertex pairs of the candidates
+	std::vector<uint8_t> touched(vertexCount);
+	std::vector<uint32_t> collapseTo(vertexCount);
+
+	for (int pass = 0; pass < MAX_PASSES && outIndices.size() > targetIndexCount; ++pass)
+	{
+		const size_t triangleCount = outIndices.size() / 3;
+
+		// Vertex -> triangles of the current index list
+		std::fill(first.begin(), first.end(), 0u);
+		for (uint32_t index : outIndices) ++first[index + 1];
+		for (uint32_t v = 0; v < vertexCount; ++v) first[v + 1] += first[v];
+
+		adjacency.resize(outIndices.size());
+		{
+			std::vector<uint32_t> fill(first.begin(), first.end() - 1);
+			for (size_t i = 0; i < outIndices.size(); ++i)
+			{
+				adjacency[fill[outIndices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		if (pass > 0) BuildGroupEdges(outIndices, weld, uses, edges);
+
+		// Locked: non-manifold, seam / border ends and corners (not two seam edges),
+		// several vertices at a position without a seam between them (surfaces touching at a point)
+		std::fill(constraintCount.begin(), constraintCount.end(), static_cast<uint8_t>(0));
+		std::fill(locked.begin(), locked.end(), static_cast<uint8_t>(0));
+		for (const GroupEdge& edge : edges)
+		{
+			if (edge.kind == EdgeKind::NonManifold)
+			{
+				locked[edge.a] = locked[edge.b] = 1;
+			}
+			else if (edge.kind == EdgeKind::Constraint)
+			{
+				constraintCount[edge.a] = static_cast<uint8_t>(std::min(constraintCount[edge.a] + 1, 3));
+				constraintCount[edge.b] = static_cast<uint8_t>(std::min(constraintCount[edge.b] + 1, 3));
+			}
+		}
+		for (uint32_t v = 0; v < vertexCount; ++v)
+		{
+			if (weld[v] != v) continue;
+
+			uint32_t live = 0;
+			uint32_t m = v;
+			do
+			{
+				if (first[m + 1] > first[m]) ++live;
+				m = next[m];
+			} while (m != v);
+
+			if (constraintCount[v] != 0 && constraintCount[v] != 2) locked[v] = 1;
+			if (constraintCount[v] == 0 && live > 1) locked[v] = 1;
+		}
+
+		// Both directions of every edge, seam / border positions only along their seam
+		candidates.clear();
+		pairs.clear();
+		for (const GroupEdge& edge : edges)
+		{
+			if (edge.kind == EdgeKind::NonManifold) continue;
+
+			for (int dir = 0; dir < 2; ++dir)
+			{
+				const uint32_t from = dir ? edge.b : edge.a;
+				const uint32_t to = dir ? edge.a : edge.b;
+				if (locked[from]) continue;
+				if (constraintCount[from] != 0 && edge.kind != EdgeKind::Constraint) continue;
+
+				float cost = static_cast<float>(quadrics[from].Evaluate(Position(vertices, to)) + quadrics[to].Evaluate(Position(vertices, to)));
+				if (cost > maxCost) continue;
+
+				const uint32_t firstPair = static_cast<uint32_t>(pairs.size());
+				if (!FindPartners(outIndices, first, adjacency, weld, next, from, to, pairs))
+				{
+					pairs.resize(firstPair);
+					continue;
+				}
+
+				if (vertices.boneIndices && vertices.boneWeights)
+				{
+					float skin = 0.0f;
+					for (size_t p = firstPair; p < pairs.size(); p += 2)
+					{
+						skin = std::max(skin, SkinDifference(vertices, pairs[p], pairs[p + 1]));
+					}
+					cost += (skin * skinErrorScale) * (skin * skinErrorScale);
+					if (skin > SKIN_MAX_DIFFERENCE || cost > maxCost)
+					{
+						pairs.resize(firstPair);
+						continue;
+					}
+				}
+
+				Collapse c;
+				c.from = from;
+				c.to = to;
+				c.cost = cost;
+				c.firstPair = firstPair;
+				c.pairCount = static_cast<uint32_t>(pairs.size() - firstPair) / 2;
+				candidates.push_back(c);
+			}
+		}
+
+		if (candidates.empty()) break;
+
+		std::sort(candidates.begin(), candidates.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+		// Independent collapses only: the neighborhood of a collapsed position is frozen for this pass
+		std::fill(touched.begin(), touched.end(), static_cast<uint8_t>(0));
+		for (uint32_t v = 0; v < vertexCount; ++v) collapseTo[v] = v;
+
+		const size_t removeGoal = (outIndices.size() - targetIndexCount) / 3;
+		size_t removed = 0;
+		size_t collapsed = 0;
+
+		for (const Collapse& c : candidates)
+		{
+			if (touched[c.from] || touched[c.to]) continue;
+
+			bool flips = false;
+			size_t shared = 0;
+			for (uint32_t p = 0; p < c.pairCount && !flips; ++p)
+			{
+				const uint32_t from = pairs[c.firstPair + p * 2 + 0];
+				const uint32_t to = pairs[c.firstPair + p * 2 + 1];
+
+				for (uint32_t a = first[from]; a < first[from + 1] && !flips; ++a)
+				{
+					const uint32_t* tri = &outIndices[adjacency[a] * 3];
+					if (tri[0] == to || tri[1] == to || tri[2] == to)
+					{
+						++shared;
+						continue;
+					}
+					flips = FlipsTriangle(vertices, tri, from, to);
+				}
+			}
+			if (flips) continue;
+
+			quadrics[c.to].Add(quadrics[c.from]);
+			appliedCost = std::max(appliedCost, c.cost);
+
+			for (uint32_t p = 0; p < c.pairCount; ++p)
+			{
+				const uint32_t from = pairs[c.firstPair + p * 2 + 0];
+				collapseTo[from] = pairs[c.firstPair + p * 2 + 1];
+
+				for (uint32_t a = first[from]; a < first[from + 1]; ++a)
+				{
+					const uint32_t* tri = &outIndices[adjacency[a] * 3];
+					touched[weld[tri[0]]] = touched[weld[tri[1]]] = touched[weld[tri[2]]] = 1;
+				}
+			}
+
+			++collapsed;
+			removed += shared;
+			if (removed >= removeGoal) break;
+		}
+
+		if (collapsed == 0) break;
+
+		// Apply, drop the triangles that lost an edge
+		size_t write = 0;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t i0 = collapseTo[outIndices[t * 3 + 0]];
+			const uint32_t i1 = collapseTo[outIndices[t * 3 + 1]];
+			const uint32_t i2 = collapseTo[outIndices[t * 3 + 2]];
+			if (i0 == i1 || i1 == i2 || i0 == i2) continue;
+
+			outIndices[write++] = i0;
+			outIndices[write++] = i1;
+			outIndices[write++] = i2;
+		}
+		outIndices.resize(write);
+	}
+
+	if (vertices.normals) PickFacingNormals(vertices, cornerNext, outIndices);
+
+	outError = std::sqrt(appliedCost);
+}
+
+static const float* Position(const MeshSimplifyVertices& v, uint32_t i)
+{
+	return reinterpret_cast<const float*>(static_cast<const uint8_t*>(v.positions) + static_cast<size_t>(i) * v.positionStride);
+}
+
+// Weld by exact position (attributes : texcoord and skin too), outWeld = first vertex, outNext = circular list over them
+static void WeldVertices(const MeshSimplifyVertices& vertices, bool attributes, std::vector<uint32_t>& outWeld, std::vector<uint32_t>& outNext)
+{
+	const uint32_t vertexCount = vertices.vertexCount;
+
+	auto compare = [&vertices, attributes](uint32_t a, uint32_t b)
+	{
+		int c = memcmp(Position(vertices, a), Position(vertices, b), sizeof(float) * 3);
+		if (c != 0 || !attributes) return c;
+
+		if (vertices.texcoords)
+		{
+			const uint8_t* base = static_cast<const uint8_t*>(vertices.texcoords);
+			c = memcmp(base + static_cast<size_t>(a) * vertices.texcoordStride, base + static_cast<size_t>(b) * vertices.texcoordStride, sizeof(float) * 2);
+			if (c != 0) return c;
+		}
+		if (vertices.boneIndices && vertices.boneWeights)
+		{
+			const uint8_t* base = static_cast<const uint8_t*>(vertices.boneIndices);
+			c = memcmp(base + static_cast<size_t>(a) * vertices.skinStride, base + static_cast<size_t>(b) * vertices.skinStride, sizeof(uint32_t) * 4);
+			if (c != 0) return c;
+
+			base = static_cast<const uint8_t*>(vertices.boneWeights);
+			c = memcmp(base + static_cast<size_t>(a) * vertices.skinStride, base + static_cast<size_t>(b) * vertices.skinStride, sizeof(float) * 4);
+		}
+		return c;
+	};
+
+	std::vector<uint32_t> order(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; ++i) order[i] = i;
+
+	std::sort(order.begin(), order.end(), [&compare](uint32_t a, uint32_t b)
+	{
+		const int c = compare(a, b);
+		return c < 0 || (c == 0 && a < b);
+	});
+
+	outWeld.resize(vertexCount);
+	outNext.resize(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; )
+	{
+		uint32_t j = i + 1;
+		while (j < vertexCount && compare(order[i], order[j]) == 0) ++j;
+
+		for (uint32_t k = i; k < j; ++k)
+		{
+			outWeld[order[k]] = order[i];
+			outNext[order[k]] = order[k + 1 < j ? k + 1 : i];
+		}
+		i = j;
+	}
+}
+
+// Edges over welded positions with their kind, from every triangle side of the index list
+static void BuildGroupEdges(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& weld, std::vector<EdgeUse>& uses, std::vector<GroupEdge>& outEdges)
+{
+	uses.clear();
+	outEdges.clear();
+
+	for (size_t t = 0; t + 2 < indices.size(); t += 3)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			uint32_t va = indices[t + k];
+			uint32_t vb = indices[t + (k + 1) % 3];
+			uint32_t a = weld[va];
+			uint32_t b = weld[vb];
+			if (a == b) continue;
+			if (a > b)
+			{
+				std::swap(a, b);
+				std::swap(va, vb);
+			}
+
+			EdgeUse use;
+			use.groups = (static_cast<uint64_t>(a) << 32) | b;
+			use.vertices = (static_cast<uint64_t>(va) << 32) | vb;
+			use.triangle = static_cast<uint32_t>(t / 3);
+			uses.push_back(use);
+		}
+	}
+	std::sort(uses.begin(), uses.end(), [](const EdgeUse& l, const EdgeUse& r)
+	{
+		return l.groups != r.groups ? l.groups < r.groups : l.vertices < r.vertices;
+	});
+
+	for (size_t i = 0; i < uses.size(); )
+	{
+		size_t j = i + 1;
+		while (j < uses.size() && uses[j].groups == uses[i].groups) ++j;
+
+		GroupEdge edge;
+		edge.a = static_cast<uint32_t>(uses[i].groups >> 32);
+		edge.b = static_cast<uint32_t>(uses[i].groups & 0xFFFFFFFFu);
+		edge.firstUse = static_cast<uint32_t>(i);
+		edge.useCount = static_cast<uint32_t>(j - i);
+
+		if (j - i > 2) edge.kind = EdgeKind::NonManifold;
+		else if (j - i == 1 || uses[i].vertices != uses[i + 1].vertices) edge.kind = EdgeKind::Constraint;
+		else edge.kind = EdgeKind::Interior;
+
+		outEdges.push_back(edge);
+		i = j;
+	}
+}
+
+// Plane through the edge and the normal of each of its triangles: moving along the seam costs nothing,
+// moving off it costs the squared distance like a surface plane
+static void AddConstraintPlanes(const MeshSimplifyVertices& v, const std::vector<uint32_t>& indices, const std::vector<EdgeUse>& uses, const GroupEdge& edge, Quadric& qa, Quadric& qb)
+{
+	const float* pa = Position(v, edge.a);
+	const float* pb = Position(v, edge.b);
+	const double e[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+
+	for (uint32_t u = edge.firstUse; u < edge.firstUse + edge.useCount; ++u)
+	{
+		const uint32_t* tri = &indices[uses[u].triangle * 3];
+		const float* p0 = Position(v, tri[0]);
+		const float* p1 = Position(v, tri[1]);
+		const float* p2 = Position(v, tri[2]);
+
+		const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		const double f[3] = {
+			e1[1] * e2[2] - e1[2] * e2[1],
+			e1[2] * e2[0] - e1[0] * e2[2],
+			e1[0] * e2[1] - e1[1] * e2[0] };
+
+		double n[3] = {
+			e[1] * f[2] - e[2] * f[1],
+			e[2] * f[0] - e[0] * f[2],
+			e[0] * f[1] - e[1] * f[0] };
+
+		const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length <= 0.0) continue;
+
+		n[0] /= length; n[1] /= length; n[2] /= length;
+		const double d = -(n[0] * pa[0] + n[1] * pa[1] + n[2] * pa[2]);
+
+		qa.AddPlane(n[0], n[1], n[2], d);
+		qb.AddPlane(n[0], n[1], n[2], d);
+	}
+}
+
+// Every live vertex at "from" needs exactly one vertex at "to" it shares a triangle with,
+// otherwise it would take the attributes of the other side of a seam
+static bool FindPartners(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& first, const std::vector<uint32_t>& adjacency, const std::vector<uint32_t>& weld, const std::vector<uint32_t>& next, uint32_t from, uint32_t to, std::vector<uint32_t>& pairs)
+{
+	uint32_t m = from;
+	do
+	{
+		if (first[m + 1] > first[m])
+		{
+			uint32_t partner = UINT32_MAX;
+			for (uint32_t a = first[m]; a < first[m + 1]; ++a)
+			{
+				const uint32_t* tri = &indices[adjacency[a] * 3];
+				for (int k = 0; k < 3; ++k)
+				{
+					if (weld[tri[k]] != to || tri[k] == partner) continue;
+					if (partner != UINT32_MAX) return false;
+					partner = tri[k];
+				}
+			}
+			if (partner == UINT32_MAX) return false;
+
+			pairs.push_back(m);
+			pairs.push_back(partner);
+		}
+		m = next[m];
+	} while (m != from);
+
+	return true;
+}
+
+// Half the L1 distance between the two weight sets: 0 same influences, 1 nothing in common
+static float SkinDifference(const MeshSimplifyVertices& v, uint32_t a, uint32_t b)
+{
+	const uint8_t* base = static_cast<const uint8_t*>(v.boneIndices);
+	const uint8_t* wbase = static_cast<const uint8_t*>(v.boneWeights);
+
+	const uint32_t* ia = reinterpret_cast<const uint32_t*>(base + static_cast<size_t>(a) * v.skinStride);
+	const uint32_t* ib = reinterpret_cast<const uint32_t*>(base + static_cast<size_t>(b) * v.skinStride);
+	const float* wa = reinterpret_cast<const float*>(wbase + static_cast<size_t>(a) * v.skinStride);
+	const float* wb = reinterpret_cast<const float*>(wbase + static_cast<size_t>(b) * v.skinStride);
+
+	float diff = 0.0f;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		if (wa[i] <= 0.0f) continue;
+
+		float other = 0.0f;
+		for (int j = 0; j < 4; ++j)
+		{
+			if (ib[j] == ia[i]) other += wb[j];
+		}
+		diff += std::fabs(wa[i] - other);
+	}
+
+	for (int j = 0; j < 4; ++j)
+	{
+		if (wb[j] <= 0.0f) continue;
+
+		bool shared = false;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (ia[i] == ib[j] && wa[i] > 0.0f) shared = true;
+		}
+		if (!shared) diff += wb[j];
+	}
+
+	return diff * 0.5f;
+}
+
+static bool FlipsTriangle(const MeshSimplifyVertices& v, const uint32_t* tri, uint32_t from, uint32_t to)
+{
+	const float* p[3];
+	const float* q[3];
+	for (int k = 0; k < 3; ++k)
+	{
+		p[k] = Position(v, tri[k]);
+		q[k] = Position(v, tri[k] == from ? to : tri[k]);
+	}
+
+	auto normal = [](const float* const* c, float* n)
+	{
+		const float e1[3] = { c[1][0] - c[0][0], c[1][1] - c[0][1], c[1][2] - c[0][2] };
+		const float e2[3] = { c[2][0] - c[0][0], c[2][1] - c[0][1], c[2][2] - c[0][2] };
+		n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+		n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+		n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+	};
+
+	float n0[3], n1[3];
+	normal(p, n0);
+	normal(q, n1);
+
+	return n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0f;
+}
+
+// Each corner takes the vertex of its corner list whose normal is closest to the simplified triangle's
+static void PickFacingNormals(const MeshSimplifyVertices& v, const std::vector<uint32_t>& next, std::vector<uint32_t>& indices)
+{
+	const uint8_t* base = static_cast<const uint8_t*>(v.normals);
+
+	for (size_t t = 0; t + 2 < indices.size(); t += 3)
+	{
+		const float* p0 = Position(v, indices[t + 0]);
+		const float* p1 = Position(v, indices[t + 1]);
+		const float* p2 = Position(v, indices[t + 2]);
+
+		const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		const float n[3] = {
+			e1[1] * e2[2] - e1[2] * e2[1],
+			e1[2] * e2[0] - e1[0] * e2[2],
+			e1[0] * e2[1] - e1[1] * e2[0] };
+
+		for (int k = 0; k < 3; ++k)
+		{
+			const uint32_t start = indices[t + k];
+			uint32_t best = start;
+			float bestDot = -FLT_MAX;
+
+			uint32_t m = start;
+			do
+			{
+				const float* normal = reinterpret_cast<const float*>(base + static_cast<size_t>(m) * v.normalStride);
+				const float dot = normal[0] * n[0] + normal[1] * n[1] + normal[2] * n[2];
+				if (dot > bestDot)
+				{
+					bestDot = dot;
+					best = m;
+				}
+				m = next[m];
+			} while (m != start);
+
+			indices[t + k] = best;
+		}
+	}
+}
@@ -0,0 +1,63 @@
+/*==============================================================================
+
+   Quadric error mesh simplification [mesh_simplify_util.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef MESH_SIMPLIFY_UTIL_H
+#define MESH_SIMPLIFY_UTIL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+// -------------------------------
+Edge collapse onto an existing vertex (Garland & Heckbert quadrics), standard C++ only
+├─ output is an index list over the same vertices : LODs share the parent's vertex buffer
+├─ vertices at one position collapse together, each to the vertex it shares a triangle with at the target
+├─ seams (UV / skin splits) and borders
+│   ├─ their vertices only collapse along the seam / border, extra quadric planes keep its line
+│   └─ locked (never removed) where seams meet or end, and at non-manifold edges
+├─ hard normals (normals given) : vertices that differ in normal only are no seam,
+│   each output corner takes the one facing its simplified triangle
+├─ skinned input : collapses between different weights cost more, far apart ones are refused
+└─ collapses that flip a triangle are refused
+// -------------------------------
+*/
+
+// Vertex attributes read by the simplifier, strides in bytes (optional streams may be nullptr)
+struct MeshSimplifyVertices
+{
+	const void* positions = nullptr;   // float3
+	size_t positionStride = 0;
+
+	const void* normals = nullptr;     // float3, optional : hard edges / flat shading do not lock the mesh
+	size_t normalStride = 0;
+
+	const void* texcoords = nullptr;   // float2, read with normals (UV seams stay seams)
+	size_t texcoordStride = 0;
+
+	const void* boneIndices = nullptr; // uint32[4], with boneWeights
+	const void* boneWeights = nullptr; // float[4]
+	size_t skinStride = 0;
+
+	uint32_t vertexCount = 0;
+};
+
+// Collapses toward targetIndexCount while every collapse stays below maxError (object space distance)
+// outError : largest error of the applied collapses, 0 when nothing was removed
+void MeshSimplify_Run(
+	const uint32_t* indices,
+	size_t indexCount,
+	const MeshSimplifyVertices& vertices,
+	size_t targetIndexCount,
+	float maxError,
+	std::vector<uint32_t>& outIndices,
+	float& outError
+);
+
+#endif // MESH_SIMPLIFY_UTIL_H
@@ -9,30 +9,102 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <cstring>
 #include <unordered_set>
 
 #include "model_asset.h"
+
+// --------------------
+// Assimp lib
+// --------------------
+#include "assimp/cimport.h"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+#include "assimp/matrix4x4.h"
+#include "assimp/config.h"
+#pragma comment (lib, "assimp-vc143-mt.lib")
+
+#include <d3d11.h>
 #include "WICTextureLoader11.h"
 #include "direct3d.h"
 #include "default3Dmaterial.h"
 #include "skeleton_util.h"
 #include "axis_util.h"
 #include "texture.h"
+#include "model_cook.h"
+#include "system_timer.h"
+#include "worker_pool_util.h"
+#include "mesh_optimize_util.h"
+#include "mesh_simplify_util.h"
 
 using namespace DirectX;
 
 static const int MAX_BONES = 256;
+static const float BONE_BOUNDS_MIN_WEIGHT = 0.1f; // smaller influences do not grow a bone's box
+static const unsigned int CONVERT_VERTEX_CHUNK = 16384; // vertices per conversion task, big meshes are split
+static const uint32_t MAX_INDEX16_VERTICES = 65535;
+static const float LOD_MIN_REDUCTION = 0.9f; // a LOD keeps at most this much of the previous level's triangles
+
+// Importer output of one mesh, kept until the buffers and the cooked file are written
+struct ImportedMesh
+{
+	std::vector<Vertex3d> vertices;
+	std::vector<VertexPacked> packedVertices;
+	std::vector<VertexSkinPacked> skinVertices;
+	std::vector<uint32_t> indices;
+	std::vector<BoneBounds> boneBounds;
+	std::vector<MeshLod> lods;         // levels after the full mesh
+	std::vector<uint32_t> lodIndices;
+
+	MeshOptimizeReport optimizeReport; // ACMR / ATVR / overfetch around every reorder stage
+};
 
 // ---- Function Tool ----
 static std::wstring Utf8ToWstring(const std::string& s);
-static void AssignUVForMesh(Vertex3d* vertex, const aiMesh* mesh);
-static void LoadAllModelTextures(ModelAsset* asset, const std::string& directory);
+static void AssignUVForMesh(Vertex3d* vertex, const aiMesh* mesh, unsigned int begin, unsigned int end);
+static void LoadAllModelTextures(
+	ModelAsset* asset,
+	const std::vector<ModelCookTexture>& embedded,
+	const std::vector<ModelCookMaterial>& materials,
+	const std::string& directory
+);
+static void LoadTextureFile(ModelAsset* asset, const std::string& directory, const std::string& rawName);
 static void ApplySkinWeightToVertices(
 	Vertex3d* vertices,
 	const aiMesh* mesh,
 	const std::unordered_map<std::string, int>& boneNameToIndex
 );
-static AABB ComputeLocalAABB(const aiMesh* mesh);
+static AABB ComputeLocalAABB(const aiMesh* mesh, unsigned int begin, unsigned int end);
+static void MergeAABB(AABB& ioBox, const AABB& box);
+static void ComputeBoneBounds(const Vertex3d* vertices, unsigned int vertexCount, std::vector<BoneBounds>& outBounds);
+
+// Import path -> ModelCook records, then one path for both sources
+static void ConvertMeshes(
+	const aiScene* scene,
+	const std::unordered_map<std::string, int>& boneNameToIndex,
+	const ModelLodSettings& lod,
+	std::vector<ImportedMesh>& outImported,
+	std::vector<ModelCookMesh>& outMeshes,
+	int& outTaskCount,
+	int& outThreadCount
+);
+static AABB ConvertVertexRange(const aiMesh* mesh, Vertex3d* vertex, unsigned int begin, unsigned int end);
+static void FinishMesh(
+	const aiMesh* mesh,
+	const std::unordered_map<std::string, int>& boneNameToIndex,
+	const ModelLodSettings& lod,
+	ImportedMesh& imported,
+	ModelCookMesh& out
+);
+static void BuildLodChain(const std::vector<Vertex3d>& vertices, const std::vector<uint32_t>& indices, const ModelCookMesh& mesh, const ModelLodSettings& lod, ImportedMesh& imported);
+static void CreateAssetBuffers(ModelAsset* asset, const std::vector<ModelCookMesh>& meshes);
+static ID3D11Buffer* CreateImmutableBuffer(const void* data, size_t bytes, UINT bindFlags);
+static void ReportVertexMemory(const char* filename, const ModelAsset* asset);
+static void ReportMeshOptimize(const char* filename, const std::vector<ImportedMesh>& imported);
+static void ReportMeshLod(const char* filename, const ModelAsset* asset);
+static void ReadMaterials(const aiScene* scene, std::vector<ModelCookMaterial>& outMaterials);
+static void ReadEmbeddedTextures(const aiScene* scene, std::vector<ModelCookTexture>& outTextures);
+static void BuildMaterials(ModelAsset* asset, const std::vector<ModelCookMaterial>& materials, const std::string& directory);
 
 // Path normalization
 static std::string NormalizePath(std::string p);
@@ -43,189 +115,113 @@ static void RegisterTextureAlias(ModelAsset* asset, ID3D11ShaderResourceView* sr
 
 
 // Fbx model file load
-ModelAsset* ModelAsset_Load(const char* filename, bool yUp, float scale)
+// Cooked .meshcache first (model_cook.h), assimp only when it is missing or stale
+ModelAsset* ModelAsset_Load(const char* filename, bool yUp, float scale, const ModelLodSettings& lod)
 {
+	const double start = SystemTimer_GetAbsoluteTime();
+
+	// Stage timings (ms), logged at the end
+	double stageStart = start;
+	auto lap = [&stageStart]()
+	{
+		const double now = SystemTimer_GetAbsoluteTime();
+		const double ms = (now - stageStart) * 1000.0;
+		stageStart = now;
+		return ms;
+	};
+
 	ModelAsset* asset = new ModelAsset();
 	asset->importScale = scale;
 	asset->sourceYup = yUp;
+	asset->lodSettings = lod;
 
 	const std::string modelPath(filename);
 
-	// ---- Assimp import setting ----
-	asset->aiScene = aiImportFile(
-		filename,
-		aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_ConvertToLeftHanded
-	);
-	assert(asset->aiScene);
-
-	SkeletonUtil::BuildBoneNameToIndexTable(asset->aiScene, asset->boneNameToIndex);
+	// Model file path analyzation
+	size_t pos = modelPath.find_last_of("/\\");
+	std::string directory = (pos != std::string::npos) ? modelPath.substr(0, pos) : "";
 
-	const XMMATRIX axisFix = GetAxisConversion(UpFromBool(asset->sourceYup), UpAxis::Y_Up);
-	const XMMATRIX importScaleM = XMMatrixScaling(asset->importScale, asset->importScale, asset->importScale);
-	asset->importFix = importScaleM * axisFix; // import fix only do once
+	// The source is only hashed to detect a stale cache (no source file: trust the cooked one)
+	const std::string cookedPath = ModelCook_GetCookedPath(filename);
+	uint64_t sourceHash = 0;
+	const bool hasSource = FileUtil_HashFile(filename, sourceHash);
+	const double hashMs = lap();
 
-	asset->meshes.resize(asset->aiScene->mNumMeshes);
+	ModelCookData cooked;
+	const bool fromCache = ModelCook_Load(cookedPath.c_str(), sourceHash, hasSource, yUp, scale, lod, cooked);
 
-	for (unsigned int m = 0; m < asset->aiScene->mNumMeshes; m++)
+	if (fromCache)
 	{
-		aiMesh* mesh = asset->aiScene->mMeshes[m];
-		MeshAsset& out = asset->meshes[m];
-
-		out.skinned = (mesh->mNumBones > 0);
-		out.materialIndex = mesh->mMaterialIndex;
-		out.localAABB = ComputeLocalAABB(mesh);
-
-		// Vertex buffer
-		Vertex3d* vertex = new Vertex3d[mesh->mNumVertices];
-
-		for (unsigned int v = 0; v < mesh->mNumVertices; v++)
-		{
-			vertex[v].position = XMFLOAT3{ mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z }; // position
-			vertex[v].normal   = XMFLOAT3{ mesh->mNormals[v].x,  mesh->mNormals[v].y,  mesh->mNormals[v].z };  // normal
-			vertex[v].color = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f); // vertex color
-
-			// Tangent
-			if (mesh->mTangents)
-			{
-				vertex[v].tangent = XMFLOAT3{ mesh->mTangents[v].x, mesh->mTangents[v].y, mesh->mTangents[v].z };
-			}
-			else
-			{
-				vertex[v].tangent = { 1, 0, 0 };
-			}
-		}
-
-		// Skin weight
-		ApplySkinWeightToVertices(vertex, mesh, asset->boneNameToIndex);
-
-		// UV
-		AssignUVForMesh(vertex, mesh);
-
-		D3D11_BUFFER_DESC vbd;
-		ZeroMemory(&vbd, sizeof(vbd));
-		vbd.Usage = D3D11_USAGE_DYNAMIC;
-		vbd.ByteWidth = UINT(sizeof(Vertex3d) * mesh->mNumVertices);
-		vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		vbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-
-		D3D11_SUBRESOURCE_DATA vsd;
-		ZeroMemory(&vsd, sizeof(vsd));
-		vsd.pSysMem = vertex;
-
-		Direct3D_GetDevice()->CreateBuffer(&vbd, &vsd, &out.vertexBuffer);
-
-		delete[] vertex;
-
-		// Index buffer
-		unsigned int* index = new unsigned int[mesh->mNumFaces * 3];
-
-		for (unsigned int f = 0; f < mesh->mNumFaces; f++)
-		{
-			const aiFace* face = &mesh->mFaces[f];
-			assert(face->mNumIndices == 3);
-
-			index[f * 3 + 0] = face->mIndices[0];
-			index[f * 3 + 1] = face->mIndices[1];
-			index[f * 3 + 2] = face->mIndices[2];
-		}
-
-		D3D11_BUFFER_DESC ibd;
-		ZeroMemory(&ibd, sizeof(ibd));
-		ibd.Usage = D3D11_USAGE_DEFAULT;
-		ibd.ByteWidth = UINT(sizeof(unsigned int) * mesh->mNumFaces * 3);
-		ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-		ibd.CPUAccessFlags = 0;
-
-		D3D11_SUBRESOURCE_DATA isd;
-		ZeroMemory(&isd, sizeof(isd));
-		isd.pSysMem = index;
-
-		Direct3D_GetDevice()->CreateBuffer(&ibd, &isd, &out.indexBuffer);
+		asset->aiScene = cooked.scene; // nodes, mesh names / counts and bones only
+		asset->cookedScene = true;
+		cooked.scene = nullptr;
+	}
+	else
+	{
+		// ---- Assimp import setting ----
+		asset->aiScene = aiImportFile(
+			filename,
+			aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_ConvertToLeftHanded
+		);
+		assert(asset->aiScene);
+	}
+	const double sourceMs = lap(); // cooked map + scene shell, or assimp import
 
-		delete[] index;
+	SkeletonUtil::BuildBoneNameToIndexTable(asset->aiScene, asset->boneNameToIndex);
+	SkeletonRuntime_Build(asset->aiScene, asset->boneNameToIndex, asset->skeleton);
+	const double skeletonMs = lap();
 
-		out.indexCount = mesh->mNumFaces * 3;
-	}
+	const XMMATRIX axisFix = GetAxisConversion(UpFromBool(asset->sourceYup), UpAxis::Y_Up);
+	const XMMATRIX importScaleM = XMMatrixScaling(asset->importScale, asset->importScale, asset->importScale);
+	asset->importFix = importScaleM * axisFix; // import fix only do once
 
-	// Model file path analyzation
-	size_t pos = modelPath.find_last_of("/\\");
-	std::string directory = (pos != std::string::npos) ? modelPath.substr(0, pos) : "";
+	std::vector<ImportedMesh> imported;
 
-	LoadAllModelTextures(asset, directory);
+	// ---- CPU conversion (parallel, no device) ----
+	int convertTasks = 0;
+	int convertThreads = 1;
 
-	// ---- Material Building ----
-	if (asset->aiScene->mNumMaterials > 0)
+	if (!fromCache)
 	{
-		asset->materials.resize(asset->aiScene->mNumMaterials, nullptr);
+		ConvertMeshes(asset->aiScene, asset->boneNameToIndex, lod, imported, cooked.meshes, convertTasks, convertThreads);
 
-		for (unsigned int i = 0; i < asset->aiScene->mNumMaterials; ++i)
-		{
-			aiMaterial* aimat = asset->aiScene->mMaterials[i];
-			Default3DMaterial* mat = new Default3DMaterial();
+		ReadMaterials(asset->aiScene, cooked.materials);
+		ReadEmbeddedTextures(asset->aiScene, cooked.textures);
+	}
+	const double convertMs = lap();
 
-			aiString aiName;
+	ReportMeshOptimize(filename, imported);
 
-			// Set material name
-			if (AI_SUCCESS == aimat->Get(AI_MATKEY_NAME, aiName) && aiName.length > 0)
-			{
-				mat->SetName(aiName.C_Str());
-			}
-			else
-			{
-				char buf[64];
-				sprintf_s(buf, "Material %u", i);
-				mat->SetName(buf);
-			}
+	// ---- GPU buffers (one vertex / skin / index buffer for the whole asset) ----
+	CreateAssetBuffers(asset, cooked.meshes);
+	const double uploadMs = lap();
 
-			// Diffuse color
-			aiColor3D diffuse(1.0f, 1.0f, 1.0f);
-			if (AI_SUCCESS == aimat->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse))
-			{
-				mat->SetBaseColor({ diffuse.r, diffuse.g, diffuse.b, 1.0f });
-			}
+	ReportVertexMemory(filename, asset);
+	ReportMeshLod(filename, asset);
 
-			// Specular color
-			aiColor3D specular(1.0f, 1.0f, 1.0f);
-			if (AI_SUCCESS == aimat->Get(AI_MATKEY_COLOR_SPECULAR, specular))
-			{
-				mat->SetSpecularColor({ specular.r, specular.g, specular.b, 1.0f });
-			}
+	LoadAllModelTextures(asset, cooked.textures, cooked.materials, directory);
+	const double textureMs = lap();
 
-			// Shininess -> SpecularPower
-			float shininess = 0.0f;
-			if (AI_SUCCESS == aimat->Get(AI_MATKEY_SHININESS, shininess))
-			{
-				if (shininess > 0.0f)
-					mat->SetSpecularPower(shininess);
-			}
-
-			// Diffuse map path
-			aiString diffuseName;
-			if (AI_SUCCESS == aimat->GetTexture(aiTextureType_DIFFUSE, 0, &diffuseName) && diffuseName.length != 0)
-			{
-				mat->SetDiffuseMapPath(MakeTextureKey(directory, diffuseName.C_Str()));
-			}
+	// ---- Material Building ----
+	BuildMaterials(asset, cooked.materials, directory);
+	const double materialMs = lap();
 
-			// Normal map path (NORMALS or HEIGHT)
-			aiString normalName;
-			if (AI_SUCCESS == aimat->GetTexture(aiTextureType_NORMALS, 0, &normalName) ||
-				AI_SUCCESS == aimat->GetTexture(aiTextureType_HEIGHT, 0, &normalName) &&
-				normalName.length != 0)
-			{
-				mat->SetNormalMapPath(MakeTextureKey(directory, normalName.C_Str()));
-			}
+	if (!fromCache && hasSource &&
+		!ModelCook_Write(cookedPath.c_str(), sourceHash, yUp, scale, lod, asset->aiScene, cooked.meshes, cooked.materials, cooked.textures))
+	{
+		char buf[512];
+		sprintf_s(buf, "[ModelCook] failed to write %s\n", cookedPath.c_str());
+		OutputDebugStringA(buf);
+	}
+	const double writeMs = lap();
 
-			// Specular map path
-			aiString specName;
-			if (AI_SUCCESS == aimat->GetTexture(aiTextureType_SPECULAR, 0, &specName) && specName.length != 0)
-			{
-				mat->SetSpecularMapPath(MakeTextureKey(directory, specName.C_Str()));
-			}
+	char buf[768];
+	sprintf_s(buf, "[ModelCook] %s : %s, %.2f ms\n", filename, fromCache ? "cooked" : "imported", (SystemTimer_GetAbsoluteTime() - start) * 1000.0);
+	OutputDebugStringA(buf);
 
-			asset->materials[i] = mat;
-			Default3DMaterial_Register(mat);
-		}
-	}
+	sprintf_s(buf, "[ModelLoad] %s : hash %.2f / %s %.2f / skeleton %.2f / convert %.2f (%d tasks, %d threads) / upload %.2f / textures %.2f / materials %.2f / cook write %.2f ms\n",
+		filename, hashMs, fromCache ? "map" : "assimp", sourceMs, skeletonMs, convertMs, convertTasks, convertThreads, uploadMs, textureMs, materialMs, writeMs);
+	OutputDebugStringA(buf);
 
 	return asset;
 }
@@ -234,18 +230,20 @@ void ModelAsset_Release(ModelAsset* asset)
 {
 	if (!asset) return;
 
-	for (auto& m : asset->meshes)
+	if (asset->vertexBuffer)
 	{
-		if (m.vertexBuffer)
-		{
-			m.vertexBuffer->Release();
-			m.vertexBuffer = nullptr;
-		}
-		if (m.indexBuffer)
-		{
-			m.indexBuffer->Release();
-			m.indexBuffer = nullptr;
-		}
+		asset->vertexBuffer->Release();
+		asset->vertexBuffer = nullptr;
+	}
+	if (asset->skinBuffer)
+	{
+		asset->skinBuffer->Release();
+		asset->skinBuffer = nullptr;
+	}
+	if (asset->indexBuffer)
+	{
+		asset->indexBuffer->Release();
+		asset->indexBuffer = nullptr;
 	}
 	asset->meshes.clear();
 
@@ -270,7 +268,19 @@ void ModelAsset_Release(ModelAsset* asset)
 	}
 	asset->materials.clear();
 
-	if (asset->aiScene) aiReleaseImport(asset->aiScene);
+	// Only aiImportFile's scenes go back to assimp, the cooked shell was allocated on this side of the DLL
+	if (asset->aiScene)
+	{
+		if (asset->cookedScene)
+		{
+			ModelCook_ReleaseSceneShell(const_cast<aiScene*>(asset->aiScene));
+		}
+		else
+		{
+			aiReleaseImport(asset->aiScene);
+		}
+		asset->aiScene = nullptr;
+	}
 	delete asset;
 }
 
@@ -285,18 +295,18 @@ std::wstring Utf8ToWstring(const std::string& s)
 }
 
 // Assign uv for mesh
-static void AssignUVForMesh(Vertex3d* vertex, const aiMesh* mesh)
+static void AssignUVForMesh(Vertex3d* vertex, const aiMesh* mesh, unsigned int begin, unsigned int end)
 {
 	if (mesh->HasTextureCoords(0))
 	{
-		for (unsigned int v = 0; v < mesh->mNumVertices; ++v)
+		for (unsigned int v = begin; v < end; ++v)
 		{
 			vertex[v].texcoord = XMFLOAT2{ mesh->mTextureCoords[0][v].x, mesh->mTextureCoords[0][v].y };
 		}
 	}
 	else
 	{
-		for (unsigned int v = 0; v < mesh->mNumVertices; ++v)
+		for (unsigned int v = begin; v < end; ++v)
 		{
 			vertex[v].texcoord = XMFLOAT2{ 0.0f, 0.0f };
 		}
@@ -304,27 +314,27 @@ static void AssignUVForMesh(Vertex3d* vertex, const aiMesh* mesh)
 }
 
 // Load model with textures
-static void LoadAllModelTextures(ModelAsset* asset, const std::string& directory)
+static void LoadAllModelTextures(
+	ModelAsset* asset,
+	const std::vector<ModelCookTexture>& embedded,
+	const std::vector<ModelCookMaterial>& materials,
+	const std::string& directory)
 {
 	// DIFFUSE MAP
-	// eNX`Ăꍇ
-	for (unsigned int i = 0; i < asset->aiScene->mNumTextures; ++i)
+	// eNX`ߍ܂Ăꍇ
+	for (size_t i = 0; i < embedded.size(); ++i)
 	{
-		aiTexture* aitexture = asset->aiScene->mTextures[i];
-		if (!aitexture) continue;
+		const ModelCookTexture& tex = embedded[i];
+		if (!tex.data || tex.bytes == 0) continue;
 
 		ID3D11ShaderResourceView* texture = nullptr;
 		ID3D11Resource* resource = nullptr;
 
-		const size_t bytes = (aitexture->mHeight == 0)
-			? static_cast<size_t>(aitexture->mWidth)
-			: static_cast<size_t>(aitexture->mWidth) * static_cast<size_t>(aitexture->mHeight) * 4;
-
 		HRESULT hr = CreateWICTextureFromMemory(
 			Direct3D_GetDevice(),
 			Direct3D_GetContext(),
-			reinterpret_cast<const uint8_t*>(aitexture->pcData),
-			bytes,
+			tex.data,
+			static_cast<size_t>(tex.bytes),
 			&resource,
 			&texture
 		);
@@ -333,141 +343,684 @@ static void LoadAllModelTextures(ModelAsset* asset, const std::string& directory
 			resource->Release();
 
 			const std::string starKey = "*" + std::to_string(i);
-			//asset->textures[starKey] = texture;
 			RegisterTextureAlias(asset, texture, starKey);
 
-			if (aitexture->mFilename.length > 0)
+			if (!tex.name.empty())
 			{
-				//asset->textures[aitexture->mFilename.C_Str()] = texture;
-				RegisterTextureAlias(asset, texture, aitexture->mFilename.C_Str());
-			}			
+				RegisterTextureAlias(asset, texture, tex.name);
+			}
 		}
 	}
 
 	// eNX`FBXƂ͕ʂɗpӂĂꍇ
-	for (unsigned int m = 0; m < asset->aiScene->mNumMaterials; ++m)
+	for (const ModelCookMaterial& mat : materials)
+	{
+		LoadTextureFile(asset, directory, mat.diffuseMap);
+	}
+
+	// NORMAL MAP
+	for (const ModelCookMaterial& mat : materials)
+	{
+		LoadTextureFile(asset, directory, mat.normalMap);
+	}
+
+	// SPECULAR MAP
+	for (const ModelCookMaterial& mat : materials)
+	{
+		LoadTextureFile(asset, directory, mat.specularMap);
+	}
+}
+
+// One texture next to the model file, registered under its full and raw names
+static void LoadTextureFile(ModelAsset* asset, const std::string& directory, const std::string& rawName)
+{
+	if (rawName.empty()) return;
+
+	if (asset->textures.count(rawName))
+	{
+		return;
+	}
+
+	std::string fullKey = MakeTextureKey(directory, rawName);
+
+	std::wstring wpath = Utf8ToWstring(fullKey);
+
+	ID3D11ShaderResourceView* texture = nullptr;
+	ID3D11Resource* resource = nullptr;
+
+	HRESULT hr = CreateWICTextureFromFile(
+		Direct3D_GetDevice(),
+		Direct3D_GetContext(),
+		wpath.c_str(),
+		&resource,
+		&texture
+	);
+
+	if (SUCCEEDED(hr) && texture)
+	{
+		resource->Release();
+
+		RegisterTextureAlias(asset, texture, fullKey);
+		RegisterTextureAlias(asset, texture, rawName);
+	}
+}
+
+// aiMesh[] -> Vertex3d / packed / index arrays (import path only)
+// 1. vertex ranges in parallel : attribute copy, UV, box of the range
+// 2. one task per mesh         : skin weights (written per bone, not per vertex), indices,
+//                                index / vertex reorder (mesh_optimize_util.h), LOD chain (mesh_simplify_util.h),
+//                                bone bounds, packing
+static void ConvertMeshes(
+	const aiScene* scene,
+	const std::unordered_map<std::string, int>& boneNameToIndex,
+	const ModelLodSettings& lod,
+	std::vector<ImportedMesh>& outImported,
+	std::vector<ModelCookMesh>& outMeshes,
+	int& outTaskCount,
+	int& outThreadCount)
+{
+	const unsigned int meshCount = scene->mNumMeshes;
+
+	outImported.resize(meshCount);
+	outMeshes.assign(meshCount, ModelCookMesh());
+
+	struct RangeTask
 	{
-		aiMaterial* aimaterial = asset->aiScene->mMaterials[m];
-		aiString diffuseName;
+		unsigned int mesh;
+		unsigned int begin;
+		unsigned int end;
+		AABB box;
+	};
 
-		if (AI_SUCCESS != aimaterial->GetTexture(aiTextureType_DIFFUSE, 0, &diffuseName))
+	std::vector<RangeTask> tasks;
+	std::vector<int> firstTask(meshCount + 1, 0); // tasks of mesh m : [firstTask[m], firstTask[m + 1])
+
+	for (unsigned int m = 0; m < meshCount; m++)
+	{
+		const unsigned int vertexCount = scene->mMeshes[m]->mNumVertices;
+
+		outImported[m].vertices.resize(vertexCount); // allocated here, filled by the ranges
+		firstTask[m] = static_cast<int>(tasks.size());
+
+		for (unsigned int begin = 0; begin < vertexCount; begin += CONVERT_VERTEX_CHUNK)
 		{
-			continue;
-		} // with no diffuse texture
+			RangeTask task;
+			task.mesh = m;
+			task.begin = begin;
+			task.end = std::min(begin + CONVERT_VERTEX_CHUNK, vertexCount);
+			tasks.push_back(task);
+		}
+	}
+	firstTask[meshCount] = static_cast<int>(tasks.size());
+
+	const int jobCount = std::max(static_cast<int>(tasks.size()), static_cast<int>(meshCount));
+
+	WorkerPool pool;
+	pool.Start(std::max(0, std::min(WorkerPool::DefaultWorkerCount(), jobCount - 1)));
 
-		if (asset->textures.count(diffuseName.C_Str()))
+	outTaskCount = static_cast<int>(tasks.size() + meshCount);
+	outThreadCount = pool.GetThreadCount();
+
+	pool.ParallelFor(static_cast<int>(tasks.size()), 1, [scene, &tasks, &outImported](int begin, int end)
+	{
+		for (int i = begin; i < end; ++i)
 		{
-			continue;
+			RangeTask& task = tasks[i];
+			task.box = ConvertVertexRange(scene->mMeshes[task.mesh], outImported[task.mesh].vertices.data(), task.begin, task.end);
 		}
+	});
 
-		std::string rawName = diffuseName.C_Str();
-		std::string fullKey = MakeTextureKey(directory, rawName);
+	pool.ParallelFor(static_cast<int>(meshCount), 1, [&](int begin, int end)
+	{
+		for (int m = begin; m < end; ++m)
+		{
+			const aiMesh* mesh = scene->mMeshes[m];
+			ModelCookMesh& out = outMeshes[m];
 
-		std::wstring wpath = Utf8ToWstring(fullKey);
+			out.skinned = (mesh->mNumBones > 0);
+			out.layout = out.skinned ? VertexLayout::Skinned : VertexLayout::Static;
+			out.materialIndex = mesh->mMaterialIndex;
 
-		ID3D11ShaderResourceView* texture = nullptr;
-		ID3D11Resource* resource = nullptr;
+			out.localAABB.min = { FLT_MAX, FLT_MAX, FLT_MAX };
+			out.localAABB.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			for (int t = firstTask[m]; t < firstTask[m + 1]; ++t)
+			{
+				MergeAABB(out.localAABB, tasks[t].box);
+			}
 
-		HRESULT hr = CreateWICTextureFromFile(
-			Direct3D_GetDevice(),
-			Direct3D_GetContext(),
-			wpath.c_str(),
-			&resource,
-			&texture
-		);
+			FinishMesh(mesh, boneNameToIndex, lod, outImported[m], out);
+		}
+	});
 
-		if (SUCCEEDED(hr) && texture)
+	pool.Stop();
+}
+
+// Attributes of [begin, end), returns the box of those vertices
+static AABB ConvertVertexRange(const aiMesh* mesh, Vertex3d* vertex, unsigned int begin, unsigned int end)
+{
+	for (unsigned int v = begin; v < end; v++)
+	{
+		vertex[v].position = XMFLOAT3{ mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z }; // position
+		vertex[v].normal   = XMFLOAT3{ mesh->mNormals[v].x,  mesh->mNormals[v].y,  mesh->mNormals[v].z };  // normal
+		vertex[v].color = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f); // vertex color
+
+		// Tangent
+		if (mesh->mTangents)
 		{
-			resource->Release();
+			vertex[v].tangent = XMFLOAT3{ mesh->mTangents[v].x, mesh->mTangents[v].y, mesh->mTangents[v].z };
+		}
+		else
+		{
+			vertex[v].tangent = { 1, 0, 0 };
+		}
+	}
+
+	// UV
+	AssignUVForMesh(vertex, mesh, begin, end);
 
-			RegisterTextureAlias(asset, texture, fullKey);
-			RegisterTextureAlias(asset, texture, rawName);
+	return ComputeLocalAABB(mesh, begin, end);
+}
+
+// Whole mesh part, after every range of the mesh is done
+static void FinishMesh(
+	const aiMesh* mesh,
+	const std::unordered_map<std::string, int>& boneNameToIndex,
+	const ModelLodSettings& lod,
+	ImportedMesh& imported,
+	ModelCookMesh& out)
+{
+	std::vector<Vertex3d>& vertices = imported.vertices;
+	std::vector<uint32_t>& outIndices = imported.indices;
+
+	// Skin weight
+	ApplySkinWeightToVertices(vertices.data(), mesh, boneNameToIndex);
+
+	// Index buffer
+	outIndices.resize(mesh->mNumFaces * 3);
+
+	for (unsigned int f = 0; f < mesh->mNumFaces; f++)
+	{
+		const aiFace* face = &mesh->mFaces[f];
+		assert(face->mNumIndices == 3);
+
+		outIndices[f * 3 + 0] = face->mIndices[0];
+		outIndices[f * 3 + 1] = face->mIndices[1];
+		outIndices[f * 3 + 2] = face->mIndices[2];
+	}
+
+	// Vertex cache -> overdraw -> vertex fetch order, measured on the packed stream 0
+	std::vector<uint32_t> remap;
+	MeshOptimize_Run(outIndices, vertices.empty() ? nullptr : &vertices[0].position, sizeof(Vertex3d), static_cast<uint32_t>(vertices.size()),
+		sizeof(VertexPacked), remap, &imported.optimizeReport);
+	MeshOptimize_RemapVertices(vertices, remap);
+
+	// Coarser index lists over the final vertex order
+	BuildLodChain(vertices, outIndices, out, lod, imported);
+
+	Vertex3d* vertex = vertices.data();
+
+	if (out.skinned)
+	{
+		ComputeBoneBounds(vertex, static_cast<unsigned int>(vertices.size()), imported.boneBounds);
+	}
+
+	// GPU streams, the skin stream only for the skinned layout
+	imported.packedVertices.resize(vertices.size());
+	if (out.layout == VertexLayout::Skinned)
+	{
+		imported.skinVertices.resize(vertices.size());
+	}
+
+	const uint32_t droppedInfluences = VertexPack_EncodeVertices(vertex, static_cast<uint32_t>(vertices.size()), imported.packedVertices.data(),
+		imported.skinVertices.empty() ? nullptr : imported.skinVertices.data());
+
+	if (droppedInfluences > 0)
+	{
+		char buf[256];
+		sprintf_s(buf, "[VertexPack] %s : %u influences on bones %u and above dropped (uint8 bone indices)\n",
+			mesh->mName.C_Str(), droppedInfluences, VERTEX_PACK_MAX_BONES);
+		OutputDebugStringA(buf);
+	}
+
+	out.vertices = vertices.data();
+	out.packedVertices = imported.packedVertices.data();
+	out.skinVertices = imported.skinVertices.empty() ? nullptr : imported.skinVertices.data();
+	out.vertexCount = static_cast<uint32_t>(vertices.size());
+	out.indices = outIndices.data();
+	out.indexCount = static_cast<uint32_t>(outIndices.size());
+	out.boneBounds = imported.boneBounds.data();
+	out.boneBoundsCount = static_cast<uint32_t>(imported.boneBounds.size());
+	out.lods = imported.lods.data();
+	out.lodCount = static_cast<uint32_t>(imported.lods.size());
+	out.lodIndices = imported.lodIndices.data();
+	out.lodIndexCount = static_cast<uint32_t>(imported.lodIndices.size());
+}
+
+// Every level is simplified from the full mesh toward ratio^level of its triangles, seams / borders / skin kept
+// Stops at levelCount, below minTriangles, or when the error bound leaves too little to remove
+static void BuildLodChain(const std::vector<Vertex3d>& vertices, const std::vector<uint32_t>& indices, const ModelCookMesh& mesh, const ModelLodSettings& lod, ImportedMesh& imported)
+{
+	imported.lods.clear();
+	imported.lodIndices.clear();
+
+	const size_t triangleCount = indices.size() / 3;
+	if (vertices.empty() || triangleCount < lod.minTriangles) return;
+
+	const XMVECTOR extent = XMVectorSubtract(XMLoadFloat3(&mesh.localAABB.max), XMLoadFloat3(&mesh.localAABB.min));
+	const float maxError = lod.maxError * XMVectorGetX(XMVector3Length(extent));
+
+	MeshSimplifyVertices source;
+	source.positions = &vertices[0].position;
+	source.positionStride = sizeof(Vertex3d);
+	source.normals = &vertices[0].normal;
+	source.normalStride = sizeof(Vertex3d);
+	source.texcoords = &vertices[0].texcoord;
+	source.texcoordStride = sizeof(Vertex3d);
+	if (mesh.skinned)
+	{
+		source.boneIndices = vertices[0].boneIndex;
+		source.boneWeights = vertices[0].boneWeight;
+		source.skinStride = sizeof(Vertex3d);
+	}
+	source.vertexCount = static_cast<uint32_t>(vertices.size());
+
+	std::vector<uint32_t> levelIndices;
+	size_t previousCount = indices.size();
+	float previousError = 0.0f;
+	float ratio = 1.0f;
+
+	for (uint32_t level = 1; level < lod.levelCount; ++level)
+	{
+		ratio *= lod.ratio;
+		const size_t target = static_cast<size_t>(triangleCount * ratio) * 3;
+
+		float error = 0.0f;
+		MeshSimplify_Run(indices.data(), indices.size(), source, target, maxError, levelIndices, error);
+
+		if (levelIndices.empty() || levelIndices.size() > previousCount * LOD_MIN_REDUCTION) break;
+
+		MeshOptimize_VertexCache(levelIndices.data(), levelIndices.size(), source.vertexCount);
+
+		MeshLod out;
+		out.startIndex = static_cast<uint32_t>(imported.lodIndices.size());
+		out.indexCount = static_cast<uint32_t>(levelIndices.size());
+		out.error = std::max(error, previousError); // never finer than the level before
+		imported.lods.push_back(out);
+		imported.lodIndices.insert(imported.lodIndices.end(), levelIndices.begin(), levelIndices.end());
+
+		previousCount = levelIndices.size();
+		previousError = out.error;
+
+		if (levelIndices.size() / 3 < lod.minTriangles) break;
+	}
+}
+
+// Every mesh suballocated from shared immutable buffers
+// Skinned meshes take the first vertices, so the skin stream lines up with stream 0 for the same base vertex
+static void CreateAssetBuffers(ModelAsset* asset, const std::vector<ModelCookMesh>& meshes)
+{
+	asset->meshes.resize(meshes.size());
+
+	uint32_t vertexTotal = 0;
+	uint32_t skinnedTotal = 0;
+	uint32_t index16Total = 0;
+	uint32_t index32Total = 0;
+
+	for (int pass = 0; pass < 2; ++pass) // 0 : skinned layout, 1 : static layout
+	{
+		for (size_t m = 0; m < meshes.size(); ++m)
+		{
+			const ModelCookMesh& src = meshes[m];
+			if ((src.layout == VertexLayout::Skinned) != (pass == 0)) continue;
+
+			MeshAsset& out = asset->meshes[m];
+			out.baseVertex = vertexTotal;
+			vertexTotal += src.vertexCount;
+			if (pass == 0) skinnedTotal += src.vertexCount;
 		}
 	}
 
-	// NORMAL MAP
-	for (unsigned int m = 0; m < asset->aiScene->mNumMaterials; ++m)
+	for (size_t m = 0; m < meshes.size(); ++m)
 	{
-		aiMaterial* aimaterial = asset->aiScene->mMaterials[m];
-		aiString normalName;
+		const ModelCookMesh& src = meshes[m];
+		MeshAsset& out = asset->meshes[m];
 
-		if (AI_SUCCESS != aimaterial->GetTexture(aiTextureType_NORMALS, 0, &normalName))
+		out.skinned = src.skinned;
+		out.layout = src.layout;
+		out.materialIndex = src.materialIndex;
+		out.localAABB = src.localAABB;
+		out.vertexCount = src.vertexCount;
+		out.indexCount = src.indexCount;
+
+		// Indices stay local to the mesh (base vertex added by DrawIndexed), LOD indices right after the full mesh
+		const uint32_t meshIndexCount = src.indexCount + src.lodIndexCount;
+		if (src.vertexCount <= MAX_INDEX16_VERTICES)
 		{
-			if (AI_SUCCESS != aimaterial->GetTexture(aiTextureType_HEIGHT, 0, &normalName))
-			{
-				continue;
-			}
-		} // with no normal map
+			out.indexSize = sizeof(uint16_t);
+			out.startIndex = index16Total;
+			index16Total += meshIndexCount;
+		}
+		else
+		{
+			out.indexSize = sizeof(uint32_t);
+			out.startIndex = index32Total;
+			index32Total += meshIndexCount;
+		}
 
-		if (asset->textures.count(normalName.C_Str()))
+		out.lods.resize(1 + src.lodCount);
+		out.lods[0].startIndex = out.startIndex;
+		out.lods[0].indexCount = src.indexCount;
+		out.lods[0].error = 0.0f;
+		for (uint32_t l = 0; l < src.lodCount; ++l)
 		{
-			continue;
+			out.lods[1 + l] = src.lods[l];
+			out.lods[1 + l].startIndex += out.startIndex + src.indexCount;
 		}
 
-		std::string rawName = normalName.C_Str();
-		std::string fullKey = MakeTextureKey(directory, rawName);
+		if (out.skinned && src.vertices)
+		{
+			out.cpuVertices.assign(src.vertices, src.vertices + src.vertexCount);
+			out.boneBounds.assign(src.boneBounds, src.boneBounds + src.boneBoundsCount);
+		}
+	}
 
-		std::wstring wpath = Utf8ToWstring(fullKey);
+	// 32 bit part after the 16 bit part, 4 byte aligned
+	const uint32_t index32Offset = (index16Total * sizeof(uint16_t) + 3u) & ~3u;
 
-		ID3D11ShaderResourceView* texture = nullptr;
-		ID3D11Resource* resource = nullptr;
+	std::vector<VertexPacked> vertices(vertexTotal);
+	std::vector<VertexSkinPacked> skin(skinnedTotal);
+	std::vector<uint8_t> indices(index32Offset + index32Total * sizeof(uint32_t), 0);
 
-		HRESULT hr = CreateWICTextureFromFile(
-			Direct3D_GetDevice(),
-			Direct3D_GetContext(),
-			wpath.c_str(),
-			&resource,
-			&texture
-		);
+	for (size_t m = 0; m < meshes.size(); ++m)
+	{
+		const ModelCookMesh& src = meshes[m];
+		MeshAsset& out = asset->meshes[m];
 
-		if (SUCCEEDED(hr) && texture)
+		if (src.vertexCount > 0)
 		{
-			resource->Release();
+			memcpy(&vertices[out.baseVertex], src.packedVertices, sizeof(VertexPacked) * src.vertexCount);
 
-			RegisterTextureAlias(asset, texture, fullKey);
-			RegisterTextureAlias(asset, texture, rawName);
+			if (out.layout == VertexLayout::Skinned)
+			{
+				memcpy(&skin[out.baseVertex], src.skinVertices, sizeof(VertexSkinPacked) * src.vertexCount);
+			}
 		}
+
+		out.indexBufferOffset = (out.indexSize == sizeof(uint16_t)) ? 0 : index32Offset;
+
+		auto writeIndices = [&indices, &out](const uint32_t* data, uint32_t count, uint32_t start)
+		{
+			if (out.indexSize == sizeof(uint16_t))
+			{
+				uint16_t* dst = reinterpret_cast<uint16_t*>(indices.data()) + start;
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					dst[i] = static_cast<uint16_t>(data[i]);
+				}
+			}
+			else if (count > 0)
+			{
+				memcpy(indices.data() + out.indexBufferOffset + start * sizeof(uint32_t), data, sizeof(uint32_t) * count);
+			}
+		};
+
+		writeIndices(src.indices, src.indexCount, out.startIndex);
+		writeIndices(src.lodIndices, src.lodIndexCount, out.startIndex + src.indexCount);
 	}
 
-	// SPECULAR MAP
-	for (unsigned int m = 0; m < asset->aiScene->mNumMaterials; ++m)
+	asset->vertexBuffer = CreateImmutableBuffer(vertices.data(), vertices.size() * sizeof(VertexPacked), D3D11_BIND_VERTEX_BUFFER);
+	asset->skinBuffer = CreateImmutableBuffer(skin.data(), skin.size() * sizeof(VertexSkinPacked), D3D11_BIND_VERTEX_BUFFER);
+	asset->indexBuffer = CreateImmutableBuffer(indices.data(), indices.size(), D3D11_BIND_INDEX_BUFFER);
+}
+
+// nullptr for an empty range (an asset without skinned meshes has no skin buffer)
+static ID3D11Buffer* CreateImmutableBuffer(const void* data, size_t bytes, UINT bindFlags)
+{
+	if (bytes == 0) return nullptr;
+
+	D3D11_BUFFER_DESC bd;
+	ZeroMemory(&bd, sizeof(bd));
+	bd.Usage = D3D11_USAGE_IMMUTABLE;
+	bd.ByteWidth = static_cast<UINT>(bytes);
+	bd.BindFlags = bindFlags;
+	bd.CPUAccessFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA sd;
+	ZeroMemory(&sd, sizeof(sd));
+	sd.pSysMem = data;
+
+	ID3D11Buffer* buffer = nullptr;
+	Direct3D_GetDevice()->CreateBuffer(&bd, &sd, &buffer);
+	return buffer;
+}
+
+// GPU vertex bytes of the packed layouts against Vertex3d, index bytes against 32 bit indices
+static void ReportVertexMemory(const char* filename, const ModelAsset* asset)
+{
+	uint64_t vertexCount = 0;
+	uint64_t skinnedCount = 0;
+	uint64_t fullBytes = 0;
+	uint64_t packedBytes = 0;
+
+	int index16Meshes = 0;
+	uint64_t index32Bytes = 0;
+	uint64_t indexBytes = 0;
+
+	for (const MeshAsset& mesh : asset->meshes)
 	{
-		aiMaterial* aimaterial = asset->aiScene->mMaterials[m];
-		aiString specNAME;
+		vertexCount += mesh.vertexCount;
+		if (mesh.layout == VertexLayout::Skinned) skinnedCount += mesh.vertexCount;
+
+		fullBytes += static_cast<uint64_t>(mesh.vertexCount) * sizeof(Vertex3d);
+		packedBytes += static_cast<uint64_t>(mesh.vertexCount) * VertexPack_GetVertexBytes(mesh.layout);
+
+		const bool index16 = (mesh.indexSize == sizeof(uint16_t));
+		if (index16) ++index16Meshes;
+		index32Bytes += static_cast<uint64_t>(mesh.indexCount) * sizeof(uint32_t);
+		indexBytes += static_cast<uint64_t>(mesh.indexCount) * (index16 ? sizeof(uint16_t) : sizeof(uint32_t));
+	}
 
-		if (AI_SUCCESS != aimaterial->GetTexture(aiTextureType_SPECULAR, 0, &specNAME))
+	char buf[512];
+	sprintf_s(buf, "[VertexPack] %s : %llu vertices (%llu skinned), Vertex3d %.1f KB -> packed %.1f KB, saved %.1f KB (%.2fx)\n",
+		filename,
+		static_cast<unsigned long long>(vertexCount),
+		static_cast<unsigned long long>(skinnedCount),
+		fullBytes / 1024.0,
+		packedBytes / 1024.0,
+		(fullBytes - packedBytes) / 1024.0,
+		packedBytes > 0 ? static_cast<double>(fullBytes) / static_cast<double>(packedBytes) : 1.0);
+	OutputDebugStringA(buf);
+
+	sprintf_s(buf, "[IndexPack] %s : %d of %d meshes 16 bit, indices %.1f KB -> %.1f KB\n",
+		filename,
+		index16Meshes,
+		static_cast<int>(asset->meshes.size()),
+		index32Bytes / 1024.0,
+		indexBytes / 1024.0);
+	OutputDebugStringA(buf);
+}
+
+// Simulated post-transform cache (ACMR / ATVR) and vertex fetch before and after every reorder stage
+static void ReportMeshOptimize(const char* filename, const std::vector<ImportedMesh>& imported)
+{
+	if (imported.empty()) return;
+
+	MeshOptimizeReport total;
+	for (const ImportedMesh& mesh : imported)
+	{
+		MeshOptimize_MergeReport(total, mesh.optimizeReport);
+	}
+
+	char buf[512];
+	for (int s = 0; s < static_cast<int>(MeshOptimizeStage::Count); ++s)
+	{
+		const VertexCacheStats& cache = total.cache[s];
+		const VertexFetchStats& fetch = total.fetch[s];
+
+		sprintf_s(buf, "[MeshOptimize] %s : %-12s ACMR %.3f / ATVR %.3f / overfetch %.2f (%u triangles)\n",
+			filename, MeshOptimize_GetStageName(static_cast<MeshOptimizeStage>(s)), cache.acmr, cache.atvr, fetch.overfetch, cache.triangleCount);
+		OutputDebugStringA(buf);
+	}
+}
+
+// Triangles and object space error of every level, for each mesh with a LOD chain
+static void ReportMeshLod(const char* filename, const ModelAsset* asset)
+{
+	char buf[512];
+	uint64_t lodTriangles = 0;
+
+	for (size_t m = 0; m < asset->meshes.size(); ++m)
+	{
+		const std::vector<MeshLod>& lods = asset->meshes[m].lods;
+		if (lods.size() < 2) continue;
+
+		int length = sprintf_s(buf, "[MeshLod] %s : mesh %d", filename, static_cast<int>(m));
+		for (size_t l = 0; l < lods.size() && length > 0; ++l)
 		{
-			continue;
-		} // with no specular map
+			length += sprintf_s(buf + length, sizeof(buf) - length, "%s LOD%d %u (%.4f)",
+				l == 0 ? "" : " /", static_cast<int>(l), lods[l].indexCount / 3, lods[l].error);
+			if (l > 0) lodTriangles += lods[l].indexCount / 3;
+		}
+		OutputDebugStringA(buf);
+		OutputDebugStringA("\n");
+	}
+
+	sprintf_s(buf, "[MeshLod] %s : %llu LOD triangles in the shared index buffer\n", filename, static_cast<unsigned long long>(lodTriangles));
+	OutputDebugStringA(buf);
+}
 
-		if (asset->textures.count(specNAME.C_Str()))
+// aiMaterial -> what Default3DMaterial takes (import path only)
+static void ReadMaterials(const aiScene* scene, std::vector<ModelCookMaterial>& outMaterials)
+{
+	outMaterials.assign(scene->mNumMaterials, ModelCookMaterial());
+
+	for (unsigned int i = 0; i < scene->mNumMaterials; ++i)
+	{
+		const aiMaterial* aimat = scene->mMaterials[i];
+		ModelCookMaterial& mat = outMaterials[i];
+
+		aiString aiName;
+
+		// Set material name
+		if (AI_SUCCESS == aimat->Get(AI_MATKEY_NAME, aiName) && aiName.length > 0)
 		{
-			continue;
+			mat.name = aiName.C_Str();
+		}
+		else
+		{
+			char buf[64];
+			sprintf_s(buf, "Material %u", i);
+			mat.name = buf;
 		}
 
-		std::string rawName = specNAME.C_Str();
-		std::string fullKey = MakeTextureKey(directory, rawName);
+		// Diffuse color
+		aiColor3D diffuse(1.0f, 1.0f, 1.0f);
+		if (AI_SUCCESS == aimat->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse))
+		{
+			mat.hasBaseColor = true;
+			mat.baseColor = { diffuse.r, diffuse.g, diffuse.b };
+		}
 
-		std::wstring wpath = Utf8ToWstring(fullKey);
+		// Specular color
+		aiColor3D specular(1.0f, 1.0f, 1.0f);
+		if (AI_SUCCESS == aimat->Get(AI_MATKEY_COLOR_SPECULAR, specular))
+		{
+			mat.hasSpecularColor = true;
+			mat.specularColor = { specular.r, specular.g, specular.b };
+		}
 
-		ID3D11ShaderResourceView* texture = nullptr;
-		ID3D11Resource* resource = nullptr;
+		// Shininess -> SpecularPower
+		float shininess = 0.0f;
+		if (AI_SUCCESS == aimat->Get(AI_MATKEY_SHININESS, shininess))
+		{
+			mat.shininess = shininess;
+		}
 
-		HRESULT hr = CreateWICTextureFromFile(
-			Direct3D_GetDevice(),
-			Direct3D_GetContext(),
-			wpath.c_str(),
-			&resource,
-			&texture
-		);
+		// Texture names as the file stores them
+		aiString name;
+		if (AI_SUCCESS == aimat->GetTexture(aiTextureType_DIFFUSE, 0, &name))
+		{
+			mat.diffuseMap = name.C_Str();
+		}
 
-		if (SUCCEEDED(hr) && texture)
+		// Normal map (NORMALS or HEIGHT)
+		if (AI_SUCCESS == aimat->GetTexture(aiTextureType_NORMALS, 0, &name) ||
+			AI_SUCCESS == aimat->GetTexture(aiTextureType_HEIGHT, 0, &name))
 		{
-			resource->Release();
+			mat.normalMap = name.C_Str();
+		}
+
+		if (AI_SUCCESS == aimat->GetTexture(aiTextureType_SPECULAR, 0, &name))
+		{
+			mat.specularMap = name.C_Str();
+		}
+	}
+}
+
+// Embedded textures, bytes stay owned by the scene (import path only)
+static void ReadEmbeddedTextures(const aiScene* scene, std::vector<ModelCookTexture>& outTextures)
+{
+	outTextures.assign(scene->mNumTextures, ModelCookTexture());
+
+	for (unsigned int i = 0; i < scene->mNumTextures; ++i)
+	{
+		const aiTexture* aitexture = scene->mTextures[i];
+		if (!aitexture) continue;
+
+		ModelCookTexture& tex = outTextures[i];
+		tex.name = aitexture->mFilename.C_Str();
+		tex.data = reinterpret_cast<const uint8_t*>(aitexture->pcData);
+		tex.bytes = (aitexture->mHeight == 0)
+			? static_cast<uint64_t>(aitexture->mWidth)
+			: static_cast<uint64_t>(aitexture->mWidth) * static_cast<uint64_t>(aitexture->mHeight) * 4;
+	}
+}
+
+static void BuildMaterials(ModelAsset* asset, const std::vector<ModelCookMaterial>& materials, const std::string& directory)
+{
+	if (materials.empty()) return;
+
+	asset->materials.resize(materials.size(), nullptr);
+
+	for (size_t i = 0; i < materials.size(); ++i)
+	{
+		const ModelCookMaterial& src = materials[i];
+		Default3DMaterial* mat = new Default3DMaterial();
+
+		mat->SetName(src.name);
+
+		if (src.hasBaseColor)
+		{
+			mat->SetBaseColor({ src.baseColor.x, src.baseColor.y, src.baseColor.z, 1.0f });
+		}
+
+		if (src.hasSpecularColor)
+		{
+			mat->SetSpecularColor({ src.specularColor.x, src.specularColor.y, src.specularColor.z, 1.0f });
+		}
+
+		if (src.shininess > 0.0f)
+		{
+			mat->SetSpecularPower(src.shininess);
+		}
+
+		if (!src.diffuseMap.empty())
+		{
+			mat->SetDiffuseMapPath(MakeTextureKey(directory, src.diffuseMap));
+		}
+
+		if (!src.normalMap.empty())
+		{
+			mat->SetNormalMapPath(MakeTextureKey(directory, src.normalMap));
+		}
 
-			RegisterTextureAlias(asset, texture, fullKey);
-			RegisterTextureAlias(asset, texture, rawName);
+		if (!src.specularMap.empty())
+		{
+			mat->SetSpecularMapPath(MakeTextureKey(directory, src.specularMap));
 		}
+
+		asset->materials[i] = mat;
+		Default3DMaterial_Register(mat);
 	}
 }
 
@@ -629,12 +1182,12 @@ static void ApplySkinWeightToVertices(Vertex3d* vertices, const aiMesh* mesh, co
 	}
 }
 
-static AABB ComputeLocalAABB(const aiMesh* mesh)
+static AABB ComputeLocalAABB(const aiMesh* mesh, unsigned int begin, unsigned int end)
 {
 	XMFLOAT3 min = { FLT_MAX,  FLT_MAX,  FLT_MAX };
 	XMFLOAT3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
 
-	for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+	for (unsigned int v = begin; v < end; v++)
 	{
 		const aiVector3D& p = mesh->mVertices[v];
 
@@ -649,3 +1202,73 @@ static AABB ComputeLocalAABB(const aiMesh* mesh)
 
 	return { min, max };
 }
+
+static void MergeAABB(AABB& ioBox, const AABB& box)
+{
+	ioBox.min.x = std::min(ioBox.min.x, box.min.x);
+	ioBox.min.y = std::min(ioBox.min.y, box.min.y);
+	ioBox.min.z = std::min(ioBox.min.z, box.min.z);
+	ioBox.max.x = std::max(ioBox.max.x, box.max.x);
+	ioBox.max.y = std::max(ioBox.max.y, box.max.y);
+	ioBox.max.z = std::max(ioBox.max.z, box.max.z);
+}
+
+// Per bone box of the vertices it moves with more than BONE_BOUNDS_MIN_WEIGHT
+// The strongest influence always counts, so every vertex lands in at least one box
+static void ComputeBoneBounds(const Vertex3d* vertices, unsigned int vertexCount, std::vector<BoneBounds>& outBounds)
+{
+	outBounds.clear();
+
+	// slot per bone index, MAX_BONES : vertices without weights
+	std::vector<int> slotOfBone(MAX_BONES + 1, -1);
+
+	auto grow = [&outBounds, &slotOfBone](int bone, const XMFLOAT3& p)
+	{
+		const int key = (bone < 0) ? MAX_BONES : bone;
+
+		if (slotOfBone[key] < 0)
+		{
+			slotOfBone[key] = static_cast<int>(outBounds.size());
+
+			BoneBounds bb;
+			bb.bone = bone;
+			bb.box = { p, p };
+			outBounds.push_back(bb);
+			return;
+		}
+
+		AABB& box = outBounds[slotOfBone[key]].box;
+		box.min.x = std::min(box.min.x, p.x);
+		box.min.y = std::min(box.min.y, p.y);
+		box.min.z = std::min(box.min.z, p.z);
+		box.max.x = std::max(box.max.x, p.x);
+		box.max.y = std::max(box.max.y, p.y);
+		box.max.z = std::max(box.max.z, p.z);
+	};
+
+	for (unsigned int v = 0; v < vertexCount; ++v)
+	{
+		const Vertex3d& vtx = vertices[v];
+
+		int strongest = -1;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (vtx.boneWeight[i] <= 0.0f) continue;
+			if (strongest < 0 || vtx.boneWeight[i] > vtx.boneWeight[strongest]) strongest = i;
+		}
+
+		if (strongest < 0)
+		{
+			grow(-1, vtx.position);
+			continue;
+		}
+
+		for (int i = 0; i < 4; ++i)
+		{
+			if (i == strongest || vtx.boneWeight[i] > BONE_BOUNDS_MIN_WEIGHT)
+			{
+				grow(static_cast<int>(vtx.boneIndex[i]), vtx.position);
+			}
+		}
+	}
+}
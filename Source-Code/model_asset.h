@@ -10,48 +10,68 @@
 #ifndef MODEL_ASSET_H
 #define MODEL_ASSET_H
 
-// --------------------
-// Assimp lib
-// --------------------
-#include "assimp/cimport.h"
-#include "assimp/scene.h"
-#include "assimp/postprocess.h"
-#include "assimp/matrix4x4.h"
-#include "assimp/config.h"
-#pragma comment (lib, "assimp-vc143-mt.lib")
-
 #include <vector>
 #include <unordered_map>
 #include <string>
-#include <d3d11.h>
 #include <DirectXMath.h>
 
-#include "collision.h"
+#include "aabb.h"
+#include "model_vertex.h"
+#include "skeleton_runtime.h"
+#include "vertex_pack_util.h"
 
+// No assimp / D3D header here: the animation runtime and the headless tools use
+// ModelAsset without them (model_asset.cpp imports, model_renderer.cpp draws)
+struct aiScene;
+struct ID3D11Buffer;
+struct ID3D11ShaderResourceView;
 class Default3DMaterial;
 
-struct Vertex3d
+// Index-only level of detail, drawn over the same vertices as the full mesh
+struct MeshLod
+{
+	uint32_t startIndex = 0; // same part of the index buffer as MeshAsset::startIndex
+	uint32_t indexCount = 0;
+	float error = 0.0f;      // object space distance the surface moved (0 : full mesh)
+};
+
+// LOD chain built at import (mesh_simplify_util.h), part of the cooked file's import settings
+struct ModelLodSettings
 {
-	DirectX::XMFLOAT3 position; // _W
-	DirectX::XMFLOAT3 normal;   // @
-	DirectX::XMFLOAT3 tangent;  // ؐ
-	DirectX::XMFLOAT4 color;    // F
-	DirectX::XMFLOAT2 texcoord; // UV
-
-	UINT  boneIndex[4]; // e{[̃CfbNX
-	float boneWeight[4];// e{[̃EFCg
+	uint32_t levelCount = 4;    // including the full mesh, 1 : no LODs
+	float ratio = 0.5f;         // triangles of level n against the full mesh : ratio^n
+	float maxError = 0.02f;     // largest collapse error, relative to the mesh AABB diagonal
+	uint32_t minTriangles = 64; // meshes / levels smaller than this get no further level
 };
 
 // aiMeshƂɊǗĂ
 struct MeshAsset
 {
-	ID3D11Buffer* vertexBuffer = nullptr;
-	ID3D11Buffer* indexBuffer = nullptr;
+	// Range in the asset's shared buffers (ModelAsset::vertexBuffer / indexBuffer)
+	uint32_t baseVertex = 0;
+	uint32_t vertexCount = 0;
+	uint32_t startIndex = 0;       // in indexSize units from indexBufferOffset
 	uint32_t indexCount = 0;
+	uint32_t indexBufferOffset = 0; // bytes, start of the 16 / 32 bit part
+	uint32_t indexSize = 2;         // bytes per index, 2 when the mesh has 65535 vertices or less
+
 	uint32_t materialIndex = 0;
 
 	bool skinned = false;
+	VertexLayout layout = VertexLayout::Static; // chosen at import (vertex_pack_util.h)
 	AABB localAABB{};
+
+	std::vector<MeshLod> lods; // lods[0] : the full mesh, then coarser levels with growing error
+
+	std::vector<Vertex3d> cpuVertices; // skinned meshes only, input of CPU skinning (animation_skinning.h)
+	std::vector<BoneBounds> boneBounds; // skinned meshes only, posed AABB without skinning vertices
+};
+
+// Vertex shader / palette the asset is drawn with
+enum class SkinningMethod
+{
+	LinearBlend,    // skin matrices, shader_vertex_3d_skinned.hlsl
+	DualQuaternion, // SkinDualQuat, shader_vertex_3d_skinned_dq.hlsl (no scale in the skin matrices)
 };
 
 // fbxt@CƂɊǗĂ
@@ -60,22 +80,35 @@ struct ModelAsset
 	// Import settings
 	float importScale = 1.0f;
 	bool sourceYup = true;
+	ModelLodSettings lodSettings;
 
 	DirectX::XMMATRIX importFix = DirectX::XMMatrixIdentity();
 
 	// Assimp assets
-	const aiScene* aiScene = nullptr;
+	const struct aiScene* aiScene = nullptr; // elaborated: the member has the type's name
+	bool cookedScene = false; // aiScene is a ModelCook shell (ModelCook_ReleaseSceneShell), not aiImportFile's
 
 	// GPU resources and materials
+	// One immutable buffer per stream for every mesh, bound once per asset
+	//  vertexBuffer : VertexPacked, skinned meshes first
+	//  skinBuffer   : VertexSkinPacked of the skinned meshes (same base vertex as stream 0)
+	//  indexBuffer  : 16 bit indices, then 32 bit indices (MeshAsset::indexBufferOffset)
+	ID3D11Buffer* vertexBuffer = nullptr;
+	ID3D11Buffer* skinBuffer = nullptr;
+	ID3D11Buffer* indexBuffer = nullptr;
+
 	std::vector<MeshAsset> meshes;
 	std::unordered_map<std::string, ID3D11ShaderResourceView*> textures;
 	std::vector<Default3DMaterial*> materials;
 
 	// Bones
 	std::unordered_map<std::string, int> boneNameToIndex;
+	SkeletonRuntime skeleton; // flat node/bone tables for animation
+
+	SkinningMethod skinning = SkinningMethod::LinearBlend;
 };
 
-ModelAsset* ModelAsset_Load(const char* filename, bool yUp = false, float scale = 1.0f);
+ModelAsset* ModelAsset_Load(const char* filename, bool yUp = false, float scale = 1.0f, const ModelLodSettings& lod = ModelLodSettings());
 void        ModelAsset_Release(ModelAsset* asset);
 
 #endif // MODEL_ASSET_H
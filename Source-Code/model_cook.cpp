@@ -0,0 +1,674 @@
+/*==============================================================================
+
+   Cooked model file [model_cook.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "model_cook.h"
+#include "model_asset.h"
+#include "model_cook_format.h"
+#include "assimp/scene.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+static_assert(sizeof(Vertex3d) == 92, "Vertex3d is written as is");
+static_assert(sizeof(VertexPacked) == MESH_FILE_PACKED_VERTEX_SIZE, "VertexPacked is written as is");
+static_assert(sizeof(BoneBounds) == 28, "BoneBounds is written as is");
+static_assert(sizeof(MeshLod) == sizeof(MeshFileLod), "MeshLod is written as is");
+static_assert(sizeof(aiMatrix4x4) == 16 * sizeof(float), "aiMatrix4x4 is written as is");
+
+static void FlattenNodeRecursive(const aiNode* node, int parent, std::vector<const aiNode*>& outNodes, std::vector<int>& outParent);
+static aiScene* BuildSceneShell(
+	const uint8_t* base,
+	const MeshFileHeader& header,
+	const MeshFileMesh* fileMeshes,
+	const MeshFileBone* fileBones,
+	const MeshFileNode* fileNodes,
+	const uint32_t* nodeMeshes
+);
+static void ReleaseNodeRecursive(aiNode* node);
+static std::string ReadString(const uint8_t* base, uint32_t offset, uint32_t length);
+static uint64_t AlignUp8(uint64_t v);
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t fileSize);
+
+
+ModelCookData::~ModelCookData()
+{
+	// Scene shell built here, never handed to the asset
+	ModelCook_ReleaseSceneShell(scene);
+}
+
+std::string ModelCook_GetCookedPath(const char* sourcePath)
+{
+	std::string path = sourcePath ? sourcePath : "";
+
+	const size_t dot = path.find_last_of('.');
+	const size_t slash = path.find_last_of("/\\");
+
+	if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+	{
+		path.erase(dot);
+	}
+
+	return path + ".meshcache";
+}
+
+bool ModelCook_Load(const char* cookedPath, uint64_t sourceHash, bool checkHash, bool yUp, float scale, const ModelLodSettings& lod, ModelCookData& out)
+{
+	if (!out.file.Open(cookedPath)) return false;
+
+	const uint8_t* base = out.file.Data();
+	const uint64_t size = out.file.Size();
+
+	if (size < sizeof(MeshFileHeader)) return false;
+
+	const MeshFileHeader& header = *reinterpret_cast<const MeshFileHeader*>(base);
+
+	if (header.magic != MESH_FILE_MAGIC || header.version != MESH_FILE_VERSION) return false;
+	if (header.fileSize != size) return false;
+	if (checkHash && header.sourceHash != sourceHash) return false; // stale
+	if ((header.yUp != 0) != yUp || header.importScale != scale) return false; // cooked for other import settings
+	if (header.lodLevelCount != lod.levelCount || header.lodRatio != lod.ratio ||
+		header.lodMaxError != lod.maxError || header.lodMinTriangles != lod.minTriangles)
+	{
+		return false; // cooked with another LOD chain
+	}
+
+	const uint64_t meshesOffset = sizeof(MeshFileHeader);
+	if (!InFile(meshesOffset, static_cast<uint64_t>(header.meshCount) * sizeof(MeshFileMesh), size) ||
+		!InFile(header.bonesOffset, static_cast<uint64_t>(header.boneCount) * sizeof(MeshFileBone), size) ||
+		!InFile(header.nodesOffset, static_cast<uint64_t>(header.nodeCount) * sizeof(MeshFileNode), size) ||
+		!InFile(header.nodeMeshesOffset, static_cast<uint64_t>(header.nodeMeshCount) * sizeof(uint32_t), size) ||
+		!InFile(header.materialsOffset, static_cast<uint64_t>(header.materialCount) * sizeof(MeshFileMaterial), size) ||
+		!InFile(header.texturesOffset, static_cast<uint64_t>(header.textureCount) * sizeof(MeshFileTexture), size))
+	{
+		return false;
+	}
+
+	if (header.nodeCount == 0) return false;
+
+	const MeshFileMesh* fileMeshes = reinterpret_cast<const MeshFileMesh*>(base + meshesOffset);
+	const MeshFileBone* fileBones = reinterpret_cast<const MeshFileBone*>(base + header.bonesOffset);
+	const MeshFileNode* fileNodes = reinterpret_cast<const MeshFileNode*>(base + header.nodesOffset);
+	const uint32_t* nodeMeshes = reinterpret_cast<const uint32_t*>(base + header.nodeMeshesOffset);
+	const MeshFileMaterial* fileMaterials = reinterpret_cast<const MeshFileMaterial*>(base + header.materialsOffset);
+	const MeshFileTexture* fileTextures = reinterpret_cast<const MeshFileTexture*>(base + header.texturesOffset);
+
+	// Range checks only, the streams are handed over without touching them
+	for (uint32_t i = 0; i < header.meshCount; ++i)
+	{
+		const MeshFileMesh& fm = fileMeshes[i];
+		const uint64_t skinnedCount = (fm.layout == static_cast<uint32_t>(VertexLayout::Skinned)) ? fm.vertexCount : 0;
+		if (fm.layout > static_cast<uint32_t>(VertexLayout::Skinned) ||
+			!InFile(fm.nameOffset, fm.nameLength, size) ||
+			!InFile(fm.packedOffset, static_cast<uint64_t>(fm.vertexCount) * sizeof(VertexPacked), size) ||
+			!InFile(fm.skinOffset, skinnedCount * sizeof(VertexSkinPacked), size) ||
+			!InFile(fm.vertexOffset, skinnedCount * sizeof(Vertex3d), size) ||
+			!InFile(fm.indexOffset, static_cast<uint64_t>(fm.indexCount) * sizeof(uint32_t), size) ||
+			!InFile(fm.boneBoundsOffset, static_cast<uint64_t>(fm.boneBoundsCount) * sizeof(BoneBounds), size) ||
+			!InFile(fm.lodOffset, static_cast<uint64_t>(fm.lodCount) * sizeof(MeshLod), size) ||
+			!InFile(fm.lodIndexOffset, static_cast<uint64_t>(fm.lodIndexCount) * sizeof(uint32_t), size) ||
+			fm.boneFirst > header.boneCount || fm.boneCount > header.boneCount - fm.boneFirst)
+		{
+			return false;
+		}
+
+		const MeshLod* lods = reinterpret_cast<const MeshLod*>(base + fm.lodOffset);
+		for (uint32_t l = 0; l < fm.lodCount; ++l)
+		{
+			if (lods[l].startIndex > fm.lodIndexCount || lods[l].indexCount > fm.lodIndexCount - lods[l].startIndex) return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header.boneCount; ++i)
+	{
+		if (!InFile(fileBones[i].nameOffset, fileBones[i].nameLength, size)) return false;
+	}
+
+	for (uint32_t i = 0; i < header.nodeCount; ++i)
+	{
+		const MeshFileNode& fn = fileNodes[i];
+		if (!InFile(fn.nameOffset, fn.nameLength, size) ||
+			fn.parent >= static_cast<int32_t>(i) || (i > 0 && fn.parent < 0) ||
+			fn.meshFirst > header.nodeMeshCount || fn.meshCount > header.nodeMeshCount - fn.meshFirst)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header.nodeMeshCount; ++i)
+	{
+		if (nodeMeshes[i] >= header.meshCount) return false;
+	}
+
+	for (uint32_t i = 0; i < header.materialCount; ++i)
+	{
+		const MeshFileMaterial& fm = fileMaterials[i];
+		if (!InFile(fm.nameOffset, fm.nameLength, size) ||
+			!InFile(fm.diffuseOffset, fm.diffuseLength, size) ||
+			!InFile(fm.normalOffset, fm.normalLength, size) ||
+			!InFile(fm.specularOffset, fm.specularLength, size))
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header.textureCount; ++i)
+	{
+		const MeshFileTexture& ft = fileTextures[i];
+		if (!InFile(ft.nameOffset, ft.nameLength, size) || !InFile(ft.dataOffset, ft.bytes, size)) return false;
+	}
+
+	// Streams : pointers into the mapping
+	out.meshes.resize(header.meshCount);
+
+	for (uint32_t i = 0; i < header.meshCount; ++i)
+	{
+		const MeshFileMesh& fm = fileMeshes[i];
+		ModelCookMesh& mesh = out.meshes[i];
+
+		mesh.layout = static_cast<VertexLayout>(fm.layout);
+		mesh.packedVertices = reinterpret_cast<const VertexPacked*>(base + fm.packedOffset);
+		if (mesh.layout == VertexLayout::Skinned)
+		{
+			mesh.skinVertices = reinterpret_cast<const VertexSkinPacked*>(base + fm.skinOffset);
+			mesh.vertices = reinterpret_cast<const Vertex3d*>(base + fm.vertexOffset);
+		}
+		mesh.indices = reinterpret_cast<const uint32_t*>(base + fm.indexOffset);
+		mesh.boneBounds = reinterpret_cast<const BoneBounds*>(base + fm.boneBoundsOffset);
+		mesh.lods = reinterpret_cast<const MeshLod*>(base + fm.lodOffset);
+		mesh.lodIndices = reinterpret_cast<const uint32_t*>(base + fm.lodIndexOffset);
+		mesh.vertexCount = fm.vertexCount;
+		mesh.indexCount = fm.indexCount;
+		mesh.boneBoundsCount = fm.boneBoundsCount;
+		mesh.lodCount = fm.lodCount;
+		mesh.lodIndexCount = fm.lodIndexCount;
+		mesh.materialIndex = fm.materialIndex;
+		mesh.skinned = (fm.flags & MESH_FLAG_SKINNED) != 0;
+		mesh.localAABB.min = DirectX::XMFLOAT3(fm.aabbMin[0], fm.aabbMin[1], fm.aabbMin[2]);
+		mesh.localAABB.max = DirectX::XMFLOAT3(fm.aabbMax[0], fm.aabbMax[1], fm.aabbMax[2]);
+	}
+
+	out.materials.resize(header.materialCount);
+
+	for (uint32_t i = 0; i < header.materialCount; ++i)
+	{
+		const MeshFileMaterial& fm = fileMaterials[i];
+		ModelCookMaterial& mat = out.materials[i];
+
+		mat.name = ReadString(base, fm.nameOffset, fm.nameLength);
+		mat.hasBaseColor = (fm.flags & MATERIAL_FLAG_BASE_COLOR) != 0;
+		mat.hasSpecularColor = (fm.flags & MATERIAL_FLAG_SPECULAR_COLOR) != 0;
+		mat.baseColor = DirectX::XMFLOAT3(fm.baseColor[0], fm.baseColor[1], fm.baseColor[2]);
+		mat.specularColor = DirectX::XMFLOAT3(fm.specularColor[0], fm.specularColor[1], fm.specularColor[2]);
+		mat.shininess = fm.shininess;
+		mat.diffuseMap = ReadString(base, fm.diffuseOffset, fm.diffuseLength);
+		mat.normalMap = ReadString(base, fm.normalOffset, fm.normalLength);
+		mat.specularMap = ReadString(base, fm.specularOffset, fm.specularLength);
+	}
+
+	out.textures.resize(header.textureCount);
+
+	for (uint32_t i = 0; i < header.textureCount; ++i)
+	{
+		const MeshFileTexture& ft = fileTextures[i];
+		ModelCookTexture& tex = out.textures[i];
+
+		tex.name = ReadString(base, ft.nameOffset, ft.nameLength);
+		tex.data = base + ft.dataOffset;
+		tex.bytes = ft.bytes;
+	}
+
+	out.scene = BuildSceneShell(base, header, fileMeshes, fileBones, fileNodes, nodeMeshes);
+
+	return true;
+}
+
+// Everything the shell points to was new'ed in this module and is deleted here;
+// the aiScene / aiNode destructors (inside the assimp DLL, other CRT heap) only see null members
+void ModelCook_ReleaseSceneShell(aiScene* scene)
+{
+	if (!scene) return;
+
+	ReleaseNodeRecursive(scene->mRootNode);
+	scene->mRootNode = nullptr;
+
+	for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+	{
+		delete scene->mMeshes[i]; // aiMesh / aiBone destructors are inline, compiled here
+	}
+	delete[] scene->mMeshes;
+	scene->mMeshes = nullptr;
+	scene->mNumMeshes = 0;
+
+	delete scene;
+}
+
+bool ModelCook_Write(
+	const char* cookedPath,
+	uint64_t sourceHash,
+	bool yUp,
+	float scale,
+	const ModelLodSettings& lod,
+	const aiScene* scene,
+	const std::vector<ModelCookMesh>& meshes,
+	const std::vector<ModelCookMaterial>& materials,
+	const std::vector<ModelCookTexture>& textures)
+{
+	if (!scene || !scene->mRootNode) return false;
+	if (meshes.size() != scene->mNumMeshes) return false;
+
+	const uint32_t meshCount = static_cast<uint32_t>(meshes.size());
+	const uint32_t materialCount = static_cast<uint32_t>(materials.size());
+	const uint32_t textureCount = static_cast<uint32_t>(textures.size());
+
+	std::vector<const aiNode*> nodes;
+	std::vector<int> parents;
+	FlattenNodeRecursive(scene->mRootNode, -1, nodes, parents);
+
+	const uint32_t nodeCount = static_cast<uint32_t>(nodes.size());
+
+	// 1. Tables (string offsets are patched once the table position is known)
+	std::string strings;
+
+	std::vector<MeshFileMesh> fileMeshes(meshCount);
+	std::vector<MeshFileBone> fileBones;
+
+	for (uint32_t i = 0; i < meshCount; ++i)
+	{
+		const aiMesh* src = scene->mMeshes[i];
+		const ModelCookMesh& mesh = meshes[i];
+		MeshFileMesh& fm = fileMeshes[i];
+		memset(&fm, 0, sizeof(fm));
+
+		fm.nameOffset = static_cast<uint32_t>(strings.size());
+		fm.nameLength = src ? static_cast<uint32_t>(src->mName.length) : 0;
+		if (src) strings.append(src->mName.C_Str(), src->mName.length);
+
+		fm.vertexCount = mesh.vertexCount;
+		fm.indexCount = mesh.indexCount;
+		fm.materialIndex = mesh.materialIndex;
+		fm.flags = mesh.skinned ? MESH_FLAG_SKINNED : 0;
+		fm.layout = static_cast<uint32_t>(mesh.layout);
+		fm.boneBoundsCount = mesh.boneBoundsCount;
+		fm.lodCount = mesh.lodCount;
+		fm.lodIndexCount = mesh.lodIndexCount;
+		memcpy(fm.aabbMin, &mesh.localAABB.min, sizeof(fm.aabbMin));
+		memcpy(fm.aabbMax, &mesh.localAABB.max, sizeof(fm.aabbMax));
+
+		fm.boneFirst = static_cast<uint32_t>(fileBones.size());
+		fm.boneCount = src ? src->mNumBones : 0;
+
+		for (uint32_t b = 0; b < fm.boneCount; ++b)
+		{
+			const aiBone* bone = src->mBones[b];
+
+			MeshFileBone fb;
+			memset(&fb, 0, sizeof(fb));
+			fb.nameOffset = static_cast<uint32_t>(strings.size());
+			fb.nameLength = bone ? static_cast<uint32_t>(bone->mName.length) : 0;
+			if (bone)
+			{
+				strings.append(bone->mName.C_Str(), bone->mName.length);
+				memcpy(fb.offsetMatrix, &bone->mOffsetMatrix, sizeof(fb.offsetMatrix));
+			}
+
+			fileBones.push_back(fb);
+		}
+	}
+
+	std::vector<MeshFileNode> fileNodes(nodeCount);
+	std::vector<uint32_t> nodeMeshes;
+
+	for (uint32_t i = 0; i < nodeCount; ++i)
+	{
+		const aiNode* node = nodes[i];
+		MeshFileNode& fn = fileNodes[i];
+		memset(&fn, 0, sizeof(fn));
+
+		fn.nameOffset = static_cast<uint32_t>(strings.size());
+		fn.nameLength = static_cast<uint32_t>(node->mName.length);
+		strings.append(node->mName.C_Str(), node->mName.length);
+
+		fn.parent = parents[i];
+		fn.meshFirst = static_cast<uint32_t>(nodeMeshes.size());
+		fn.meshCount = node->mNumMeshes;
+		nodeMeshes.insert(nodeMeshes.end(), node->mMeshes, node->mMeshes + node->mNumMeshes);
+		memcpy(fn.transform, &node->mTransformation, sizeof(fn.transform));
+	}
+
+	std::vector<MeshFileMaterial> fileMaterials(materialCount);
+
+	auto addString = [&strings](const std::string& s, uint32_t& outOffset, uint32_t& outLength)
+	{
+		outOffset = static_cast<uint32_t>(strings.size());
+		outLength = static_cast<uint32_t>(s.size());
+		strings += s;
+	};
+
+	for (uint32_t i = 0; i < materialCount; ++i)
+	{
+		const ModelCookMaterial& mat = materials[i];
+		MeshFileMaterial& fm = fileMaterials[i];
+		memset(&fm, 0, sizeof(fm));
+
+		addString(mat.name, fm.nameOffset, fm.nameLength);
+		fm.flags =
+			(mat.hasBaseColor ? MATERIAL_FLAG_BASE_COLOR : 0) |
+			(mat.hasSpecularColor ? MATERIAL_FLAG_SPECULAR_COLOR : 0);
+		memcpy(fm.baseColor, &mat.baseColor, sizeof(fm.baseColor));
+		memcpy(fm.specularColor, &mat.specularColor, sizeof(fm.specularColor));
+		fm.shininess = mat.shininess;
+		addString(mat.diffuseMap, fm.diffuseOffset, fm.diffuseLength);
+		addString(mat.normalMap, fm.normalOffset, fm.normalLength);
+		addString(mat.specularMap, fm.specularOffset, fm.specularLength);
+	}
+
+	std::vector<MeshFileTexture> fileTextures(textureCount);
+
+	for (uint32_t i = 0; i < textureCount; ++i)
+	{
+		MeshFileTexture& ft = fileTextures[i];
+		memset(&ft, 0, sizeof(ft));
+
+		addString(textures[i].name, ft.nameOffset, ft.nameLength);
+		ft.bytes = textures[i].bytes;
+	}
+
+	// 2. Layout : header, tables, texture bytes, per mesh streams, strings
+	MeshFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = MESH_FILE_MAGIC;
+	header.version = MESH_FILE_VERSION;
+	header.sourceHash = sourceHash;
+	header.importScale = scale;
+	header.yUp = yUp ? 1u : 0u;
+	header.lodLevelCount = lod.levelCount;
+	header.lodRatio = lod.ratio;
+	header.lodMaxError = lod.maxError;
+	header.lodMinTriangles = lod.minTriangles;
+	header.meshCount = meshCount;
+	header.boneCount = static_cast<uint32_t>(fileBones.size());
+	header.nodeCount = nodeCount;
+	header.nodeMeshCount = static_cast<uint32_t>(nodeMeshes.size());
+	header.materialCount = materialCount;
+	header.textureCount = textureCount;
+
+	uint64_t offset = sizeof(MeshFileHeader) + static_cast<uint64_t>(meshCount) * sizeof(MeshFileMesh);
+	header.bonesOffset = offset;
+	offset = AlignUp8(offset + fileBones.size() * sizeof(MeshFileBone));
+	header.nodesOffset = offset;
+	offset = AlignUp8(offset + fileNodes.size() * sizeof(MeshFileNode));
+	header.nodeMeshesOffset = offset;
+	offset = AlignUp8(offset + nodeMeshes.size() * sizeof(uint32_t));
+	header.materialsOffset = offset;
+	offset = AlignUp8(offset + fileMaterials.size() * sizeof(MeshFileMaterial));
+	header.texturesOffset = offset;
+	offset = AlignUp8(offset + fileTextures.size() * sizeof(MeshFileTexture));
+
+	for (MeshFileTexture& ft : fileTextures)
+	{
+		ft.dataOffset = offset;
+		offset = AlignUp8(offset + ft.bytes);
+	}
+
+	for (MeshFileMesh& fm : fileMeshes)
+	{
+		const uint64_t skinnedCount = (fm.layout == static_cast<uint32_t>(VertexLayout::Skinned)) ? fm.vertexCount : 0;
+
+		fm.packedOffset = offset;
+		offset = AlignUp8(offset + static_cast<uint64_t>(fm.vertexCount) * sizeof(VertexPacked));
+		fm.skinOffset = offset;
+		offset = AlignUp8(offset + skinnedCount * sizeof(VertexSkinPacked));
+		fm.vertexOffset = offset;
+		offset = AlignUp8(offset + skinnedCount * sizeof(Vertex3d));
+		fm.indexOffset = offset;
+		offset = AlignUp8(offset + static_cast<uint64_t>(fm.indexCount) * sizeof(uint32_t));
+		fm.boneBoundsOffset = offset;
+		offset = AlignUp8(offset + static_cast<uint64_t>(fm.boneBoundsCount) * sizeof(BoneBounds));
+		fm.lodOffset = offset;
+		offset = AlignUp8(offset + static_cast<uint64_t>(fm.lodCount) * sizeof(MeshLod));
+		fm.lodIndexOffset = offset;
+		offset = AlignUp8(offset + static_cast<uint64_t>(fm.lodIndexCount) * sizeof(uint32_t));
+	}
+
+	const uint64_t stringsOffset = offset;
+	header.fileSize = stringsOffset + strings.size();
+	if (header.fileSize > UINT32_MAX) return false; // string offsets are 32 bit
+
+	const uint32_t stringBase = static_cast<uint32_t>(stringsOffset);
+	for (MeshFileMesh& fm : fileMeshes) fm.nameOffset += stringBase;
+	for (MeshFileBone& fb : fileBones) fb.nameOffset += stringBase;
+	for (MeshFileNode& fn : fileNodes) fn.nameOffset += stringBase;
+	for (MeshFileTexture& ft : fileTextures) ft.nameOffset += stringBase;
+	for (MeshFileMaterial& fm : fileMaterials)
+	{
+		fm.nameOffset += stringBase;
+		fm.diffuseOffset += stringBase;
+		fm.normalOffset += stringBase;
+		fm.specularOffset += stringBase;
+	}
+
+	// 3. Write to a temporary file first, a half written .meshcache is never picked up
+	const std::string tempPath = std::string(cookedPath) + ".tmp";
+	bool written = false;
+	{
+		std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+		if (!ofs) return false;
+
+		const char zeros[8] = {};
+		auto padTo = [&ofs, &zeros](uint64_t target)
+		{
+			const uint64_t pos = static_cast<uint64_t>(ofs.tellp());
+			if (target > pos) ofs.write(zeros, static_cast<std::streamsize>(target - pos));
+		};
+
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		ofs.write(reinterpret_cast<const char*>(fileMeshes.data()), fileMeshes.size() * sizeof(MeshFileMesh));
+
+		padTo(header.bonesOffset);
+		ofs.write(reinterpret_cast<const char*>(fileBones.data()), fileBones.size() * sizeof(MeshFileBone));
+		padTo(header.nodesOffset);
+		ofs.write(reinterpret_cast<const char*>(fileNodes.data()), fileNodes.size() * sizeof(MeshFileNode));
+		padTo(header.nodeMeshesOffset);
+		ofs.write(reinterpret_cast<const char*>(nodeMeshes.data()), nodeMeshes.size() * sizeof(uint32_t));
+		padTo(header.materialsOffset);
+		ofs.write(reinterpret_cast<const char*>(fileMaterials.data()), fileMaterials.size() * sizeof(MeshFileMaterial));
+		padTo(header.texturesOffset);
+		ofs.write(reinterpret_cast<const char*>(fileTextures.data()), fileTextures.size() * sizeof(MeshFileTexture));
+
+		for (uint32_t i = 0; i < textureCount; ++i)
+		{
+			padTo(fileTextures[i].dataOffset);
+			ofs.write(reinterpret_cast<const char*>(textures[i].data), static_cast<std::streamsize>(textures[i].bytes));
+		}
+
+		for (uint32_t i = 0; i < meshCount; ++i)
+		{
+			const ModelCookMesh& mesh = meshes[i];
+			const MeshFileMesh& fm = fileMeshes[i];
+
+			padTo(fm.packedOffset);
+			ofs.write(reinterpret_cast<const char*>(mesh.packedVertices), static_cast<std::streamsize>(mesh.vertexCount) * sizeof(VertexPacked));
+
+			if (mesh.layout == VertexLayout::Skinned)
+			{
+				padTo(fm.skinOffset);
+				ofs.write(reinterpret_cast<const char*>(mesh.skinVertices), static_cast<std::streamsize>(mesh.vertexCount) * sizeof(VertexSkinPacked));
+				padTo(fm.vertexOffset);
+				ofs.write(reinterpret_cast<const char*>(mesh.vertices), static_cast<std::streamsize>(mesh.vertexCount) * sizeof(Vertex3d));
+			}
+			padTo(fm.indexOffset);
+			ofs.write(reinterpret_cast<const char*>(mesh.indices), static_cast<std::streamsize>(mesh.indexCount) * sizeof(uint32_t));
+			padTo(fm.boneBoundsOffset);
+			ofs.write(reinterpret_cast<const char*>(mesh.boneBounds), static_cast<std::streamsize>(mesh.boneBoundsCount) * sizeof(BoneBounds));
+			padTo(fm.lodOffset);
+			ofs.write(reinterpret_cast<const char*>(mesh.lods), static_cast<std::streamsize>(mesh.lodCount) * sizeof(MeshLod));
+			padTo(fm.lodIndexOffset);
+			ofs.write(reinterpret_cast<const char*>(mesh.lodIndices), static_cast<std::streamsize>(mesh.lodIndexCount) * sizeof(uint32_t));
+		}
+
+		padTo(stringsOffset);
+		ofs.write(strings.data(), strings.size());
+
+		ofs.close();
+		written = !ofs.fail();
+	}
+
+	if (written)
+	{
+		std::remove(cookedPath);
+		written = (std::rename(tempPath.c_str(), cookedPath) == 0);
+	}
+
+	// Nothing is left behind on a failed write or rename
+	if (!written)
+	{
+		std::remove(tempPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+static void FlattenNodeRecursive(const aiNode* node, int parent, std::vector<const aiNode*>& outNodes, std::vector<int>& outParent)
+{
+	if (!node) return;
+
+	const int index = static_cast<int>(outNodes.size());
+
+	outNodes.push_back(node);
+	outParent.push_back(parent);
+
+	for (unsigned int i = 0; i < node->mNumChildren; ++i)
+	{
+		FlattenNodeRecursive(node->mChildren[i], index, outNodes, outParent);
+	}
+}
+
+// aiScene with what the asset reads outside the import itself:
+// node tree + mesh indices, mesh name / counts, bone names + offset matrices (no vertex data, no weights)
+static aiScene* BuildSceneShell(
+	const uint8_t* base,
+	const MeshFileHeader& header,
+	const MeshFileMesh* fileMeshes,
+	const MeshFileBone* fileBones,
+	const MeshFileNode* fileNodes,
+	const uint32_t* nodeMeshes)
+{
+	aiScene* scene = new aiScene();
+
+	// Nodes, parent always comes first
+	std::vector<aiNode*> nodes(header.nodeCount, nullptr);
+	std::vector<unsigned int> childCount(header.nodeCount, 0);
+
+	for (uint32_t i = 0; i < header.nodeCount; ++i)
+	{
+		const MeshFileNode& fn = fileNodes[i];
+
+		aiNode* node = new aiNode(ReadString(base, fn.nameOffset, fn.nameLength));
+		memcpy(&node->mTransformation, fn.transform, sizeof(fn.transform));
+
+		if (fn.meshCount > 0)
+		{
+			node->mNumMeshes = fn.meshCount;
+			node->mMeshes = new unsigned int[fn.meshCount];
+			memcpy(node->mMeshes, nodeMeshes + fn.meshFirst, fn.meshCount * sizeof(uint32_t));
+		}
+
+		if (fn.parent >= 0) ++childCount[fn.parent];
+		nodes[i] = node;
+	}
+
+	for (uint32_t i = 0; i < header.nodeCount; ++i)
+	{
+		if (childCount[i] > 0) nodes[i]->mChildren = new aiNode*[childCount[i]];
+	}
+
+	for (uint32_t i = 1; i < header.nodeCount; ++i)
+	{
+		aiNode* parent = nodes[fileNodes[i].parent];
+		nodes[i]->mParent = parent;
+		parent->mChildren[parent->mNumChildren++] = nodes[i];
+	}
+
+	scene->mRootNode = nodes[0];
+
+	// Meshes
+	if (header.meshCount > 0)
+	{
+		scene->mNumMeshes = header.meshCount;
+		scene->mMeshes = new aiMesh*[header.meshCount];
+
+		for (uint32_t i = 0; i < header.meshCount; ++i)
+		{
+			const MeshFileMesh& fm = fileMeshes[i];
+
+			aiMesh* mesh = new aiMesh();
+			mesh->mName.Set(ReadString(base, fm.nameOffset, fm.nameLength));
+			mesh->mNumVertices = fm.vertexCount;
+			mesh->mNumFaces = fm.indexCount / 3;
+			mesh->mMaterialIndex = fm.materialIndex;
+
+			if (fm.boneCount > 0)
+			{
+				mesh->mNumBones = fm.boneCount;
+				mesh->mBones = new aiBone*[fm.boneCount];
+
+				for (uint32_t b = 0; b < fm.boneCount; ++b)
+				{
+					const MeshFileBone& fb = fileBones[fm.boneFirst + b];
+
+					aiBone* bone = new aiBone();
+					bone->mName.Set(ReadString(base, fb.nameOffset, fb.nameLength));
+					memcpy(&bone->mOffsetMatrix, fb.offsetMatrix, sizeof(fb.offsetMatrix));
+					mesh->mBones[b] = bone;
+				}
+			}
+
+			scene->mMeshes[i] = mesh;
+		}
+	}
+
+	return scene;
+}
+
+static void ReleaseNodeRecursive(aiNode* node)
+{
+	if (!node) return;
+
+	for (unsigned int i = 0; i < node->mNumChildren; ++i)
+	{
+		ReleaseNodeRecursive(node->mChildren[i]);
+	}
+
+	delete[] node->mChildren;
+	node->mChildren = nullptr;
+	node->mNumChildren = 0;
+
+	delete[] node->mMeshes;
+	node->mMeshes = nullptr;
+	node->mNumMeshes = 0;
+
+	delete node;
+}
+
+static std::string ReadString(const uint8_t* base, uint32_t offset, uint32_t length)
+{
+	return std::string(reinterpret_cast<const char*>(base + offset), length);
+}
+
+static uint64_t AlignUp8(uint64_t v)
+{
+	return (v + 7) & ~static_cast<uint64_t>(7);
+}
+
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t fileSize)
+{
+	return offset <= fileSize && bytes <= fileSize - offset;
+}
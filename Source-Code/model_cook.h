@@ -0,0 +1,137 @@
+/*==============================================================================
+
+   Cooked model file [model_cook.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef MODEL_COOK_H
+#define MODEL_COOK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "collision.h"
+#include "mapped_file_util.h"
+#include "vertex_pack_util.h"
+
+struct aiScene;
+struct Vertex3d;
+struct BoneBounds;
+struct MeshLod;
+struct ModelLodSettings;
+
+/*
+// -------------------------------
+.meshcache (little endian, every section 8 byte aligned)
+├─ MeshFileHeader : magic, version, FNV-1a 64 of the source file, import settings (yUp, scale, LOD settings)
+├─ MeshFileMesh[meshCount] : counts, material, AABB, where the streams are
+├─ MeshFileBone[boneCount] : name + aiBone::mOffsetMatrix, meshes point at their range
+├─ MeshFileNode[nodeCount] : node tree (parent before child) + aiNode::mTransformation + mesh range
+├─ uint32 nodeMeshes[]     : aiNode::mMeshes of every node
+├─ MeshFileMaterial[materialCount] : colors + texture names as the source file stores them
+├─ MeshFileTexture[textureCount]   : embedded textures, bytes as assimp hands them over
+├─ per mesh : VertexPacked[], VertexSkinPacked[] (skinned), Vertex3d[] (skinned, CPU skinning),
+│             uint32 indices[], BoneBounds[], MeshLod[] + uint32 LOD indices[] exactly as in memory
+└─ string table (not null terminated)
+
+ModelAsset_Load
+├─ cooked file present, hash and import settings match
+│   ├─ MappedFile, packed vertex / index / LOD index streams go to CreateBuffer from the mapping
+│   └─ aiScene rebuilt with nodes, mesh names / counts and bones only (outliner, skeleton, track binding),
+│      allocated and freed on the game side (ModelCook_ReleaseSceneShell), never given to assimp
+└─ otherwise -> assimp import -> ModelCook_Write
+// -------------------------------
+*/
+
+// One mesh as ModelAsset_Load creates its buffers (pointers into the mapping or into the importer's arrays)
+struct ModelCookMesh
+{
+	const VertexPacked* packedVertices = nullptr; // stream 0
+	const VertexSkinPacked* skinVertices = nullptr; // stream 1, VertexLayout::Skinned only
+	const Vertex3d* vertices = nullptr; // full precision, cooked files keep it for skinned meshes only
+	const uint32_t* indices = nullptr;
+	const BoneBounds* boneBounds = nullptr;
+	const MeshLod* lods = nullptr;         // levels after the full mesh, startIndex into lodIndices
+	const uint32_t* lodIndices = nullptr;  // over the same vertices as indices
+	uint32_t vertexCount = 0;
+	uint32_t indexCount = 0;
+	uint32_t boneBoundsCount = 0;
+	uint32_t lodCount = 0;
+	uint32_t lodIndexCount = 0;
+	uint32_t materialIndex = 0;
+	bool skinned = false;
+	VertexLayout layout = VertexLayout::Static;
+	AABB localAABB{};
+};
+
+// aiMaterial reduced to what Default3DMaterial takes
+struct ModelCookMaterial
+{
+	std::string name;
+
+	bool hasBaseColor = false;
+	bool hasSpecularColor = false;
+	DirectX::XMFLOAT3 baseColor = { 1.0f, 1.0f, 1.0f };
+	DirectX::XMFLOAT3 specularColor = { 1.0f, 1.0f, 1.0f };
+	float shininess = 0.0f; // 0 : not set
+
+	// Raw names, resolved against the model directory at load
+	std::string diffuseMap;
+	std::string normalMap;   // NORMALS, or HEIGHT when there is none
+	std::string specularMap;
+};
+
+// Embedded texture ("*index" and its file name)
+struct ModelCookTexture
+{
+	std::string name;
+	const uint8_t* data = nullptr;
+	uint64_t bytes = 0;
+};
+
+// Result of ModelCook_Load, the pointers stay valid while it lives
+struct ModelCookData
+{
+	MappedFile file;
+	aiScene* scene = nullptr; // taken over by the asset, ModelCook_ReleaseSceneShell here otherwise
+
+	std::vector<ModelCookMesh> meshes;
+	std::vector<ModelCookMaterial> materials;
+	std::vector<ModelCookTexture> textures;
+
+	ModelCookData() = default;
+	~ModelCookData();
+
+	ModelCookData(const ModelCookData&) = delete;
+	ModelCookData& operator=(const ModelCookData&) = delete;
+};
+
+// "resources/Model/Chair02.fbx" -> "resources/Model/Chair02.meshcache"
+std::string ModelCook_GetCookedPath(const char* sourcePath);
+
+// false when the file is missing, broken, from another version, cooked with other import / LOD settings,
+// or (checkHash) cooked from a different source file
+bool ModelCook_Load(const char* cookedPath, uint64_t sourceHash, bool checkHash, bool yUp, float scale, const ModelLodSettings& lod, ModelCookData& out);
+
+// Frees the scene ModelCook_Load built (never aiReleaseImport : it is not assimp's allocation)
+void ModelCook_ReleaseSceneShell(aiScene* scene);
+
+// scene : node tree, mesh names and bones are taken from it
+bool ModelCook_Write(
+	const char* cookedPath,
+	uint64_t sourceHash,
+	bool yUp,
+	float scale,
+	const ModelLodSettings& lod,
+	const aiScene* scene,
+	const std::vector<ModelCookMesh>& meshes,
+	const std::vector<ModelCookMaterial>& materials,
+	const std::vector<ModelCookTexture>& textures
+);
+
+#endif // MODEL_COOK_H
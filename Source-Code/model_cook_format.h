@@ -0,0 +1,148 @@
+/*==============================================================================
+
+   Cooked model file layout [model_cook_format.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef MODEL_COOK_FORMAT_H
+#define MODEL_COOK_FORMAT_H
+
+// On-disk structures of .meshcache (model_cook.h), standard C++ only so tools can read the file
+
+#include <cstdint>
+
+static const uint32_t MESH_FILE_MAGIC = 0x4853454D; // "MESH"
+static const uint32_t MESH_FILE_VERSION = 5;        // bump when the layout, Vertex3d, the packed vertices, the import flags or the LOD builder change
+
+static const uint32_t MESH_FLAG_SKINNED = 1u << 0;
+
+static const uint32_t MESH_FILE_PACKED_VERTEX_SIZE = 28; // sizeof(VertexPacked), position first
+
+static const uint32_t MATERIAL_FLAG_BASE_COLOR = 1u << 0;
+static const uint32_t MATERIAL_FLAG_SPECULAR_COLOR = 1u << 1;
+
+struct MeshFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+
+	float importScale;
+	uint32_t yUp;
+
+	// ModelLodSettings
+	uint32_t lodLevelCount;
+	float lodRatio;
+	float lodMaxError;
+	uint32_t lodMinTriangles;
+
+	uint32_t meshCount;
+	uint32_t boneCount;
+	uint32_t nodeCount;
+	uint32_t nodeMeshCount;
+	uint32_t materialCount;
+	uint32_t textureCount;
+
+	uint64_t fileSize;
+	uint64_t bonesOffset;
+	uint64_t nodesOffset;
+	uint64_t nodeMeshesOffset;
+	uint64_t materialsOffset;
+	uint64_t texturesOffset;
+};
+
+struct MeshFileMesh
+{
+	uint32_t nameOffset;
+	uint32_t nameLength;
+
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t materialIndex;
+	uint32_t flags;
+
+	uint32_t boneFirst; // MeshFileBone range
+	uint32_t boneCount;
+	uint32_t boneBoundsCount;
+	uint32_t layout; // VertexLayout
+	uint32_t lodCount;      // levels after the full mesh
+	uint32_t lodIndexCount; // indices of all those levels
+
+	uint64_t packedOffset; // VertexPacked[vertexCount]
+	uint64_t skinOffset;   // VertexSkinPacked[vertexCount], skinned layout only
+	uint64_t vertexOffset; // Vertex3d[vertexCount], skinned layout only
+	uint64_t indexOffset;
+	uint64_t boneBoundsOffset;
+	uint64_t lodOffset;      // MeshFileLod[lodCount]
+	uint64_t lodIndexOffset; // uint32[lodIndexCount]
+
+	float aabbMin[3];
+	float aabbMax[3];
+};
+
+// Same layout as MeshLod
+struct MeshFileLod
+{
+	uint32_t startIndex; // into the mesh's LOD indices
+	uint32_t indexCount;
+	float error;         // object space
+};
+
+struct MeshFileBone
+{
+	uint32_t nameOffset;
+	uint32_t nameLength;
+
+	float offsetMatrix[16]; // aiMatrix4x4, a1..d4
+};
+
+struct MeshFileNode
+{
+	uint32_t nameOffset;
+	uint32_t nameLength;
+	int32_t parent;
+	uint32_t meshFirst; // nodeMeshes range
+	uint32_t meshCount;
+	uint32_t pad;
+
+	float transform[16]; // aiMatrix4x4, a1..d4
+};
+
+struct MeshFileMaterial
+{
+	uint32_t nameOffset;
+	uint32_t nameLength;
+	uint32_t flags;
+
+	float baseColor[3];
+	float specularColor[3];
+	float shininess;
+
+	uint32_t diffuseOffset;
+	uint32_t diffuseLength;
+	uint32_t normalOffset;
+	uint32_t normalLength;
+	uint32_t specularOffset;
+	uint32_t specularLength;
+};
+
+struct MeshFileTexture
+{
+	uint32_t nameOffset;
+	uint32_t nameLength;
+	uint64_t dataOffset;
+	uint64_t bytes;
+};
+
+static_assert(sizeof(MeshFileHeader) == 112, "MeshFileHeader layout");
+static_assert(sizeof(MeshFileMesh) == 128, "MeshFileMesh layout");
+static_assert(sizeof(MeshFileLod) == 12, "MeshFileLod layout");
+static_assert(sizeof(MeshFileBone) == 72, "MeshFileBone layout");
+static_assert(sizeof(MeshFileNode) == 88, "MeshFileNode layout");
+static_assert(sizeof(MeshFileMaterial) == 64, "MeshFileMaterial layout");
+static_assert(sizeof(MeshFileTexture) == 24, "MeshFileTexture layout");
+
+#endif // MODEL_COOK_FORMAT_H
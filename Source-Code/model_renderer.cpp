@@ -16,6 +16,9 @@
 #include "texture.h"
 #include "debug_ostream.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace DirectX;
 
 extern Default3DMaterial g_DefaultSceneMaterial;
@@ -24,6 +27,14 @@ static Texture g_TextureWhite;
 static Texture g_NormalFlat;
 static bool g_TexReady = false;
 
+static const float LOD_MAX_PIXEL_ERROR = 1.0f; // coarsest LOD whose error stays below this on screen
+static float g_LodPixelScale = 0.0f;          // pixels per unit of error at distance 1, 0 : always the full mesh
+
+static void DrawMesh(ModelAsset* asset, const MeshAsset& mesh, const XMMATRIX& world, const XMFLOAT3& cameraPos, const AABB* posedBounds);
+static void UnlitDrawMesh(ModelAsset* asset, const MeshAsset& mesh, const XMMATRIX& world, const XMFLOAT4& color);
+static void BindAssetBuffers(const ModelAsset* asset);
+static void BindIndexBuffer(const ModelAsset* asset, const MeshAsset& mesh);
+static const MeshLod* SelectLod(const MeshAsset& mesh, const XMMATRIX& finalWorld, const XMFLOAT3& cameraPos, const AABB* posedBounds);
 static void BindPS_SRV(UINT slot, ID3D11ShaderResourceView* srv);
 static ID3D11ShaderResourceView* FindSRV(ModelAsset* asset, const std::string& key);
 
@@ -50,6 +61,12 @@ void ModelRenderer_Finalize()
 	g_TexReady = false;
 }
 
+void ModelRenderer_SetLodView(const XMFLOAT4X4& proj, unsigned int viewportHeight)
+{
+	// Perspective : screen y = proj._22 * y / z in NDC, half the viewport per NDC unit
+	g_LodPixelScale = proj._22 * 0.5f * static_cast<float>(viewportHeight);
+}
+
 void ModelRenderer_Draw(
 	ModelAsset* asset,
 	uint32_t meshIndex,
@@ -64,7 +81,93 @@ void ModelRenderer_Draw(
 
 	MeshAsset& mesh = asset->meshes[meshIndex];
 
-	Default3DShader& shader = mesh.skinned ? g_Default3DshaderSkinned : g_Default3DshaderStatic;
+	BindAssetBuffers(asset);
+	BindIndexBuffer(asset, mesh);
+
+	DrawMesh(asset, mesh, world, cameraPos, nullptr);
+}
+
+void ModelRenderer_DrawAsset(
+	ModelAsset* asset,
+	const XMMATRIX& world,
+	const XMFLOAT3& cameraPos,
+	const AABB* posedBounds
+)
+{
+	ModelRenderer_Initialize();
+
+	if (!asset) return;
+
+	// Shared buffers once, the index buffer again only when the index format changes
+	BindAssetBuffers(asset);
+
+	const MeshAsset* bound = nullptr;
+	for (MeshAsset& mesh : asset->meshes)
+	{
+		if (!bound || bound->indexSize != mesh.indexSize || bound->indexBufferOffset != mesh.indexBufferOffset)
+		{
+			BindIndexBuffer(asset, mesh);
+			bound = &mesh;
+		}
+
+		DrawMesh(asset, mesh, world, cameraPos, posedBounds);
+	}
+}
+
+void ModelRenderer_UnlitDraw(
+	ModelAsset* asset,
+	uint32_t meshIndex,
+	const XMMATRIX& world,
+	const XMFLOAT4& color
+)
+{
+	ModelRenderer_Initialize();
+
+	if (!asset) return;
+	if (meshIndex >= asset->meshes.size()) return;
+
+	MeshAsset& mesh = asset->meshes[meshIndex];
+	if (mesh.skinned) return;
+
+	BindAssetBuffers(asset);
+	BindIndexBuffer(asset, mesh);
+
+	UnlitDrawMesh(asset, mesh, world, color);
+}
+
+void ModelRenderer_UnlitDrawAsset(
+	ModelAsset* asset,
+	const XMMATRIX& world,
+	const XMFLOAT4& color
+)
+{
+	ModelRenderer_Initialize();
+
+	if (!asset) return;
+
+	BindAssetBuffers(asset);
+
+	const MeshAsset* bound = nullptr;
+	for (MeshAsset& mesh : asset->meshes)
+	{
+		if (mesh.skinned) continue;
+
+		if (!bound || bound->indexSize != mesh.indexSize || bound->indexBufferOffset != mesh.indexBufferOffset)
+		{
+			BindIndexBuffer(asset, mesh);
+			bound = &mesh;
+		}
+
+		UnlitDrawMesh(asset, mesh, world, color);
+	}
+}
+
+// Buffers already bound (BindAssetBuffers / BindIndexBuffer)
+static void DrawMesh(ModelAsset* asset, const MeshAsset& mesh, const XMMATRIX& world, const XMFLOAT3& cameraPos, const AABB* posedBounds)
+{
+	Default3DShader& shader =
+		!mesh.skinned ? g_Default3DshaderStatic :
+		(asset->skinning == SkinningMethod::DualQuaternion) ? g_Default3DshaderSkinnedDQ : g_Default3DshaderSkinned;
 	shader.Begin();
 
 	const XMMATRIX finalWorld = asset->importFix * world; // import fix
@@ -103,30 +206,16 @@ void ModelRenderer_Draw(
 	BindPS_SRV(1, normalSRV);
 	BindPS_SRV(2, specularSRV);
 
-	// Binding VB and IB
-	UINT stride = sizeof(Vertex3d);
-	UINT offset = 0;
-	Direct3D_GetContext()->IASetVertexBuffers(0, 1, &mesh.vertexBuffer, &stride, &offset);
-	Direct3D_GetContext()->IASetIndexBuffer(mesh.indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	// Index-only LODs share the mesh's vertices and index buffer part, only the range changes
+	const MeshLod* lod = SelectLod(mesh, finalWorld, cameraPos, posedBounds);
+	const UINT indexCount = lod ? lod->indexCount : mesh.indexCount;
+	const UINT startIndex = lod ? lod->startIndex : mesh.startIndex;
 
-	Direct3D_GetContext()->DrawIndexed(mesh.indexCount, 0, 0);
+	Direct3D_GetContext()->DrawIndexed(indexCount, startIndex, static_cast<INT>(mesh.baseVertex));
 }
 
-void ModelRenderer_UnlitDraw(
-	ModelAsset* asset,
-	uint32_t meshIndex,
-	const XMMATRIX& world,
-	const XMFLOAT4& color
-)
+static void UnlitDrawMesh(ModelAsset* asset, const MeshAsset& mesh, const XMMATRIX& world, const XMFLOAT4& color)
 {
-	ModelRenderer_Initialize();
-
-	if (!asset) return;
-	if (meshIndex >= asset->meshes.size()) return;
-
-	MeshAsset& mesh = asset->meshes[meshIndex];
-	if (mesh.skinned) return;
-
 	g_DefaultUnlitShader.Begin();
 
 	const XMMATRIX finalWorld = asset->importFix * world; // import fix
@@ -153,13 +242,64 @@ void ModelRenderer_UnlitDraw(
 
 	BindPS_SRV(0, diffuseSRV);
 
-	// Binding VB and IB
-	UINT stride = sizeof(Vertex3d);
-	UINT offset = 0;
-	Direct3D_GetContext()->IASetVertexBuffers(0, 1, &mesh.vertexBuffer, &stride, &offset);
-	Direct3D_GetContext()->IASetIndexBuffer(mesh.indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	Direct3D_GetContext()->DrawIndexed(mesh.indexCount, mesh.startIndex, static_cast<INT>(mesh.baseVertex));
+}
+
+// Stream 0 and the skin stream (static input layouts do not read slot 1)
+static void BindAssetBuffers(const ModelAsset* asset)
+{
+	ID3D11Buffer* buffers[2] = { asset->vertexBuffer, asset->skinBuffer };
+	UINT strides[2] = { sizeof(VertexPacked), sizeof(VertexSkinPacked) };
+	UINT offsets[2] = { 0, 0 };
+	Direct3D_GetContext()->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+}
+
+static void BindIndexBuffer(const ModelAsset* asset, const MeshAsset& mesh)
+{
+	Direct3D_GetContext()->IASetIndexBuffer(asset->indexBuffer, mesh.indexSize == sizeof(uint32_t) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT, mesh.indexBufferOffset);
+}
+
+// Coarsest level whose object space error projects to LOD_MAX_PIXEL_ERROR pixels or less,
+// measured at the nearest point of the bounding sphere (nullptr : full mesh)
+// Skinned meshes use the posed world box when there is one, the bind-pose box does not follow the animation
+static const MeshLod* SelectLod(const MeshAsset& mesh, const XMMATRIX& finalWorld, const XMFLOAT3& cameraPos, const AABB* posedBounds)
+{
+	if (mesh.lods.size() < 2 || g_LodPixelScale <= 0.0f) return nullptr;
+
+	// Largest axis scale of the world matrix, errors grow with it
+	const float scale = std::sqrt(std::max(std::max(
+		XMVectorGetX(XMVector3LengthSq(finalWorld.r[0])),
+		XMVectorGetX(XMVector3LengthSq(finalWorld.r[1]))),
+		XMVectorGetX(XMVector3LengthSq(finalWorld.r[2]))));
 
-	Direct3D_GetContext()->DrawIndexed(mesh.indexCount, 0, 0);
+	XMVECTOR center;
+	float radius;
+	if (mesh.skinned && posedBounds)
+	{
+		const XMVECTOR boxMin = XMLoadFloat3(&posedBounds->min);
+		const XMVECTOR boxMax = XMLoadFloat3(&posedBounds->max);
+		center = XMVectorScale(XMVectorAdd(boxMin, boxMax), 0.5f);
+		radius = 0.5f * XMVectorGetX(XMVector3Length(XMVectorSubtract(boxMax, boxMin)));
+	}
+	else
+	{
+		const XMVECTOR boxMin = XMLoadFloat3(&mesh.localAABB.min);
+		const XMVECTOR boxMax = XMLoadFloat3(&mesh.localAABB.max);
+		center = XMVector3TransformCoord(XMVectorScale(XMVectorAdd(boxMin, boxMax), 0.5f), finalWorld);
+		radius = 0.5f * XMVectorGetX(XMVector3Length(XMVectorSubtract(boxMax, boxMin))) * scale;
+	}
+
+	const float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(center, XMLoadFloat3(&cameraPos)))) - radius;
+	if (distance <= 0.0f) return nullptr;
+
+	const float pixelsPerUnit = g_LodPixelScale * scale / distance;
+
+	for (size_t l = mesh.lods.size() - 1; l > 0; --l)
+	{
+		if (mesh.lods[l].error * pixelsPerUnit <= LOD_MAX_PIXEL_ERROR) return &mesh.lods[l];
+	}
+
+	return nullptr;
 }
 
 static void BindPS_SRV(UINT slot, ID3D11ShaderResourceView* srv)
@@ -13,10 +13,14 @@
 #include <DirectXMath.h>
 
 struct ModelAsset;
+struct AABB;
 
 void ModelRenderer_Initialize();
 void ModelRenderer_Finalize();
 
+// Once per frame before drawing : projection and viewport height turn a LOD's error into pixels
+void ModelRenderer_SetLodView(const DirectX::XMFLOAT4X4& proj, unsigned int viewportHeight);
+
 void ModelRenderer_Draw(
 	ModelAsset* asset,
 	uint32_t meshIndex,
@@ -30,4 +34,18 @@ void ModelRenderer_UnlitDraw(
 	const DirectX::XMFLOAT4& color
 );
 
+// Every mesh of the asset, the shared buffers are bound once
+// posedBounds : world box of the current pose, LOD distance of the skinned meshes (nullptr : bind pose)
+void ModelRenderer_DrawAsset(
+	ModelAsset* asset,
+	const DirectX::XMMATRIX& world,
+	const DirectX::XMFLOAT3& cameraPos,
+	const AABB* posedBounds = nullptr
+);
+void ModelRenderer_UnlitDrawAsset(
+	ModelAsset* asset,
+	const DirectX::XMMATRIX& world,
+	const DirectX::XMFLOAT4& color
+);
+
 # endif // MODEL_RENDERER_H
\ No newline at end of file
@@ -0,0 +1,39 @@
+/*==============================================================================
+
+   CPU side vertex of an imported mesh [model_vertex.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef MODEL_VERTEX_H
+#define MODEL_VERTEX_H
+
+#include <cstdint>
+#include <DirectXMath.h>
+
+#include "aabb.h"
+
+// No D3D / assimp header: CPU skinning and its test build without them (tools/skinning_test.cpp)
+
+struct Vertex3d
+{
+	DirectX::XMFLOAT3 position; // _W
+	DirectX::XMFLOAT3 normal;   // @
+	DirectX::XMFLOAT3 tangent;  // ؐ
+	DirectX::XMFLOAT4 color;    // F
+	DirectX::XMFLOAT2 texcoord; // UV
+
+	uint32_t boneIndex[4]; // e{[̃CfbNX
+	float boneWeight[4];   // e{[̃EFCg
+};
+
+// Bind-pose box of the vertices one bone moves (bone -1 : vertices without weights)
+struct BoneBounds
+{
+	int bone = -1;
+	AABB box{};
+};
+
+#endif // MODEL_VERTEX_H
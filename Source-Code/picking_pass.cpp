@@ -122,13 +122,13 @@ void PickingPass::DrawAsset(ModelAsset* asset, uint32_t meshIndex, const DirectX
 
     MeshAsset& mesh = asset->meshes[meshIndex];
 
-    UINT stride = sizeof(Vertex3d);
+    UINT stride = sizeof(VertexPacked); // stream 0 only, the picking layout reads POSITION
     UINT offset = 0;
 
-    m_pContext->IASetVertexBuffers(0, 1, &mesh.vertexBuffer, &stride, &offset);
-    m_pContext->IASetIndexBuffer(mesh.indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    m_pContext->IASetVertexBuffers(0, 1, &asset->vertexBuffer, &stride, &offset);
+    m_pContext->IASetIndexBuffer(asset->indexBuffer, mesh.indexSize == sizeof(uint32_t) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT, mesh.indexBufferOffset);
 
-    m_pContext->DrawIndexed(mesh.indexCount, 0, 0);
+    m_pContext->DrawIndexed(mesh.indexCount, mesh.startIndex, static_cast<INT>(mesh.baseVertex));
 }
 
 // From mouse coordinate to return object id
@@ -16,6 +16,9 @@
 #include "collision.h"
 #include "debug_draw_gate.h"
 #include "scene_manager.h"
+#include "animation_skinning.h"
+#include "animation_root_motion.h"
+#include "imgui/imgui.h"
 
 #include <DirectXMath.h>
 
@@ -27,6 +30,12 @@ static constexpr float AABB_HEIGHT = 6.0f;
 
 static constexpr float KILL_Y = -50.0f;
 
+// Crossfade time between state clips (take-off is short so the jump reads immediately)
+static constexpr double ANIM_FADE_SEC = 0.2;
+static constexpr double ANIM_JUMP_FADE_SEC = 0.1;
+
+static bool IsClipPlayable(AnimationClipHandle handle);
+
 
 Player::Player()
 	: m_State(AnimState::None)
@@ -53,27 +62,53 @@ void Player::Initialize(const DirectX::XMFLOAT3& position, const DirectX::XMFLOA
 	m_LocalAABB.max = {  AABB_HALF_W, AABB_HEIGHT,  AABB_HALF_D };
 	m_WorldAABB = m_LocalAABB;
 
-	// Animation player
-	m_AnimPlayer = new AnimationPlayer();
+	// Animation instance (one blend layer: state machine clips)
+	m_AnimInstance = AnimationSystem::Instance().CreateInstance(m_Asset, 1);
+	m_AnimBlender = AnimationSystem::Instance().GetBlender(m_AnimInstance);
+	UpdateAABB();
 
 	// Load animation clip
-	AnimationClip* idleClip = Animation_LoadFromFile("resources/Animation/Idle.fbx", m_Asset, true);
-	int idleId = AnimationManager::Instance().RegisterClip(idleClip);
-	m_ClipIdle = AnimationManager::Instance().GetClipById(idleId);
+	// All four load side by side on the loader threads; the prepare step runs there too
+	// Clips are kept quantized only (AnimationBench shows the error report)
+	AnimationManager& manager = AnimationManager::Instance();
+	const ModelAsset* asset = m_Asset;
+	AnimationCompressionSettings compression;
+
+	auto compress = [asset, compression](AnimationClip* clip)
+	{
+		AnimationCompression_CompressClip(clip, asset, compression);
+	};
 
-	AnimationClip* walkClip = Animation_LoadFromFile("resources/Animation/Walking.fbx", m_Asset, true);
-	int walkId = AnimationManager::Instance().RegisterClip(walkClip);
-	m_ClipWalk = AnimationManager::Instance().GetClipById(walkId);
+	m_ClipIdle = manager.LoadAsync("resources/Animation/Idle.fbx", m_Asset, true, compress);
 
-	m_ClipRun = nullptr;
+	// Events: foot contacts at the start and the middle of the walk cycle, take-off at the jump start
+	m_ClipWalk = manager.LoadAsync("resources/Animation/Walking.fbx", m_Asset, true,
+		[asset, compression](AnimationClip* clip)
+		{
+			AnimationRootMotion_Extract(clip, asset); // before compression: the root keys are rewritten
+			AnimationCompression_CompressClip(clip, asset, compression);
+
+			if (clip->ticksPerSecond > 0.0)
+			{
+				const double walkSec = clip->duration / clip->ticksPerSecond;
+				Animation_AddEvent(clip, "footstep", 0.0, "foot_l", 0.0f);
+				Animation_AddEvent(clip, "footstep", walkSec * 0.5, "foot_r", 1.0f);
+			}
+		});
+
+	m_ClipRun = AnimationClipHandle();
+
+	m_ClipJump = manager.LoadAsync("resources/Animation/Jump.fbx", m_Asset, true,
+		[asset, compression](AnimationClip* clip)
+		{
+			AnimationCompression_CompressClip(clip, asset, compression);
+			Animation_AddEvent(clip, "vfx", 0.0, "takeoff");
+		});
 
-	AnimationClip* jumpClip = Animation_LoadFromFile("resources/Animation/Jump.fbx", m_Asset, true);
-	int jumpId = AnimationManager::Instance().RegisterClip(jumpClip);
-	m_ClipJump = AnimationManager::Instance().GetClipById(jumpId);
+	m_ClipFall = manager.LoadAsync("resources/Animation/Falling.fbx", m_Asset, true, compress);
 
-	AnimationClip* fallClip = Animation_LoadFromFile("resources/Animation/Falling.fbx", m_Asset, true);
-	int fallId = AnimationManager::Instance().RegisterClip(fallClip);
-	m_ClipFall = AnimationManager::Instance().GetClipById(fallId);
+	// Ground speed comes from the walk clip once it has arrived (Update)
+	m_UseRootMotion = false;
 
 	// Initialize state
 	ChangeState(AnimState::Idle);
@@ -81,39 +116,107 @@ void Player::Initialize(const DirectX::XMFLOAT3& position, const DirectX::XMFLOA
 
 void Player::Finalize()
 {
+	if (m_AnimInstance >= 0)
+	{
+		AnimationSystem::Instance().DestroyInstance(m_AnimInstance);
+		m_AnimInstance = -1;
+	}
+	m_AnimBlender = nullptr;
+	Animation_ReleaseSkinningPalette(m_SkinPalette);
+
 	if (m_Asset)
 	{
+		AnimationManager::Instance().WaitForLoads(); // loader threads read the asset
+		AnimationManager::Instance().ReleaseBindings(m_Asset);
 		ModelAsset_Release(m_Asset);
 		m_Asset = nullptr;
 	}
 
-	m_ClipIdle = nullptr;
-	m_ClipWalk = nullptr;
-	m_ClipRun = nullptr;
-	m_ClipJump = nullptr;
-	m_ClipFall = nullptr;
-
-	delete m_AnimPlayer;
-	m_AnimPlayer = nullptr;
+	m_ClipIdle = AnimationClipHandle();
+	m_ClipWalk = AnimationClipHandle();
+	m_ClipRun = AnimationClipHandle();
+	m_ClipJump = AnimationClipHandle();
+	m_ClipFall = AnimationClipHandle();
 }
 
 void Player::Update(double elapsed_time, const XMFLOAT3& cameraFront)
 {
+	// Walk clip may still be loading: keyboard speed until it is there
+	if (!m_UseRootMotion)
+	{
+		const AnimationClip* walk = AnimationManager::Instance().ResolveClip(m_ClipWalk);
+		m_UseRootMotion = walk && !walk->rootMotion.Empty();
+	}
+
 	UpdateMovement(elapsed_time, cameraFront);
 	UpdatePhysics(elapsed_time);
-	UpdateState();
-	UpdateAnimation(elapsed_time);
+	UpdateState(); // crossfades only, AnimationSystem::Update advances and evaluates the pose
 }
 
-void Player::UpdateAnimationOnly(double elapsed_time)
+void Player::DebugDraw()
 {
-	UpdateAnimation(elapsed_time);
+	if (!m_Asset) return;
+
+	// AnimationSystem builds the dual quaternion palette from the next update on,
+	// DrawAsset picks the matching vertex shader and Draw the matching upload
+	int method = static_cast<int>(m_Asset->skinning);
+	ImGui::Text("Player Skinning");
+	ImGui::RadioButton("Linear Blend", &method, static_cast<int>(SkinningMethod::LinearBlend));
+	ImGui::SameLine();
+	ImGui::RadioButton("Dual Quaternion", &method, static_cast<int>(SkinningMethod::DualQuaternion));
+	m_Asset->skinning = static_cast<SkinningMethod>(method);
+
+	ImGui::Text("Footsteps : %d", m_FootstepCount);
+	ImGui::Text("Last event : %s", m_LastEvent.empty() ? "-" : m_LastEvent.c_str());
+	if (m_AnimBlender) ImGui::Text("Dropped events : %d", m_AnimBlender->GetEvents().GetDropped());
+
+	ImGui::Separator();
 }
 
 void Player::Draw(const XMFLOAT3& cameraPosition)
 {
 	if (!m_Asset) return;
 
+	XMMATRIX world = GetWorldMatrix();
+
+	// Palette was built by AnimationSystem::Update this frame
+	if (m_Asset->skinning == SkinningMethod::DualQuaternion)
+	{
+		const std::vector<SkinDualQuat>* dualQuats = AnimationSystem::Instance().GetDualQuatPalette(m_AnimInstance);
+		if (dualQuats && !dualQuats->empty())
+		{
+			Animation_UpdateSkinningCB(*dualQuats, &m_SkinPalette);
+		}
+	}
+	else
+	{
+		const std::vector<XMFLOAT4X4>* palette = AnimationSystem::Instance().GetPalette(m_AnimInstance);
+		if (palette)
+		{
+			Animation_UpdateSkinningCB(*palette, &m_SkinPalette);
+		}
+	}
+
+	ModelRenderer_DrawAsset(m_Asset, world, cameraPosition, m_HasPosedAABB ? &m_PosedAABB : nullptr);
+/*
+#if defined(DEBUG) || defined(_DEBUG)
+	Collision_DebugDraw(m_WorldAABB, { 0.0f, 0.0f, 1.0f, 1.0f });
+#endif
+*/
+	if (DebugDraw_Allow(DebugDrawCategory::Collision))
+	{
+		Collision_DebugDraw(m_WorldAABB, { 0.0f, 0.0f, 1.0f, 1.0f });
+
+		if (m_HasPosedAABB)
+		{
+			Collision_DebugDraw(m_PosedAABB, { 1.0f, 1.0f, 0.0f, 1.0f });
+		}
+	}
+
+}
+
+XMMATRIX Player::GetWorldMatrix() const
+{
 	XMVECTOR pos = XMLoadFloat3(&m_Position);
 	XMVECTOR front = XMLoadFloat3(&m_Front);
 
@@ -135,27 +238,7 @@ void Player::Draw(const XMFLOAT3& cameraPosition)
 	XMMATRIX trans = XMMatrixTranslationFromVector(pos);
 	XMMATRIX scale = XMMatrixScaling(1.0f, 1.0f, 1.0f);
 
-	XMMATRIX world = modelFix * scale * rot * trans;
-
-	if (m_AnimPlayer)
-	{
-		Animation_UpdateSkinningCB(*m_AnimPlayer);
-	}
-
-	for (uint32_t mi = 0; mi < (uint32_t)m_Asset->meshes.size(); ++mi)
-	{
-		ModelRenderer_Draw(m_Asset, mi, world, cameraPosition);
-	}
-/*
-#if defined(DEBUG) || defined(_DEBUG)
-	Collision_DebugDraw(m_WorldAABB, { 0.0f, 0.0f, 1.0f, 1.0f });
-#endif
-*/
-	if (DebugDraw_Allow(DebugDrawCategory::Collision))
-	{
-		Collision_DebugDraw(m_WorldAABB, { 0.0f, 0.0f, 1.0f, 1.0f });
-	}
-
+	return modelFix * scale * rot * trans;
 }
 
 void Player::SetState(AnimState state)
@@ -214,7 +297,8 @@ void Player::UpdateMovement(double elapsed_time, const XMFLOAT3& cameraFront)
 
 		XMStoreFloat3(&m_Front, moveDir);
 
-		XMVECTOR horizVel = moveDir * m_MoveSpeed;
+		// On the ground with root motion the clip moves the character (UpdatePhysics)
+		XMVECTOR horizVel = (m_UseRootMotion && m_IsGround) ? XMVectorZero() : moveDir * m_MoveSpeed;
 		velocity = XMVectorSet(
 			XMVectorGetX(horizVel),
 			XMVectorGetY(velocity),
@@ -248,6 +332,20 @@ void Player::UpdatePhysics(double elapsed_time)
 	velocity += gdir * m_Gravity * (float)elapsed_time;
 	position += velocity * (float)elapsed_time;
 
+	// Root motion of the last AnimationSystem update, resolved together with the velocity step
+	if (m_UseRootMotion && m_IsGround && m_AnimBlender)
+	{
+		const RootMotionDelta& root = m_AnimBlender->GetRootMotionDelta();
+
+		position += XMVector3TransformNormal(XMLoadFloat3(&root.translation), GetWorldMatrix());
+
+		// Input decides the facing while moving, turn-in-place clips turn the character otherwise
+		if (!m_IsMoving && root.yaw != 0.0f)
+		{
+			XMStoreFloat3(&m_Front, XMVector3TransformNormal(XMLoadFloat3(&m_Front), XMMatrixRotationY(root.yaw)));
+		}
+	}
+
 	XMStoreFloat3(&m_Position, position);
 	XMStoreFloat3(&m_Velocity, velocity);
 
@@ -272,11 +370,23 @@ void Player::UpdatePhysics(double elapsed_time)
 	ResetIfFallen(KILL_Y, { 0.0f, 0.0f, 0.0f });
 }
 
-void Player::UpdateAnimation(double elapsed_time)
+void Player::HandleAnimationEvents()
 {
-	if (!m_AnimPlayer) return;
+	if (!m_AnimBlender) return;
+
+	AnimationEventQueue& events = m_AnimBlender->GetEvents();
+	AnimationEventRecord record;
 
-	m_AnimPlayer->Update(elapsed_time);
+	while (events.Pop(record))
+	{
+		if (record.track->name == "footstep")
+		{
+			++m_FootstepCount;
+		}
+
+		// Shown in DebugDraw, the record itself points into the clip
+		m_LastEvent = record.clip->animName + " / " + record.track->name + " (" + record.event->name + ")";
+	}
 }
 
 void Player::UpdateAABB()
@@ -291,6 +401,20 @@ void Player::UpdateAABB()
 		m_LocalAABB.max.y + m_Position.y,
 		m_LocalAABB.max.z + m_Position.z 
 	};
+
+	// Posed box: per-bone bounds through the last palette (one frame behind, AnimationSystem runs after the player)
+	m_HasPosedAABB = false;
+
+	const std::vector<XMFLOAT4X4>* palette = AnimationSystem::Instance().GetPalette(m_AnimInstance);
+	AABB posedLocal;
+	if (m_Asset && palette && AnimationSkinning_ComputePosedAABB(m_Asset, *palette, posedLocal))
+	{
+		m_PosedAABB = Collision_TransformAABB(posedLocal, m_Asset->importFix * GetWorldMatrix());
+		m_HasPosedAABB = true;
+	}
+
+	// Animation LOD (distance / frustum) culls with the posed box
+	AnimationSystem::Instance().SetInstanceBounds(m_AnimInstance, GetPosedAABB());
 }
 
 void Player::UpdateState()
@@ -352,7 +476,7 @@ void Player::CheckFallState(bool wasGround)
 
 void Player::ChangeState(AnimState newState)
 {
-	if (!m_AnimPlayer || !m_Asset) return;
+	if (!m_AnimBlender || !m_Asset) return;
 	if (m_State == newState) return;
 
 	m_State = newState;
@@ -360,41 +484,41 @@ void Player::ChangeState(AnimState newState)
 	switch (m_State)
 	{
 	case AnimState::Idle:
-		if (m_ClipIdle)
+		if (IsClipPlayable(m_ClipIdle))
 		{
-			m_AnimPlayer->Play(m_ClipIdle, m_Asset, true, 0.0);
+			m_AnimBlender->CrossFade(0, m_ClipIdle, true, ANIM_FADE_SEC);
 		}
 		break;
 
 	case AnimState::Walk:
-		if (m_ClipWalk)
+		if (IsClipPlayable(m_ClipWalk))
 		{
-			m_AnimPlayer->Play(m_ClipWalk, m_Asset, true, 0.0);
+			m_AnimBlender->CrossFade(0, m_ClipWalk, true, ANIM_FADE_SEC);
 		}
 		break;
 
 	case AnimState::Run:
-		if (m_ClipRun)
+		if (IsClipPlayable(m_ClipRun))
 		{
-			m_AnimPlayer->Play(m_ClipRun, m_Asset, true, 0.0);
+			m_AnimBlender->CrossFade(0, m_ClipRun, true, ANIM_FADE_SEC);
 		}
 		break;
 
 	case AnimState::Jump:
-		if (m_ClipJump)
+		if (IsClipPlayable(m_ClipJump))
 		{
-			m_AnimPlayer->Play(m_ClipJump, m_Asset, false, 0.0);
+			m_AnimBlender->CrossFade(0, m_ClipJump, false, ANIM_JUMP_FADE_SEC);
 		}
-		else if (m_ClipWalk)
+		else if (IsClipPlayable(m_ClipWalk)) // Jump.fbx missing or broken: keep moving instead of the bind pose
 		{
-			m_AnimPlayer->Play(m_ClipWalk, m_Asset, true, 0.0);
+			m_AnimBlender->CrossFade(0, m_ClipWalk, true, ANIM_FADE_SEC);
 		}
 		break;
 
 	case AnimState::Fall:
-		if (m_ClipFall)
+		if (IsClipPlayable(m_ClipFall))
 		{
-			m_AnimPlayer->Play(m_ClipFall, m_Asset, true, 0.0);
+			m_AnimBlender->CrossFade(0, m_ClipFall, true, ANIM_FADE_SEC);
 		}
 		break;
 
@@ -436,3 +560,10 @@ bool Player::IsOnGround() const
 {
 	return m_IsGround;
 }
+
+// Pending clips are fine to fade to (the blender holds the bind pose until they arrive), failed loads are not
+static bool IsClipPlayable(AnimationClipHandle handle)
+{
+	const ClipLoadState state = AnimationManager::Instance().GetLoadState(handle);
+	return state == ClipLoadState::Pending || state == ClipLoadState::Ready;
+}
@@ -12,8 +12,11 @@
 #define PLAYER_H
 
 #include <DirectXMath.h>
+#include <string>
 
 #include "animation.h"
+#include "animation_blender.h"
+#include "animation_system.h"
 #include "collision.h"
 #include "aabb_provider.h"
 
@@ -40,17 +43,21 @@ public:
 	void Finalize();
 
 	void Update(double elapsed_time, const DirectX::XMFLOAT3& cameraFront);
-	void UpdateAnimationOnly(double elapsed_time);
 
 	void Draw(const DirectX::XMFLOAT3& cameraPosition);
+	void DebugDraw(); // ImGui (Inspector > Animation) : skinning method of the player asset, last events
+	void HandleAnimationEvents(); // Game_Update, every frame in both modes: the queue never fills up with stale events
 
 	const DirectX::XMFLOAT3& GetPosition() const { return m_Position; }
+	const ModelAsset* GetAsset() const { return m_Asset; }
 	void SetPosition(const DirectX::XMFLOAT3& pos) { m_Position = pos; }
 
 	AnimState GetState() const { return m_State; }
+	int GetFootstepCount() const { return m_FootstepCount; }
 	void SetState(AnimState state);
 
 	const AABB& GetAABB() const override { return m_WorldAABB; }
+	const AABB& GetPosedAABB() const { return m_HasPosedAABB ? m_PosedAABB : m_WorldAABB; } // follows the animation (culling, broad phase)
 
 	bool IsOnGround() const;
 
@@ -65,7 +72,8 @@ private:
 	bool m_IsFall = false;
 	bool m_IsMoving = false;
 
-	float m_MoveSpeed = 8.0f;
+	float m_MoveSpeed = 8.0f;    // airborne, or on the ground when the walk clip has no root motion
+	bool m_UseRootMotion = false;
 	float m_Gravity = 9.8f * 10.0f;
 	float m_JumpVelocity = 40.0f;
 
@@ -77,13 +85,16 @@ private:
 	float m_FallSpeedThredhold = -0.5f;
 
 	ModelAsset* m_Asset = nullptr;
-	AABB m_LocalAABB{};
+	AABB m_LocalAABB{};  // collision box, deliberately not animated
 	AABB m_WorldAABB{};
+	AABB m_PosedAABB{};  // world box of the current pose, from the per-bone bounds
+	bool m_HasPosedAABB = false;
+	SkinningPaletteBuffer m_SkinPalette; // own skinning CB, unchanged palettes are not uploaded again
 
 	void UpdateMovement(double elapsed_time, const DirectX::XMFLOAT3& cameraFront);
 	void UpdatePhysics(double elapsed_time);
-	void UpdateAnimation(double elapsed_time);
 	void UpdateAABB();
+	DirectX::XMMATRIX GetWorldMatrix() const;
 	void UpdateState();
 
 	void ChangeState(AnimState newState); // Status machine
@@ -92,14 +103,19 @@ private:
 	void ResetIfFallen(float killY, const DirectX::XMFLOAT3& respawnPos);
 
 	// for animation
-	AnimationPlayer* m_AnimPlayer = nullptr;
+	int m_AnimInstance = -1;                   // AnimationSystem instance, evaluated in AnimationSystem::Update
+	AnimationBlender* m_AnimBlender = nullptr; // crossfades between state clips (owned by the instance)
 	AnimState m_State = AnimState::Idle;
 
-	AnimationClip* m_ClipIdle = nullptr;
-	AnimationClip* m_ClipWalk = nullptr;
-	AnimationClip* m_ClipRun = nullptr;
-	AnimationClip* m_ClipJump = nullptr;
-	AnimationClip* m_ClipFall = nullptr;
+	// Loaded in the background (AnimationManager::LoadAsync), bind pose until they arrive
+	AnimationClipHandle m_ClipIdle;
+	AnimationClipHandle m_ClipWalk;
+	AnimationClipHandle m_ClipRun;
+	AnimationClipHandle m_ClipJump;
+	AnimationClipHandle m_ClipFall;
+
+	int m_FootstepCount = 0; // "footstep" events received (audio hook)
+	std::string m_LastEvent; // debug UI only
 };
 
 
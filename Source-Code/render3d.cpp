@@ -13,9 +13,14 @@
 //#include "player_camera.h"
 #include "camera_base.h"
 #include "light.h"
+#include "direct3d.h"
+#include "model_renderer.h"
 
 void Render3D_BeginFrame(const CameraBase& camera)
 {
 	// Update light manager
 	g_LightManager.BindAllLightsToPipeline();
+
+	// Model LOD choice for this camera
+	ModelRenderer_SetLodView(camera.GetProj(), Direct3D_GetBackBufferHeight());
 }
@@ -8,6 +8,7 @@
 ==============================================================================*/
 
 #include "scene_manager.h"
+#include "collision.h"
 
 #include <algorithm>
 #include <DirectXMath.h>
@@ -7,6 +7,8 @@
 
 ==============================================================================*/
 
+#include "shader_vertex_pack.hlsli"
+
 // 萔obt@
 
 static const uint MAX_BONES = 256;
@@ -35,8 +37,8 @@ cbuffer SkinningCB : register(b3)
 struct VS_IN
 {
     float4 posL : POSITION0; // local position
-    float3 normalL : NORMAL0; // local normal
-    float3 tangentL : TANGENT0;
+    float2 normalL : NORMAL0; // local normal, octahedral
+    float2 tangentL : TANGENT0; // octahedral
     float4 color : COLOR0;
     float2 uv : TEXCOORD0;
     
@@ -67,8 +69,8 @@ VS_OUT main(VS_IN vi)
     
     // [JԂ̒lURs[
     float4 localPos = vi.posL;
-    float3 localNormal = vi.normalL;
-    float3 localTangent = vi.tangentL;
+    float3 localNormal = OctDecode(vi.normalL);
+    float3 localTangent = OctDecode(vi.tangentL);
     
     float4 skinnedPos;
     float3 skinnedNormal;
@@ -114,8 +116,8 @@ VS_OUT main(VS_IN vi)
     else
     {
         skinnedPos = vi.posL;
-        skinnedNormal = vi.normalL;
-        skinnedTangent = vi.tangentL;
+        skinnedNormal = localNormal;
+        skinnedTangent = localTangent;
     }
 
     // WϊiXLjO̒_world/view.projցj
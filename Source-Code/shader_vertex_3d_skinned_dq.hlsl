@@ -0,0 +1,160 @@
+/*==============================================================================
+
+   Dual quaternion skinning vertex shader [shader_vertex_3d_skinned_dq.hlsl]
+
+   * vertex shader didn't do any light simulation *
+   * same inputs / outputs as shader_vertex_3d_skinned.hlsl (packed streams, vertex_pack_util.h) *
+
+==============================================================================*/
+
+#include "shader_vertex_pack.hlsli"
+
+// Constant buffers
+
+static const uint MAX_DQ_BONES = 512; // 2 float4 per bone, same 16KB as 256 float4x4 (uint8 indices reach the first 256)
+
+cbuffer VS_CONSTANT_BUFFER : register(b0)
+{
+    float4x4 world;
+};
+
+cbuffer VS_CONSTANT_BUFFER : register(b1)
+{
+    float4x4 view;
+};
+
+cbuffer VS_CONSTANT_BUFFER : register(b2)
+{
+    float4x4 proj;
+};
+
+// SkinDualQuat[] : boneDQ[2 * i] = real (rotation), boneDQ[2 * i + 1] = dual
+cbuffer SkinningCB : register(b3)
+{
+    float4 boneDQ[MAX_DQ_BONES * 2];
+};
+
+struct VS_IN
+{
+    float4 posL : POSITION0; // local position
+    float2 normalL : NORMAL0; // local normal, octahedral
+    float2 tangentL : TANGENT0; // octahedral
+    float4 color : COLOR0;
+    float2 uv : TEXCOORD0;
+
+    uint4 boneIndex : BLENDINDICES0;
+    float4 boneWeight : BLENDWEIGHT0;
+};
+
+
+struct VS_OUT
+{
+    float4 posH : SV_POSITION; // clip position
+    float4 posW : POSITION0; // world position
+    float4 normalW : NORMAL0; // world normal
+    float3 tangentW : TANGENT0;
+    float4 color : COLOR0;
+    float2 uv : TEXCOORD0;
+};
+
+float3 RotateByQuat(float3 v, float4 q)
+{
+    return v + 2.0f * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+
+//=============================================================================
+// Vertex shader
+//=============================================================================
+
+
+VS_OUT main(VS_IN vi)
+{
+    VS_OUT vo;
+
+    float3 localNormal = OctDecode(vi.normalL);
+    float3 localTangent = OctDecode(vi.tangentL);
+
+    float4 skinnedPos;
+    float3 skinnedNormal;
+    float3 skinnedTangent;
+
+    float weightSum = vi.boneWeight.x + vi.boneWeight.y + vi.boneWeight.z + vi.boneWeight.w;
+
+    float4 real = 0.0f;
+    float4 dual = 0.0f;
+    float4 pivot = 0.0f;
+    bool first = true;
+
+    if (weightSum > 0.0001f)
+    {
+        [unroll]
+        for (int i = 0; i < 4; ++i)
+        {
+            uint idx = vi.boneIndex[i];
+            float w = vi.boneWeight[i];
+
+            if (idx >= MAX_DQ_BONES)
+                continue;
+
+            if (w > 0.0f)
+            {
+                float4 r = boneDQ[idx * 2];
+                float4 d = boneDQ[idx * 2 + 1];
+
+                // q and -q are the same rotation: blend on the side of the first influence
+                if (first)
+                {
+                    pivot = r;
+                    first = false;
+                }
+                else if (dot(r, pivot) < 0.0f)
+                {
+                    w = -w;
+                }
+
+                real += r * w;
+                dual += d * w;
+            }
+        }
+    }
+
+    float len = length(real);
+
+    if (!first && len > 0.0f)
+    {
+        real /= len;
+        dual /= len;
+
+        float3 translation = 2.0f * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+
+        skinnedPos = float4(RotateByQuat(vi.posL.xyz, real) + translation, 1.0f);
+        skinnedNormal = normalize(RotateByQuat(localNormal, real));
+        skinnedTangent = normalize(RotateByQuat(localTangent, real));
+    }
+    else
+    {
+        skinnedPos = vi.posL;
+        skinnedNormal = localNormal;
+        skinnedTangent = localTangent;
+    }
+
+    // Skinned vertex to world / view / proj
+    float4 mtxW = mul(skinnedPos, world);
+    float4 mtxWV = mul(mtxW, view);
+    vo.posH = mul(mtxWV, proj);
+
+    float3 normalW = mul(float4(skinnedNormal, 0.0f), world).xyz;
+    normalW = normalize(normalW);
+    vo.normalW = float4(normalW, 0.0f);
+
+    float3 tangentW = mul(float4(skinnedTangent, 0.0f), world).xyz;
+    tangentW = normalize(tangentW);
+    vo.tangentW = tangentW;
+
+    vo.posW = mtxW;
+    vo.color = vi.color;
+    vo.uv = vi.uv;
+
+    return vo;
+}
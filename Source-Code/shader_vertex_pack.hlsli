@@ -0,0 +1,21 @@
+/*==============================================================================
+
+   Packed vertex stream decode [shader_vertex_pack.hlsli]
+
+   * included by the 3d vertex shaders that read VertexPacked (vertex_pack_util.h) *
+
+==============================================================================*/
+
+#ifndef SHADER_VERTEX_PACK_HLSLI
+#define SHADER_VERTEX_PACK_HLSLI
+
+// Octahedral normal (R16G16_SNORM, vertex_pack_util.h) -> unit vector
+float3 OctDecode(float2 e)
+{
+    float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy += (n.xy >= 0.0f) ? -t : t;
+    return normalize(n);
+}
+
+#endif // SHADER_VERTEX_PACK_HLSLI
@@ -175,19 +175,19 @@ static void DrawAnimatedSkeletonForAsset(const ModelAsset* asset, const Animatio
 	SkeletonUtil::BuildSkeletonClosure(scene, boneNames, skelSet);
 	if (skelSet.empty()) return;
 
-	// 3. Get pose from AnimationPlayer
-	std::unordered_map<const aiNode*, XMMATRIX> nodeWorlds;
-	player->GetCurrentPose(nodeWorlds);
+	// 3. Get pose from AnimationPlayer (indexed by SkeletonRuntime node)
+	const SkeletonRuntime& skel = asset->skeleton;
+	const PoseView nodeModel = player->GetCurrentPose();
+	if (nodeModel.Size() != skel.NodeCount()) return;
 
 	const XMMATRIX finalWorld = asset->importFix * world;
 
 	// 4. Draw joints and bones
-	for (const aiNode* n : skelSet)
+	for (int i = 0; i < skel.NodeCount(); ++i)
 	{
-		auto itW = nodeWorlds.find(n);
-		if (itW == nodeWorlds.end()) continue;
+		if (!skelSet.count(skel.nodes[i])) continue;
 
-		XMMATRIX jointWorld = itW->second * finalWorld;
+		XMMATRIX jointWorld = nodeModel[i] * finalWorld;
 
 		XMFLOAT4X4 m;
 		XMStoreFloat4x4(&m, jointWorld);
@@ -197,20 +197,16 @@ static void DrawAnimatedSkeletonForAsset(const ModelAsset* asset, const Animatio
 		Draw3d_MakeCross(jointPos, g_settings.jointSize, g_settings.jointColor);
 
 		// Draw Bone
-		const aiNode* parent = n->mParent;
-		if (parent && skelSet.count(parent))
+		const int parent = skel.parentIndex[i];
+		if (parent >= 0 && skelSet.count(skel.nodes[parent]))
 		{
-			auto itPW = nodeWorlds.find(parent);
-			if (itPW != nodeWorlds.end())
-			{
-				XMMATRIX parentWorld = itPW->second * finalWorld;
+			XMMATRIX parentWorld = nodeModel[parent] * finalWorld;
 
-				XMFLOAT4X4 mp;
-				XMStoreFloat4x4(&mp, parentWorld);
-				XMFLOAT3 parentPos(mp._41, mp._42, mp._43);
+			XMFLOAT4X4 mp;
+			XMStoreFloat4x4(&mp, parentWorld);
+			XMFLOAT3 parentPos(mp._41, mp._42, mp._43);
 
-				Draw3d_MakeLine(parentPos, jointPos, g_settings.boneColor);
-			}
+			Draw3d_MakeLine(parentPos, jointPos, g_settings.boneColor);
 		}
 	}
 }
@@ -0,0 +1,80 @@
+/*==============================================================================
+
+   Flat skeleton data for runtime [skeleton_runtime.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "skeleton_runtime.h"
+
+using namespace DirectX;
+
+
+int SkeletonRuntime::FindNodeIndex(const aiNode* node) const
+{
+	auto it = nodeToIndex.find(node);
+	return (it != nodeToIndex.end()) ? it->second : -1;
+}
+
+int SkeletonRuntime::FindNodeIndexByName(const std::string& name) const
+{
+	for (int i = 0; i < NodeCount(); ++i)
+	{
+		if (names[i] == name) return i;
+	}
+
+	return -1;
+}
+
+int SkeletonRuntime_AddNode(SkeletonRuntime& skel, const aiNode* node, const char* name, int parent, const XMFLOAT4X4& bindLocal)
+{
+	const int index = skel.NodeCount();
+
+	skel.nodes.push_back(node);
+	skel.names.push_back(name ? name : "");
+	skel.parentIndex.push_back(parent);
+	skel.depth.push_back(parent >= 0 ? skel.depth[parent] + 1 : 0);
+	skel.bindLocal.push_back(bindLocal);
+	if (node) skel.nodeToIndex.emplace(node, index);
+
+	XMVECTOR s, r, t;
+	if (!XMMatrixDecompose(&s, &r, &t, XMLoadFloat4x4(&bindLocal)))
+	{
+		s = XMVectorSplatOne();
+		r = XMQuaternionIdentity();
+		t = XMVectorZero();
+	}
+
+	XMFLOAT3 fs, ft;
+	XMFLOAT4 fr;
+	XMStoreFloat3(&fs, s);
+	XMStoreFloat4(&fr, r);
+	XMStoreFloat3(&ft, t);
+
+	skel.bindT.push_back(ft);
+	skel.bindR.push_back(fr);
+	skel.bindS.push_back(fs);
+
+	return index;
+}
+
+namespace SkeletonUtil
+{
+	const char* GetShortName(const char* fullName)
+	{
+		if (!fullName) return "";
+
+		const char* last = fullName;
+		for (const char* p = fullName; *p; ++p)
+		{
+			if (*p == '|' || *p == ':' || *p == '/' || *p == '\\')
+			{
+				last = p + 1;
+			}
+		}
+
+		return last;
+	}
+}
@@ -0,0 +1,70 @@
+/*==============================================================================
+
+   Flat skeleton data for runtime [skeleton_runtime.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef SKELETON_RUNTIME_H
+#define SKELETON_RUNTIME_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <DirectXMath.h>
+
+struct aiNode;
+struct aiScene;
+
+// aiNode tree flattened once at load time
+// nodes[] is parent-ordered: parentIndex[i] < i for every node except the root
+// The frame path matches names[], never aiNode: a skeleton read from a cooked file
+// without a scene (headless tools) has nullptr nodes
+struct SkeletonRuntime
+{
+	std::vector<const aiNode*> nodes;
+	std::vector<std::string> names;              // aiNode::mName
+	std::vector<int> parentIndex;                // -1 for root node
+	std::vector<int> depth;                      // 0 for root node (animation LOD bone reduction)
+	std::vector<DirectX::XMFLOAT4X4> bindLocal;  // aiNode::mTransformation
+
+	// bindLocal decomposed, for blending nodes that a clip does not animate
+	std::vector<DirectX::XMFLOAT3> bindT;
+	std::vector<DirectX::XMFLOAT4> bindR;
+	std::vector<DirectX::XMFLOAT3> bindS;
+
+	// Bone index (ModelAsset::boneNameToIndex) -> node index
+	std::vector<int> boneToNode;                 // -1 if the bone has no node
+	std::vector<DirectX::XMFLOAT4X4> boneOffset; // aiBone::mOffsetMatrix
+
+	// Load-time lookup only, never use it on the frame path
+	std::unordered_map<const aiNode*, int> nodeToIndex;
+
+	int NodeCount() const { return static_cast<int>(parentIndex.size()); }
+	int BoneCount() const { return static_cast<int>(boneToNode.size()); }
+
+	int FindNodeIndex(const aiNode* node) const;
+	int FindNodeIndexByName(const std::string& name) const; // full name, load time only
+};
+
+// Appends one node after its parent, bindLocal is decomposed into bindT / R / S
+// node may be nullptr (cooked skeleton without a scene)
+int SkeletonRuntime_AddNode(SkeletonRuntime& skel, const aiNode* node, const char* name, int parent, const DirectX::XMFLOAT4X4& bindLocal);
+
+// From an imported (or cooked shell) scene, skeleton_runtime_import.cpp
+void SkeletonRuntime_Build(
+	const aiScene* scene,
+	const std::unordered_map<std::string, int>& boneNameToIndex,
+	SkeletonRuntime& out
+);
+
+namespace SkeletonUtil
+{
+	// "Armature|mixamorig:Hips" -> "Hips" : name after the last '|', ':', '/' or '\'
+	// Track binding, retargeting and bone masks all match short names with this
+	const char* GetShortName(const char* fullName);
+}
+
+#endif // SKELETON_RUNTIME_H
@@ -0,0 +1,107 @@
+/*==============================================================================
+
+   Flat skeleton from an assimp scene [skeleton_runtime_import.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   The assimp side of skeleton_runtime.cpp, kept apart so the runtime tables
+   build without assimp headers
+
+==============================================================================*/
+
+#include "skeleton_runtime.h"
+#include "skeleton_util.h"
+
+#include "assimp/scene.h"
+
+using namespace DirectX;
+
+static XMFLOAT4X4 AiMatToFloat4x4(const aiMatrix4x4& m);
+static void FlattenNodeRecursive(const aiNode* node, int parent, SkeletonRuntime& out);
+
+
+void SkeletonRuntime_Build(
+	const aiScene* scene,
+	const std::unordered_map<std::string, int>& boneNameToIndex,
+	SkeletonRuntime& out
+)
+{
+	out = SkeletonRuntime();
+
+	if (!scene || !scene->mRootNode) return;
+
+	// 1. Flatten aiNode tree (pre-order, parent always comes first)
+	FlattenNodeRecursive(scene->mRootNode, -1, out);
+
+	// 2. Bone index -> node index
+	out.boneToNode.assign(boneNameToIndex.size(), -1);
+	out.boneOffset.resize(boneNameToIndex.size());
+
+	for (XMFLOAT4X4& m : out.boneOffset)
+	{
+		XMStoreFloat4x4(&m, XMMatrixIdentity());
+	}
+
+	SkeletonUtil::NameToNodeMap name2node;
+	SkeletonUtil::BuildNameToNodeMap(scene->mRootNode, name2node);
+
+	for (const auto& kv : boneNameToIndex)
+	{
+		const int boneIndex = kv.second;
+		if (boneIndex < 0 || boneIndex >= out.BoneCount()) continue;
+
+		auto it = name2node.find(kv.first);
+		if (it == name2node.end()) continue;
+
+		out.boneToNode[boneIndex] = out.FindNodeIndex(it->second);
+	}
+
+	// 3. Offset matrices (first aiBone found with that name wins)
+	std::vector<bool> offsetSet(boneNameToIndex.size(), false);
+
+	for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+	{
+		const aiMesh* mesh = scene->mMeshes[m];
+		if (!mesh || mesh->mNumBones == 0) continue;
+
+		for (unsigned int b = 0; b < mesh->mNumBones; ++b)
+		{
+			const aiBone* bone = mesh->mBones[b];
+			if (!bone) continue;
+
+			auto it = boneNameToIndex.find(bone->mName.C_Str());
+			if (it == boneNameToIndex.end()) continue;
+
+			const int boneIndex = it->second;
+			if (boneIndex < 0 || boneIndex >= out.BoneCount() || offsetSet[boneIndex]) continue;
+
+			out.boneOffset[boneIndex] = AiMatToFloat4x4(bone->mOffsetMatrix);
+			offsetSet[boneIndex] = true;
+		}
+	}
+}
+
+static XMFLOAT4X4 AiMatToFloat4x4(const aiMatrix4x4& m)
+{
+	XMFLOAT4X4 out;
+	XMStoreFloat4x4(&out, XMMATRIX(
+		m.a1, m.b1, m.c1, m.d1,
+		m.a2, m.b2, m.c2, m.d2,
+		m.a3, m.b3, m.c3, m.d3,
+		m.a4, m.b4, m.c4, m.d4
+	));
+	return out;
+}
+
+static void FlattenNodeRecursive(const aiNode* node, int parent, SkeletonRuntime& out)
+{
+	if (!node) return;
+
+	const int index = SkeletonRuntime_AddNode(out, node, node->mName.C_Str(), parent, AiMatToFloat4x4(node->mTransformation));
+
+	for (unsigned int i = 0; i < node->mNumChildren; ++i)
+	{
+		FlattenNodeRecursive(node->mChildren[i], index, out);
+	}
+}
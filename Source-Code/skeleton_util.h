@@ -17,6 +17,7 @@
 #include <string>
 #include <DirectXMath.h>
 
+#include "assimp/scene.h"
 #include "model_asset.h"
 
 namespace SkeletonUtil
@@ -38,6 +39,8 @@ namespace SkeletonUtil
 	const aiNode* FindNodeByName(const aiScene* scene, const std::string& name);
 
 	void BuildBoneNameToIndexTable(const aiScene* scene, std::unordered_map<std::string, int>& outMap);
+
+	// GetShortName : skeleton_runtime.h (no assimp needed)
 }
 
 
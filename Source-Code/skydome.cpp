@@ -42,10 +42,7 @@ void Skydome_Draw()
 {
 	Direct3D_BeginSkydome();
 
-	for (uint32_t mi = 0; mi < (uint32_t)g_pModelSky->meshes.size(); ++mi)
-	{
-		ModelRenderer_UnlitDraw(g_pModelSky, mi, XMMatrixTranslationFromVector(XMLoadFloat3(&g_Position)), { 1.0f, 1.0f, 1.0f, 1.0f });
-	}
+	ModelRenderer_UnlitDrawAsset(g_pModelSky, XMMatrixTranslationFromVector(XMLoadFloat3(&g_Position)), { 1.0f, 1.0f, 1.0f, 1.0f });
 
 	Direct3D_EndSkydome();
 }
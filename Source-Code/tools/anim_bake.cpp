@@ -0,0 +1,262 @@
+/*==============================================================================
+
+   Headless crowd clip baker [anim_bake.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   Not part of the game project, no GPU or Windows API needed (DirectXMath Inc
+   and a sal.h on the include path, see skinning_test.cpp):
+
+     g++ -std=c++14 -O2 -msse4.1 -I.. -I<DirectXMath>/Inc -I<sal.h dir> \
+         anim_bake.cpp bench_rig.cpp ../animation_bake.cpp ../animation_skinning.cpp \
+         ../animation_skinning_mesh.cpp ../animation.cpp ../animation_sampler.cpp ../animation_compression.cpp \
+         ../animation_retarget.cpp ../animation_cook.cpp ../animation_root_motion.cpp \
+         ../skeleton_runtime.cpp ../mapped_file_util.cpp ../worker_pool_util.cpp \
+         ../axis_util.cpp -pthread -o anim_bake
+     ./anim_bake [--rate 30] [--positions] [--out dir] [--rig mannequin.meshcache] [clip.anim ...]
+
+   The only place the crowd clips are baked, the game just loads the results:
+   ├─ clip.anim -> clip.vat next to it (the path BakedCrowd looks for,
+   │               e.g. resources/Animation/Idle.anim -> Idle.vat)
+   ├─ --positions : VertexPositions bake, needs --rig (skinned vertices of the .meshcache)
+   └─ every .vat is loaded back and each frame compared with the player's own
+      palette (or CPU skinned positions) at that time
+   Without --rig / clips : the mannequin.FBX hierarchy and generated clips
+   (bench_rig.h), written to --out (current directory by default).
+   Exit code 1 when a bake fails, does not load back or differs by more than
+   --max-diff (or a file cannot be read).
+
+==============================================================================*/
+
+#include "bench_rig.h"
+#include "model_asset.h"
+#include "animation.h"
+#include "animation_bake.h"
+#include "animation_skinning.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+
+// Generated clips, lengths of the BakedCrowd clips
+struct GeneratedClip
+{
+	const char* name;
+	double seconds;
+};
+
+static const GeneratedClip GENERATED_CLIPS[] =
+{
+	{ "Idle", 2.7 },
+	{ "Sad_Idle", 3.3 },
+};
+
+static bool BakeClip(const ModelAsset& asset, const AnimationClip* clip, const AnimationBakeSettings& settings, const std::string& bakedPath, float maxDiff);
+static float MaxBakeDiff(const ModelAsset& asset, const AnimationClip* clip, const BakedAnimation& baked);
+
+
+int main(int argc, char** argv)
+{
+	AnimationBakeSettings settings;
+	float maxDiff = 1.0e-4f;
+	const char* outDir = nullptr;
+	const char* rigPath = nullptr;
+	std::vector<const char*> clipPaths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+		{
+			settings.sampleRate = atof(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--positions") == 0)
+		{
+			settings.layout = BakedAnimationLayout::VertexPositions;
+			continue;
+		}
+		if (strcmp(argv[i], "--max-diff") == 0 && i + 1 < argc)
+		{
+			maxDiff = static_cast<float>(atof(argv[++i]));
+			continue;
+		}
+		if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+		{
+			outDir = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--rig") == 0 && i + 1 < argc)
+		{
+			rigPath = argv[++i];
+			continue;
+		}
+		if (argv[i][0] == '-')
+		{
+			printf("usage: anim_bake [--rate fps] [--positions] [--max-diff value] [--out dir] [--rig file.meshcache] [clip.anim ...]\n");
+			return 1;
+		}
+
+		clipPaths.push_back(argv[i]);
+	}
+
+	if (!(settings.sampleRate > 0.0))
+	{
+		printf("--rate : must be above 0\n");
+		return 1;
+	}
+
+	ModelAsset asset;
+	if (rigPath)
+	{
+		if (!BenchRig_LoadMeshCache(rigPath, asset))
+		{
+			printf("%s : cannot read\n", rigPath);
+			return 1;
+		}
+	}
+	else
+	{
+		BenchRig_BuildMannequin(asset);
+	}
+
+	printf("rig %s : %d nodes, %d bones, %s at %.1f fps\n",
+		rigPath ? rigPath : "(generated mannequin)", asset.skeleton.NodeCount(), asset.skeleton.BoneCount(),
+		settings.layout == BakedAnimationLayout::BonePalette ? "bone palettes" : "vertex positions", settings.sampleRate);
+
+	bool ok = true;
+
+	for (const char* path : clipPaths)
+	{
+		AnimationClip* clip = BenchRig_LoadClip(path, asset);
+		if (!clip)
+		{
+			printf("%s : cannot read\n", path);
+			ok = false;
+			continue;
+		}
+
+		ok = BakeClip(asset, clip, settings, AnimationBake_GetBakedPath(path), maxDiff) && ok;
+		Animation_DestroyClip(clip);
+	}
+
+	if (clipPaths.empty())
+	{
+		uint32_t seed = 1;
+		for (const GeneratedClip& g : GENERATED_CLIPS)
+		{
+			std::string bakedPath = outDir ? std::string(outDir) + "/" : std::string();
+			bakedPath += std::string(g.name) + ".vat";
+
+			AnimationClip* clip = BenchRig_MakeClip(asset, g.name, g.seconds, seed++);
+			clip->loop = true;
+
+			ok = BakeClip(asset, clip, settings, bakedPath, maxDiff) && ok;
+			Animation_DestroyClip(clip);
+		}
+	}
+
+	AnimationManager::Instance().ReleaseBindings(&asset);
+
+	return ok ? 0 : 1;
+}
+
+static bool BakeClip(const ModelAsset& asset, const AnimationClip* clip, const AnimationBakeSettings& settings, const std::string& bakedPath, float maxDiff)
+{
+	AnimationBakeReport report;
+
+	const auto start = std::chrono::steady_clock::now();
+	const bool written = AnimationBake_Write(&asset, clip, settings, bakedPath.c_str(), &report);
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (!written)
+	{
+		printf("%s : bake failed%s\n", bakedPath.c_str(),
+			settings.layout == BakedAnimationLayout::VertexPositions ? " (no skinned vertices, --rig needed)" : "");
+		return false;
+	}
+
+	BakedAnimation* baked = AnimationBake_Load(bakedPath.c_str());
+	if (!baked)
+	{
+		printf("%s : written but does not load back\n", bakedPath.c_str());
+		return false;
+	}
+
+	const float diff = MaxBakeDiff(asset, clip, *baked);
+	AnimationBake_Destroy(baked);
+
+	printf("%s : %d frames x %d texels, %.1f KB, %.2f ms, max diff %.6f\n", bakedPath.c_str(),
+		report.frameCount, report.texelsPerFrame, report.fileBytes / 1024.0, ms, diff);
+
+	if (diff > maxDiff)
+	{
+		printf("  MISMATCH (above %.6f)\n", maxDiff);
+		return false;
+	}
+
+	return true;
+}
+
+// Every frame of the bake against the player at the same time, the way AnimationBake_Write samples it
+static float MaxBakeDiff(const ModelAsset& asset, const AnimationClip* clip, const BakedAnimation& baked)
+{
+	AnimationPlayer player;
+	std::vector<XMFLOAT4X4> palette;
+	std::vector<XMFLOAT3> positions, normals;
+
+	float maxDiff = 0.0f;
+
+	for (int f = 0; f < baked.frameCount; ++f)
+	{
+		double timeSec = f / baked.sampleRate;
+		if (timeSec >= baked.durationSec) timeSec = baked.durationSec * (1.0 - 1.0e-9);
+
+		player.Play(clip, &asset, clip->loop, timeSec);
+		player.ComputeSkinMatrices(palette);
+
+		if (baked.layout == BakedAnimationLayout::BonePalette)
+		{
+			if (static_cast<int>(palette.size()) != baked.boneCount) return INFINITY;
+
+			const XMFLOAT4X4* frame = AnimationBake_GetPaletteFrame(baked, f);
+			for (int b = 0; b < baked.boneCount; ++b)
+			{
+				for (int r = 0; r < 4; ++r)
+				{
+					for (int c = 0; c < 4; ++c)
+					{
+						maxDiff = std::max(maxDiff, fabsf(frame[b].m[r][c] - palette[b].m[r][c]));
+					}
+				}
+			}
+		}
+		else
+		{
+			const XMFLOAT4* frame = AnimationBake_GetPositionFrame(baked, f);
+			for (const BakedMeshRange& range : baked.meshes)
+			{
+				if (range.meshIndex >= static_cast<int>(asset.meshes.size())) return INFINITY;
+
+				AnimationSkinning_SkinMesh(asset.meshes[range.meshIndex], palette, positions, normals);
+
+				for (int v = 0; v < range.vertexCount; ++v)
+				{
+					const XMFLOAT4& t = frame[range.firstTexel + v];
+					maxDiff = std::max(maxDiff, fabsf(t.x - positions[v].x));
+					maxDiff = std::max(maxDiff, fabsf(t.y - positions[v].y));
+					maxDiff = std::max(maxDiff, fabsf(t.z - positions[v].z));
+				}
+			}
+		}
+	}
+
+	return maxDiff;
+}
@@ -0,0 +1,352 @@
+/*==============================================================================
+
+   Rig and clips of the headless animation tools [bench_rig.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "bench_rig.h"
+
+#include "model_cook_format.h"
+#include "model_asset.h"
+#include "animation.h"
+#include "animation_cook.h"
+#include "axis_util.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+
+static const double BENCH_CLIP_FPS = 30.0;  // ticks per second and key rate of BenchRig_MakeClip
+static const float BENCH_CLIP_SWING = 0.35f; // largest rotation of a generated key around the bind pose (radians)
+
+// player.cpp loads mannequin.FBX Z up at 0.04
+static const bool MANNEQUIN_YUP = false;
+static const float MANNEQUIN_SCALE = 0.04f;
+
+static bool ReadFile(const char* path, std::vector<uint8_t>& outBytes);
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t size);
+static XMFLOAT4X4 FileMatToFloat4x4(const float* m);
+static void SetImportSettings(ModelAsset& out, bool yUp, float scale);
+static void AddMannequinNode(ModelAsset& out, const char* name, const char* parent, float x, float y, float z);
+static void AddMannequinArm(ModelAsset& out, const char* side, float sign);
+static void AddMannequinLeg(ModelAsset& out, const char* side, float sign);
+static void BindEveryNodeAsBone(ModelAsset& out);
+
+
+bool BenchRig_LoadMeshCache(const char* path, ModelAsset& out)
+{
+	std::vector<uint8_t> bytes;
+	if (!ReadFile(path, bytes) || bytes.size() < sizeof(MeshFileHeader)) return false;
+
+	const uint8_t* base = bytes.data();
+	const uint64_t size = bytes.size();
+
+	MeshFileHeader header;
+	memcpy(&header, base, sizeof(header));
+
+	if (header.magic != MESH_FILE_MAGIC || header.version != MESH_FILE_VERSION ||
+		!InFile(sizeof(MeshFileHeader), static_cast<uint64_t>(header.meshCount) * sizeof(MeshFileMesh), size) ||
+		!InFile(header.bonesOffset, static_cast<uint64_t>(header.boneCount) * sizeof(MeshFileBone), size) ||
+		!InFile(header.nodesOffset, static_cast<uint64_t>(header.nodeCount) * sizeof(MeshFileNode), size) ||
+		header.nodeCount == 0)
+	{
+		return false;
+	}
+
+	SetImportSettings(out, header.yUp != 0, header.importScale);
+
+	// 1. Nodes, already pre-order with the parent first (ModelCook)
+	out.skeleton = SkeletonRuntime();
+	for (uint32_t i = 0; i < header.nodeCount; ++i)
+	{
+		MeshFileNode fn;
+		memcpy(&fn, base + header.nodesOffset + i * sizeof(MeshFileNode), sizeof(fn));
+
+		if (!InFile(fn.nameOffset, fn.nameLength, size) || fn.parent >= static_cast<int32_t>(i)) return false;
+
+		const std::string name(reinterpret_cast<const char*>(base + fn.nameOffset), fn.nameLength);
+		SkeletonRuntime_AddNode(out.skeleton, nullptr, name.c_str(), fn.parent, FileMatToFloat4x4(fn.transform));
+	}
+
+	// 2. Bone indices in first appearance order over the meshes, like ModelAsset_Load,
+	//    skinned meshes keep their CPU vertex copy (VertexPositions bakes, CPU skinning)
+	out.boneNameToIndex.clear();
+	out.meshes.assign(header.meshCount, MeshAsset());
+	std::vector<XMFLOAT4X4> offsets;
+
+	for (uint32_t m = 0; m < header.meshCount; ++m)
+	{
+		MeshFileMesh fm;
+		memcpy(&fm, base + sizeof(MeshFileHeader) + m * sizeof(MeshFileMesh), sizeof(fm));
+
+		if (static_cast<uint64_t>(fm.boneFirst) + fm.boneCount > header.boneCount) return false;
+
+		MeshAsset& mesh = out.meshes[m];
+		mesh.layout = static_cast<VertexLayout>(fm.layout);
+		mesh.skinned = (mesh.layout == VertexLayout::Skinned);
+		mesh.vertexCount = fm.vertexCount;
+		mesh.indexCount = fm.indexCount;
+		mesh.materialIndex = fm.materialIndex;
+
+		if (mesh.skinned)
+		{
+			if (!InFile(fm.vertexOffset, static_cast<uint64_t>(fm.vertexCount) * sizeof(Vertex3d), size)) return false;
+
+			const Vertex3d* vertices = reinterpret_cast<const Vertex3d*>(base + fm.vertexOffset);
+			mesh.cpuVertices.assign(vertices, vertices + fm.vertexCount);
+		}
+
+		for (uint32_t b = fm.boneFirst; b < fm.boneFirst + fm.boneCount; ++b)
+		{
+			MeshFileBone fb;
+			memcpy(&fb, base + header.bonesOffset + b * sizeof(MeshFileBone), sizeof(fb));
+
+			if (!InFile(fb.nameOffset, fb.nameLength, size)) return false;
+
+			const std::string name(reinterpret_cast<const char*>(base + fb.nameOffset), fb.nameLength);
+			if (out.boneNameToIndex.count(name)) continue; // first aiBone with that name wins
+
+			out.boneNameToIndex.emplace(name, static_cast<int>(offsets.size()));
+			offsets.push_back(FileMatToFloat4x4(fb.offsetMatrix));
+		}
+	}
+
+	// 3. Bone -> node by name
+	SkeletonRuntime& skel = out.skeleton;
+	skel.boneOffset = offsets;
+	skel.boneToNode.assign(offsets.size(), -1);
+	for (const auto& kv : out.boneNameToIndex)
+	{
+		skel.boneToNode[kv.second] = skel.FindNodeIndexByName(kv.first);
+	}
+
+	return true;
+}
+
+void BenchRig_BuildMannequin(ModelAsset& out)
+{
+	SetImportSettings(out, MANNEQUIN_YUP, MANNEQUIN_SCALE);
+	out.skeleton = SkeletonRuntime();
+	out.boneNameToIndex.clear();
+
+	// Centimetres, Z up, node names of mannequin.FBX
+	AddMannequinNode(out, "RootNode", nullptr, 0.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, "root", "RootNode", 0.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, "pelvis", "root", 0.0f, 1.0f, 96.0f);
+	AddMannequinNode(out, "spine_01", "pelvis", 0.0f, 0.0f, 8.0f);
+	AddMannequinNode(out, "spine_02", "spine_01", 0.0f, 0.0f, 9.0f);
+	AddMannequinNode(out, "spine_03", "spine_02", 0.0f, 0.0f, 9.0f);
+	AddMannequinNode(out, "spine_04", "spine_03", 0.0f, 0.0f, 9.0f);
+	AddMannequinNode(out, "spine_05", "spine_04", 0.0f, 0.0f, 10.0f);
+	AddMannequinNode(out, "neck_01", "spine_05", 0.0f, -2.0f, 12.0f);
+	AddMannequinNode(out, "neck_02", "neck_01", 0.0f, 0.0f, 5.0f);
+	AddMannequinNode(out, "head", "neck_02", 0.0f, 0.0f, 6.0f);
+
+	AddMannequinArm(out, "l", 1.0f);
+	AddMannequinArm(out, "r", -1.0f);
+	AddMannequinLeg(out, "l", 1.0f);
+	AddMannequinLeg(out, "r", -1.0f);
+
+	AddMannequinNode(out, "ik_foot_root", "root", 0.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, "ik_foot_l", "ik_foot_root", 9.0f, 0.0f, 8.0f);
+	AddMannequinNode(out, "ik_foot_r", "ik_foot_root", -9.0f, 0.0f, 8.0f);
+	AddMannequinNode(out, "ik_hand_root", "root", 0.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, "ik_hand_gun", "ik_hand_root", -56.0f, 5.0f, 110.0f);
+	AddMannequinNode(out, "ik_hand_l", "ik_hand_gun", 112.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, "ik_hand_r", "ik_hand_gun", 0.0f, 0.0f, 0.0f);
+
+	BindEveryNodeAsBone(out);
+}
+
+AnimationClip* BenchRig_LoadClip(const char* animPath, const ModelAsset& asset)
+{
+	// Tools have no source file to hash against
+	return AnimationCook_Load(animPath, 0, false, &asset);
+}
+
+AnimationClip* BenchRig_MakeClip(const ModelAsset& asset, const char* name, double seconds, uint32_t seed)
+{
+	const SkeletonRuntime& skel = asset.skeleton;
+	const int frameCount = static_cast<int>(seconds * BENCH_CLIP_FPS) + 1;
+
+	AnimationClip* clip = new AnimationClip();
+	clip->animName = name ? name : "";
+	clip->ticksPerSecond = BENCH_CLIP_FPS;
+	clip->duration = static_cast<double>(frameCount - 1);
+	clip->SourceYup = asset.sourceYup;
+
+	uint32_t state = seed ? seed : 1u;
+	auto next01 = [&state]()
+	{
+		state = state * 1664525u + 1013904223u;
+		return static_cast<float>(state >> 8) / 16777216.0f;
+	};
+
+	// Every node but the scene root keyed on every frame, all three channels, the way
+	// the FBX bakes arrive from assimp
+	for (int n = 1; n < skel.NodeCount(); ++n)
+	{
+		BoneAnimTrack track;
+		track.nodeName = skel.names[n];
+		track.node = skel.nodes[n];
+
+		const XMVECTOR bindR = XMLoadFloat4(&skel.bindR[n]);
+		const float phase = next01() * XM_2PI;
+		const float swing = next01() * BENCH_CLIP_SWING;
+		const float lift = (n == 2) ? 4.0f : 0.0f; // pelvis bounces
+
+		for (int f = 0; f < frameCount; ++f)
+		{
+			const double t = static_cast<double>(f);
+			const float w = XM_2PI * static_cast<float>(t / clip->duration) + phase;
+
+			VectorKey pos;
+			pos.time = t;
+			pos.value = skel.bindT[n];
+			pos.value.z += lift * sinf(2.0f * w);
+			track.positionKeys.push_back(pos);
+
+			QuatKey rot;
+			rot.time = t;
+			XMStoreFloat4(&rot.value, XMQuaternionMultiply(XMQuaternionRotationRollPitchYaw(swing * sinf(w), 0.5f * swing * cosf(w), 0.0f), bindR));
+			track.rotationKeys.push_back(rot);
+
+			VectorKey scl;
+			scl.time = t;
+			scl.value = skel.bindS[n];
+			track.scaleKeys.push_back(scl);
+		}
+
+		track.endTime = clip->duration;
+		clip->tracks.push_back(track);
+	}
+
+	return clip;
+}
+
+static bool ReadFile(const char* path, std::vector<uint8_t>& outBytes)
+{
+	std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+	if (!ifs) return false;
+
+	const std::streamsize size = ifs.tellg();
+	if (size <= 0) return false;
+
+	outBytes.resize(static_cast<size_t>(size));
+	ifs.seekg(0, std::ios::beg);
+	return static_cast<bool>(ifs.read(reinterpret_cast<char*>(outBytes.data()), size));
+}
+
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t size)
+{
+	return offset <= size && bytes <= size - offset;
+}
+
+// aiMatrix4x4 a1..d4 -> row vector convention (same as AiMatToFloat4x4)
+static XMFLOAT4X4 FileMatToFloat4x4(const float* m)
+{
+	XMFLOAT4X4 out;
+	XMStoreFloat4x4(&out, XMMATRIX(
+		m[0], m[4], m[8], m[12],
+		m[1], m[5], m[9], m[13],
+		m[2], m[6], m[10], m[14],
+		m[3], m[7], m[11], m[15]
+	));
+	return out;
+}
+
+static void SetImportSettings(ModelAsset& out, bool yUp, float scale)
+{
+	out.sourceYup = yUp;
+	out.importScale = scale;
+
+	const XMMATRIX axisFix = GetAxisConversion(UpFromBool(yUp), UpAxis::Y_Up);
+	out.importFix = XMMatrixScaling(scale, scale, scale) * axisFix;
+}
+
+static void AddMannequinNode(ModelAsset& out, const char* name, const char* parent, float x, float y, float z)
+{
+	const int parentIndex = parent ? out.skeleton.FindNodeIndexByName(parent) : -1;
+
+	XMFLOAT4X4 bindLocal;
+	XMStoreFloat4x4(&bindLocal, XMMatrixTranslation(x, y, z));
+
+	SkeletonRuntime_AddNode(out.skeleton, nullptr, name, parentIndex, bindLocal);
+}
+
+static void AddMannequinArm(ModelAsset& out, const char* side, float sign)
+{
+	auto n = [side](const char* bone) { return std::string(bone) + "_" + side; };
+
+	AddMannequinNode(out, n("clavicle").c_str(), "spine_05", sign * 3.0f, -1.0f, 9.0f);
+	AddMannequinNode(out, n("upperarm").c_str(), n("clavicle").c_str(), sign * 15.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, n("upperarm_twist_01").c_str(), n("upperarm").c_str(), sign * 7.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, n("upperarm_twist_02").c_str(), n("upperarm").c_str(), sign * 14.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, n("lowerarm").c_str(), n("upperarm").c_str(), sign * 28.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, n("lowerarm_twist_01").c_str(), n("lowerarm").c_str(), sign * 13.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, n("lowerarm_twist_02").c_str(), n("lowerarm").c_str(), sign * 6.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, n("hand").c_str(), n("lowerarm").c_str(), sign * 26.0f, 0.0f, 0.0f);
+
+	AddMannequinNode(out, n("thumb_01").c_str(), n("hand").c_str(), sign * 3.0f, -3.0f, -1.0f);
+	AddMannequinNode(out, n("thumb_02").c_str(), n("thumb_01").c_str(), sign * 4.0f, 0.0f, 0.0f);
+	AddMannequinNode(out, n("thumb_03").c_str(), n("thumb_02").c_str(), sign * 3.0f, 0.0f, 0.0f);
+
+	static const char* const fingers[] = { "index", "middle", "ring", "pinky" };
+	for (int f = 0; f < 4; ++f)
+	{
+		const std::string finger = fingers[f];
+		const float spread = static_cast<float>(f) * 2.0f - 3.0f;
+
+		AddMannequinNode(out, n((finger + "_metacarpal").c_str()).c_str(), n("hand").c_str(), sign * 3.5f, spread, 0.0f);
+		AddMannequinNode(out, n((finger + "_01").c_str()).c_str(), n((finger + "_metacarpal").c_str()).c_str(), sign * 6.0f, 0.0f, 0.0f);
+		AddMannequinNode(out, n((finger + "_02").c_str()).c_str(), n((finger + "_01").c_str()).c_str(), sign * 4.0f, 0.0f, 0.0f);
+		AddMannequinNode(out, n((finger + "_03").c_str()).c_str(), n((finger + "_02").c_str()).c_str(), sign * 3.0f, 0.0f, 0.0f);
+	}
+}
+
+static void AddMannequinLeg(ModelAsset& out, const char* side, float sign)
+{
+	auto n = [side](const char* bone) { return std::string(bone) + "_" + side; };
+
+	AddMannequinNode(out, n("thigh").c_str(), "pelvis", sign * 9.0f, 0.0f, -2.0f);
+	AddMannequinNode(out, n("thigh_twist_01").c_str(), n("thigh").c_str(), 0.0f, 0.0f, -22.0f);
+	AddMannequinNode(out, n("calf").c_str(), n("thigh").c_str(), 0.0f, 0.0f, -43.0f);
+	AddMannequinNode(out, n("calf_twist_01").c_str(), n("calf").c_str(), 0.0f, 0.0f, -20.0f);
+	AddMannequinNode(out, n("calf_twist_02").c_str(), n("calf").c_str(), 0.0f, 0.0f, -10.0f);
+	AddMannequinNode(out, n("foot").c_str(), n("calf").c_str(), 0.0f, 0.0f, -42.0f);
+	AddMannequinNode(out, n("ball").c_str(), n("foot").c_str(), 0.0f, -13.0f, -6.0f);
+}
+
+// Skin everything under the scene root, offset = inverse bind pose in model space
+static void BindEveryNodeAsBone(ModelAsset& out)
+{
+	SkeletonRuntime& skel = out.skeleton;
+	const int nodeCount = skel.NodeCount();
+
+	PoseMatrixBuffer model(nodeCount);
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		const XMMATRIX local = XMLoadFloat4x4(&skel.bindLocal[i]);
+		model[i] = (skel.parentIndex[i] >= 0) ? local * model[skel.parentIndex[i]] : local;
+	}
+
+	skel.boneToNode.clear();
+	skel.boneOffset.clear();
+
+	for (int i = 1; i < nodeCount; ++i)
+	{
+		out.boneNameToIndex.emplace(skel.names[i], static_cast<int>(skel.boneToNode.size()));
+		skel.boneToNode.push_back(i);
+
+		XMFLOAT4X4 offset;
+		XMStoreFloat4x4(&offset, XMMatrixInverse(nullptr, model[i]));
+		skel.boneOffset.push_back(offset);
+	}
+}
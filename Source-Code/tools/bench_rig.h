@@ -0,0 +1,33 @@
+/*==============================================================================
+
+   Rig and clips of the headless animation tools [bench_rig.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   ModelAsset with only the animation part filled (import settings, bone table,
+   SkeletonRuntime), no assimp scene and no GPU buffers:
+   ├─ BenchRig_LoadMeshCache : nodes, bones and skinned CPU vertices of a cooked model (.meshcache)
+   ├─ BenchRig_BuildMannequin : the mannequin.FBX hierarchy (UE mannequin names),
+   │                            for machines without the cooked files
+   ├─ BenchRig_LoadClip : cooked clip (.anim), tracks matched to the rig by name
+   └─ BenchRig_MakeClip : every node keyed on a 30 fps grid, like the FBX bakes
+
+==============================================================================*/
+
+#ifndef BENCH_RIG_H
+#define BENCH_RIG_H
+
+#include <cstdint>
+
+struct ModelAsset;
+struct AnimationClip;
+
+bool BenchRig_LoadMeshCache(const char* path, ModelAsset& out);
+void BenchRig_BuildMannequin(ModelAsset& out);
+
+// nullptr when the file cannot be read, delete the clip with Animation_DestroyClip
+AnimationClip* BenchRig_LoadClip(const char* animPath, const ModelAsset& asset);
+AnimationClip* BenchRig_MakeClip(const ModelAsset& asset, const char* name, double seconds, uint32_t seed);
+
+#endif // BENCH_RIG_H
@@ -0,0 +1,273 @@
+/*==============================================================================
+
+   Crossfades interrupted by the next one [blend_test.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   Not part of the game project, no GPU or Windows API needed (DirectXMath Inc
+   and a sal.h on the include path, see skinning_test.cpp):
+
+     g++ -std=c++14 -O2 -msse4.1 -I.. -I<DirectXMath>/Inc -I<sal.h dir> \
+         blend_test.cpp bench_rig.cpp ../animation_blender.cpp ../animation_skinning.cpp \
+         ../animation.cpp ../animation_sampler.cpp ../animation_compression.cpp \
+         ../animation_retarget.cpp ../animation_cook.cpp ../animation_root_motion.cpp \
+         ../skeleton_runtime.cpp ../mapped_file_util.cpp ../worker_pool_util.cpp \
+         ../axis_util.cpp -pthread -o blend_test
+     ./blend_test [--fade 0.3] [--rig mannequin.meshcache] [clip.anim clip.anim clip.anim]
+
+   AnimationBlender on clip A, crossfade to B, and before it is done to C
+   (at 25 / 50 / 75 % of the fade, then again halfway into the fade to C):
+   ├─ the palette right after each CrossFade is the one right before it
+   ├─ no frame step after an interruption is larger than the steps of the
+   │  uninterrupted fade A -> B (twice that, the clips do not move evenly)
+   └─ once the fade is over, the palette is the one of C played on its own
+   Without --rig / clips : the mannequin.FBX hierarchy and generated clips
+   (bench_rig.h). Exit code 1 on a failure (or a file cannot be read).
+
+==============================================================================*/
+
+#include "bench_rig.h"
+#include "model_asset.h"
+#include "animation.h"
+#include "animation_blender.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace DirectX;
+
+static const double TEST_FRAME_TIME = 1.0 / 60.0;
+static const float SWITCH_TOLERANCE = 1.0e-4f; // relative to the matrix element (at least 1)
+
+typedef std::vector<XMFLOAT4X4> Palette;
+
+static float PaletteDiff(const Palette& a, const Palette& b);
+static float RunUninterrupted(const ModelAsset& asset, const AnimationClip* const clips[3], double fadeSec);
+static bool RunInterrupted(const ModelAsset& asset, const AnimationClip* const clips[3], double fadeSec, double interruptAt, float maxReferenceStep);
+static void Step(AnimationBlender& blender, Palette& palette, float& outStep);
+
+
+int main(int argc, char** argv)
+{
+	double fadeSec = 0.3;
+	const char* rigPath = nullptr;
+	std::vector<const char*> clipPaths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--fade") == 0 && i + 1 < argc)
+		{
+			fadeSec = atof(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--rig") == 0 && i + 1 < argc)
+		{
+			rigPath = argv[++i];
+			continue;
+		}
+		if (argv[i][0] == '-')
+		{
+			printf("usage: blend_test [--fade seconds] [--rig file.meshcache] [clip.anim clip.anim clip.anim]\n");
+			return 1;
+		}
+
+		clipPaths.push_back(argv[i]);
+	}
+
+	if (!(fadeSec >= TEST_FRAME_TIME * 8.0))
+	{
+		printf("--fade : at least 8 frames (%.3f s)\n", TEST_FRAME_TIME * 8.0);
+		return 1;
+	}
+	if (!clipPaths.empty() && clipPaths.size() != 3)
+	{
+		printf("three clips (A, B, C) or none\n");
+		return 1;
+	}
+
+	ModelAsset asset;
+	if (rigPath)
+	{
+		if (!BenchRig_LoadMeshCache(rigPath, asset))
+		{
+			printf("%s : cannot read\n", rigPath);
+			return 1;
+		}
+	}
+	else
+	{
+		BenchRig_BuildMannequin(asset);
+	}
+
+	AnimationClip* clips[3] = {};
+	bool ok = true;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		if (clipPaths.empty())
+		{
+			static const char* const NAMES[3] = { "A", "B", "C" };
+			clips[i] = BenchRig_MakeClip(asset, NAMES[i], 1.0 + 0.4 * i, 11 + i);
+		}
+		else
+		{
+			clips[i] = BenchRig_LoadClip(clipPaths[i], asset);
+			if (!clips[i])
+			{
+				printf("%s : cannot read\n", clipPaths[i]);
+				ok = false;
+			}
+		}
+
+		if (clips[i]) clips[i]->loop = true;
+	}
+
+	if (ok)
+	{
+		printf("rig %s : %d nodes, %d bones, fade %.3f s\n",
+			rigPath ? rigPath : "(generated mannequin)", asset.skeleton.NodeCount(), asset.skeleton.BoneCount(), fadeSec);
+
+		const float maxReferenceStep = RunUninterrupted(asset, clips, fadeSec);
+		printf("A -> B, not interrupted : max frame step %.6f\n", maxReferenceStep);
+
+		ok = RunInterrupted(asset, clips, fadeSec, 0.25, maxReferenceStep) && ok;
+		ok = RunInterrupted(asset, clips, fadeSec, 0.50, maxReferenceStep) && ok;
+		ok = RunInterrupted(asset, clips, fadeSec, 0.75, maxReferenceStep) && ok;
+	}
+
+	for (AnimationClip* clip : clips)
+	{
+		if (clip) Animation_DestroyClip(clip);
+	}
+	AnimationManager::Instance().ReleaseBindings(&asset);
+
+	return ok ? 0 : 1;
+}
+
+// Largest palette change between two frames of a plain A -> B fade (and a little after it)
+static float RunUninterrupted(const ModelAsset& asset, const AnimationClip* const clips[3], double fadeSec)
+{
+	AnimationBlender blender;
+	blender.Initialize(&asset);
+	blender.CrossFade(0, clips[0], true, 0.0);
+
+	Palette palette;
+	float step = 0.0f, maxStep = 0.0f;
+
+	Step(blender, palette, step);
+	blender.CrossFade(0, clips[1], true, fadeSec);
+
+	const int frames = static_cast<int>(fadeSec / TEST_FRAME_TIME) + 4;
+	for (int f = 0; f < frames; ++f)
+	{
+		Step(blender, palette, step);
+		maxStep = std::max(maxStep, step);
+	}
+
+	blender.Finalize();
+	return maxStep;
+}
+
+// A, fade to B, interrupted by C at interruptAt of the fade, and by A again halfway into that one
+static bool RunInterrupted(const ModelAsset& asset, const AnimationClip* const clips[3], double fadeSec, double interruptAt, float maxReferenceStep)
+{
+	AnimationBlender blender;
+	blender.Initialize(&asset);
+	blender.CrossFade(0, clips[0], true, 0.0);
+
+	Palette palette, switched;
+	float step = 0.0f;
+
+	Step(blender, palette, step);
+	blender.CrossFade(0, clips[1], true, fadeSec);
+
+	// Fades to C and then back to A, each one cut before it is over
+	const AnimationClip* const targets[2] = { clips[2], clips[0] };
+	const double cuts[2] = { interruptAt, 0.5 };
+
+	float maxSwitch = 0.0f, maxStep = 0.0f;
+
+	for (int t = 0; t < 2; ++t)
+	{
+		const int frames = std::max(1, static_cast<int>(fadeSec * cuts[t] / TEST_FRAME_TIME + 0.5));
+		for (int f = 0; f < frames; ++f)
+		{
+			Step(blender, palette, step);
+			maxStep = std::max(maxStep, step);
+		}
+
+		if (!blender.IsFading(0))
+		{
+			printf("  interrupt at %.0f %% : fade %d already over\n", interruptAt * 100.0, t + 1);
+			return false;
+		}
+
+		// Nothing advances between the two palettes, only the fade source changes
+		blender.CrossFade(0, targets[t], true, fadeSec);
+		blender.ComputeSkinMatrices(switched);
+		maxSwitch = std::max(maxSwitch, PaletteDiff(palette, switched));
+	}
+
+	// Rest of the last fade, then the clip on its own
+	int framesOnA = 0;
+	while (blender.IsFading(0))
+	{
+		Step(blender, palette, step);
+		maxStep = std::max(maxStep, step);
+		++framesOnA;
+	}
+
+	AnimationPlayer player;
+	Palette alone;
+	player.Play(clips[0], &asset, true, framesOnA * TEST_FRAME_TIME);
+	player.ComputeSkinMatrices(alone);
+	const float endDiff = PaletteDiff(palette, alone);
+
+	blender.Finalize();
+
+	const bool switchOk = maxSwitch <= SWITCH_TOLERANCE;
+	const bool stepOk = maxStep <= maxReferenceStep * 2.0f + SWITCH_TOLERANCE;
+	const bool endOk = endDiff <= SWITCH_TOLERANCE;
+
+	printf("interrupt at %.0f %% : jump at the switch %.6f, max frame step %.6f, after the fade %.6f%s\n",
+		interruptAt * 100.0, maxSwitch, maxStep, endDiff, (switchOk && stepOk && endOk) ? "" : "  FAILED");
+
+	return switchOk && stepOk && endOk;
+}
+
+// One 60 Hz frame, outStep = palette change against the previous frame (0 on the first one)
+static void Step(AnimationBlender& blender, Palette& palette, float& outStep)
+{
+	Palette previous;
+	previous.swap(palette);
+
+	blender.Update(TEST_FRAME_TIME);
+	blender.ComputeSkinMatrices(palette);
+
+	outStep = (previous.size() == palette.size()) ? PaletteDiff(previous, palette) : 0.0f;
+}
+
+static float PaletteDiff(const Palette& a, const Palette& b)
+{
+	if (a.size() != b.size()) return INFINITY;
+
+	float maxDiff = 0.0f;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				const float d = fabsf(a[i].m[r][c] - b[i].m[r][c]);
+				maxDiff = std::max(maxDiff, d / std::max(1.0f, fabsf(a[i].m[r][c])));
+			}
+		}
+	}
+
+	return maxDiff;
+}
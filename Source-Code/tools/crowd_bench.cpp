@@ -0,0 +1,254 @@
+/*==============================================================================
+
+   Headless crowd stress benchmark of AnimationSystem [crowd_bench.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   Not part of the game project, no GPU or Windows API needed (DirectXMath Inc
+   and a sal.h on the include path, see skinning_test.cpp):
+
+     g++ -std=c++14 -O2 -msse4.1 -I.. -I<DirectXMath>/Inc -I<sal.h dir> \
+         crowd_bench.cpp bench_rig.cpp ../animation_system.cpp ../animation_blender.cpp \
+         ../animation_skinning.cpp ../animation.cpp ../animation_sampler.cpp \
+         ../animation_compression.cpp ../animation_retarget.cpp ../animation_cook.cpp \
+         ../animation_root_motion.cpp ../skeleton_runtime.cpp ../mapped_file_util.cpp \
+         ../worker_pool_util.cpp ../axis_util.cpp -pthread -o crowd_bench
+     ./crowd_bench [--instances 500] [--frames 120] [--threads n] [--rig mannequin.meshcache] [clip.anim ...]
+
+   instances mannequins, each cycling through the clips with its own start time,
+   updated for frames 60 Hz frames by one private AnimationSystem per thread
+   count (1, 2, 4, ... --threads, hardware threads by default). Reports ms/frame and the speedup over
+   1 thread. Instances own all their scratch, so every run has to produce the
+   palettes of the 1 thread run bit for bit; exit code 1 when one does not
+   (or a file cannot be read).
+   Without --rig / clips : the mannequin.FBX hierarchy and generated clips of the
+   resources/Animation lengths (bench_rig.h).
+
+==============================================================================*/
+
+#include "bench_rig.h"
+#include "model_asset.h"
+#include "animation.h"
+#include "animation_system.h"
+#include "worker_pool_util.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace DirectX;
+
+static const double BENCH_FRAME_TIME = 1.0 / 60.0;
+static const double CROWD_PHASE_STEP = 0.037; // start time offset between crowd members
+
+// Generated clips, lengths of resources/Animation
+struct GeneratedClip
+{
+	const char* name;
+	double seconds;
+};
+
+static const GeneratedClip GENERATED_CLIPS[] =
+{
+	{ "Idle", 2.7 },
+	{ "Walking", 1.1 },
+	{ "Running", 0.7 },
+	{ "Jump", 1.6 },
+	{ "Falling", 1.0 },
+	{ "Sad_Idle", 3.3 },
+};
+
+typedef std::vector<std::vector<XMFLOAT4X4>> CrowdPalettes;
+
+static double RunCrowd(const ModelAsset& asset, const std::vector<AnimationClip*>& clips, int instanceCount, int frames, int threadCount, CrowdPalettes& outPalettes);
+static bool SamePalettes(const CrowdPalettes& a, const CrowdPalettes& b);
+
+
+int main(int argc, char** argv)
+{
+	int instanceCount = 500;
+	int frames = 120;
+	int maxThreads = WorkerPool::DefaultWorkerCount() + 1;
+	const char* rigPath = nullptr;
+	std::vector<const char*> clipPaths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc)
+		{
+			instanceCount = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+		{
+			frames = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			maxThreads = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--rig") == 0 && i + 1 < argc)
+		{
+			rigPath = argv[++i];
+			continue;
+		}
+		if (argv[i][0] == '-')
+		{
+			printf("usage: crowd_bench [--instances n] [--frames n] [--threads n] [--rig file.meshcache] [clip.anim ...]\n");
+			return 1;
+		}
+
+		clipPaths.push_back(argv[i]);
+	}
+
+	if (instanceCount < 1) instanceCount = 1;
+	if (frames < 1) frames = 1;
+	if (maxThreads < 1) maxThreads = 1;
+
+	ModelAsset asset;
+	if (rigPath)
+	{
+		if (!BenchRig_LoadMeshCache(rigPath, asset))
+		{
+			printf("%s : cannot read\n", rigPath);
+			return 1;
+		}
+	}
+	else
+	{
+		BenchRig_BuildMannequin(asset);
+	}
+
+	std::vector<AnimationClip*> clips;
+	bool ok = true;
+
+	for (const char* path : clipPaths)
+	{
+		AnimationClip* clip = BenchRig_LoadClip(path, asset);
+		if (!clip)
+		{
+			printf("%s : cannot read\n", path);
+			ok = false;
+			continue;
+		}
+		clips.push_back(clip);
+	}
+
+	if (clipPaths.empty())
+	{
+		uint32_t seed = 1;
+		for (const GeneratedClip& g : GENERATED_CLIPS)
+		{
+			clips.push_back(BenchRig_MakeClip(asset, g.name, g.seconds, seed++));
+		}
+	}
+
+	if (clips.empty())
+	{
+		printf("no clip\n");
+		return 1;
+	}
+
+	printf("rig %s : %d nodes, %d bones, %d clips, %d instances x %d frames\n",
+		rigPath ? rigPath : "(generated mannequin)", asset.skeleton.NodeCount(), asset.skeleton.BoneCount(),
+		static_cast<int>(clips.size()), instanceCount, frames);
+
+	std::vector<int> threadCounts;
+	for (int t = 1; t < maxThreads; t *= 2)
+	{
+		threadCounts.push_back(t);
+	}
+	threadCounts.push_back(maxThreads);
+
+	CrowdPalettes reference;
+	double baseMs = 0.0;
+
+	for (int threads : threadCounts)
+	{
+		CrowdPalettes palettes;
+		const double ms = RunCrowd(asset, clips, instanceCount, frames, threads, palettes);
+
+		bool identical = true;
+		if (reference.empty())
+		{
+			if (palettes.empty() || palettes.front().empty())
+			{
+				printf("no palette : nothing was evaluated\n");
+				return 1;
+			}
+
+			reference.swap(palettes);
+			baseMs = ms;
+		}
+		else
+		{
+			identical = SamePalettes(reference, palettes);
+		}
+
+		printf("%2d threads : %8.3f ms/frame (x%.2f)%s\n", threads, ms, ms > 0.0 ? baseMs / ms : 0.0,
+			identical ? "" : " PALETTE MISMATCH");
+		ok = identical && ok;
+	}
+
+	AnimationManager::Instance().ReleaseBindings(&asset);
+	for (AnimationClip* clip : clips)
+	{
+		Animation_DestroyClip(clip);
+	}
+
+	return ok ? 0 : 1;
+}
+
+// ms per AnimationSystem::Update, outPalettes : every instance after the last frame
+static double RunCrowd(const ModelAsset& asset, const std::vector<AnimationClip*>& clips, int instanceCount, int frames, int threadCount, CrowdPalettes& outPalettes)
+{
+	AnimationSystem system;
+	system.Initialize(threadCount - 1);
+
+	std::vector<int> ids(instanceCount);
+	for (int i = 0; i < instanceCount; ++i)
+	{
+		ids[i] = system.CreateInstance(&asset, 1);
+
+		AnimationBlender* blender = system.GetBlender(ids[i]);
+		blender->CrossFade(0, clips[i % clips.size()], true, 0.0);
+		blender->Update(i * CROWD_PHASE_STEP);
+	}
+
+	// Warm-up: pose pools and palettes reach their final size
+	system.Update(BENCH_FRAME_TIME);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; ++f)
+	{
+		system.Update(BENCH_FRAME_TIME);
+	}
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+	outPalettes.clear();
+	for (int id : ids)
+	{
+		outPalettes.push_back(*system.GetPalette(id));
+	}
+
+	system.Finalize();
+	return ms;
+}
+
+static bool SamePalettes(const CrowdPalettes& a, const CrowdPalettes& b)
+{
+	if (a.size() != b.size()) return false;
+
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i].size() != b[i].size()) return false;
+		if (!a[i].empty() && memcmp(a[i].data(), b[i].data(), a[i].size() * sizeof(XMFLOAT4X4)) != 0) return false;
+	}
+
+	return true;
+}
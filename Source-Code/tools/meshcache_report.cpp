@@ -0,0 +1,202 @@
+/*==============================================================================
+
+   Headless vertex cache / LOD report of cooked models [meshcache_report.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   Not part of the game project, no GPU or Windows API needed:
+
+     g++ -std=c++14 -O2 -I.. meshcache_report.cpp ../mesh_optimize_util.cpp -o meshcache_report
+     ./meshcache_report [--max-acmr 0.8] ../resources/Model/Chair02.meshcache
+
+   Per mesh : ACMR / ATVR / overfetch of the cooked order, then of every reorder
+   stage run again on it, then triangles / error / ACMR of every cooked LOD.
+   Exit code 1 when a cooked mesh is above --max-acmr (or a file cannot be read),
+   so asset regressions fail a script.
+
+==============================================================================*/
+
+#include "model_cook_format.h"
+#include "mesh_optimize_util.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static bool ReadFile(const char* path, std::vector<uint8_t>& outBytes);
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t size);
+static void PrintStage(const char* label, const VertexCacheStats& cache, const VertexFetchStats& fetch);
+static bool PrintLods(const uint8_t* base, uint64_t size, const MeshFileMesh& fm, uint64_t& ioLodTriangles);
+static bool ReportFile(const char* path, float maxAcmr);
+
+
+int main(int argc, char** argv)
+{
+	float maxAcmr = 0.0f; // 0 : no limit
+	int fileCount = 0;
+	bool ok = true;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--max-acmr") == 0 && i + 1 < argc)
+		{
+			maxAcmr = static_cast<float>(atof(argv[++i]));
+			continue;
+		}
+
+		ok = ReportFile(argv[i], maxAcmr) && ok;
+		++fileCount;
+	}
+
+	if (fileCount == 0)
+	{
+		printf("usage: meshcache_report [--max-acmr value] file.meshcache ...\n");
+		return 1;
+	}
+
+	return ok ? 0 : 1;
+}
+
+static bool ReportFile(const char* path, float maxAcmr)
+{
+	std::vector<uint8_t> bytes;
+	if (!ReadFile(path, bytes) || bytes.size() < sizeof(MeshFileHeader))
+	{
+		printf("%s : cannot read\n", path);
+		return false;
+	}
+
+	const uint8_t* base = bytes.data();
+	const uint64_t size = bytes.size();
+
+	MeshFileHeader header;
+	memcpy(&header, base, sizeof(header));
+
+	if (header.magic != MESH_FILE_MAGIC || header.version != MESH_FILE_VERSION ||
+		!InFile(sizeof(MeshFileHeader), static_cast<uint64_t>(header.meshCount) * sizeof(MeshFileMesh), size))
+	{
+		printf("%s : not a version %u .meshcache\n", path, MESH_FILE_VERSION);
+		return false;
+	}
+
+	printf("%s : %u meshes\n", path, header.meshCount);
+
+	bool ok = true;
+	MeshOptimizeReport total;
+	uint64_t lodTriangles = 0;
+
+	for (uint32_t m = 0; m < header.meshCount; ++m)
+	{
+		MeshFileMesh fm;
+		memcpy(&fm, base + sizeof(MeshFileHeader) + m * sizeof(MeshFileMesh), sizeof(fm));
+
+		if (!InFile(fm.packedOffset, static_cast<uint64_t>(fm.vertexCount) * MESH_FILE_PACKED_VERTEX_SIZE, size) ||
+			!InFile(fm.indexOffset, static_cast<uint64_t>(fm.indexCount) * sizeof(uint32_t), size) ||
+			!InFile(fm.nameOffset, fm.nameLength, size))
+		{
+			printf("  mesh %u : broken ranges\n", m);
+			ok = false;
+			continue;
+		}
+
+		const std::string name(reinterpret_cast<const char*>(base + fm.nameOffset), fm.nameLength);
+
+		std::vector<uint32_t> indices(fm.indexCount);
+		memcpy(indices.data(), base + fm.indexOffset, indices.size() * sizeof(uint32_t));
+
+		// Cooked order, then the stages again on top of it
+		MeshOptimizeReport report;
+		std::vector<uint32_t> remap;
+		MeshOptimize_Run(indices, base + fm.packedOffset, MESH_FILE_PACKED_VERTEX_SIZE, fm.vertexCount, MESH_FILE_PACKED_VERTEX_SIZE, remap, &report);
+		MeshOptimize_MergeReport(total, report);
+
+		printf("  mesh %u \"%s\" : %u vertices, %u triangles\n", m, name.c_str(), fm.vertexCount, fm.indexCount / 3);
+		for (int s = 0; s < static_cast<int>(MeshOptimizeStage::Count); ++s)
+		{
+			const MeshOptimizeStage stage = static_cast<MeshOptimizeStage>(s);
+			PrintStage(stage == MeshOptimizeStage::Source ? "cooked" : MeshOptimize_GetStageName(stage), report.cache[s], report.fetch[s]);
+		}
+
+		if (!PrintLods(base, size, fm, lodTriangles))
+		{
+			printf("    LOD ranges broken\n");
+			ok = false;
+		}
+
+		const float cookedAcmr = report.cache[static_cast<int>(MeshOptimizeStage::Source)].acmr;
+		if (maxAcmr > 0.0f && cookedAcmr > maxAcmr)
+		{
+			printf("    FAIL : cooked ACMR %.3f > %.3f\n", cookedAcmr, maxAcmr);
+			ok = false;
+		}
+	}
+
+	printf("  total\n");
+	for (int s = 0; s < static_cast<int>(MeshOptimizeStage::Count); ++s)
+	{
+		const MeshOptimizeStage stage = static_cast<MeshOptimizeStage>(s);
+		PrintStage(stage == MeshOptimizeStage::Source ? "cooked" : MeshOptimize_GetStageName(stage), total.cache[s], total.fetch[s]);
+	}
+	printf("    LOD triangles %llu\n", static_cast<unsigned long long>(lodTriangles));
+
+	return ok;
+}
+
+// LOD0 is the mesh itself, the cooked levels follow
+static bool PrintLods(const uint8_t* base, uint64_t size, const MeshFileMesh& fm, uint64_t& ioLodTriangles)
+{
+	if (!InFile(fm.lodOffset, static_cast<uint64_t>(fm.lodCount) * sizeof(MeshFileLod), size) ||
+		!InFile(fm.lodIndexOffset, static_cast<uint64_t>(fm.lodIndexCount) * sizeof(uint32_t), size))
+	{
+		return false;
+	}
+
+	printf("    LOD0         %u triangles\n", fm.indexCount / 3);
+
+	for (uint32_t l = 0; l < fm.lodCount; ++l)
+	{
+		MeshFileLod lod;
+		memcpy(&lod, base + fm.lodOffset + l * sizeof(MeshFileLod), sizeof(lod));
+
+		if (lod.startIndex > fm.lodIndexCount || lod.indexCount > fm.lodIndexCount - lod.startIndex) return false;
+
+		std::vector<uint32_t> indices(lod.indexCount);
+		memcpy(indices.data(), base + fm.lodIndexOffset + static_cast<uint64_t>(lod.startIndex) * sizeof(uint32_t), indices.size() * sizeof(uint32_t));
+
+		const VertexCacheStats cache = MeshOptimize_AnalyzeVertexCache(indices.data(), indices.size(), fm.vertexCount);
+
+		printf("    LOD%-9u %u triangles (%.1f%%), error %.5f, ACMR %.3f\n",
+			l + 1, lod.indexCount / 3, fm.indexCount > 0 ? 100.0 * lod.indexCount / fm.indexCount : 0.0, lod.error, cache.acmr);
+
+		ioLodTriangles += lod.indexCount / 3;
+	}
+
+	return true;
+}
+
+static void PrintStage(const char* label, const VertexCacheStats& cache, const VertexFetchStats& fetch)
+{
+	printf("    %-12s ACMR %.3f  ATVR %.3f  overfetch %.2f\n", label, cache.acmr, cache.atvr, fetch.overfetch);
+}
+
+static bool ReadFile(const char* path, std::vector<uint8_t>& outBytes)
+{
+	std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+	if (!ifs) return false;
+
+	const std::streamsize size = ifs.tellg();
+	if (size <= 0) return false;
+
+	outBytes.resize(static_cast<size_t>(size));
+	ifs.seekg(0, std::ios::beg);
+	return static_cast<bool>(ifs.read(reinterpret_cast<char*>(outBytes.data()), size));
+}
+
+static bool InFile(uint64_t offset, uint64_t bytes, uint64_t size)
+{
+	return offset <= size && bytes <= size - offset;
+}
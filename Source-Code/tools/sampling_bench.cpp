@@ -0,0 +1,317 @@
+/*==============================================================================
+
+   Headless pose sampling benchmark [sampling_bench.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   Not part of the game project, no GPU or Windows API needed (DirectXMath Inc
+   and a sal.h on the include path, see skinning_test.cpp):
+
+     g++ -std=c++14 -O2 -msse4.1 -I.. -I<DirectXMath>/Inc -I<sal.h dir> \
+         sampling_bench.cpp bench_rig.cpp ../animation.cpp ../animation_sampler.cpp \
+         ../animation_compression.cpp ../animation_retarget.cpp ../animation_cook.cpp \
+         ../animation_root_motion.cpp ../skeleton_runtime.cpp ../mapped_file_util.cpp \
+         ../worker_pool_util.cpp ../axis_util.cpp -pthread -o sampling_bench
+     ./sampling_bench [--iterations 2000] [--max-diff 0.001] [--rig mannequin.meshcache] [clip.anim ...]
+
+   Bones/sec of the local pose (every node of the rig, one 60 Hz step per pose):
+   ├─ scalar : AnimationPlayer::SampleLocalPose(batched = false), per bone key search
+   ├─ gather : AnimationSampler with a binding without key table, key search per
+   │           channel and key pairs gathered into SoA lanes on every sample
+   └─ table  : AnimationSampler with the binding's PoseKeyTable (AnimationManager),
+               keys gathered (and decoded) once when the binding is made
+   Every clip runs twice, as loaded and compressed with the settings Player uses
+   (quantized keys only, the way the game samples them).
+   Without --rig / clips : the mannequin.FBX hierarchy and generated 30 fps clips
+   (bench_rig.h), the cooked files only exist once the game has run.
+   Exit code 1 when a path differs from the scalar one by more than --max-diff
+   (or a file cannot be read).
+
+==============================================================================*/
+
+#include "bench_rig.h"
+#include "model_asset.h"
+#include "animation.h"
+#include "animation_sampler.h"
+#include "animation_compression.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+
+static const double BENCH_FRAME_TIME = 1.0 / 60.0;
+static const int VERIFY_FRAMES = 240; // compared untimed after the timed runs
+
+// Generated clips, lengths of resources/Animation
+struct GeneratedClip
+{
+	const char* name;
+	double seconds;
+};
+
+static const GeneratedClip GENERATED_CLIPS[] =
+{
+	{ "Idle", 2.7 },
+	{ "Walking", 1.1 },
+	{ "Running", 0.7 },
+	{ "Jump", 1.6 },
+	{ "Falling", 1.0 },
+};
+
+static double NowSec();
+static float MaxPoseDiff(const PoseMatrixBuffer& a, const PoseMatrixBuffer& b);
+static double TimePlayer(AnimationPlayer& player, const AnimationClip* clip, const ModelAsset& asset, int iterations, bool batched, PoseMatrixBuffer& pose);
+static double TimeGather(AnimationPlayer& player, const AnimationClip* clip, const ModelAsset& asset, const AnimationBinding& binding, int iterations, PoseMatrixBuffer& pose);
+static bool BenchClip(const AnimationClip* clip, const ModelAsset& asset, int iterations, float maxDiff);
+
+
+int main(int argc, char** argv)
+{
+	int iterations = 2000;
+	float maxDiff = 1.0e-3f;
+	const char* rigPath = nullptr;
+	std::vector<const char*> clipPaths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+		{
+			iterations = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--max-diff") == 0 && i + 1 < argc)
+		{
+			maxDiff = static_cast<float>(atof(argv[++i]));
+			continue;
+		}
+		if (strcmp(argv[i], "--rig") == 0 && i + 1 < argc)
+		{
+			rigPath = argv[++i];
+			continue;
+		}
+		if (argv[i][0] == '-')
+		{
+			printf("usage: sampling_bench [--iterations n] [--max-diff value] [--rig file.meshcache] [clip.anim ...]\n");
+			return 1;
+		}
+
+		clipPaths.push_back(argv[i]);
+	}
+
+	if (iterations < 1) iterations = 1;
+
+	ModelAsset asset;
+	if (rigPath)
+	{
+		if (!BenchRig_LoadMeshCache(rigPath, asset))
+		{
+			printf("%s : cannot read\n", rigPath);
+			return 1;
+		}
+	}
+	else
+	{
+		BenchRig_BuildMannequin(asset);
+	}
+
+	std::vector<AnimationClip*> clips;
+	bool ok = true;
+
+	for (const char* path : clipPaths)
+	{
+		AnimationClip* clip = BenchRig_LoadClip(path, asset);
+		if (!clip)
+		{
+			printf("%s : cannot read\n", path);
+			ok = false;
+			continue;
+		}
+		clips.push_back(clip);
+	}
+
+	if (clipPaths.empty())
+	{
+		uint32_t seed = 1;
+		for (const GeneratedClip& g : GENERATED_CLIPS)
+		{
+			clips.push_back(BenchRig_MakeClip(asset, g.name, g.seconds, seed++));
+		}
+	}
+
+	// Compressed copies, same as Player's prepare step (raw keys released)
+	const size_t rawClipCount = clips.size();
+	for (size_t i = 0; i < rawClipCount; ++i)
+	{
+		AnimationClip* copy = new AnimationClip(*clips[i]);
+		if (!AnimationCompression_CompressClip(copy, &asset, AnimationCompressionSettings()))
+		{
+			printf("%s : compression failed\n", copy->animName.c_str());
+			Animation_DestroyClip(copy);
+			ok = false;
+			continue;
+		}
+		clips.push_back(copy);
+	}
+
+	printf("rig %s : %d nodes, %d bones, %d iterations\n",
+		rigPath ? rigPath : "(generated mannequin)", asset.skeleton.NodeCount(), asset.skeleton.BoneCount(), iterations);
+
+	for (const AnimationClip* clip : clips)
+	{
+		ok = BenchClip(clip, asset, iterations, maxDiff) && ok;
+	}
+
+	AnimationManager::Instance().ReleaseBindings(&asset);
+	for (AnimationClip* clip : clips)
+	{
+		Animation_DestroyClip(clip);
+	}
+
+	return ok ? 0 : 1;
+}
+
+static bool BenchClip(const AnimationClip* clip, const ModelAsset& asset, int iterations, float maxDiff)
+{
+	const int nodeCount = asset.skeleton.NodeCount();
+
+	// The table path is the player's own binding (AnimationManager::GetBinding builds the table),
+	// the gather path a copy of it without the table
+	const AnimationBinding* managed = AnimationManager::Instance().GetBinding(clip, &asset);
+	if (!managed) return false;
+
+	AnimationBinding gather;
+	Animation_ResolveBinding(clip, &asset, gather);
+	gather.retarget = managed->retarget;
+
+	AnimationPlayer player;
+	PoseMatrixBuffer scalarPose;
+	PoseMatrixBuffer gatherPose;
+	PoseMatrixBuffer tablePose;
+
+	const double bones = static_cast<double>(nodeCount) * iterations;
+
+	const double scalarSec = TimePlayer(player, clip, asset, iterations, false, scalarPose);
+	const double gatherSec = TimeGather(player, clip, asset, gather, iterations, gatherPose);
+	const double tableSec = managed->keyTable.Empty() ? 0.0 : TimePlayer(player, clip, asset, iterations, true, tablePose);
+
+	const double scalarRate = (scalarSec > 0.0) ? bones / scalarSec : 0.0;
+	const double gatherRate = (gatherSec > 0.0) ? bones / gatherSec : 0.0;
+	const double tableRate = (tableSec > 0.0) ? bones / tableSec : 0.0;
+
+	// Same frames on all three paths, untimed
+	float gatherDiff = 0.0f;
+	float tableDiff = 0.0f;
+	{
+		AnimationPlayer reference;
+		reference.Play(clip, &asset, true, 0.0);
+		player.Play(clip, &asset, true, 0.0);
+
+		std::vector<TrackCursor> cursors(clip->tracks.size());
+		PoseSampleScratch scratch;
+
+		for (int f = 0; f < VERIFY_FRAMES; ++f)
+		{
+			reference.Update(BENCH_FRAME_TIME);
+			player.Update(BENCH_FRAME_TIME);
+
+			reference.SampleLocalPose(scalarPose, false);
+
+			const double ticks = player.GetCurrentTimeSec() * clip->ticksPerSecond;
+			AnimationSampler_SampleLocalPose(clip, &gather, asset.skeleton, ticks, cursors.data(), scratch, gatherPose);
+			gatherDiff = std::max(gatherDiff, MaxPoseDiff(scalarPose, gatherPose));
+
+			if (!managed->keyTable.Empty())
+			{
+				player.SampleLocalPose(tablePose, true);
+				tableDiff = std::max(tableDiff, MaxPoseDiff(scalarPose, tablePose));
+			}
+		}
+	}
+
+	printf("%s : %d tracks, %.0f ticks%s\n", clip->animName.c_str(), static_cast<int>(clip->tracks.size()), clip->duration,
+		clip->IsCompressed() ? ", compressed" : "");
+	printf("  scalar %8.2f M bones/s\n", scalarRate * 1.0e-6);
+	printf("  gather %8.2f M bones/s (x%.2f), max diff %.6f\n", gatherRate * 1.0e-6, scalarRate > 0.0 ? gatherRate / scalarRate : 0.0, gatherDiff);
+	if (managed->keyTable.Empty())
+	{
+		printf("  table  none (keys off a common grid or over the size limit)\n");
+	}
+	else
+	{
+		const double tableKB = managed->keyTable.frames.size() * sizeof(float) / 1024.0;
+		printf("  table  %8.2f M bones/s (x%.2f), max diff %.6f, %d frames %.1f KB\n", tableRate * 1.0e-6,
+			scalarRate > 0.0 ? tableRate / scalarRate : 0.0, tableDiff, managed->keyTable.frameCount, tableKB);
+	}
+
+	const bool ok = gatherDiff <= maxDiff && tableDiff <= maxDiff;
+	if (!ok)
+	{
+		printf("  MISMATCH (above %.6f)\n", maxDiff);
+	}
+
+	return ok;
+}
+
+// Player's own path: batched = true samples through its binding (key table when it has one)
+static double TimePlayer(AnimationPlayer& player, const AnimationClip* clip, const ModelAsset& asset, int iterations, bool batched, PoseMatrixBuffer& pose)
+{
+	player.Play(clip, &asset, true, 0.0);
+
+	const double start = NowSec();
+	for (int i = 0; i < iterations; ++i)
+	{
+		player.Update(BENCH_FRAME_TIME);
+		player.SampleLocalPose(pose, batched);
+	}
+	return NowSec() - start;
+}
+
+// Player only keeps the time, the sampler gets the binding without table
+static double TimeGather(AnimationPlayer& player, const AnimationClip* clip, const ModelAsset& asset, const AnimationBinding& binding, int iterations, PoseMatrixBuffer& pose)
+{
+	player.Play(clip, &asset, true, 0.0);
+
+	std::vector<TrackCursor> cursors(clip->tracks.size());
+	PoseSampleScratch scratch;
+
+	const double start = NowSec();
+	for (int i = 0; i < iterations; ++i)
+	{
+		player.Update(BENCH_FRAME_TIME);
+
+		const double ticks = player.GetCurrentTimeSec() * clip->ticksPerSecond;
+		AnimationSampler_SampleLocalPose(clip, &binding, asset.skeleton, ticks, cursors.data(), scratch, pose);
+	}
+	return NowSec() - start;
+}
+
+static double NowSec()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static float MaxPoseDiff(const PoseMatrixBuffer& a, const PoseMatrixBuffer& b)
+{
+	if (a.size() != b.size()) return INFINITY;
+
+	float maxDiff = 0.0f;
+	for (size_t n = 0; n < a.size(); ++n)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			XMFLOAT4 d;
+			XMStoreFloat4(&d, XMVectorAbs(XMVectorSubtract(a[n].r[row], b[n].r[row])));
+			maxDiff = std::max(maxDiff, std::max(std::max(d.x, d.y), std::max(d.z, d.w)));
+		}
+	}
+
+	return maxDiff;
+}
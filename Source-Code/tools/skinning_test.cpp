@@ -0,0 +1,378 @@
+/*==============================================================================
+
+   CPU skinning kernels against their scalar reference [skinning_test.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+   Not part of the game project, no GPU or Windows API needed. DirectXMath is
+   header only and builds with GCC / Clang (its Inc directory and a sal.h on
+   the include path, see the DirectXMath readme):
+
+     g++ -std=c++14 -O2 -I.. -I<DirectXMath>/Inc -I<sal.h dir> skinning_test.cpp \
+         ../animation_skinning.cpp ../worker_pool_util.cpp -pthread -o skinning_test
+     ./skinning_test [--vertices 200000] [--bones 80] [--seed 1]
+
+   Random palettes (rotation, non-uniform scale, translation, transposed like
+   the skinning CB) and vertices with 0..4 influences, plus the cases the shader
+   skips (index past the palette, zero / negative weight, weight sum below the
+   bind-pose threshold):
+   ├─ AnimationSkinning_Skin against AnimationSkinning_SkinReference
+   ├─ AnimationSkinning_SkinParallel on a WorkerPool : bit-identical to Skin
+   ├─ posed AABB from per-bone boxes contains every skinned position
+   └─ dual quaternion skinning of a rigid palette against linear blend (one influence)
+   Exit code 1 on a mismatch, so it can run in a script.
+
+==============================================================================*/
+
+#include "model_vertex.h"
+#include "animation_skinning.h"
+#include "worker_pool_util.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace DirectX;
+
+static const float POSITION_TOLERANCE = 1.0e-4f; // relative to the position's magnitude (at least 1)
+static const float NORMAL_TOLERANCE = 1.0e-4f;
+static const float BOX_TOLERANCE = 1.0e-4f;
+
+struct TestRandom
+{
+	uint32_t state;
+
+	uint32_t Next()
+	{
+		// xorshift32: same sequence on every compiler, unlike the <random> distributions
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	float Range(float lo, float hi) { return lo + (hi - lo) * (Next() >> 8) * (1.0f / 16777216.0f); }
+	int Index(int count) { return static_cast<int>(Next() % static_cast<uint32_t>(count)); }
+};
+
+static void BuildPalette(TestRandom& rnd, int boneCount, bool rigid, std::vector<XMFLOAT4X4>& outPalette);
+static void BuildVertices(TestRandom& rnd, int vertexCount, int boneCount, bool wellFormed, std::vector<Vertex3d>& outVertices);
+static void BuildBoneBounds(const std::vector<Vertex3d>& vertices, int boneCount, std::vector<BoneBounds>& outBounds);
+static float PositionError(const XMFLOAT3& a, const XMFLOAT3& b);
+static float NormalError(const XMFLOAT3& a, const XMFLOAT3& b);
+static bool TestAgainstReference(const std::vector<Vertex3d>& vertices, const std::vector<XMFLOAT4X4>& palette, const char* label);
+static bool TestParallel(const std::vector<Vertex3d>& vertices, const std::vector<XMFLOAT4X4>& palette);
+static bool TestPosedBounds(const std::vector<Vertex3d>& vertices, const std::vector<XMFLOAT4X4>& palette);
+static bool TestDualQuat(TestRandom& rnd, int vertexCount, int boneCount);
+
+
+int main(int argc, char** argv)
+{
+	int vertexCount = 200000;
+	int boneCount = 80;
+	uint32_t seed = 1;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--vertices") == 0 && i + 1 < argc) vertexCount = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--bones") == 0 && i + 1 < argc) boneCount = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		else
+		{
+			printf("usage: skinning_test [--vertices count] [--bones count] [--seed value]\n");
+			return 1;
+		}
+	}
+
+	if (vertexCount <= 0 || boneCount <= 0 || boneCount > 256)
+	{
+		printf("vertices > 0, bones 1..256\n");
+		return 1;
+	}
+
+	TestRandom rnd = { seed ? seed : 1 };
+
+	std::vector<XMFLOAT4X4> palette;
+	BuildPalette(rnd, boneCount, false, palette);
+
+	// Weights normalized, indices in range (what the importer produces)
+	std::vector<Vertex3d> vertices;
+	BuildVertices(rnd, vertexCount, boneCount, true, vertices);
+
+	// Everything the shader has to survive
+	std::vector<Vertex3d> edgeVertices;
+	BuildVertices(rnd, vertexCount / 4 + 1, boneCount, false, edgeVertices);
+
+	printf("%d vertices, %d bones, seed %u\n", vertexCount, boneCount, seed);
+
+	bool ok = true;
+	ok = TestAgainstReference(vertices, palette, "skin vs reference") && ok;
+	ok = TestAgainstReference(edgeVertices, palette, "skin vs reference, edge cases") && ok;
+	ok = TestParallel(vertices, palette) && ok;
+	ok = TestPosedBounds(vertices, palette) && ok;
+	ok = TestDualQuat(rnd, vertexCount, boneCount) && ok;
+
+	printf(ok ? "OK\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
+
+// Rotations within 60 degrees of identity: the blended normal of opposing influences
+// stays long enough to be compared after normalization
+static void BuildPalette(TestRandom& rnd, int boneCount, bool rigid, std::vector<XMFLOAT4X4>& outPalette)
+{
+	outPalette.resize(boneCount);
+
+	for (int b = 0; b < boneCount; ++b)
+	{
+		const XMVECTOR axis = XMVectorSet(rnd.Range(-1.0f, 1.0f), rnd.Range(-1.0f, 1.0f), rnd.Range(-1.0f, 1.0f), 0.0f);
+		const float angle = rnd.Range(-XM_PI / 3.0f, XM_PI / 3.0f);
+		const XMVECTOR rot = XMVector3Equal(axis, XMVectorZero()) ? XMQuaternionIdentity() : XMQuaternionRotationAxis(axis, angle);
+
+		const XMVECTOR scale = rigid
+			? XMVectorSplatOne()
+			: XMVectorSet(rnd.Range(0.8f, 1.25f), rnd.Range(0.8f, 1.25f), rnd.Range(0.8f, 1.25f), 0.0f);
+		const XMVECTOR trans = XMVectorSet(rnd.Range(-2.0f, 2.0f), rnd.Range(-2.0f, 2.0f), rnd.Range(-2.0f, 2.0f), 0.0f);
+
+		const XMMATRIX skin = XMMatrixScalingFromVector(scale) * XMMatrixRotationQuaternion(rot) * XMMatrixTranslationFromVector(trans);
+
+		// Transposed for HLSL, as Animation_BuildSkinMatrices stores it
+		XMStoreFloat4x4(&outPalette[b], XMMatrixTranspose(skin));
+	}
+}
+
+static void BuildVertices(TestRandom& rnd, int vertexCount, int boneCount, bool wellFormed, std::vector<Vertex3d>& outVertices)
+{
+	outVertices.resize(vertexCount);
+
+	for (int v = 0; v < vertexCount; ++v)
+	{
+		Vertex3d& vtx = outVertices[v];
+		memset(&vtx, 0, sizeof(vtx));
+
+		vtx.position = XMFLOAT3(rnd.Range(-1.0f, 1.0f), rnd.Range(-1.0f, 1.0f), rnd.Range(-1.0f, 1.0f));
+
+		XMVECTOR n = XMVectorSet(rnd.Range(-1.0f, 1.0f), rnd.Range(-1.0f, 1.0f), rnd.Range(-1.0f, 1.0f), 0.0f);
+		if (XMVectorGetX(XMVector3LengthSq(n)) < 1.0e-4f) n = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+		XMStoreFloat3(&vtx.normal, XMVector3Normalize(n));
+
+		const int influences = wellFormed ? 1 + rnd.Index(4) : rnd.Index(5);
+
+		float sum = 0.0f;
+		for (int i = 0; i < influences; ++i)
+		{
+			vtx.boneIndex[i] = static_cast<uint32_t>(wellFormed ? rnd.Index(boneCount) : rnd.Index(boneCount + 8));
+			vtx.boneWeight[i] = rnd.Range(0.05f, 1.0f);
+			sum += vtx.boneWeight[i];
+		}
+
+		for (int i = 0; i < influences; ++i)
+		{
+			vtx.boneWeight[i] /= sum;
+		}
+
+		if (wellFormed) continue;
+
+		switch (v % 6)
+		{
+		case 0: // below the bind-pose threshold
+			for (int i = 0; i < 4; ++i) vtx.boneWeight[i] *= 1.0e-5f;
+			break;
+		case 1: // negative weight, skipped by the shader
+			vtx.boneWeight[0] = -vtx.boneWeight[0];
+			break;
+		case 2: // weights that do not add up to 1 (the shader does not renormalize)
+			for (int i = 0; i < 4; ++i) vtx.boneWeight[i] *= 0.7f;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+// Exact per-bone boxes (every influence with a weight), so the posed box has to contain every vertex
+static void BuildBoneBounds(const std::vector<Vertex3d>& vertices, int boneCount, std::vector<BoneBounds>& outBounds)
+{
+	std::vector<int> slotOfBone(boneCount, -1);
+	outBounds.clear();
+
+	for (const Vertex3d& vtx : vertices)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			if (!(vtx.boneWeight[i] > 0.0f)) continue;
+
+			const int bone = static_cast<int>(vtx.boneIndex[i]);
+			if (slotOfBone[bone] < 0)
+			{
+				slotOfBone[bone] = static_cast<int>(outBounds.size());
+
+				BoneBounds bb;
+				bb.bone = bone;
+				bb.box.min = bb.box.max = vtx.position;
+				outBounds.push_back(bb);
+				continue;
+			}
+
+			AABB& box = outBounds[slotOfBone[bone]].box;
+			box.min.x = fminf(box.min.x, vtx.position.x);
+			box.min.y = fminf(box.min.y, vtx.position.y);
+			box.min.z = fminf(box.min.z, vtx.position.z);
+			box.max.x = fmaxf(box.max.x, vtx.position.x);
+			box.max.y = fmaxf(box.max.y, vtx.position.y);
+			box.max.z = fmaxf(box.max.z, vtx.position.z);
+		}
+	}
+}
+
+static bool TestAgainstReference(const std::vector<Vertex3d>& vertices, const std::vector<XMFLOAT4X4>& palette, const char* label)
+{
+	const int count = static_cast<int>(vertices.size());
+	const int bones = static_cast<int>(palette.size());
+
+	std::vector<XMFLOAT3> positions(count), normals(count);
+	std::vector<XMFLOAT3> refPositions(count), refNormals(count);
+
+	AnimationSkinning_Skin(vertices.data(), count, palette.data(), bones, positions.data(), normals.data());
+	AnimationSkinning_SkinReference(vertices.data(), count, palette.data(), bones, refPositions.data(), refNormals.data());
+
+	float maxPosition = 0.0f;
+	float maxNormal = 0.0f;
+	int failures = 0;
+
+	for (int v = 0; v < count; ++v)
+	{
+		const float ep = PositionError(positions[v], refPositions[v]);
+		const float en = NormalError(normals[v], refNormals[v]);
+
+		maxPosition = fmaxf(maxPosition, ep);
+		maxNormal = fmaxf(maxNormal, en);
+
+		if (!(ep <= POSITION_TOLERANCE) || !(en <= NORMAL_TOLERANCE))
+		{
+			if (failures < 5)
+			{
+				printf("    vertex %d : position (%f %f %f) / (%f %f %f), normal error %g\n", v,
+					positions[v].x, positions[v].y, positions[v].z,
+					refPositions[v].x, refPositions[v].y, refPositions[v].z, en);
+			}
+			++failures;
+		}
+	}
+
+	printf("  %-34s max position error %.2e, max normal error %.2e : %s\n", label, maxPosition, maxNormal, failures ? "FAIL" : "ok");
+	return failures == 0;
+}
+
+static bool TestParallel(const std::vector<Vertex3d>& vertices, const std::vector<XMFLOAT4X4>& palette)
+{
+	const int count = static_cast<int>(vertices.size());
+	const int bones = static_cast<int>(palette.size());
+
+	std::vector<XMFLOAT3> positions(count), normals(count);
+	std::vector<XMFLOAT3> parallelPositions(count), parallelNormals(count);
+
+	AnimationSkinning_Skin(vertices.data(), count, palette.data(), bones, positions.data(), normals.data());
+
+	WorkerPool pool;
+	pool.Start(3);
+	AnimationSkinning_SkinParallel(&pool, vertices.data(), count, palette.data(), bones, parallelPositions.data(), parallelNormals.data());
+	pool.Stop();
+
+	const bool same =
+		memcmp(positions.data(), parallelPositions.data(), count * sizeof(XMFLOAT3)) == 0 &&
+		memcmp(normals.data(), parallelNormals.data(), count * sizeof(XMFLOAT3)) == 0;
+
+	printf("  %-34s 4 threads : %s\n", "parallel vs single thread", same ? "bit-identical" : "FAIL (results differ)");
+	return same;
+}
+
+static bool TestPosedBounds(const std::vector<Vertex3d>& vertices, const std::vector<XMFLOAT4X4>& palette)
+{
+	const int count = static_cast<int>(vertices.size());
+	const int bones = static_cast<int>(palette.size());
+
+	std::vector<BoneBounds> bounds;
+	BuildBoneBounds(vertices, bones, bounds);
+
+	AABB box;
+	if (!AnimationSkinning_ComputePosedAABB(bounds.data(), static_cast<int>(bounds.size()), palette.data(), bones, box))
+	{
+		printf("  %-34s no box : FAIL\n", "posed AABB");
+		return false;
+	}
+
+	std::vector<XMFLOAT3> positions(count);
+	AnimationSkinning_Skin(vertices.data(), count, palette.data(), bones, positions.data(), nullptr);
+
+	int outside = 0;
+	for (const XMFLOAT3& p : positions)
+	{
+		if (p.x < box.min.x - BOX_TOLERANCE || p.y < box.min.y - BOX_TOLERANCE || p.z < box.min.z - BOX_TOLERANCE ||
+			p.x > box.max.x + BOX_TOLERANCE || p.y > box.max.y + BOX_TOLERANCE || p.z > box.max.z + BOX_TOLERANCE)
+		{
+			++outside;
+		}
+	}
+
+	printf("  %-34s %d bone boxes, %d vertices outside : %s\n", "posed AABB", static_cast<int>(bounds.size()), outside, outside ? "FAIL" : "ok");
+	return outside == 0;
+}
+
+// Single influence, rigid skin matrices: both methods are the same rigid transform
+static bool TestDualQuat(TestRandom& rnd, int vertexCount, int boneCount)
+{
+	std::vector<XMFLOAT4X4> palette;
+	BuildPalette(rnd, boneCount, true, palette);
+
+	std::vector<Vertex3d> vertices;
+	BuildVertices(rnd, vertexCount / 4 + 1, boneCount, true, vertices);
+
+	for (Vertex3d& vtx : vertices)
+	{
+		vtx.boneWeight[0] = 1.0f;
+		vtx.boneWeight[1] = vtx.boneWeight[2] = vtx.boneWeight[3] = 0.0f;
+	}
+
+	std::vector<SkinDualQuat> dualQuats;
+	AnimationSkinning_BuildDualQuatPalette(palette, dualQuats);
+
+	const int count = static_cast<int>(vertices.size());
+	std::vector<XMFLOAT3> positions(count), normals(count);
+	std::vector<XMFLOAT3> dqPositions(count), dqNormals(count);
+
+	AnimationSkinning_Skin(vertices.data(), count, palette.data(), boneCount, positions.data(), normals.data());
+	AnimationSkinning_SkinDualQuat(vertices.data(), count, dualQuats.data(), static_cast<int>(dualQuats.size()), dqPositions.data(), dqNormals.data());
+
+	float maxPosition = 0.0f;
+	float maxNormal = 0.0f;
+	int failures = 0;
+
+	for (int v = 0; v < count; ++v)
+	{
+		const float ep = PositionError(dqPositions[v], positions[v]);
+		const float en = NormalError(dqNormals[v], normals[v]);
+
+		maxPosition = fmaxf(maxPosition, ep);
+		maxNormal = fmaxf(maxNormal, en);
+
+		if (!(ep <= POSITION_TOLERANCE * 10.0f) || !(en <= NORMAL_TOLERANCE * 10.0f)) ++failures;
+	}
+
+	printf("  %-34s max position error %.2e, max normal error %.2e : %s\n", "dual quaternion vs linear (rigid)", maxPosition, maxNormal, failures ? "FAIL" : "ok");
+	return failures == 0;
+}
+
+static float PositionError(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	const float d = fmaxf(fabsf(a.x - b.x), fmaxf(fabsf(a.y - b.y), fabsf(a.z - b.z)));
+	const float m = fmaxf(1.0f, fmaxf(fabsf(b.x), fmaxf(fabsf(b.y), fabsf(b.z))));
+	return d / m;
+}
+
+static float NormalError(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return fmaxf(fabsf(a.x - b.x), fmaxf(fabsf(a.y - b.y), fabsf(a.z - b.z)));
+}
@@ -0,0 +1,164 @@
+/*==============================================================================
+
+   Packed vertex streams [vertex_pack_util.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "vertex_pack_util.h"
+#include "model_asset.h"
+
+#include <algorithm>
+#include <cmath>
+#include <DirectXPackedVector.h>
+
+using namespace DirectX;
+
+static const float OCT_MIN_LENGTH = 1.0e-8f;
+
+static int16_t ToSnorm16(float v);
+static uint8_t ToUnorm8(float v);
+
+
+uint32_t VertexPack_GetVertexBytes(VertexLayout layout)
+{
+	return (layout == VertexLayout::Skinned)
+		? static_cast<uint32_t>(sizeof(VertexPacked) + sizeof(VertexSkinPacked))
+		: static_cast<uint32_t>(sizeof(VertexPacked));
+}
+
+// Project onto the octahedron |x| + |y| + |z| = 1, fold the lower half over the diagonals
+void VertexPack_OctEncode(const XMFLOAT3& n, int16_t out[2])
+{
+	const float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+	if (l1 < OCT_MIN_LENGTH)
+	{
+		out[0] = 0; // +Z
+		out[1] = 0;
+		return;
+	}
+
+	float x = n.x / l1;
+	float y = n.y / l1;
+
+	if (n.z < 0.0f)
+	{
+		const float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		const float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = fx;
+		y = fy;
+	}
+
+	out[0] = ToSnorm16(x);
+	out[1] = ToSnorm16(y);
+}
+
+XMFLOAT3 VertexPack_OctDecode(const int16_t e[2])
+{
+	const float x = std::max(e[0] / 32767.0f, -1.0f);
+	const float y = std::max(e[1] / 32767.0f, -1.0f);
+
+	XMFLOAT3 n(x, y, 1.0f - std::fabs(x) - std::fabs(y));
+
+	const float t = std::max(-n.z, 0.0f);
+	n.x += (n.x >= 0.0f) ? -t : t;
+	n.y += (n.y >= 0.0f) ? -t : t;
+
+	XMFLOAT3 out;
+	XMStoreFloat3(&out, XMVector3Normalize(XMLoadFloat3(&n)));
+	return out;
+}
+
+void VertexPack_Encode(
+	const XMFLOAT3& position,
+	const XMFLOAT3& normal,
+	const XMFLOAT3& tangent,
+	const XMFLOAT4& color,
+	const XMFLOAT2& texcoord,
+	VertexPacked& out)
+{
+	out.position = position;
+
+	VertexPack_OctEncode(normal, out.normal);
+	VertexPack_OctEncode(tangent, out.tangent);
+
+	out.color[0] = ToUnorm8(color.x);
+	out.color[1] = ToUnorm8(color.y);
+	out.color[2] = ToUnorm8(color.z);
+	out.color[3] = ToUnorm8(color.w);
+
+	out.texcoord[0] = PackedVector::XMConvertFloatToHalf(texcoord.x);
+	out.texcoord[1] = PackedVector::XMConvertFloatToHalf(texcoord.y);
+}
+
+int VertexPack_EncodeSkin(const unsigned int boneIndex[4], const float boneWeight[4], VertexSkinPacked& out)
+{
+	// Out of range bones : weight 0, the rest scaled up to the same total
+	float weight[4];
+	float total = 0.0f;
+	float kept = 0.0f;
+	int dropped = 0;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		const bool inRange = boneIndex[i] < VERTEX_PACK_MAX_BONES;
+		if (!inRange && boneWeight[i] > 0.0f) ++dropped;
+
+		weight[i] = inRange ? boneWeight[i] : 0.0f;
+		total += std::max(boneWeight[i], 0.0f);
+		kept += std::max(weight[i], 0.0f);
+	}
+
+	const float scale = (dropped > 0 && kept > 0.0f) ? total / kept : 1.0f;
+
+	int sum = 0;
+	int largest = 0;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		out.boneIndex[i] = (boneIndex[i] < VERTEX_PACK_MAX_BONES) ? static_cast<uint8_t>(boneIndex[i]) : 0;
+		out.boneWeight[i] = ToUnorm8(weight[i] * scale);
+
+		sum += out.boneWeight[i];
+		if (weight[i] > weight[largest]) largest = i;
+	}
+
+	// Unweighted vertices stay unweighted (bind pose in the shader)
+	if (sum == 0) return dropped;
+
+	out.boneWeight[largest] = static_cast<uint8_t>(std::min(std::max(out.boneWeight[largest] + (255 - sum), 0), 255));
+	return dropped;
+}
+
+uint32_t VertexPack_EncodeVertices(const Vertex3d* vertices, uint32_t vertexCount, VertexPacked* outVertices, VertexSkinPacked* outSkin)
+{
+	uint32_t dropped = 0;
+
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		const Vertex3d& src = vertices[v];
+
+		VertexPack_Encode(src.position, src.normal, src.tangent, src.color, src.texcoord, outVertices[v]);
+
+		if (outSkin)
+		{
+			dropped += static_cast<uint32_t>(VertexPack_EncodeSkin(src.boneIndex, src.boneWeight, outSkin[v]));
+		}
+	}
+
+	return dropped;
+}
+
+static int16_t ToSnorm16(float v)
+{
+	v = std::min(std::max(v, -1.0f), 1.0f);
+	return static_cast<int16_t>(std::lround(v * 32767.0f));
+}
+
+static uint8_t ToUnorm8(float v)
+{
+	v = std::min(std::max(v, 0.0f), 1.0f);
+	return static_cast<uint8_t>(std::lround(v * 255.0f));
+}
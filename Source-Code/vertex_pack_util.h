@@ -0,0 +1,85 @@
+/*==============================================================================
+
+   Packed vertex streams [vertex_pack_util.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef VERTEX_PACK_UTIL_H
+#define VERTEX_PACK_UTIL_H
+
+#include <cstdint>
+#include <DirectXMath.h>
+
+struct Vertex3d;
+
+/*
+// -------------------------------
+Vertex3d (92 bytes) is kept on the CPU only (import, CPU skinning, bake)
+The GPU gets
+├─ stream 0 : VertexPacked (28 bytes), every mesh
+│   ├─ position : R32G32B32_FLOAT
+│   ├─ normal   : R16G16_SNORM, octahedral
+│   ├─ tangent  : R16G16_SNORM, octahedral
+│   ├─ color    : R8G8B8A8_UNORM
+│   └─ texcoord : R16G16_FLOAT
+└─ stream 1 : VertexSkinPacked (8 bytes), VertexLayout::Skinned only
+    ├─ boneIndex  : R8G8B8A8_UINT (MAX_BONES = 256)
+    └─ boneWeight : R8G8B8A8_UNORM, quantized to sum to 255
+// -------------------------------
+*/
+
+// Chosen per mesh at import, decides the streams and the input layout
+enum class VertexLayout : uint32_t
+{
+	Static = 0,  // stream 0
+	Skinned = 1, // stream 0 + stream 1
+};
+
+struct VertexPacked
+{
+	DirectX::XMFLOAT3 position;
+	int16_t normal[2];
+	int16_t tangent[2];
+	uint8_t color[4];
+	uint16_t texcoord[2]; // half
+};
+
+static const unsigned int VERTEX_PACK_MAX_BONES = 256; // uint8 bone indices
+
+struct VertexSkinPacked
+{
+	uint8_t boneIndex[4];
+	uint8_t boneWeight[4];
+};
+
+static_assert(sizeof(VertexPacked) == 28, "VertexPacked layout");
+static_assert(sizeof(VertexSkinPacked) == 8, "VertexSkinPacked layout");
+
+// GPU bytes per vertex of a layout (both streams)
+uint32_t VertexPack_GetVertexBytes(VertexLayout layout);
+
+// Unit vector <-> octahedral snorm16 pair (same decode as OctDecode in the vertex shaders)
+void VertexPack_OctEncode(const DirectX::XMFLOAT3& n, int16_t out[2]);
+DirectX::XMFLOAT3 VertexPack_OctDecode(const int16_t e[2]);
+
+void VertexPack_Encode(
+	const DirectX::XMFLOAT3& position,
+	const DirectX::XMFLOAT3& normal,
+	const DirectX::XMFLOAT3& tangent,
+	const DirectX::XMFLOAT4& color,
+	const DirectX::XMFLOAT2& texcoord,
+	VertexPacked& out
+);
+
+// Weights of 0 stay 0, the rounding error goes to the largest one
+// Influences on bones uint8 cannot index are dropped and their weight goes to the others; returns how many
+int VertexPack_EncodeSkin(const unsigned int boneIndex[4], const float boneWeight[4], VertexSkinPacked& out);
+
+// outSkin : nullptr for VertexLayout::Static
+// Returns the influences EncodeSkin dropped over all vertices
+uint32_t VertexPack_EncodeVertices(const Vertex3d* vertices, uint32_t vertexCount, VertexPacked* outVertices, VertexSkinPacked* outSkin);
+
+#endif // VERTEX_PACK_UTIL_H
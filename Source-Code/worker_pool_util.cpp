@@ -0,0 +1,210 @@
+/*==============================================================================
+
+   Worker thread pool [worker_pool_util.cpp]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#include "worker_pool_util.h"
+
+#include <algorithm>
+
+
+WorkerPool::~WorkerPool()
+{
+	Stop();
+}
+
+void WorkerPool::Start(int workerCount)
+{
+	Stop();
+
+	m_Quit = false;
+	m_Generation = 0;
+
+	for (int i = 0; i < workerCount; ++i)
+	{
+		m_Threads.emplace_back(&WorkerPool::WorkerMain, this);
+	}
+}
+
+void WorkerPool::Stop()
+{
+	if (m_Threads.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+	m_WakeCv.notify_all();
+
+	for (std::thread& t : m_Threads)
+	{
+		t.join();
+	}
+	m_Threads.clear();
+}
+
+void WorkerPool::ParallelFor(int count, int grain, const RangeJob& job)
+{
+	if (count <= 0) return;
+	if (grain < 1) grain = 1;
+
+	// Not worth waking anyone
+	if (m_Threads.empty() || count <= grain)
+	{
+		job(0, count);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Job = &job;
+		m_Count = count;
+		m_Grain = grain;
+		m_NextIndex.store(0);
+		m_Busy = GetWorkerCount();
+		++m_Generation;
+	}
+	m_WakeCv.notify_all();
+
+	RunChunks();
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_DoneCv.wait(lock, [this] { return m_Busy == 0; });
+	m_Job = nullptr;
+}
+
+int WorkerPool::DefaultWorkerCount()
+{
+	const int hw = static_cast<int>(std::thread::hardware_concurrency());
+	return std::max(hw - 1, 0);
+}
+
+void WorkerPool::WorkerMain()
+{
+	uint64_t seen = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WakeCv.wait(lock, [this, seen] { return m_Quit || m_Generation != seen; });
+
+			if (m_Quit) return;
+			seen = m_Generation;
+		}
+
+		RunChunks();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (--m_Busy == 0)
+			{
+				m_DoneCv.notify_one();
+			}
+		}
+	}
+}
+
+void WorkerPool::RunChunks()
+{
+	for (;;)
+	{
+		const int begin = m_NextIndex.fetch_add(m_Grain);
+		if (begin >= m_Count) break;
+
+		(*m_Job)(begin, std::min(begin + m_Grain, m_Count));
+	}
+}
+
+
+TaskQueue::~TaskQueue()
+{
+	Stop();
+}
+
+void TaskQueue::Start(int threadCount)
+{
+	Stop();
+
+	m_Quit = false;
+
+	for (int i = 0; i < threadCount; ++i)
+	{
+		m_Threads.emplace_back(&TaskQueue::ThreadMain, this);
+	}
+}
+
+void TaskQueue::Stop()
+{
+	if (m_Threads.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+		m_Tasks.clear();
+	}
+	m_WakeCv.notify_all();
+	m_IdleCv.notify_all(); // WaitIdle returns on m_Quit
+
+	for (std::thread& t : m_Threads)
+	{
+		t.join();
+	}
+	m_Threads.clear();
+}
+
+void TaskQueue::Push(Task task)
+{
+	// No thread: run it here rather than never
+	if (m_Threads.empty())
+	{
+		task();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Tasks.push_back(std::move(task));
+	}
+	m_WakeCv.notify_one();
+}
+
+void TaskQueue::WaitIdle()
+{
+	if (m_Threads.empty()) return;
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_IdleCv.wait(lock, [this] { return m_Quit || (m_Tasks.empty() && m_Running == 0); });
+}
+
+void TaskQueue::ThreadMain()
+{
+	for (;;)
+	{
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WakeCv.wait(lock, [this] { return m_Quit || !m_Tasks.empty(); });
+
+			if (m_Quit) return;
+
+			task = std::move(m_Tasks.front());
+			m_Tasks.pop_front();
+			++m_Running;
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (--m_Running == 0 && m_Tasks.empty())
+			{
+				m_IdleCv.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,109 @@
+/*==============================================================================
+
+   Worker thread pool [worker_pool_util.h]
+														 Author : Gu Anyi
+														 Date   : 2026/10/17
+--------------------------------------------------------------------------------
+
+==============================================================================*/
+
+#ifndef WORKER_POOL_UTIL_H
+#define WORKER_POOL_UTIL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join pool: ParallelFor splits [0, count) into fixed chunks of 'grain'
+// The calling thread works too and returns when every chunk is done
+// Chunks never overlap, so jobs that only write their own indices are deterministic
+class WorkerPool
+{
+public:
+
+	// (begin, end) : half-open index range of one chunk
+	typedef std::function<void(int, int)> RangeJob;
+
+	WorkerPool() = default;
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// workerCount extra threads (0: everything runs on the caller)
+	void Start(int workerCount);
+	void Stop();
+
+	int GetWorkerCount() const { return static_cast<int>(m_Threads.size()); }
+	int GetThreadCount() const { return GetWorkerCount() + 1; }
+
+	void ParallelFor(int count, int grain, const RangeJob& job);
+
+	// hardware_concurrency - 1, at least 0
+	static int DefaultWorkerCount();
+
+private:
+
+	void WorkerMain();
+	void RunChunks();
+
+	std::vector<std::thread> m_Threads;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WakeCv;
+	std::condition_variable m_DoneCv;
+
+	const RangeJob* m_Job = nullptr;
+	int m_Count = 0;
+	int m_Grain = 1;
+	std::atomic<int> m_NextIndex{ 0 };
+
+	int m_Busy = 0;             // workers still inside the current job
+	uint64_t m_Generation = 0;  // bumped per ParallelFor, wakes the workers
+	bool m_Quit = false;
+};
+
+// Fire-and-forget queue: long jobs (file loads) run on their own threads, FIFO
+// Unlike WorkerPool nobody waits; jobs report back through state they own
+class TaskQueue
+{
+public:
+
+	typedef std::function<void()> Task;
+
+	TaskQueue() = default;
+	~TaskQueue();
+
+	TaskQueue(const TaskQueue&) = delete;
+	TaskQueue& operator=(const TaskQueue&) = delete;
+
+	void Start(int threadCount);
+	void Stop(); // waits for running tasks, queued ones are dropped
+
+	bool IsRunning() const { return !m_Threads.empty(); }
+	int GetThreadCount() const { return static_cast<int>(m_Threads.size()); }
+
+	void Push(Task task);
+	void WaitIdle(); // until the queue is empty and no task is running
+
+private:
+
+	void ThreadMain();
+
+	std::vector<std::thread> m_Threads;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WakeCv;
+	std::condition_variable m_IdleCv;
+
+	std::deque<Task> m_Tasks;
+	int m_Running = 0;
+	bool m_Quit = false;
+};
+
+#endif // WORKER_POOL_UTIL_H